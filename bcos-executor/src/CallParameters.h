@@ -2,12 +2,14 @@
 
 #include <bcos-framework/protocol/LogEntry.h>
 #include <bcos-utilities/Common.h>
+#include <bcos-utilities/FixedSizePool.h>
 #include <memory>
 #include <string>
 
 namespace bcos::executor
 {
-struct CallParameters
+// allocated from a pool, every transaction creates several of them in the DMC rounds
+struct CallParameters : public bcos::PoolAllocated<CallParameters>
 {
     using UniquePtr = std::unique_ptr<CallParameters>;
     using UniqueConstPtr = std::unique_ptr<const CallParameters>;
@@ -60,6 +62,28 @@ struct CallParameters
      */
     bool internalCall = false;
 
+    // copy the request fields, used to execute the same request more than once
+    UniquePtr copyRequest() const
+    {
+        auto request = std::make_unique<CallParameters>(type);
+        request->contextID = contextID;
+        request->seq = seq;
+        request->senderAddress = senderAddress;
+        request->codeAddress = codeAddress;
+        request->receiveAddress = receiveAddress;
+        request->origin = origin;
+        request->gas = gas;
+        request->data = data;
+        request->abi = abi;
+        request->keyLocks = keyLocks;
+        request->createSalt = createSalt;
+        request->staticCall = staticCall;
+        request->create = create;
+        request->internalCreate = internalCreate;
+        request->internalCall = internalCall;
+        return request;
+    }
+
     std::string toString()
     {
         std::stringstream ss;
@@ -21,8 +21,11 @@
 
 
 #pragma once
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <functional>
 #include <map>
+#include <numeric>
 #include <unordered_map>
 #include <set>
 #include <vector>
@@ -42,6 +45,17 @@ using OnFirstConflictHandler = std::function<void(ID)>;  // conflict
 using OnEmptyConflictHandler = std::function<void(ID)>;  // conflict
 using OnAllConflictHandler = std::function<void(ID)>;    // conflict
 
+// Conflict graph in compressed sparse row format
+// the txs depend on id are edges[offsets[id], offsets[id + 1])
+struct ConflictGraph
+{
+    std::vector<ID> offsets;
+    std::vector<ID> edges;
+    std::vector<ID> inDegrees;
+    // the txs without conflict parent, in order
+    std::vector<ID> roots;
+};
+
 class CriticalFieldsInterface
 {
 public:
@@ -55,6 +69,9 @@ public:
         OnFirstConflictHandler const& _onFirstConflict,
         OnEmptyConflictHandler const& _onEmptyConflict,
         OnAllConflictHandler const& _onAllConflict) = 0;
+
+    // the txs without criticals (nullptr) are not in the graph
+    virtual ConflictGraph conflictGraph() = 0;
 };
 
 class CriticalFields : public virtual CriticalFieldsInterface
@@ -124,7 +141,104 @@ public:
         }
     };
 
+    ConflictGraph conflictGraph() override
+    {
+        auto txsSize = m_criticals.size();
+        // hash the critical fields in parallel
+        std::vector<std::vector<size_t>> fieldHashes(txsSize);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, txsSize),
+            [this, &fieldHashes](tbb::blocked_range<size_t> const& range) {
+                for (auto id = range.begin(); id < range.end(); ++id)
+                {
+                    auto const& criticals = m_criticals[id];
+                    if (!criticals)
+                    {
+                        continue;
+                    }
+                    fieldHashes[id].reserve(criticals->size());
+                    for (auto const& c : *criticals)
+                    {
+                        fieldHashes[id].push_back(boost::hash_range(c.begin(), c.end()));
+                    }
+                }
+            });
+
+        // Partition the fields by hash, every shard links a tx to the last tx before it with the
+        // same field. The earlier txs with the field are reachable through the last one.
+        std::vector<std::vector<std::pair<ID, ID>>> shardEdges(c_conflictShards);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, c_conflictShards),
+            [this, txsSize, &fieldHashes, &shardEdges](tbb::blocked_range<size_t> const& range) {
+                for (auto shard = range.begin(); shard < range.end(); ++shard)
+                {
+                    std::unordered_map<FieldKey, ID, FieldKeyHash> lastIds;
+                    auto& edges = shardEdges[shard];
+                    for (ID id = 0; id < txsSize; ++id)
+                    {
+                        auto const& hashes = fieldHashes[id];
+                        for (size_t i = 0; i < hashes.size(); ++i)
+                        {
+                            if (hashes[i] % c_conflictShards != shard)
+                            {
+                                continue;
+                            }
+                            auto key = FieldKey{hashes[i], &(*m_criticals[id])[i]};
+                            auto [it, inserted] = lastIds.try_emplace(key, id);
+                            if (!inserted && it->second != id)
+                            {
+                                edges.emplace_back(it->second, id);
+                                it->second = id;
+                            }
+                        }
+                    }
+                }
+            });
+
+        // Note: two txs with several same fields may be linked more than once, the duplicated
+        // edges are counted in the inDegrees too
+        ConflictGraph graph;
+        graph.offsets.assign(txsSize + 1, 0);
+        graph.inDegrees.assign(txsSize, 0);
+        for (auto const& edges : shardEdges)
+        {
+            for (auto const& [from, to] : edges)
+            {
+                ++graph.offsets[from + 1];
+                ++graph.inDegrees[to];
+            }
+        }
+        std::partial_sum(graph.offsets.begin(), graph.offsets.end(), graph.offsets.begin());
+        graph.edges.resize(graph.offsets.back());
+        std::vector<ID> cursors(graph.offsets.begin(), graph.offsets.end() - 1);
+        for (auto const& edges : shardEdges)
+        {
+            for (auto const& [from, to] : edges)
+            {
+                graph.edges[cursors[from]++] = to;
+            }
+        }
+        for (ID id = 0; id < txsSize; ++id)
+        {
+            if (m_criticals[id] && graph.inDegrees[id] == 0)
+            {
+                graph.roots.push_back(id);
+            }
+        }
+        return graph;
+    }
+
 private:
+    struct FieldKey
+    {
+        size_t hash;
+        std::vector<uint8_t> const* field;
+        bool operator==(FieldKey const& _other) const { return *field == *_other.field; }
+    };
+    struct FieldKeyHash
+    {
+        size_t operator()(FieldKey const& _key) const { return _key.hash; }
+    };
+    static constexpr size_t c_conflictShards = 32;
+
     std::vector<CriticalFieldPtr> m_criticals;
 };
 }  // namespace critical
@@ -22,12 +22,14 @@
 
 #include "TxDAG2.h"
 #include "CriticalFields.h"
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+#include <atomic>
 
 using namespace std;
 using namespace bcos;
 using namespace bcos::executor;
 using namespace bcos::executor::critical;
-using namespace tbb::flow;
 
 #define DAG_LOG(LEVEL) BCOS_LOG(LEVEL) << LOG_BADGE("DAG")
 
@@ -40,55 +42,54 @@ void TxDAG2::init(critical::CriticalFieldsInterface::Ptr _txsCriticals, ExecuteT
     f_executeTx = _f;
     m_totalParaTxs = _txsCriticals->size();
 
-    // Generate tasks in m_tasks
-    // Note: we must generate every task in m_tasks before make_edge(). Otherwise, may lead to core.
-    using Msg = const continue_msg&;
-    std::vector<size_t> id2TaskId(txsSize);
-    for (ID id = 0; id < _txsCriticals->size(); ++id)
-    {
-        if (_txsCriticals->contains(id))
-        {
-            // generate tasks
-            auto task = [this, id](Msg) { f_executeTx(id); };
-            auto t = Task(m_dag, std::move(task));
-            auto taskId = m_tasks.size();
-            m_tasks.push_back(t);
-
-            id2TaskId[id] = taskId;
-        }
-    }
-
-    // define conflict handler
-    auto onConflictHandler = [&](ID pId, ID id) {
-        auto pTaskId = id2TaskId[pId];
-        auto taskId = id2TaskId[id];
-        make_edge(m_tasks[pTaskId], m_tasks[taskId]);
-    };
-    auto onFirstConflictHandler = [&](ID id) {
-        auto taskId = id2TaskId[id];
-        make_edge(m_startTask, m_tasks[taskId]);
-    };
-    auto onEmptyConflictHandler = [&](ID id) {
-        auto taskId = id2TaskId[id];
-        make_edge(m_startTask, m_tasks[taskId]);
-    };
-    auto onAllConflictHandler = [&](ID id) {
-        // do nothing
-        // ignore normal tx, only handle DAG tx, normal tx has been sent back to be executed by DMC
-        (void)id;
-    };
-
-    // parse criticals
-    _txsCriticals->traverseDag(
-        onConflictHandler, onFirstConflictHandler, onEmptyConflictHandler, onAllConflictHandler);
+    // Note: normal tx (without criticals) is not in the graph, it has been sent back to be
+    // executed by DMC
+    m_graph = _txsCriticals->conflictGraph();
 
-    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG");
+    DAG_LOG(TRACE) << LOG_DESC("End init transaction DAG") << LOG_KV("roots", m_graph.roots.size())
+                   << LOG_KV("edges", m_graph.edges.size());
 }
 
 void TxDAG2::run(unsigned int threadNum)
 {
     // TODO: add timeout logic
-    (void)threadNum;
-    m_startTask.try_put(continue_msg());
-    m_dag.wait_for_all();
-}
\ No newline at end of file
+    std::vector<std::atomic<ID>> inDegrees(m_graph.inDegrees.size());
+    for (size_t id = 0; id < inDegrees.size(); ++id)
+    {
+        inDegrees[id].store(m_graph.inDegrees[id], std::memory_order_relaxed);
+    }
+
+    tbb::task_arena arena(threadNum > 0 ? (int)threadNum : tbb::task_arena::automatic);
+    arena.execute([this, &inDegrees]() {
+        tbb::task_group group;
+        // execute the tx, then spawn the ready children to be stolen by the idle threads and
+        // continue with the first ready child in the current thread
+        std::function<void(ID)> executeTx = [this, &inDegrees, &group, &executeTx](ID id) {
+            while (id != INVALID_ID)
+            {
+                f_executeTx(id);
+                auto next = INVALID_ID;
+                for (auto i = m_graph.offsets[id]; i < m_graph.offsets[id + 1]; ++i)
+                {
+                    auto child = m_graph.edges[i];
+                    if (inDegrees[child].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    {
+                        continue;
+                    }
+                    if (next == INVALID_ID)
+                    {
+                        next = child;
+                        continue;
+                    }
+                    group.run([child, &executeTx]() { executeTx(child); });
+                }
+                id = next;
+            }
+        };
+        for (auto root : m_graph.roots)
+        {
+            group.run([root, &executeTx]() { executeTx(root); });
+        }
+        group.wait();
+    });
+}
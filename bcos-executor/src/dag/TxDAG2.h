@@ -22,7 +22,6 @@
 
 #pragma once
 #include "./TxDAGInterface.h"
-#include "tbb/flow_graph.h"
 #include <vector>
 
 
@@ -33,10 +32,8 @@ namespace executor
 
 class TxDAG2 : public virtual TxDAGInterface
 {
-    using Task = tbb::flow::continue_node<tbb::flow::continue_msg>;
-
 public:
-    TxDAG2() : m_startTask(m_dag) {}
+    TxDAG2() = default;
 
     virtual ~TxDAG2() {}
 
@@ -47,9 +44,7 @@ public:
 
 private:
     ExecuteTxFunc f_executeTx;
-    tbb::flow::graph m_dag;
-    tbb::flow::broadcast_node<tbb::flow::continue_msg> m_startTask;
-    std::vector<Task> m_tasks = std::vector<Task>();
+    critical::ConflictGraph m_graph;
     size_t m_totalParaTxs;
 };
 
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/**
+ * @brief : optimistic concurrent execution of the transactions without conflict fields
+ * @date: 2022-10-18
+ */
+
+#include "TxOCC.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+using namespace std;
+using namespace bcos;
+using namespace bcos::storage;
+using namespace bcos::executor;
+
+void ReadSetStorage::asyncGetPrimaryKeys(std::string_view _table,
+    const std::optional<storage::Condition const>& _condition,
+    std::function<void(Error::UniquePtr, std::vector<std::string>)> _callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scannedTables.emplace(_table);
+    }
+    m_state->asyncGetPrimaryKeys(_table, _condition, std::move(_callback));
+}
+
+void ReadSetStorage::asyncGetRow(std::string_view _table, std::string_view _key,
+    std::function<void(Error::UniquePtr, std::optional<storage::Entry>)> _callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_readKeys.emplace(_table, _key);
+    }
+    m_state->asyncGetRow(_table, _key, std::move(_callback));
+}
+
+void ReadSetStorage::asyncGetRows(std::string_view _table,
+    const std::variant<const gsl::span<std::string_view const>,
+        const gsl::span<std::string const>>& _keys,
+    std::function<void(Error::UniquePtr, std::vector<std::optional<storage::Entry>>)> _callback)
+{
+    std::visit(
+        [this, &_table](auto const& keys) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto const& key : keys)
+            {
+                m_readKeys.emplace(_table, key);
+            }
+        },
+        _keys);
+    m_state->asyncGetRows(_table, _keys, std::move(_callback));
+}
+
+void ReadSetStorage::asyncSetRow(std::string_view, std::string_view, storage::Entry,
+    std::function<void(Error::UniquePtr)> _callback)
+{
+    _callback(BCOS_ERROR_UNIQUE_PTR(
+        StorageError::ReadOnly, "The writes of speculative execution stay in the overlay"));
+}
+
+bool ReadSetStorage::conflictWith(
+    KeySet const& _writtenKeys, std::unordered_set<std::string> const& _writtenTables) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto const& table : m_scannedTables)
+    {
+        if (_writtenTables.count(table))
+        {
+            return true;
+        }
+    }
+    for (auto const& key : m_readKeys)
+    {
+        if (_writtenKeys.count(key))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+TxOCC::Attempt TxOCC::execute(ID _id, ExecuteTxFunc const& _f)
+{
+    Attempt attempt;
+    attempt.readSet = std::make_shared<ReadSetStorage>(m_state);
+    attempt.overlay = std::make_shared<StateStorage>(attempt.readSet);
+    attempt.commit = _f(_id, attempt.overlay);
+    return attempt;
+}
+
+size_t TxOCC::run(ID _txsNum, ExecuteTxFunc const& _f, unsigned int _threadNum)
+{
+    std::vector<Attempt> attempts(_txsNum);
+    tbb::task_arena arena(std::max(_threadNum, 1u));
+    arena.execute([&]() {
+        tbb::parallel_for(
+            tbb::blocked_range<ID>(0, _txsNum), [&](tbb::blocked_range<ID> const& _range) {
+                for (auto id = _range.begin(); id != _range.end(); ++id)
+                {
+                    attempts[id] = execute(id, _f);
+                }
+            });
+    });
+
+    // validate and commit in order, the writes go to the block state only here
+    ReadSetStorage::KeySet writtenKeys;
+    std::unordered_set<std::string> writtenTables;
+    size_t reexecuted = 0;
+    std::mutex writesMutex;
+    std::vector<std::tuple<std::string, std::string, Entry>> writes;
+    m_state->setRecoder(nullptr);
+    for (ID id = 0; id < _txsNum; ++id)
+    {
+        auto attempt = std::move(attempts[id]);
+        if (attempt.readSet->conflictWith(writtenKeys, writtenTables))
+        {
+            // nothing else is written in the meantime, the retry always commits
+            attempt = execute(id, _f);
+            ++reexecuted;
+        }
+        if (!attempt.commit)
+        {
+            continue;
+        }
+        writes.clear();
+        attempt.overlay->parallelTraverse(true,
+            [&](const std::string_view& _table, const std::string_view& _key, const Entry& _entry) {
+                std::lock_guard<std::mutex> lock(writesMutex);
+                writes.emplace_back(_table, _key, _entry);
+                return true;
+            });
+        for (auto& [table, key, entry] : writes)
+        {
+            m_state->asyncSetRow(table, key, std::move(entry), [](Error::UniquePtr) {});
+            writtenTables.emplace(table);
+            writtenKeys.emplace(std::move(table), std::move(key));
+        }
+    }
+    return reexecuted;
+}
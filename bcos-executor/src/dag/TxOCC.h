@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/**
+ * @brief : optimistic concurrent execution of the transactions without conflict fields
+ * @date: 2022-10-18
+ */
+
+#pragma once
+#include "bcos-table/src/StateStorage.h"
+#include <boost/functional/hash.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace bcos
+{
+namespace executor
+{
+// The read-only view of the block state for one speculative execution, records every key read
+// from the block state. The keys written by the transaction itself are read from the overlay
+// on top of this view and never reach it.
+class ReadSetStorage : public virtual storage::StorageInterface
+{
+public:
+    using Ptr = std::shared_ptr<ReadSetStorage>;
+    using Key = std::pair<std::string, std::string>;
+    using KeySet = std::unordered_set<Key, boost::hash<Key>>;
+
+    explicit ReadSetStorage(storage::StorageInterface::Ptr _state) : m_state(std::move(_state)) {}
+
+    void asyncGetPrimaryKeys(std::string_view _table,
+        const std::optional<storage::Condition const>& _condition,
+        std::function<void(Error::UniquePtr, std::vector<std::string>)> _callback) override;
+
+    void asyncGetRow(std::string_view _table, std::string_view _key,
+        std::function<void(Error::UniquePtr, std::optional<storage::Entry>)> _callback) override;
+
+    void asyncGetRows(std::string_view _table,
+        const std::variant<const gsl::span<std::string_view const>,
+            const gsl::span<std::string const>>& _keys,
+        std::function<void(Error::UniquePtr, std::vector<std::optional<storage::Entry>>)>
+            _callback) override;
+
+    void asyncSetRow(std::string_view _table, std::string_view _key, storage::Entry _entry,
+        std::function<void(Error::UniquePtr)> _callback) override;
+
+    // true if any key read by the transaction has been written by the given keys or tables
+    bool conflictWith(
+        KeySet const& _writtenKeys, std::unordered_set<std::string> const& _writtenTables) const;
+
+private:
+    storage::StorageInterface::Ptr m_state;
+    mutable std::mutex m_mutex;
+    KeySet m_readKeys;
+    // the tables whose primary keys have been listed
+    std::unordered_set<std::string> m_scannedTables;
+};
+
+// Executes the transactions speculatively in parallel, each against its own overlay of the block
+// state, then validates and commits them in the order of their IDs. A transaction whose read keys
+// have been written by an earlier committed transaction is re-executed on the latest state, so
+// the result is the same as executing all the transactions serially.
+class TxOCC
+{
+public:
+    using Ptr = std::shared_ptr<TxOCC>;
+    using ID = uint32_t;
+    // execute the transaction on the given state, return false to drop its writes
+    using ExecuteTxFunc = std::function<bool(ID, storage::StateStorageInterface::Ptr)>;
+
+    explicit TxOCC(storage::StateStorageInterface::Ptr _state) : m_state(std::move(_state)) {}
+
+    // return the number of the re-executed transactions
+    size_t run(ID _txsNum, ExecuteTxFunc const& _f, unsigned int _threadNum);
+
+private:
+    struct Attempt
+    {
+        ReadSetStorage::Ptr readSet;
+        storage::StateStorage::Ptr overlay;
+        bool commit = false;
+    };
+    Attempt execute(ID _id, ExecuteTxFunc const& _f);
+
+    storage::StateStorageInterface::Ptr m_state;
+};
+}  // namespace executor
+}  // namespace bcos
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the storage keys accessed by the recent calls of the contract functions
+ * @file AccessSetCache.cpp
+ */
+
+#include "AccessSetCache.h"
+
+using namespace bcos;
+using namespace bcos::executor;
+
+std::string AccessSetCache::itemKey(std::string_view _table, std::string_view _selector)
+{
+    std::string key;
+    key.reserve(_table.size() + _selector.size() + 1);
+    key.append(_table).append(1, '\0').append(_selector);
+    return key;
+}
+
+void AccessSetCache::record(std::string_view _table, std::string_view _selector, Keys _keys)
+{
+    if (_keys.size() > m_maxKeys)
+    {
+        _keys.resize(m_maxKeys);
+    }
+    m_items.insert(itemKey(_table, _selector), std::make_shared<const Keys>(std::move(_keys)));
+}
+
+bool AccessSetCache::collect(std::string_view _table, std::string_view _selector,
+    std::set<std::string, std::less<>>& _keys)
+{
+    auto keys = m_items.get(itemKey(_table, _selector));
+    if (!keys)
+    {
+        return false;
+    }
+    _keys.insert((*keys)->begin(), (*keys)->end());
+    return true;
+}
+
+size_t AccessSetCache::size() const
+{
+    return m_items.size();
+}
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the storage keys accessed by the recent calls of the contract functions
+ * @file AccessSetCache.h
+ */
+
+#pragma once
+#include <bcos-utilities/LRUCache.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bcos
+{
+namespace executor
+{
+/// The executor-wide LRU cache of the keys of the contract table accessed by the last call of
+/// every contract function, keyed by the table and the function selector. The keys are the
+/// prediction of the next calls of the function, prefetched in one multi-get before executing
+class AccessSetCache
+{
+public:
+    using Ptr = std::shared_ptr<AccessSetCache>;
+    using Keys = std::vector<std::string>;
+
+    AccessSetCache(size_t _capacity, size_t _maxKeys) : m_maxKeys(_maxKeys), m_items(_capacity) {}
+
+    // replace the keys of the function with the keys accessed by its last call
+    void record(std::string_view _table, std::string_view _selector, Keys _keys);
+    // add the recorded keys of the function to _keys, return false if nothing is recorded
+    bool collect(std::string_view _table, std::string_view _selector,
+        std::set<std::string, std::less<>>& _keys);
+
+    // the number of the recorded functions
+    size_t size() const;
+
+private:
+    static std::string itemKey(std::string_view _table, std::string_view _selector);
+
+    size_t m_maxKeys;
+    // every function is charged 1 against the capacity
+    LRUCache<std::string, std::shared_ptr<const Keys>> m_items;
+};
+}  // namespace executor
+}  // namespace bcos
@@ -22,6 +22,8 @@
 #pragma once
 
 #include "../Common.h"
+#include "../vm/CodeCache.h"
+#include "AccessSetCache.h"
 #include "ExecutiveFactory.h"
 #include "ExecutiveFlowInterface.h"
 #include "bcos-framework/executor/ExecutionMessage.h"
@@ -81,6 +83,15 @@ public:
 
     VMSchedule const& vmSchedule() const { return m_schedule; }
 
+    CodeCache::Ptr codeCache() const { return m_codeCache; }
+    void setCodeCache(CodeCache::Ptr _codeCache) { m_codeCache = std::move(_codeCache); }
+
+    AccessSetCache::Ptr accessSetCache() const { return m_accessSetCache; }
+    void setAccessSetCache(AccessSetCache::Ptr _accessSetCache)
+    {
+        m_accessSetCache = std::move(_accessSetCache);
+    }
+
     ExecutiveFlowInterface::Ptr getExecutiveFlow(std::string codeAddress);
     void setExecutiveFlow(std::string codeAddress, ExecutiveFlowInterface::Ptr executiveFlow);
 
@@ -129,6 +140,8 @@ private:
     uint64_t m_txGasLimit = 3000000000;
     std::shared_ptr<storage::StateStorageInterface> m_storage;
     crypto::Hash::Ptr m_hashImpl;
+    CodeCache::Ptr m_codeCache;
+    AccessSetCache::Ptr m_accessSetCache;
 };
 
 }  // namespace executor
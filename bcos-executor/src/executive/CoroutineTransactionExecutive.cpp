@@ -30,10 +30,26 @@ CallParameters::UniquePtr CoroutineTransactionExecutive::start(CallParameters::U
             m_syncStorageWrapper->importExistsKeyLocks(callParameters->keyLocks);
         }
 
+        // the function selector, the data is moved on executing
+        std::string selector;
+        if (!callParameters->create && callParameters->data.size() >= 4)
+        {
+            selector.assign(callParameters->data.begin(), callParameters->data.begin() + 4);
+        }
+
         m_exchangeMessage = execute(std::move(callParameters));
         // Execute is finished, erase the key locks
         m_exchangeMessage->keyLocks.clear();
 
+        // record the keys accessed by the function for prefetching the next calls
+        auto accessSetCache = blockContext->accessSetCache();
+        if (accessSetCache && !selector.empty())
+        {
+            accessSetCache->record(
+                getContractTableName(m_contractAddress, blockContext->isWasm()), selector,
+                m_syncStorageWrapper->accessedKeys());
+        }
+
         // Return the ownership to input
         push = std::move(*m_pushMessage);
 
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief The transaction executive of the optimistic execution
+ * @file OCCTransactionExecutive.h
+ * @date: 2022-10-18
+ */
+
+#pragma once
+
+#include "TransactionExecutive.h"
+
+namespace bcos
+{
+namespace executor
+{
+// Runs a transaction optimistically on the state of its own contract. The callee of an external
+// call may be dispatched to another executor and is not validated by the optimistic execution, so
+// the call is not executed: it reverts and the transaction is marked to be sent back to DMC.
+class OCCTransactionExecutive : public TransactionExecutive
+{
+public:
+    using Ptr = std::shared_ptr<OCCTransactionExecutive>;
+
+    using TransactionExecutive::TransactionExecutive;
+
+    CallParameters::UniquePtr externalCall(CallParameters::UniquePtr input) override
+    {
+        m_externalCalled = true;
+        auto output = std::make_unique<CallParameters>(CallParameters::REVERT);
+        output->status = (int32_t)protocol::TransactionStatus::RevertInstruction;
+        output->contextID = contextID();
+        output->seq = seq();
+        output->gas = input->gas;
+        return output;
+    }
+
+    // true if the transaction has tried to call another contract
+    bool externalCalled() const { return m_externalCalled; }
+
+private:
+    bool m_externalCalled = false;
+};
+}  // namespace executor
+}  // namespace bcos
@@ -80,6 +80,7 @@ public:
     {
         std::vector<std::string> keyLocks;
         keyLocks.reserve(m_myKeyLocks.size());
+        m_exportedKeyLocks.insert(m_myKeyLocks.begin(), m_myKeyLocks.end());
         for (auto& it : m_myKeyLocks)
         {
             keyLocks.emplace_back(std::move(it));
@@ -90,6 +91,20 @@ public:
         return keyLocks;
     }
 
+    // the keys accessed since the wrapper is created, including the exported ones
+    std::vector<std::string> accessedKeys() const
+    {
+        std::vector<std::string> keys(m_exportedKeyLocks.begin(), m_exportedKeyLocks.end());
+        for (auto const& it : m_myKeyLocks)
+        {
+            if (m_exportedKeyLocks.find(it) == m_exportedKeyLocks.end())
+            {
+                keys.emplace_back(it);
+            }
+        }
+        return keys;
+    }
+
 private:
     void acquireKeyLock(const std::string_view& key)
     {
@@ -116,5 +131,6 @@ private:
 
     std::set<std::string, std::less<>> m_existsKeyLocks;
     std::set<std::string, std::less<>> m_myKeyLocks;
+    std::set<std::string, std::less<>> m_exportedKeyLocks;
 };
 }  // namespace bcos::executor
\ No newline at end of file
@@ -368,7 +368,7 @@ std::tuple<std::unique_ptr<HostContext>, CallParameters::UniquePtr> TransactionE
         auto result = m_gasInjector->InjectMeter(code);
         if (result.status == wasm::GasInjector::Status::Success)
         {
-            result.byteCode->swap(code);
+            code.assign(result.byteCode->begin(), result.byteCode->end());
         }
         else
         {
@@ -671,8 +671,15 @@ CallParameters::UniquePtr TransactionExecutive::go(
         }
         else
         {
-            auto codeEntry = hostContext.code();
-            if (!codeEntry.has_value())
+            // the cached code outlives the execution, fall back to the code entry if the
+            // contract has no code hash
+            std::optional<storage::Entry> codeEntry;
+            auto cachedCode = hostContext.cachedCode();
+            if (!cachedCode)
+            {
+                codeEntry = hostContext.code();
+            }
+            if (!cachedCode && !codeEntry.has_value())
             {
                 revert();
                 auto callResult = hostContext.takeCallParameters();
@@ -685,7 +692,7 @@ CallParameters::UniquePtr TransactionExecutive::go(
                                     << LOG_KV("sender", callResult->senderAddress);
                 return callResult;
             }
-            auto code = codeEntry->get();
+            std::string_view code = cachedCode ? std::string_view(*cachedCode) : codeEntry->get();
             if (hasPrecompiledPrefix(code))
             {
                 return callDynamicPrecompiled(hostContext.takeCallParameters(), std::string(code));
@@ -26,10 +26,12 @@
 #include "../dag/CriticalFields.h"
 #include "../dag/ScaleUtils.h"
 #include "../dag/TxDAG2.h"
+#include "../dag/TxOCC.h"
 #include "../executive/BlockContext.h"
 #include "../executive/ExecutiveFactory.h"
 #include "../executive/ExecutiveSerialFlow.h"
 #include "../executive/ExecutiveStackFlow.h"
+#include "../executive/OCCTransactionExecutive.h"
 #include "../executive/TransactionExecutive.h"
 #include "../precompiled/BFSPrecompiled.h"
 #include "../precompiled/ConsensusPrecompiled.h"
@@ -126,12 +128,22 @@ TransactionExecutor::TransactionExecutor(bcos::ledger::LedgerInterface::Ptr ledg
     m_keyPageIgnoreTables(keyPageIgnoreTables)
 {
     assert(m_backendStorage);
+    if (m_keyPageSize > 0)
+    {
+        m_keyPageCache = std::make_shared<storage::KeyPageStorage::DataCache>(
+            KEY_PAGE_CACHE_SIZE, KEY_PAGE_CACHE_SHARDS);
+    }
 
     GlobalHashImpl::g_hashImpl = m_hashImpl;
     m_abiCache = make_shared<ClockCache<bcos::bytes, FunctionAbi>>(32);
+    m_codeCache = std::make_shared<CodeCache>(CODE_CACHE_SIZE);
+    m_accessSetCache =
+        std::make_shared<AccessSetCache>(ACCESS_SET_CACHE_SIZE, ACCESS_SET_MAX_KEYS);
     m_gasInjector = std::make_shared<wasm::GasInjector>(wasm::GetInstructionTable());
 
     m_threadPool = std::make_shared<bcos::ThreadPool>(name, std::thread::hardware_concurrency());
+    m_callThreadPool =
+        std::make_shared<bcos::ThreadPool>(name + "-call", std::thread::hardware_concurrency());
     if (m_isWasm)
     {
         initWasmEnvironment();
@@ -286,6 +298,8 @@ BlockContext::Ptr TransactionExecutor::createBlockContext(
 {
     BlockContext::Ptr context = make_shared<BlockContext>(
         storage, m_hashImpl, currentHeader, m_schedule, m_isWasm, m_isAuthCheck);
+    context->setCodeCache(m_codeCache);
+    context->setAccessSetCache(m_accessSetCache);
     return context;
 }
 
@@ -295,6 +309,8 @@ std::shared_ptr<BlockContext> TransactionExecutor::createBlockContext(
 {
     BlockContext::Ptr context = make_shared<BlockContext>(storage, m_hashImpl, blockNumber,
         blockHash, timestamp, blockVersion, m_schedule, m_isWasm, m_isAuthCheck);
+    context->setCodeCache(m_codeCache);
+    context->setAccessSetCache(m_accessSetCache);
 
     return context;
 }
@@ -323,6 +339,18 @@ void TransactionExecutor::nextBlockHeader(int64_t schedulerTermId,
         {
             std::unique_lock<std::shared_mutex> lock(m_stateStoragesMutex);
             bcos::storage::StateStorageInterface::Ptr stateStorage;
+
+            // the block is executed again after its execution failed, discard the speculative
+            // states of it and the blocks above it, which are never prepared
+            while (!m_stateStorages.empty() && !m_stateStorages.back().prepared &&
+                   m_stateStorages.back().number >= blockHeader->number())
+            {
+                EXECUTOR_NAME_LOG(INFO)
+                    << BLOCK_NUMBER(blockHeader->number()) << "NextBlockHeader, discard the state"
+                    << LOG_KV("number", m_stateStorages.back().number);
+                m_stateStorages.pop_back();
+            }
+
             if (m_stateStorages.empty())
             {
                 if (m_cachedStorage)
@@ -460,25 +488,7 @@ void TransactionExecutor::dmcCall(bcos::protocol::ExecutionMessage::UniquePtr in
     {
     case protocol::ExecutionMessage::MESSAGE:
     {
-        bcos::protocol::BlockNumber number = m_lastCommittedBlockNumber;
-        storage::StorageInterface::Ptr prev;
-
-        if (m_cachedStorage)
-        {
-            prev = m_cachedStorage;
-        }
-        else
-        {
-            prev = m_backendStorage;
-        }
-
-        // Create a temp storage
-        auto storage = createStateStorage(std::move(prev), true);
-
-        // Create a temp block context
-        // TODO: pass blockHash, version here
-        blockContext = createBlockContext(
-            number, h256(), 0, 0, std::move(storage));  // TODO: complete the block info
+        blockContext = createCallBlockContext(input->to(), true);
 
         auto inserted = m_calledContext->emplace(
             std::tuple{input->contextID(), input->seq()}, CallState{blockContext});
@@ -629,25 +639,7 @@ void TransactionExecutor::call(bcos::protocol::ExecutionMessage::UniquePtr input
     {
     case protocol::ExecutionMessage::MESSAGE:
     {
-        bcos::protocol::BlockNumber number = m_lastCommittedBlockNumber;
-        storage::StorageInterface::Ptr prev;
-
-        if (m_cachedStorage)
-        {
-            prev = m_cachedStorage;
-        }
-        else
-        {
-            prev = m_backendStorage;
-        }
-
-        // Create a temp storage
-        auto storage = createStateStorage(std::move(prev), true);
-
-        // Create a temp block context
-        // TODO: pass blockHash, version here
-        blockContext = createBlockContext(
-            number, h256(), 0, 0, std::move(storage));  // TODO: complete the block info
+        blockContext = createCallBlockContext(input->to(), false);
 
         auto inserted = m_calledContext->emplace(
             std::tuple{input->contextID(), input->seq()}, CallState{blockContext});
@@ -884,6 +876,7 @@ void TransactionExecutor::executeTransactionsInternal(std::string contractAddres
                 auto prepareT = utcTime() - recordT;
                 recordT = utcTime();
 
+                prefetchStates(contractAddress, *callParametersList);
                 auto executiveFlow =
                     getExecutiveFlow(m_blockContext, contractAddress, useCoroutine);
                 executiveFlow->submit(callParametersList);
@@ -903,6 +896,7 @@ void TransactionExecutor::executeTransactionsInternal(std::string contractAddres
     }
     else
     {
+        prefetchStates(contractAddress, *callParametersList);
         auto executiveFlow = getExecutiveFlow(m_blockContext, contractAddress, useCoroutine);
         executiveFlow->submit(callParametersList);
 
@@ -1348,6 +1342,9 @@ void TransactionExecutor::dagExecuteTransactionsInternal(
     CriticalFields::Ptr txsCriticals = make_shared<CriticalFields>(transactionsNum);
 
     mutex tableMutex;
+    // the transactions without conflict fields, executed optimistically after the dag
+    std::vector<ID> occIDs;
+    mutex occMutex;
 
     // parallel to extract critical fields
     tbb::parallel_for(tbb::blocked_range<uint64_t>(0, transactionsNum),
@@ -1501,6 +1498,12 @@ void TransactionExecutor::dagExecuteTransactionsInternal(
                                 extractConflictFields(functionAbi, *params, m_blockContext);
                         }
                     }
+                    if (conflictFields == nullptr && m_isOccExecute)
+                    {
+                        std::lock_guard guard(occMutex);
+                        occIDs.emplace_back(i);
+                        continue;
+                    }
                     if (conflictFields == nullptr)
                     {
                         EXECUTOR_NAME_LOG(DEBUG)
@@ -1534,6 +1537,11 @@ void TransactionExecutor::dagExecuteTransactionsInternal(
                                 << LOG_DESC("begin executeTransactionsWithCriticals")
                                 << LOG_KV("txsCriticalsSize", txsCriticals->size());
         executeTransactionsWithCriticals(txsCriticals, inputs, executionResults);
+        if (!occIDs.empty())
+        {
+            std::sort(occIDs.begin(), occIDs.end());
+            executeTransactionsWithOCC(occIDs, inputs, executionResults);
+        }
     }
     catch (exception& e)
     {
@@ -1587,6 +1595,11 @@ void TransactionExecutor::prepare(
         return;
     }
 
+    {
+        std::unique_lock<std::shared_mutex> lock(m_stateStoragesMutex);
+        first->prepared = true;
+    }
+
     bcos::protocol::TwoPCParams storageParams{
         params.number, params.primaryTableName, params.primaryTableKey, params.timestamp};
 
@@ -1674,7 +1687,12 @@ void TransactionExecutor::commit(
 
         EXECUTOR_NAME_LOG(DEBUG) << BLOCK_NUMBER(blockNumber) << "Commit success";
 
-        m_lastCommittedBlockNumber = blockNumber;
+        {
+            std::lock_guard<std::mutex> lock(x_callSnapshot);
+            m_lastCommittedBlockNumber = blockNumber;
+            // the calls in flight keep their own reference, the stale snapshot is not pinned
+            m_callSnapshot.reset();
+        }
 
         removeCommittedState();
 
@@ -1739,6 +1757,15 @@ void TransactionExecutor::rollback(
                 return;
             }
 
+            {
+                // the state may be prepared again
+                std::unique_lock<std::shared_mutex> lock(m_stateStoragesMutex);
+                if (!m_stateStorages.empty() && m_stateStorages.front().number == blockNumber)
+                {
+                    m_stateStorages.front().prepared = false;
+                }
+            }
+
             EXECUTOR_NAME_LOG(INFO) << BLOCK_NUMBER(blockNumber) << "Rollback success";
             callback(nullptr);
         });
@@ -1877,22 +1904,136 @@ ExecutiveFlowInterface::Ptr TransactionExecutor::getExecutiveFlow(
     ExecutiveFlowInterface::Ptr executiveFlow = blockContext->getExecutiveFlow(codeAddress);
     if (executiveFlow == nullptr)
     {
-        auto executiveFactory = std::make_shared<ExecutiveFactory>(blockContext,
-            m_precompiledContract, m_constantPrecompiled, m_builtInPrecompiled, m_gasInjector);
-        if (!useCoroutine)
+        executiveFlow = createExecutiveFlow(blockContext, useCoroutine, m_threadPool);
+        blockContext->setExecutiveFlow(codeAddress, executiveFlow);
+    }
+    return executiveFlow;
+}
+
+ExecutiveFlowInterface::Ptr TransactionExecutor::createExecutiveFlow(
+    std::shared_ptr<BlockContext> blockContext, bool useCoroutine, bcos::ThreadPool::Ptr threadPool)
+{
+    auto executiveFactory = std::make_shared<ExecutiveFactory>(blockContext,
+        m_precompiledContract, m_constantPrecompiled, m_builtInPrecompiled, m_gasInjector);
+    ExecutiveFlowInterface::Ptr executiveFlow;
+    if (!useCoroutine)
+    {
+        executiveFlow = std::make_shared<ExecutiveSerialFlow>(executiveFactory);
+    }
+    else
+    {
+        executiveFlow = std::make_shared<ExecutiveStackFlow>(executiveFactory);
+    }
+    executiveFlow->setThreadPool(std::move(threadPool));
+    return executiveFlow;
+}
+
+std::shared_ptr<const TransactionExecutor::CallSnapshot> TransactionExecutor::callSnapshot()
+{
+    std::lock_guard<std::mutex> lock(x_callSnapshot);
+    bcos::protocol::BlockNumber number = m_lastCommittedBlockNumber;
+    if (m_callSnapshot && m_callSnapshot->number == number)
+    {
+        return m_callSnapshot;
+    }
+
+    auto snapshot = m_backendStorage->snapshot();
+    if (!snapshot)
+    {
+        // read the live committed state, may see the blocks committed during the call
+        storage::StorageInterface::Ptr prev = m_backendStorage;
+        if (m_cachedStorage)
         {
-            executiveFlow = std::make_shared<ExecutiveSerialFlow>(executiveFactory);
-            executiveFlow->setThreadPool(m_threadPool);
-            blockContext->setExecutiveFlow(codeAddress, executiveFlow);
+            prev = m_cachedStorage;
         }
-        else
+        return std::make_shared<const CallSnapshot>(CallSnapshot{number, std::move(prev)});
+    }
+    // a frozen LRU cache layer on the snapshot, only filled with the rows read by the calls
+    m_callSnapshot = std::make_shared<const CallSnapshot>(
+        CallSnapshot{number, std::make_shared<storage::LRUStateStorage>(std::move(snapshot))});
+    EXECUTOR_NAME_LOG(DEBUG) << BLOCK_NUMBER(number) << "Create call snapshot";
+    return m_callSnapshot;
+}
+
+std::shared_ptr<BlockContext> TransactionExecutor::createCallBlockContext(
+    const std::string& codeAddress, bool useCoroutine)
+{
+    auto snapshot = callSnapshot();
+
+    // Create a temp storage, the key page cache of the blocks may be newer than the snapshot
+    storage::StateStorageInterface::Ptr storage;
+    if (m_keyPageSize > 0)
+    {
+        storage = std::make_shared<bcos::storage::KeyPageStorage>(
+            snapshot->storage, m_keyPageSize, m_keyPageIgnoreTables, true);
+    }
+    else
+    {
+        storage = std::make_shared<bcos::storage::StateStorage>(snapshot->storage);
+    }
+
+    // Create a temp block context
+    // TODO: pass blockHash, version here
+    auto blockContext = createBlockContext(
+        snapshot->number, h256(), 0, 0, std::move(storage));  // TODO: complete the block info
+
+    // the context is only used by the call, runs on the threads of the calls
+    blockContext->setExecutiveFlow(
+        codeAddress, createExecutiveFlow(blockContext, useCoroutine, m_callThreadPool));
+    return blockContext;
+}
+
+void TransactionExecutor::prefetchStates(std::string_view contractAddress,
+    std::vector<std::unique_ptr<CallParameters>> const& callParametersList)
+{
+    auto storage = m_blockContext->storage();
+    auto tableName = getContractTableName(contractAddress, m_isWasm);
+    // the keys must be alive until the prev storage reads them
+    auto keys = std::make_shared<std::set<std::string, std::less<>>>();
+    std::set<std::string_view> selectors;
+    for (auto const& callParameters : callParametersList)
+    {
+        if (!callParameters)
+        {
+            continue;
+        }
+        // the keys held by the other contexts in the previous round
+        keys->insert(callParameters->keyLocks.begin(), callParameters->keyLocks.end());
+        if (!callParameters->create && callParameters->data.size() >= 4)
         {
-            executiveFlow = std::make_shared<ExecutiveStackFlow>(executiveFactory);
-            executiveFlow->setThreadPool(m_threadPool);
-            blockContext->setExecutiveFlow(codeAddress, executiveFlow);
+            selectors.emplace((const char*)callParameters->data.data(), 4);
         }
     }
-    return executiveFlow;
+    // the keys accessed by the last calls of the same functions
+    size_t recordedFunctions = 0;
+    for (auto selector : selectors)
+    {
+        recordedFunctions += m_accessSetCache->collect(tableName, selector, *keys) ? 1 : 0;
+    }
+    if (keys->empty())
+    {
+        return;
+    }
+
+    auto startT = utcTime();
+    auto keyViews = std::make_shared<std::vector<std::string_view>>(keys->begin(), keys->end());
+    storage->asyncGetRows(tableName, *keyViews,
+        [this, keys, keyViews, startT, table = tableName, recordedFunctions](
+            Error::UniquePtr error, std::vector<std::optional<storage::Entry>> entries) {
+            if (error)
+            {
+                // only warms the storage, the execution reads the keys again
+                EXECUTOR_NAME_LOG(WARNING) << "prefetchStates failed" << LOG_KV("table", table)
+                                           << LOG_KV("message", error->errorMessage());
+                return;
+            }
+            EXECUTOR_NAME_LOG(DEBUG)
+                << "prefetchStates" << LOG_KV("table", table) << LOG_KV("keys", keys->size())
+                << LOG_KV("found", std::count_if(entries.begin(), entries.end(),
+                                       [](auto const& entry) { return entry.has_value(); }))
+                << LOG_KV("recordedFunctions", recordedFunctions)
+                << LOG_KV("timeCost", utcTime() - startT);
+        });
 }
 
 
@@ -2197,9 +2338,21 @@ void TransactionExecutor::removeCommittedState()
         storage = it->storage;
     }
 
+    // the storage of the committed block is still the prev of the next block here, the cache is
+    // invalidated before the next block reads the committed state directly
+    auto keyPageStorage = std::dynamic_pointer_cast<bcos::storage::KeyPageStorage>(storage);
+    if (keyPageStorage)
+    {
+        keyPageStorage->invalidateCache();
+        EXECUTOR_NAME_LOG(DEBUG) << LOG_DESC("keyPage cache") << LOG_KV("number", number)
+                                 << LOG_KV("size", m_keyPageCache->size())
+                                 << LOG_KV("hits", m_keyPageCache->hits())
+                                 << LOG_KV("misses", m_keyPageCache->misses())
+                                 << LOG_KV("evictions", m_keyPageCache->evictions());
+    }
+
     if (m_cachedStorage)
     {
-        auto keyPageStorage = std::dynamic_pointer_cast<bcos::storage::KeyPageStorage>(storage);
         if (keyPageStorage)
         {
             EXECUTOR_NAME_LOG(INFO)
@@ -2363,13 +2516,72 @@ void TransactionExecutor::executeTransactionsWithCriticals(
     txDag->run(m_DAGThreadNum);
 }
 
+void TransactionExecutor::executeTransactionsWithOCC(std::vector<ID> const& ids,
+    gsl::span<std::unique_ptr<CallParameters>> inputs,
+    vector<protocol::ExecutionMessage::UniquePtr>& executionResults)
+{
+    auto startT = utcTime();
+    TxOCC occ(m_blockContext->storage());
+    auto reexecuted = occ.run(
+        ids.size(),
+        [this, &ids, &inputs, &executionResults](
+            TxOCC::ID index, storage::StateStorageInterface::Ptr storage) {
+            if (!m_isRunning)
+            {
+                return false;
+            }
+
+            auto id = ids[index];
+            auto& input = inputs[id];
+            // every execution sees the block state through its own storage
+            auto blockContext = createBlockContext(m_blockContext->number(),
+                m_blockContext->hash(), m_blockContext->timestamp(),
+                m_blockContext->blockVersion(), std::move(storage));
+            auto executive = std::make_shared<OCCTransactionExecutive>(blockContext,
+                input->codeAddress, input->contextID, input->seq, m_gasInjector);
+            executive->setConstantPrecompiled(m_constantPrecompiled);
+            executive->setEVMPrecompiled(m_precompiledContract);
+            executive->setBuiltInPrecompiled(m_builtInPrecompiled);
+            try
+            {
+                auto output = executive->start(input->copyRequest());
+                assert(output);
+                if (executive->externalCalled())
+                {
+                    // the callee is not validated here, drop the writes and send it back to DMC
+                    executionResults[id] = toExecutionResult(input->copyRequest());
+                    executionResults[id]->setType(ExecutionMessage::SEND_BACK);
+                    return false;
+                }
+                executionResults[id] = toExecutionResult(*executive, std::move(output));
+                return true;
+            }
+            catch (std::exception& e)
+            {
+                EXECUTOR_NAME_LOG(ERROR) << "executeTransactionsWithOCC error: "
+                                         << boost::diagnostic_information(e);
+                executionResults[id] = toExecutionResult(input->copyRequest());
+                executionResults[id]->setType(ExecutionMessage::REVERT);
+                executionResults[id]->setStatus((int32_t)TransactionStatus::Unknown);
+                executionResults[id]->setMessage("Execute transaction optimistically failed");
+            }
+            return false;
+        },
+        m_DAGThreadNum);
+
+    EXECUTOR_NAME_LOG(INFO) << BLOCK_NUMBER(m_blockContext->number())
+                            << LOG_DESC("executeTransactionsWithOCC") << LOG_KV("txNum", ids.size())
+                            << LOG_KV("reexecuted", reexecuted)
+                            << LOG_KV("timeCost", utcTime() - startT);
+}
+
 bcos::storage::StateStorageInterface::Ptr TransactionExecutor::createStateStorage(
     bcos::storage::StorageInterface::Ptr storage, bool ignoreNotExist)
 {
     if (m_keyPageSize > 0)
     {
         return std::make_shared<bcos::storage::KeyPageStorage>(
-            storage, m_keyPageSize, m_keyPageIgnoreTables, ignoreNotExist);
+            storage, m_keyPageSize, m_keyPageIgnoreTables, ignoreNotExist, m_keyPageCache);
     }
     return std::make_shared<bcos::storage::StateStorage>(storage);
 }
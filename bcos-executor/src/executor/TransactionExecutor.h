@@ -26,6 +26,8 @@
 
 #include "../Common.h"
 #include "../dag/CriticalFields.h"
+#include "../executive/AccessSetCache.h"
+#include "../vm/CodeCache.h"
 #include "bcos-framework/executor/ExecutionMessage.h"
 #include "bcos-framework/executor/ParallelTransactionExecutorInterface.h"
 #include "bcos-framework/ledger/LedgerInterface.h"
@@ -36,6 +38,7 @@
 #include "bcos-framework/protocol/TransactionReceipt.h"
 #include "bcos-framework/storage/StorageInterface.h"
 #include "bcos-framework/txpool/TxPoolInterface.h"
+#include "bcos-table/src/KeyPageStorage.h"
 #include "bcos-table/src/StateStorage.h"
 #include "tbb/concurrent_unordered_map.h"
 #include <bcos-crypto/interfaces/crypto/Hash.h>
@@ -168,6 +171,10 @@ public:
     void start() override { m_isRunning = true; }
     void stop() override;
 
+    // execute the dag transactions without conflict fields optimistically instead of sending them
+    // back to the scheduler, must be the same on all the nodes
+    void setOccExecute(bool _isOccExecute) { m_isOccExecute = _isOccExecute; }
+
 protected:
     void executeTransactionsInternal(std::string contractAddress,
         gsl::span<bcos::protocol::ExecutionMessage::UniquePtr> inputs, bool useCoroutine,
@@ -224,8 +231,25 @@ protected:
         gsl::span<std::unique_ptr<CallParameters>> inputs,
         std::vector<protocol::ExecutionMessage::UniquePtr>& executionResults);
 
+    // execute transactions optimistically in the order of ids and return in executionResults
+    void executeTransactionsWithOCC(std::vector<critical::ID> const& ids,
+        gsl::span<std::unique_ptr<CallParameters>> inputs,
+        std::vector<protocol::ExecutionMessage::UniquePtr>& executionResults);
+
     std::shared_ptr<ExecutiveFlowInterface> getExecutiveFlow(
         std::shared_ptr<BlockContext> blockContext, std::string codeAddress, bool useCoroutine);
+    std::shared_ptr<ExecutiveFlowInterface> createExecutiveFlow(
+        std::shared_ptr<BlockContext> blockContext, bool useCoroutine,
+        bcos::ThreadPool::Ptr threadPool);
+
+    // the temp block context of a call on the committed state, not sharing any lock or thread
+    // with the block execution
+    std::shared_ptr<BlockContext> createCallBlockContext(
+        const std::string& codeAddress, bool useCoroutine);
+
+    // warm the block storage with the keys the calls are predicted to access, in one multi-get
+    void prefetchStates(std::string_view contractAddress,
+        std::vector<std::unique_ptr<CallParameters>> const& callParametersList);
 
 
     void asyncExecuteExecutiveFlow(std::shared_ptr<ExecutiveFlowInterface> executiveFlow,
@@ -261,7 +285,10 @@ protected:
 
         bcos::protocol::BlockNumber number;
         bcos::storage::StateStorageInterface::Ptr storage;
+        // being prepared or committed to the backend storage, can not be discarded
+        bool prepared = false;
     };
+    // the uncommitted states of the executed blocks, every state is layered on the previous one
     std::list<State> m_stateStorages;
     bcos::protocol::BlockNumber m_lastCommittedBlockNumber = 1;
 
@@ -288,6 +315,16 @@ protected:
     {
         std::shared_ptr<BlockContext> blockContext;
     };
+    // the read only snapshot of the last committed state shared by the calls, replaced after a
+    // new block is committed, the calls in flight keep reading the snapshot they started with
+    struct CallSnapshot
+    {
+        bcos::protocol::BlockNumber number;
+        storage::StorageInterface::Ptr storage;
+    };
+    std::shared_ptr<const CallSnapshot> callSnapshot();
+    std::shared_ptr<const CallSnapshot> m_callSnapshot;
+    std::mutex x_callSnapshot;
     std::shared_ptr<tbb::concurrent_hash_map<std::tuple<int64_t, int64_t>, CallState, HashCombine>>
         m_calledContext = std::make_shared<
             tbb::concurrent_hash_map<std::tuple<int64_t, int64_t>, CallState, HashCombine>>();
@@ -305,13 +342,26 @@ protected:
     std::shared_ptr<wasm::GasInjector> m_gasInjector = nullptr;
     mutable bcos::RecursiveMutex x_executiveFlowLock;
     bool m_isWasm = false;
+    bool m_isOccExecute = false;
     size_t m_keyPageSize = 0;
+    // decoded key pages of the committed state, shared by the storages of all blocks
+    constexpr static size_t KEY_PAGE_CACHE_SIZE = 128 * 1024 * 1024;
+    constexpr static size_t KEY_PAGE_CACHE_SHARDS = 16;
+    std::shared_ptr<storage::KeyPageStorage::DataCache> m_keyPageCache;
+    // the contract code shared by all blocks, keyed by code hash
+    constexpr static size_t CODE_CACHE_SIZE = 64 * 1024 * 1024;
+    CodeCache::Ptr m_codeCache;
+    // the keys accessed by the last call of the contract functions, prefetched before executing
+    constexpr static size_t ACCESS_SET_CACHE_SIZE = 4096;
+    constexpr static size_t ACCESS_SET_MAX_KEYS = 64;
+    AccessSetCache::Ptr m_accessSetCache;
     VMSchedule m_schedule = FiscoBcosScheduleV4;
     std::shared_ptr<const std::set<std::string, std::less<>>> m_keyPageIgnoreTables;
     bool m_isRunning = false;
     int64_t m_schedulerTermId = -1;
 
     bcos::ThreadPool::Ptr m_threadPool;
+    bcos::ThreadPool::Ptr m_callThreadPool;
     void initEvmEnvironment();
     void initWasmEnvironment();
 };
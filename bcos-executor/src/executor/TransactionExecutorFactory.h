@@ -78,9 +78,19 @@ public:
 
     TransactionExecutor::Ptr build()
     {
-        return std::make_shared<TransactionExecutor>(m_ledger, m_txpool, m_cache, m_storage,
-            m_executionMessageFactory, m_hashImpl, m_isWasm, m_isAuthCheck, m_keyPageSize,
-            m_keyPageIgnoreTables, m_name + "-" + std::to_string(utcTime()));
+        auto executor = std::make_shared<TransactionExecutor>(m_ledger, m_txpool, m_cache,
+            m_storage, m_executionMessageFactory, m_hashImpl, m_isWasm, m_isAuthCheck,
+            m_keyPageSize, m_keyPageIgnoreTables, m_name + "-" + std::to_string(utcTime()));
+        executor->setOccExecute(m_isOccExecute);
+        return executor;
+    }
+
+    void setOccExecute(bool _isOccExecute) { m_isOccExecute = _isOccExecute; }
+
+    // the tables whose rows are not stored in key pages
+    std::shared_ptr<const std::set<std::string, std::less<>>> keyPageIgnoreTables() const
+    {
+        return m_keyPageIgnoreTables;
     }
 
 private:
@@ -95,6 +105,7 @@ private:
     bcos::crypto::Hash::Ptr m_hashImpl;
     bool m_isWasm;
     bool m_isAuthCheck;
+    bool m_isOccExecute = false;
 };
 
 }  // namespace executor
@@ -0,0 +1,33 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the contract code cache keyed by code hash
+ * @file CodeCache.h
+ */
+
+#pragma once
+#include <bcos-utilities/LRUCache.h>
+#include <memory>
+#include <string>
+
+namespace bcos
+{
+namespace executor
+{
+/// The executor-wide LRU cache of the contract code, keyed by the code hash and bounded by the
+/// size of the code, the code is immutable once deployed so the cached code is never invalidated
+using CodeCache = LRUCache<std::string, std::shared_ptr<const std::string>>;
+}  // namespace executor
+}  // namespace bcos
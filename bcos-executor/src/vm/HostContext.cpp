@@ -412,6 +412,37 @@ std::optional<storage::Entry> HostContext::code()
     return entry;
 }
 
+std::shared_ptr<const std::string> HostContext::cachedCode()
+{
+    auto codeCache = m_executive->blockContext().lock()->codeCache();
+    if (!codeCache)
+    {
+        return nullptr;
+    }
+    // the dynamic precompiled contracts have no code hash
+    auto start = utcTimeUs();
+    auto hashEntry = m_executive->storage().getRow(m_tableName, ACCOUNT_CODE_HASH);
+    m_getTimeUsed.fetch_add(utcTimeUs() - start);
+    if (!hashEntry || hashEntry->get().empty())
+    {
+        return nullptr;
+    }
+    auto codeHash = hashEntry->get();
+    auto cached = codeCache->get(std::string(codeHash));
+    if (cached)
+    {
+        return *cached;
+    }
+    auto codeEntry = code();
+    if (!codeEntry)
+    {
+        return nullptr;
+    }
+    auto loaded = std::make_shared<const std::string>(codeEntry->get());
+    codeCache->tryInsert(std::string(codeHash), loaded, loaded->size());
+    return loaded;
+}
+
 h256 HostContext::codeHash()
 {
     auto entry = m_executive->storage().getRow(m_tableName, ACCOUNT_CODE_HASH);
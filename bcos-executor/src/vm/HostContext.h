@@ -126,6 +126,9 @@ public:
     std::string_view codeAddress() const { return m_callParameters->codeAddress; }
     bytesConstRef data() const { return ref(m_callParameters->data); }
     std::optional<storage::Entry> code();
+    // the code shared through the code cache of the block context, nullptr if the code or its
+    // hash does not exist
+    std::shared_ptr<const std::string> cachedCode();
     bool isCodeHasPrefix(std::string_view _prefix) const;
     h256 codeHash();
     u256 salt() const { return m_salt; }
@@ -102,12 +102,15 @@ VMInstance VMFactory::create(VMKind _kind)
     {
     case VMKind::BcosWasm:
         return VMInstance{evmc_create_bcoswasm()};
-    case VMKind::evmone:
-        return VMInstance{evmc_create_evmone()};
     case VMKind::DLL:
         return VMInstance{g_evmcCreateFn()};
+    case VMKind::evmone:
     default:
-        return VMInstance{evmc_create_evmone()};
+    {
+        // evmone keeps no state between executions, share one instance by all the calls
+        static const VMInstance s_evmone{evmc_create_evmone()};
+        return s_evmone;
+    }
     }
 }
 }  // namespace executor
@@ -39,7 +39,8 @@ std::vector<std::pair<std::string, std::string>>& evmcOptions() noexcept
     return s_evmcOptions;
 }
 
-VMInstance::VMInstance(evmc_vm* _instance) noexcept : m_instance(_instance)
+VMInstance::VMInstance(evmc_vm* _instance) noexcept
+  : m_instance(_instance, [](evmc_vm* _vm) { _vm->destroy(_vm); })
 {
     assert(m_instance != nullptr);
     // the abi_version of intepreter is EVMC_ABI_VERSION when callback VMFactory::create()
@@ -48,14 +49,15 @@ VMInstance::VMInstance(evmc_vm* _instance) noexcept : m_instance(_instance)
     // Set the options.
     if (m_instance->set_option)
         for (auto& pair : evmcOptions())
-            m_instance->set_option(m_instance, pair.first.c_str(), pair.second.c_str());
+            m_instance->set_option(
+                m_instance.get(), pair.first.c_str(), pair.second.c_str());
 }
 
 Result VMInstance::exec(HostContext& _hostContext, evmc_revision _rev, evmc_message* _msg,
     const uint8_t* _code, size_t _code_size)
 {
     Result result = Result(m_instance->execute(
-        m_instance, _hostContext.interface, &_hostContext, _rev, _msg, _code, _code_size));
+        m_instance.get(), _hostContext.interface, &_hostContext, _rev, _msg, _code, _code_size));
     return result;
 }
 
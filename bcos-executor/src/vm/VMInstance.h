@@ -23,6 +23,7 @@
 #include "../Common.h"
 #include <bcos-utilities/Common.h>
 #include <evmc/evmc.h>
+#include <memory>
 
 namespace bcos
 {
@@ -59,14 +60,13 @@ std::vector<std::pair<std::string, std::string>>& evmcOptions() noexcept;
 /// Translate the VMSchedule to VMInstance-C revision.
 evmc_revision toRevision(VMSchedule const& _schedule);
 
-/// The RAII wrapper for an VMInstance-C instance.
+/// The RAII wrapper for an VMInstance-C instance, the copies share the same instance
 class VMInstance
 {
 public:
     explicit VMInstance(evmc_vm* _instance) noexcept;
-    ~VMInstance() { m_instance->destroy(m_instance); }
 
-    VMInstance(VMInstance const&) = delete;
+    VMInstance(VMInstance const&) = default;
     VMInstance& operator=(VMInstance) = delete;
 
     Result exec(HostContext& _hostContext, evmc_revision _rev, evmc_message* _msg,
@@ -76,7 +76,7 @@ public:
 
 private:
     /// The VM instance created with VMInstance-C <prefix>_create() function.
-    evmc_vm* m_instance = nullptr;
+    std::shared_ptr<evmc_vm> m_instance;
 };
 
 }  // namespace executor
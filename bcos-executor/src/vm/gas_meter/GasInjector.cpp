@@ -25,6 +25,7 @@
 #include "src/cast.h"
 #include "src/ir.h"
 #include "src/stream.h"
+#include <bcos-crypto/hash/Keccak256.h>
 #include <bcos-framework/Common.h>
 #include <iostream>
 
@@ -40,6 +41,27 @@ namespace wasm
 const char* const MODULE_NAME = "bcos";
 const char* const OUT_OF_GAS_NAME = "outOfGas";
 const char* const GLOBAL_GAS_NAME = "gas";
+const size_t SHARED_RESULT_CACHE_SIZE = 64 * 1024 * 1024;
+
+GasInjector::ResultCache::Ptr GasInjector::sharedResultCache()
+{
+    static auto s_cache = std::make_shared<ResultCache>(SHARED_RESULT_CACHE_SIZE);
+    return s_cache;
+}
+
+GasInjector::GasInjector(const InstructionTable costTable, ResultCache::Ptr _cache)
+  : m_costTable(costTable), m_resultCache(std::move(_cache))
+{
+    // FNV-1a of the opcodes and costs, the injected code changes if any cost changes
+    m_tableVersion = 14695981039346656037ULL;
+    for (const auto& instruction : m_costTable)
+    {
+        for (uint64_t value : {(uint64_t)instruction.Opcode, (uint64_t)instruction.Cost})
+        {
+            m_tableVersion = (m_tableVersion ^ value) * 1099511628211ULL;
+        }
+    }
+}
 
 // write wasm will not use loc, so wrong loc doesn't matter
 void GasInjector::InjectMeterExprList(ExprList* exprs, const ImportsInfo& info)
@@ -379,6 +401,30 @@ void GasInjector::InjectMeterExprList(ExprList* exprs, const ImportsInfo& info)
 }
 
 GasInjector::Result GasInjector::InjectMeter(const std::vector<uint8_t>& byteCode)
+{
+    if (!m_resultCache)
+    {
+        return doInjectMeter(byteCode);
+    }
+    // only the successful results are cached, a failed injection is never served from the cache
+    auto codeHash =
+        bcos::crypto::keccak256Hash(bcos::bytesConstRef(byteCode.data(), byteCode.size()));
+    std::string key((const char*)codeHash.data(), codeHash.size());
+    key.append((const char*)&m_tableVersion, sizeof(m_tableVersion));
+    if (auto cached = m_resultCache->get(key))
+    {
+        return *cached;
+    }
+    auto injectResult = doInjectMeter(byteCode);
+    if (injectResult.status == Success)
+    {
+        auto size = key.size() + (injectResult.byteCode ? injectResult.byteCode->size() : 0);
+        m_resultCache->tryInsert(std::move(key), injectResult, size);
+    }
+    return injectResult;
+}
+
+GasInjector::Result GasInjector::doInjectMeter(const std::vector<uint8_t>& byteCode)
 {
     GasInjector::Result injectResult;
     // parse wasm use wabt
@@ -19,8 +19,10 @@
  */
 #pragma once
 #include "Metric.h"
+#include <bcos-utilities/LRUCache.h>
 #include <exception>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace wabt
@@ -64,9 +66,18 @@ public:
     struct Result
     {
         Status status;
-        std::shared_ptr<std::vector<uint8_t>> byteCode;
+        // shared with the result cache, must not be modified
+        std::shared_ptr<const std::vector<uint8_t>> byteCode;
     };
-    GasInjector(const InstructionTable costTable) : m_costTable(costTable) {}
+
+    // The LRU cache of the injection results, keyed by the hash of the input code and the version
+    // of the instruction table, the capacity is the total size of the cached code in bytes
+    using ResultCache = LRUCache<std::string, Result>;
+    // the cache shared by all the injectors of the process
+    static ResultCache::Ptr sharedResultCache();
+
+    // the results are not cached if _cache is nullptr
+    GasInjector(const InstructionTable costTable, ResultCache::Ptr _cache = sharedResultCache());
 
     Result InjectMeter(const std::vector<uint8_t>& byteCode);
 
@@ -80,7 +91,12 @@ private:
         uint32_t originSize;
     };
     void InjectMeterExprList(wabt::ExprList* exprs, const ImportsInfo& info);
+    Result doInjectMeter(const std::vector<uint8_t>& byteCode);
+
     const InstructionTable m_costTable;
+    // identifies the cost table in the cache key
+    uint64_t m_tableVersion = 0;
+    ResultCache::Ptr m_resultCache;
 };
 }  // namespace wasm
 }  // namespace bcos
@@ -0,0 +1,75 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/**
+ * @brief : unitest for the keys accessed by the contract functions
+ */
+
+#include "../src/executive/AccessSetCache.h"
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <string>
+
+using namespace std;
+using namespace bcos;
+using namespace bcos::executor;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_AUTO_TEST_SUITE(TestAccessSetCache)
+
+BOOST_AUTO_TEST_CASE(RecordAndCollect)
+{
+    AccessSetCache cache(10, 3);
+    set<string, less<>> keys;
+    BOOST_CHECK(!cache.collect("/apps/a", "sel1", keys));
+    BOOST_CHECK(keys.empty());
+
+    cache.record("/apps/a", "sel1", {"key1", "key2"});
+    cache.record("/apps/a", "sel2", {"key3"});
+    cache.record("/apps/b", "sel1", {"key4"});
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    BOOST_CHECK(cache.collect("/apps/a", "sel1", keys));
+    BOOST_CHECK(cache.collect("/apps/a", "sel2", keys));
+    BOOST_CHECK((keys == set<string, less<>>{"key1", "key2", "key3"}));
+
+    // the last call replaces the keys, and at most 3 keys are kept
+    cache.record("/apps/a", "sel1", {"key5", "key6", "key7", "key8"});
+    keys.clear();
+    BOOST_CHECK(cache.collect("/apps/a", "sel1", keys));
+    BOOST_CHECK((keys == set<string, less<>>{"key5", "key6", "key7"}));
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(EvictLeastRecentlyUsed)
+{
+    AccessSetCache cache(2, 64);
+    set<string, less<>> keys;
+    cache.record("/apps/a", "sel1", {"key1"});
+    cache.record("/apps/a", "sel2", {"key2"});
+    // sel1 is used more recently than sel2
+    BOOST_CHECK(cache.collect("/apps/a", "sel1", keys));
+    cache.record("/apps/a", "sel3", {"key3"});
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(cache.collect("/apps/a", "sel1", keys));
+    BOOST_CHECK(!cache.collect("/apps/a", "sel2", keys));
+    BOOST_CHECK(cache.collect("/apps/a", "sel3", keys));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
@@ -62,6 +62,68 @@ namespace bcos
 {
 namespace test
 {
+// a frozen copy of the committed state, the reads wait for the gate if it is set
+class GatedSnapshot : public StateStorage
+{
+public:
+    GatedSnapshot() : StateStorageInterface(nullptr), StateStorage(nullptr) {}
+
+    void asyncGetRow(std::string_view table, std::string_view key,
+        std::function<void(Error::UniquePtr, std::optional<Entry>)> callback) override
+    {
+        waitGate();
+        StateStorage::asyncGetRow(table, key, std::move(callback));
+    }
+
+    void asyncGetRows(std::string_view table,
+        const std::variant<const gsl::span<std::string_view const>,
+            const gsl::span<std::string const>>& keys,
+        std::function<void(Error::UniquePtr, std::vector<std::optional<Entry>>)> callback) override
+    {
+        waitGate();
+        StateStorage::asyncGetRows(table, keys, std::move(callback));
+    }
+
+    void waitGate()
+    {
+        if (gate)
+        {
+            gate->wait();
+        }
+    }
+
+    std::optional<std::shared_future<void>> gate;
+};
+
+class MockSnapshotStorage : public MockTransactionalStorage
+{
+public:
+    using MockTransactionalStorage::MockTransactionalStorage;
+
+    StorageInterface::Ptr snapshot() override
+    {
+        auto snapshot = std::make_shared<GatedSnapshot>();
+        std::mutex mutex;
+        m_inner->parallelTraverse(false,
+            [&](const std::string_view& table, const std::string_view& key, const Entry& entry) {
+                std::unique_lock<std::mutex> lock(mutex);
+                snapshot->asyncSetRow(table, key, entry, [](Error::UniquePtr) {});
+                return true;
+            });
+        snapshot->gate = m_gate;
+        m_lastSnapshot = snapshot;
+        if (m_onSnapshot)
+        {
+            m_onSnapshot();
+        }
+        return snapshot;
+    }
+
+    std::optional<std::shared_future<void>> m_gate;
+    std::function<void()> m_onSnapshot;
+    std::weak_ptr<GatedSnapshot> m_lastSnapshot;
+};
+
 struct TransactionExecutorFixture
 {
     TransactionExecutorFixture()
@@ -340,6 +402,84 @@ BOOST_AUTO_TEST_CASE(deployAndCall)
         "00000000000000000000000000");
 }
 
+BOOST_AUTO_TEST_CASE(reExecuteBlock)
+{
+    auto helloworld = string(helloBin);
+    bytes input;
+    boost::algorithm::unhex(helloworld, std::back_inserter(input));
+    auto tx = fakeTransaction(cryptoSuite, keyPair, "", input, 101, 100001, "1", "1");
+    txpool->hash2Transaction.emplace(tx->hash(), tx);
+
+    auto nextBlock = [&](bcos::protocol::BlockNumber number) {
+        auto blockHeader = std::make_shared<bcos::protocol::PBBlockHeader>(cryptoSuite);
+        blockHeader->setNumber(number);
+        std::promise<bcos::Error::Ptr> nextPromise;
+        executor->nextBlockHeader(0, blockHeader,
+            [&](bcos::Error::Ptr&& error) { nextPromise.set_value(std::move(error)); });
+        return nextPromise.get_future().get();
+    };
+
+    // execute block 1 and block 2 on the uncommitted state of block 1
+    ledger->setBlockNumber(0);
+    BOOST_CHECK(!nextBlock(1));
+    auto params = std::make_unique<NativeExecutionMessage>();
+    params->setContextID(100);
+    params->setSeq(1000);
+    params->setDepth(0);
+    h256 addressCreate("ff6f30856ad3bae00b1169808488502786a13e3c174d85682135ffd51310310e");
+    std::string addressString = addressCreate.hex().substr(0, 40);
+    params->setTo(addressString);
+    params->setStaticCall(false);
+    params->setGasAvailable(gas);
+    params->setType(ExecutionMessage::TXHASH);
+    params->setTransactionHash(tx->hash());
+    params->setCreate(true);
+    std::promise<bcos::protocol::ExecutionMessage::UniquePtr> executePromise;
+    executor->dmcExecuteTransaction(std::move(params),
+        [&](bcos::Error::UniquePtr&& error, bcos::protocol::ExecutionMessage::UniquePtr&& result) {
+            BOOST_CHECK(!error);
+            executePromise.set_value(std::move(result));
+        });
+    auto result = executePromise.get_future().get();
+    BOOST_CHECK_EQUAL(result->status(), 0);
+    auto tableName = "/apps/" + std::string(result->newEVMContractAddress());
+    BOOST_CHECK(!nextBlock(2));
+
+    // execute block 2 again, then block 1 again, the states of the failed blocks are discarded
+    BOOST_CHECK(!nextBlock(2));
+    BOOST_CHECK(!nextBlock(1));
+
+    bcos::protocol::TwoPCParams commitParams{};
+    commitParams.number = 1;
+    std::promise<void> preparePromise;
+    executor->prepare(commitParams, [&](bcos::Error::Ptr&& error) {
+        BOOST_CHECK(!error);
+        preparePromise.set_value();
+    });
+    preparePromise.get_future().get();
+
+    // the prepared state is not discarded
+    BOOST_CHECK(nextBlock(1));
+
+    std::promise<void> commitPromise;
+    executor->commit(commitParams, [&](bcos::Error::Ptr&& error) {
+        BOOST_CHECK(!error);
+        commitPromise.set_value();
+    });
+    commitPromise.get_future().get();
+
+    // the contract deployed in the discarded state is not committed
+    std::promise<bool> tablePromise;
+    backend->asyncOpenTable(tableName, [&](Error::UniquePtr&& error, std::optional<Table>&& table) {
+        BOOST_CHECK(!error);
+        tablePromise.set_value(table.has_value());
+    });
+    BOOST_CHECK(!tablePromise.get_future().get());
+
+    ledger->setBlockNumber(1);
+    BOOST_CHECK(!nextBlock(2));
+}
+
 BOOST_AUTO_TEST_CASE(externalCall)
 {
     // Solidity source code from test_external_call.sol, using remix
@@ -1346,6 +1486,128 @@ BOOST_AUTO_TEST_CASE(deployErrorCode)
     }
 }
 
+BOOST_AUTO_TEST_CASE(callSnapshot)
+{
+    auto snapshotBackend = std::make_shared<MockSnapshotStorage>(hashImpl);
+    executor = bcos::executor::TransactionExecutorFactory::build(ledger, txpool,
+        std::make_shared<bcos::storage::LRUStateStorage>(snapshotBackend), snapshotBackend,
+        std::make_shared<NativeExecutionMessageFactory>(), hashImpl, false, false, false);
+
+    auto executeBlock = [this](BlockNumber number, ExecutionMessage::UniquePtr params) {
+        auto blockHeader = std::make_shared<bcos::protocol::PBBlockHeader>(cryptoSuite);
+        blockHeader->setNumber(number);
+        ledger->setBlockNumber(number - 1);
+        std::promise<void> nextPromise;
+        executor->nextBlockHeader(0, blockHeader, [&](bcos::Error::Ptr&& error) {
+            BOOST_CHECK(!error);
+            nextPromise.set_value();
+        });
+        nextPromise.get_future().get();
+
+        std::promise<ExecutionMessage::UniquePtr> executePromise;
+        executor->dmcExecuteTransaction(std::move(params),
+            [&](bcos::Error::UniquePtr&& error, ExecutionMessage::UniquePtr&& result) {
+                BOOST_CHECK(!error);
+                executePromise.set_value(std::move(result));
+            });
+        auto result = executePromise.get_future().get();
+        BOOST_CHECK_EQUAL(result->status(), 0);
+
+        TwoPCParams commitParams{};
+        commitParams.number = number;
+        std::promise<void> preparePromise;
+        executor->prepare(commitParams, [&](bcos::Error::Ptr&& error) {
+            BOOST_CHECK(!error);
+            preparePromise.set_value();
+        });
+        preparePromise.get_future().get();
+        std::promise<void> commitPromise;
+        executor->commit(commitParams, [&](bcos::Error::Ptr&& error) {
+            BOOST_CHECK(!error);
+            commitPromise.set_value();
+        });
+        commitPromise.get_future().get();
+        return result;
+    };
+
+    bytes input;
+    boost::algorithm::unhex(helloBin, std::back_inserter(input));
+    auto tx = fakeTransaction(cryptoSuite, keyPair, "", input, 101, 100001, "1", "1");
+    auto sender = *toHexString(string_view((char*)tx->sender().data(), tx->sender().size()));
+    txpool->hash2Transaction.emplace(tx->hash(), tx);
+
+    auto params = std::make_unique<NativeExecutionMessage>();
+    params->setType(ExecutionMessage::TXHASH);
+    params->setContextID(100);
+    params->setSeq(1000);
+    params->setDepth(0);
+    h256 addressCreate("ff6f30856ad3bae00b1169808488502786a13e3c174d85682135ffd51310310e");
+    params->setTo(addressCreate.hex().substr(0, 40));
+    params->setStaticCall(false);
+    params->setGasAvailable(gas);
+    params->setTransactionHash(tx->hash());
+    params->setCreate(true);
+    auto address = std::string(executeBlock(1, std::move(params))->newEVMContractAddress());
+
+    auto get = [&, this](int64_t contextID) {
+        auto callParam = std::make_unique<NativeExecutionMessage>();
+        callParam->setType(ExecutionMessage::MESSAGE);
+        callParam->setContextID(contextID);
+        callParam->setSeq(1000);
+        callParam->setDepth(0);
+        callParam->setFrom(std::string(sender));
+        callParam->setTo(std::string(address));
+        callParam->setData(codec->encodeWithSig("get()"));
+        callParam->setOrigin(std::string(sender));
+        callParam->setStaticCall(true);
+        callParam->setGasAvailable(gas);
+        callParam->setCreate(false);
+
+        std::promise<ExecutionMessage::UniquePtr> callPromise;
+        executor->dmcCall(std::move(callParam),
+            [&](bcos::Error::UniquePtr error, ExecutionMessage::UniquePtr response) {
+                BOOST_CHECK(!error);
+                callPromise.set_value(std::move(response));
+            });
+        auto result = callPromise.get_future().get();
+        BOOST_CHECK_EQUAL(result->status(), 0);
+        std::string value;
+        codec->decode(result->data(), value);
+        return value;
+    };
+
+    // the call takes the snapshot of block 1 and waits for the gate before reading it
+    std::promise<void> gate;
+    std::promise<void> snapshotTaken;
+    snapshotBackend->m_gate = gate.get_future().share();
+    snapshotBackend->m_onSnapshot = [&snapshotTaken]() { snapshotTaken.set_value(); };
+    auto call = std::async(std::launch::async, [&get]() { return get(200); });
+    snapshotTaken.get_future().get();
+    snapshotBackend->m_gate.reset();
+    snapshotBackend->m_onSnapshot = nullptr;
+
+    // block 2 sets the value and is committed while the call is in flight
+    auto setParams = std::make_unique<NativeExecutionMessage>();
+    setParams->setType(ExecutionMessage::MESSAGE);
+    setParams->setContextID(101);
+    setParams->setSeq(1000);
+    setParams->setDepth(0);
+    setParams->setFrom(std::string(sender));
+    setParams->setTo(std::string(address));
+    setParams->setOrigin(std::string(sender));
+    setParams->setStaticCall(false);
+    setParams->setGasAvailable(gas);
+    setParams->setData(codec->encodeWithSig("set(string)", std::string("fisco")));
+    executeBlock(2, std::move(setParams));
+
+    gate.set_value();
+    BOOST_CHECK_EQUAL(call.get(), "Hello, World!");
+    auto block1Snapshot = snapshotBackend->m_lastSnapshot;
+    BOOST_CHECK_EQUAL(get(201), "fisco");
+    // the snapshot of block 1 is released with its last call
+    BOOST_CHECK(block1Snapshot.expired());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace bcos
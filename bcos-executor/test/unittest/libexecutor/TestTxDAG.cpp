@@ -233,6 +233,32 @@ BOOST_AUTO_TEST_CASE(TestRun2)
     shared_ptr<TxDAGInterface> txDag = make_shared<TxDAG2>();
     txDagTest(txDag);
 }
+
+BOOST_AUTO_TEST_CASE(TestConflictGraph)
+{
+    // tx 0, 2, 4 conflict on a, tx 1, 4 on b, tx 3 has no critical field, tx 5 is a normal tx
+    CriticalFields::Ptr criticals = make_shared<CriticalFields>(6);
+    criticals->put(0, make_shared<CriticalFields::CriticalField>(vector<bytes>{bytes{'a'}}));
+    criticals->put(1, make_shared<CriticalFields::CriticalField>(vector<bytes>{bytes{'b'}}));
+    criticals->put(2, make_shared<CriticalFields::CriticalField>(vector<bytes>{bytes{'a'}}));
+    criticals->put(3, make_shared<CriticalFields::CriticalField>());
+    criticals->put(
+        4, make_shared<CriticalFields::CriticalField>(vector<bytes>{bytes{'a'}, bytes{'b'}}));
+
+    auto graph = criticals->conflictGraph();
+    BOOST_CHECK((graph.roots == vector<ID>{0, 1, 3}));
+    BOOST_CHECK((graph.inDegrees == vector<ID>{0, 0, 1, 0, 2, 0}));
+    // only the last tx with the same field is linked
+    auto children = [&graph](ID id) {
+        return vector<ID>(graph.edges.begin() + graph.offsets[id],
+            graph.edges.begin() + graph.offsets[id + 1]);
+    };
+    BOOST_CHECK((children(0) == vector<ID>{2}));
+    BOOST_CHECK((children(1) == vector<ID>{4}));
+    BOOST_CHECK((children(2) == vector<ID>{4}));
+    BOOST_CHECK(children(3).empty());
+    BOOST_CHECK(children(4).empty());
+}
 #if 0
 BOOST_AUTO_TEST_CASE(TestRun3)
 {
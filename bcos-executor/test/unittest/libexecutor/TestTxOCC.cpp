@@ -0,0 +1,116 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/**
+ * @brief : unitest for the optimistic concurrent execution
+ */
+
+#include "../../../src/dag/TxOCC.h"
+#include <boost/test/unit_test.hpp>
+#include <memory>
+
+using namespace std;
+using namespace bcos;
+using namespace bcos::executor;
+using namespace bcos::storage;
+
+namespace bcos
+{
+namespace test
+{
+namespace
+{
+std::optional<Entry> getRow(StateStorageInterface& _storage, std::string_view _key)
+{
+    std::optional<Entry> result;
+    _storage.asyncGetRow("t_test", _key, [&](Error::UniquePtr error, std::optional<Entry> entry) {
+        BOOST_CHECK(!error);
+        result = std::move(entry);
+    });
+    return result;
+}
+
+void setRow(StateStorageInterface& _storage, std::string_view _key, std::string _value)
+{
+    Entry entry;
+    entry.importFields({std::move(_value)});
+    _storage.asyncSetRow(
+        "t_test", _key, std::move(entry), [](Error::UniquePtr error) { BOOST_CHECK(!error); });
+}
+
+int64_t getValue(StateStorageInterface& _storage, std::string_view _key)
+{
+    auto entry = getRow(_storage, _key);
+    return entry ? std::stoll(std::string(entry->get())) : 0;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestTxOCC)
+
+BOOST_AUTO_TEST_CASE(DisjointTransactions)
+{
+    auto state = std::make_shared<StateStorage>(nullptr);
+    TxOCC occ(state);
+    auto reexecuted = occ.run(
+        100,
+        [](TxOCC::ID _id, StateStorageInterface::Ptr _storage) {
+            auto key = "key" + std::to_string(_id);
+            setRow(*_storage, key, std::to_string(getValue(*_storage, key) + _id));
+            return true;
+        },
+        4);
+    BOOST_CHECK_EQUAL(reexecuted, 0);
+    for (TxOCC::ID id = 0; id < 100; ++id)
+    {
+        BOOST_CHECK_EQUAL(getValue(*state, "key" + std::to_string(id)), id);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ConflictTransactions)
+{
+    auto state = std::make_shared<StateStorage>(nullptr);
+    setRow(*state, "counter", "10");
+    TxOCC occ(state);
+    std::atomic_size_t executed = 0;
+    auto reexecuted = occ.run(
+        100,
+        [&](TxOCC::ID _id, StateStorageInterface::Ptr _storage) {
+            ++executed;
+            // every transaction records the counter it has seen
+            auto counter = getValue(*_storage, "counter");
+            setRow(*_storage, "counter", std::to_string(counter + 1));
+            setRow(*_storage, "seen" + std::to_string(_id), std::to_string(counter));
+            // the writes of the dropped transactions are discarded
+            return _id % 10 != 0;
+        },
+        4);
+    BOOST_CHECK_EQUAL(executed, 100 + reexecuted);
+    BOOST_CHECK_EQUAL(getValue(*state, "counter"), 10 + 90);
+    int64_t expected = 10;
+    for (TxOCC::ID id = 0; id < 100; ++id)
+    {
+        auto seen = getRow(*state, "seen" + std::to_string(id));
+        if (id % 10 == 0)
+        {
+            BOOST_CHECK(!seen);
+            continue;
+        }
+        BOOST_CHECK_EQUAL(std::stoll(std::string(seen->get())), expected++);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
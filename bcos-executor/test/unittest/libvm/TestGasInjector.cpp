@@ -0,0 +1,98 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/**
+ * @brief : unitest for the result cache of the gas injector
+ */
+
+#include "../../src/vm/gas_meter/GasInjector.h"
+#include "WasmPath.h"
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+using namespace std;
+using namespace bcos;
+using namespace bcos::wasm;
+
+namespace bcos::test
+{
+namespace
+{
+vector<uint8_t> readWasm(const char* path)
+{
+    ifstream file(path, ios::binary);
+    return vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestGasInjector)
+
+BOOST_AUTO_TEST_CASE(ResultCacheHit)
+{
+    auto cache = make_shared<GasInjector::ResultCache>(1024 * 1024);
+    GasInjector injector(GetInstructionTable(), cache);
+    auto code = readWasm(originBinary);
+    BOOST_REQUIRE(!code.empty());
+
+    auto result = injector.InjectMeter(code);
+    BOOST_CHECK_EQUAL(result.status, GasInjector::Success);
+    BOOST_REQUIRE(result.byteCode);
+    auto size = cache->size();
+    BOOST_CHECK_GT(size, 0);
+
+    // the identical code is served from the cache, also by another injector of the same table
+    auto cached = injector.InjectMeter(code);
+    BOOST_CHECK_EQUAL(cached.status, GasInjector::Success);
+    BOOST_CHECK_EQUAL(cached.byteCode.get(), result.byteCode.get());
+    GasInjector another(GetInstructionTable(), cache);
+    BOOST_CHECK_EQUAL(another.InjectMeter(code).byteCode.get(), result.byteCode.get());
+    BOOST_CHECK_EQUAL(cache->size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(ResultCacheTableVersion)
+{
+    auto cache = make_shared<GasInjector::ResultCache>(1024 * 1024);
+    auto code = readWasm(originBinary);
+    auto result = GasInjector(GetInstructionTable(), cache).InjectMeter(code);
+    BOOST_CHECK_EQUAL(result.status, GasInjector::Success);
+    auto size = cache->size();
+
+    // any changed cost misses the results injected with the previous table
+    auto costTable = GetInstructionTable();
+    costTable[Instruction::Enum::I32Add].Cost += 1;
+    auto changed = GasInjector(costTable, cache).InjectMeter(code);
+    BOOST_CHECK_EQUAL(changed.status, GasInjector::Success);
+    BOOST_CHECK_NE(changed.byteCode.get(), result.byteCode.get());
+    BOOST_CHECK_GT(cache->size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(ResultCacheFailure)
+{
+    auto cache = make_shared<GasInjector::ResultCache>(1024 * 1024);
+    GasInjector injector(GetInstructionTable(), cache);
+    vector<uint8_t> invalid{0x00, 0x61, 0x73, 0x6d, 0xff};
+
+    auto result = injector.InjectMeter(invalid);
+    BOOST_CHECK_NE(result.status, GasInjector::Success);
+    // the failed result is not cached, the code is injected again
+    BOOST_CHECK_EQUAL(cache->size(), 0);
+    BOOST_CHECK_EQUAL(injector.InjectMeter(invalid).status, result.status);
+    BOOST_CHECK_EQUAL(cache->size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace bcos::test
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the benchmark of gas injection by module size, with and without the result cache
+ * @file inject_bench.cpp
+ */
+
+#include "src/common.h"
+#include "vm/gas_meter/GasInjector.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace bcos;
+using namespace wabt;
+
+template <typename F>
+static double averageUs(int rounds, F&& f)
+{
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+    {
+        f();
+    }
+    auto duration = chrono::steady_clock::now() - start;
+    return (double)chrono::duration_cast<chrono::microseconds>(duration).count() / rounds;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        cerr << "Usage: " << argv[0] << " <rounds> <wasm file>..." << endl;
+        return -1;
+    }
+    int rounds = std::max(atoi(argv[1]), 1);
+    vector<pair<string, vector<uint8_t>>> modules;
+    for (int i = 2; i < argc; ++i)
+    {
+        vector<uint8_t> fileData;
+        if (!Succeeded(wabt::ReadFile(argv[i], &fileData)))
+        {
+            cerr << "Read file failed: " << argv[i] << endl;
+            return -1;
+        }
+        modules.emplace_back(argv[i], std::move(fileData));
+    }
+    sort(modules.begin(), modules.end(),
+        [](const auto& a, const auto& b) { return a.second.size() < b.second.size(); });
+
+    wasm::GasInjector injector(wasm::GetInstructionTable(), nullptr);
+    wasm::GasInjector cachedInjector(
+        wasm::GetInstructionTable(), make_shared<wasm::GasInjector::ResultCache>(1 << 30));
+    cout << left << setw(12) << "size(B)" << setw(16) << "inject(us)" << setw(16) << "cached(us)"
+         << "module" << endl;
+    for (const auto& [name, code] : modules)
+    {
+        if (cachedInjector.InjectMeter(code).status != wasm::GasInjector::Status::Success)
+        {
+            cerr << "InjectMeter failed: " << name << endl;
+            continue;
+        }
+        auto injectUs = averageUs(rounds, [&]() { injector.InjectMeter(code); });
+        auto cachedUs = averageUs(rounds, [&]() { cachedInjector.InjectMeter(code); });
+        cout << left << setw(12) << code.size() << setw(16) << injectUs << setw(16) << cachedUs
+             << name << endl;
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bcos-framework/executor/ExecutionMessage.h"
+#include <bcos-utilities/FixedSizePool.h>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/multi_index/detail/modify_key_adaptor.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -9,7 +10,9 @@
 
 namespace bcos::executor
 {
-class NativeExecutionMessage : public protocol::ExecutionMessage
+// the messages of every transaction are allocated from a pool in the DMC rounds
+class NativeExecutionMessage : public protocol::ExecutionMessage,
+                               public bcos::PoolAllocated<NativeExecutionMessage>
 {
 public:
     NativeExecutionMessage() = default;
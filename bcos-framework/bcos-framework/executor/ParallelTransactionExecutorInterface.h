@@ -32,7 +32,9 @@
 #include <bcos-utilities/FixedBytes.h>
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/range/any_range.hpp>
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace bcos
 {
@@ -81,6 +83,70 @@ public:
             bcos::Error::UniquePtr, std::vector<bcos::protocol::ExecutionMessage::UniquePtr>)>
             callback) = 0;
 
+    // execute the dmc messages of several contracts in one request, the messages are grouped by
+    // to() and executed by dmcExecuteTransactions, the outputs of all groups are returned together
+    virtual void batchDmcExecuteTransactions(
+        gsl::span<bcos::protocol::ExecutionMessage::UniquePtr> inputs,
+        std::function<void(
+            bcos::Error::UniquePtr, std::vector<bcos::protocol::ExecutionMessage::UniquePtr>)>
+            callback)
+    {
+        struct BatchState
+        {
+            std::mutex mutex;
+            size_t pending = 0;
+            bcos::Error::UniquePtr error;
+            std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs;
+            std::map<std::string, std::vector<bcos::protocol::ExecutionMessage::UniquePtr>,
+                std::less<>>
+                contracts;
+        };
+        auto state = std::make_shared<BatchState>();
+        for (auto& input : inputs)
+        {
+            auto to = input->to();
+            auto it = state->contracts.find(to);
+            if (it == state->contracts.end())
+            {
+                it = state->contracts.emplace(std::string(to), decltype(it->second)()).first;
+            }
+            it->second.emplace_back(std::move(input));
+        }
+        if (state->contracts.empty())
+        {
+            callback(nullptr, {});
+            return;
+        }
+
+        state->pending = state->contracts.size();
+        for (auto& [contract, messages] : state->contracts)
+        {
+            dmcExecuteTransactions(contract, messages,
+                [state, callback](bcos::Error::UniquePtr error,
+                    std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs) {
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (error && !state->error)
+                        {
+                            state->error = std::move(error);
+                        }
+                        std::move(outputs.begin(), outputs.end(),
+                            std::back_inserter(state->outputs));
+                        if (--state->pending > 0)
+                        {
+                            return;
+                        }
+                    }
+                    if (state->error)
+                    {
+                        callback(std::move(state->error), {});
+                        return;
+                    }
+                    callback(nullptr, std::move(state->outputs));
+                });
+        }
+    }
+
     virtual void dagExecuteTransactions(
         gsl::span<bcos::protocol::ExecutionMessage::UniquePtr> inputs,
         std::function<void(
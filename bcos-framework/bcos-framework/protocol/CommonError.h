@@ -36,6 +36,8 @@ enum CommonError : int32_t
     InconsistentTransactions = 2001,
     TxsSignatureVerifyFailed = 2002,
     FetchTransactionsFailed = 2003,
+    InvalidSnapshotChunk = 2100,  // for block sync
+    InvalidSnapshot = 2101,
     NotFoundPeerByTopicSendMsg = 3001,
     NotFoundClientByTopicDispatchMsg = 3002,
     AMOPSendMsgFailed = 3003,
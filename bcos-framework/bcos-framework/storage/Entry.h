@@ -41,7 +41,8 @@ public:
 
     using ValueType = std::variant<SBOBuffer, std::string, std::vector<unsigned char>,
         std::vector<char>, std::shared_ptr<std::string>,
-        std::shared_ptr<std::vector<unsigned char>>, std::shared_ptr<std::vector<char>>>;
+        std::shared_ptr<std::vector<unsigned char>>, std::shared_ptr<std::vector<char>>,
+        std::shared_ptr<const std::string_view>>;
 
     Entry() = default;
 
@@ -173,6 +174,31 @@ public:
         m_value = value;
     }
 
+    // refer to a read-only buffer owned by others without copy, such as a value pinned by the
+    // storage backend, the owner is kept alive by the shared_ptr
+    void setPinned(std::shared_ptr<const std::string_view> value)
+    {
+        m_size = value->size();
+        m_value = std::move(value);
+        m_status = MODIFIED;
+    }
+
+    // the pinned buffer is only for the short-lived reads, an entry kept in a cache copies the
+    // value to release the buffer
+    bool pinned() const
+    {
+        return std::holds_alternative<std::shared_ptr<const std::string_view>>(m_value);
+    }
+    void unpin()
+    {
+        if (pinned())
+        {
+            auto status = m_status;
+            set(std::string(get()));
+            m_status = status;
+        }
+    }
+
     Status status() const { return m_status; }
 
     void setStatus(Status status)
@@ -95,6 +95,41 @@ public:
             callback) const = 0;
 };
 
+class StateSnapshotInterface : public virtual StorageInterface
+{
+public:
+    using Ptr = std::shared_ptr<StateSnapshotInterface>;
+
+    virtual ~StateSnapshotInterface() = default;
+
+    // reads the rows of the system and state tables in an order independent of how they are
+    // stored, starting at the position _from ("" for the first row) until _onRow returns false,
+    // returns the position of that row, "" if all the rows are read
+    virtual std::string readStateRows(std::string_view _from,
+        std::function<bool(
+            std::string_view table, std::string_view key, std::string_view value)>
+            _onRow) const = 0;
+};
+
+class StateSnapshotImportInterface : public virtual StorageInterface
+{
+public:
+    using Ptr = std::shared_ptr<StateSnapshotImportInterface>;
+
+    virtual ~StateSnapshotImportInterface() = default;
+
+    // writes the rows of a snapshot to the staging area, the staged rows are not visible to the
+    // reads of the storage until published
+    virtual Error::Ptr stageRows(std::string_view _table, std::vector<std::string> _keys,
+        std::vector<std::string> _values) = 0;
+    // replaces the rows of the system and state tables by the staged rows in bounded writes, the
+    // rows of the current state table are written last, then drops the staged rows; an interrupted
+    // publish is finished by the next publish, drop or restart instead of rolled back
+    virtual Error::Ptr publishStagedRows(std::vector<std::string> _currentStateKeys,
+        std::vector<std::string> _currentStateValues) = 0;
+    virtual Error::Ptr dropStagedRows() = 0;
+};
+
 class MergeableStorageInterface : public virtual StorageInterface
 {
 public:
@@ -122,6 +157,11 @@ public:
 
     virtual void asyncRollback(
         const bcos::protocol::TwoPCParams& params, std::function<void(Error::Ptr)> callback) = 0;
+
+    // a read only view of the committed data, not changed by the later commits, nullptr if the
+    // storage does not support snapshots; the snapshot may also implement StateSnapshotInterface
+    // to export the whole state
+    virtual StorageInterface::Ptr snapshot() { return nullptr; }
 };
 
 }  // namespace storage
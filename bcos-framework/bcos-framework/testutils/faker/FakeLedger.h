@@ -95,8 +95,20 @@ public:
     Block::Ptr init(BlockHeader::Ptr _parentBlockHeader, bool _withHeader, BlockNumber _blockNumber,
         size_t _txsSize, int64_t _timestamp = utcTime())
     {
-        auto block = fakeAndCheckBlock(
-            m_blockFactory->cryptoSuite(), m_blockFactory, false, _txsSize, 0, false);
+        auto block =
+            fakeAndCheckBlock(m_blockFactory->cryptoSuite(), m_blockFactory, false, 0, 0, false);
+        // the nonces are fixed by the block number, so the fake ledgers of the same height share
+        // the same blocks (and txsRoots) as the nodes of one chain
+        for (size_t i = 0; i < _txsSize; i++)
+        {
+            auto tx = fakeTransaction(m_blockFactory->cryptoSuite(), _blockNumber * _txsSize + i);
+            block->appendTransaction(tx);
+            auto metaData = std::make_shared<PBTransactionMetaData>();
+            metaData->setHash(tx->hash());
+            metaData->setTo(std::string(tx->to()));
+            block->appendTransactionMetaData(metaData);
+            block->appendReceipt(testPBTransactionReceipt(m_blockFactory->cryptoSuite(), false));
+        }
         if (!_withHeader)
         {
             return block;
@@ -112,10 +124,10 @@ public:
         u256 gasUsed = 1232342523;
 
         SignatureList signatureList;
-        // fake blockHeader
+        // fake blockHeader, the txsRoot is checked by the sync module before executing the block
         auto blockHeader = fakeAndTestBlockHeader(m_blockFactory->cryptoSuite(), 0, parentInfo,
-            rootHash, rootHash, rootHash, _blockNumber, gasUsed, _timestamp, 0, m_sealerList,
-            bytes(), signatureList, false);
+            block->calculateTransactionRoot(), rootHash, rootHash, _blockNumber, gasUsed,
+            _timestamp, 0, m_sealerList, bytes(), signatureList, false);
         auto sigImpl = m_blockFactory->cryptoSuite()->signatureImpl();
         signatureList = fakeSignatureList(sigImpl, m_keyPairVec, blockHeader->hash());
         blockHeader->setSignatureList(signatureList);
@@ -179,6 +179,9 @@ void Ledger::asyncPrewriteBlock(bcos::storage::StorageInterface::Ptr storage,
     // number 2 header
     bytes headerBuffer;
     header->encode(headerBuffer);
+    // the cached header is decoded from the stored one
+    auto cachedHeader = m_blockFactory->blockHeaderFactory()->createBlockHeader(headerBuffer);
+    auto headerSize = headerBuffer.size();
 
     Entry number2HeaderEntry;
     number2HeaderEntry.importFields({std::move(headerBuffer)});
@@ -225,6 +228,7 @@ void Ledger::asyncPrewriteBlock(bcos::storage::StorageInterface::Ptr storage,
     }
     bytes transactionsBuffer;
     transactionsBlock->encode(transactionsBuffer);
+    prewriteCache(std::move(cachedHeader), headerSize, transactionsBlock);
 
     Entry number2TransactionHashesEntry;
     number2TransactionHashesEntry.importFields({std::move(transactionsBuffer)});
@@ -266,7 +270,7 @@ void Ledger::asyncPrewriteBlock(bcos::storage::StorageInterface::Ptr storage,
 
     // total transaction count
     asyncGetTotalTransactionCount(
-        [storage, block, &setRowCallback, &totalCount, &failedCount](
+        [storage, block, cache = m_cache, &setRowCallback, &totalCount, &failedCount](
             Error::Ptr error, int64_t total, int64_t failed, bcos::protocol::BlockNumber) {
             if (error)
             {
@@ -297,11 +301,28 @@ void Ledger::asyncPrewriteBlock(bcos::storage::StorageInterface::Ptr storage,
             LEDGER_LOG(INFO) << METRIC << LOG_DESC("asyncPrewriteBlock")
                              << LOG_KV("number", block->blockHeaderConst()->number())
                              << LOG_KV("totalTxs", totalTxsCount) << LOG_KV("failedTxs", failedTxs)
-                             << LOG_KV("incTxs", totalCount) << LOG_KV("incFailedTxs", failedCount);
+                             << LOG_KV("incTxs", totalCount) << LOG_KV("incFailedTxs", failedCount)
+                             << LOG_KV("cacheSize", cache->size())
+                             << LOG_KV("cacheHits", cache->hits())
+                             << LOG_KV("cacheMisses", cache->misses());
         });
     asyncPreStoreBlockTxs(_blockTxs, block, setRowCallback);
 }
 
+void Ledger::prewriteCache(
+    BlockHeader::Ptr _header, size_t _headerSize, Block::ConstPtr _transactionsBlock)
+{
+    auto txHashes = std::make_shared<std::vector<std::string>>();
+    txHashes->reserve(_transactionsBlock->transactionsHashSize());
+    for (size_t i = 0; i < _transactionsBlock->transactionsHashSize(); ++i)
+    {
+        auto hash = _transactionsBlock->transactionHash(i);
+        txHashes->emplace_back(hash.begin(), hash.end());
+    }
+    // served after the storage returns the same block hash for the number
+    m_cache->prewrite(std::move(_header), _headerSize, std::move(txHashes));
+}
+
 std::tuple<bool, bcos::crypto::HashListPtr, std::shared_ptr<std::vector<bytesConstPtr>>>
 Ledger::needStoreUnsavedTxs(
     bcos::protocol::TransactionsPtr _blockTxs, bcos::protocol::Block::ConstPtr _block)
@@ -529,9 +550,15 @@ void Ledger::asyncGetBlockHashByNumber(bcos::protocol::BlockNumber _blockNumber,
         return;
     }
 
+    if (auto hash = m_cache->hash(_blockNumber))
+    {
+        _onGetBlock(nullptr, *hash);
+        return;
+    }
+
     auto key = boost::lexical_cast<std::string>(_blockNumber);
     asyncGetSystemTableEntry(SYS_NUMBER_2_HASH, key,
-        [callback = std::move(_onGetBlock)](
+        [cache = m_cache, _blockNumber, callback = std::move(_onGetBlock)](
             Error::Ptr&& error, std::optional<bcos::storage::Entry>&& entry) {
             try
             {
@@ -548,6 +575,10 @@ void Ledger::asyncGetBlockHashByNumber(bcos::protocol::BlockNumber _blockNumber,
                 auto hashStr = entry->getField(0);
                 bcos::crypto::HashType hash(
                     std::string(hashStr), bcos::crypto::HashType::FromBinary);
+                if (hashStr.size() == bcos::crypto::HashType::SIZE)
+                {
+                    cache->putHash(_blockNumber, hash);
+                }
 
                 callback(nullptr, std::move(hash));
             }
@@ -565,9 +596,14 @@ void Ledger::asyncGetBlockNumberByHash(const crypto::HashType& _blockHash,
 {
     auto key = _blockHash;
     LEDGER_LOG(TRACE) << "GetBlockNumberByHash request" << LOG_KV("hash", key.hex());
+    if (auto number = m_cache->number(key))
+    {
+        _onGetBlock(nullptr, *number);
+        return;
+    }
 
     asyncGetSystemTableEntry(SYS_HASH_2_NUMBER, bcos::concepts::bytebuffer::toView(key),
-        [callback = std::move(_onGetBlock)](
+        [cache = m_cache, key, callback = std::move(_onGetBlock)](
             Error::Ptr&& error, std::optional<bcos::storage::Entry>&& entry) {
             try
             {
@@ -594,6 +630,10 @@ void Ledger::asyncGetBlockNumberByHash(const crypto::HashType& _blockHash,
                         << "Cast blockNumber failed, may be empty, set to default value -1"
                         << LOG_KV("blockNumber str", entry->getField(0));
                 }
+                if (blockNumber >= 0)
+                {
+                    cache->putHash(blockNumber, key);
+                }
                 callback(nullptr, blockNumber);
             }
             catch (std::exception& e)
@@ -1069,6 +1109,12 @@ Error::Ptr Ledger::checkEntryValid(Error::UniquePtr&& error,
 void Ledger::asyncGetBlockHeader(bcos::protocol::Block::Ptr block,
     bcos::protocol::BlockNumber blockNumber, std::function<void(Error::Ptr&&)> callback)
 {
+    if (auto header = m_cache->header(blockNumber))
+    {
+        block->setBlockHeader(std::move(header));
+        callback(nullptr);
+        return;
+    }
     m_storage->asyncOpenTable(SYS_NUMBER_2_BLOCK_HEADER,
         [this, blockNumber, block, callback](auto&& error, std::optional<Table>&& table) {
             auto validError = checkTableValid(std::move(error), table, SYS_NUMBER_2_BLOCK_HEADER);
@@ -1091,6 +1137,7 @@ void Ledger::asyncGetBlockHeader(bcos::protocol::Block::Ptr block,
                     auto field = entry->getField(0);
                     auto headerPtr = m_blockFactory->blockHeaderFactory()->createBlockHeader(
                         bcos::bytesConstRef((bcos::byte*)field.data(), field.size()));
+                    m_cache->putHeader(headerPtr, field.size());
 
                     block->setBlockHeader(std::move(headerPtr));
                     callback(nullptr);
@@ -1101,6 +1148,11 @@ void Ledger::asyncGetBlockHeader(bcos::protocol::Block::Ptr block,
 void Ledger::asyncGetBlockTransactionHashes(bcos::protocol::BlockNumber blockNumber,
     std::function<void(Error::Ptr&&, std::vector<std::string>&&)> callback)
 {
+    if (auto txHashes = m_cache->txHashes(blockNumber))
+    {
+        callback(nullptr, std::vector<std::string>(*txHashes));
+        return;
+    }
     m_storage->asyncOpenTable(SYS_NUMBER_2_TXS,
         [this, blockNumber, callback](auto&& error, std::optional<Table>&& table) {
             auto validError = checkTableValid(std::move(error), table, SYS_NUMBER_2_BLOCK_HEADER);
@@ -1131,6 +1183,8 @@ void Ledger::asyncGetBlockTransactionHashes(bcos::protocol::BlockNumber blockNum
                         hashList[i].assign(hash.begin(), hash.end());
                         // hashList[i] = hash.hex();
                     }
+                    m_cache->putTxHashes(
+                        blockNumber, std::make_shared<std::vector<std::string>>(hashList));
 
                     callback(nullptr, std::move(hashList));
                 });
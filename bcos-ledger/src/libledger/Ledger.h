@@ -25,6 +25,7 @@
 #include "bcos-framework/protocol/ProtocolTypeDef.h"
 #include "bcos-framework/storage/Common.h"
 #include "bcos-framework/storage/StorageInterface.h"
+#include "LedgerCache.h"
 #include "utilities/MerkleProofUtility.h"
 #include <bcos-utilities/Common.h>
 #include <bcos-utilities/Exceptions.h>
@@ -39,8 +40,10 @@ class Ledger : public LedgerInterface, public std::enable_shared_from_this<Ledge
 {
 public:
     Ledger(bcos::protocol::BlockFactory::Ptr _blockFactory,
-        bcos::storage::StorageInterface::Ptr _storage)
-      : m_blockFactory(std::move(_blockFactory)), m_storage(std::move(_storage))
+        bcos::storage::StorageInterface::Ptr _storage, size_t _cacheSize = c_ledgerCacheSize)
+      : m_blockFactory(std::move(_blockFactory)),
+        m_storage(std::move(_storage)),
+        m_cache(std::make_shared<LedgerCache>(_cacheSize))
     {
         assert(m_blockFactory);
         assert(m_storage);
@@ -143,8 +146,16 @@ private:
     needStoreUnsavedTxs(
         bcos::protocol::TransactionsPtr _blockTxs, bcos::protocol::Block::ConstPtr _block);
 
+    // write through the prewritten blocks
+    void prewriteCache(bcos::protocol::BlockHeader::Ptr _header, size_t _headerSize,
+        bcos::protocol::Block::ConstPtr _transactionsBlock);
+
+    constexpr static size_t c_ledgerCacheSize = 32 * 1024 * 1024;
+
     bcos::protocol::BlockFactory::Ptr m_blockFactory;
     bcos::storage::StorageInterface::Ptr m_storage;
+    // the headers and the transaction hashes of the recent blocks
+    LedgerCache::Ptr m_cache;
 
     mutable RecursiveMutex m_mutex;
 };
@@ -0,0 +1,187 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief LRU cache of the decoded headers and transaction hashes of the recent blocks
+ * @file LedgerCache.cpp
+ */
+#include "LedgerCache.h"
+
+using namespace bcos;
+using namespace bcos::ledger;
+using namespace bcos::protocol;
+using namespace bcos::crypto;
+
+void LedgerCache::prewrite(BlockHeader::Ptr _header, size_t _headerSize, TxHashes _txHashes)
+{
+    BlockData data;
+    data.number = _header->number();
+    data.hash = _header->hash();
+    data.header = std::move(_header);
+    data.headerSize = _headerSize;
+    data.txHashes = std::move(_txHashes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending[data.number] = std::move(data);
+    // the lowest blocks are the stale ones
+    while (m_pending.size() > m_maxPending)
+    {
+        m_pending.erase(m_pending.begin());
+    }
+}
+
+std::optional<HashType> LedgerCache::hash(BlockNumber _number)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto data = m_blocks.get(_number);
+    if (!data || !data->hash)
+    {
+        ++m_misses;
+        return std::nullopt;
+    }
+    ++m_hits;
+    return data->hash;
+}
+
+std::optional<BlockNumber> LedgerCache::number(HashType const& _hash)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_hashIndex.find(_hash);
+    if (it == m_hashIndex.end())
+    {
+        ++m_misses;
+        return std::nullopt;
+    }
+    ++m_hits;
+    m_blocks.get(it->second);
+    return it->second;
+}
+
+BlockHeader::Ptr LedgerCache::header(BlockNumber _number)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto data = m_blocks.get(_number);
+    if (!data || !data->header)
+    {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    return data->header;
+}
+
+LedgerCache::TxHashes LedgerCache::txHashes(BlockNumber _number)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto data = m_blocks.get(_number);
+    if (!data || !data->txHashes)
+    {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    return data->txHashes;
+}
+
+void LedgerCache::putHash(BlockNumber _number, HashType const& _hash)
+{
+    BlockData data;
+    data.number = _number;
+    data.hash = _hash;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    commitPending(_number, _hash);
+    merge(std::move(data));
+}
+
+void LedgerCache::putHeader(BlockHeader::Ptr _header, size_t _headerSize)
+{
+    BlockData data;
+    data.number = _header->number();
+    data.hash = _header->hash();
+    data.header = std::move(_header);
+    data.headerSize = _headerSize;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    commitPending(data.number, *data.hash);
+    merge(std::move(data));
+}
+
+void LedgerCache::putTxHashes(BlockNumber _number, TxHashes _txHashes)
+{
+    BlockData data;
+    data.number = _number;
+    data.txHashes = std::move(_txHashes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    merge(std::move(data));
+}
+
+size_t LedgerCache::size() const
+{
+    return m_blocks.size();
+}
+
+void LedgerCache::merge(BlockData _data)
+{
+    if (auto cached = m_blocks.get(_data.number))
+    {
+        if (cached->hash)
+        {
+            _data.hash = cached->hash;
+        }
+        if (cached->header)
+        {
+            _data.header = std::move(cached->header);
+            _data.headerSize = cached->headerSize;
+        }
+        if (cached->txHashes)
+        {
+            _data.txHashes = std::move(cached->txHashes);
+        }
+    }
+    auto number = _data.number;
+    auto hash = _data.hash;
+    auto size = dataSize(_data);
+    // the block larger than the capacity is not kept, the cached one is left as it is
+    if (m_blocks.insert(number, std::move(_data), size) && hash)
+    {
+        m_hashIndex[*hash] = number;
+    }
+}
+
+void LedgerCache::commitPending(BlockNumber _number, HashType const& _hash)
+{
+    auto it = m_pending.find(_number);
+    if (it != m_pending.end() && it->second.hash == _hash)
+    {
+        merge(std::move(it->second));
+    }
+    // the block _number is committed, the prewritten blocks not higher than it are settled
+    m_pending.erase(m_pending.begin(), m_pending.upper_bound(_number));
+}
+
+size_t LedgerCache::dataSize(BlockData const& _data)
+{
+    size_t size = _data.hash ? HashType::SIZE : 0;
+    size += _data.header ? _data.headerSize : 0;
+    if (_data.txHashes)
+    {
+        for (auto const& hash : *_data.txHashes)
+        {
+            size += hash.size();
+        }
+    }
+    return size;
+}
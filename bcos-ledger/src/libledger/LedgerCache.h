@@ -0,0 +1,100 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief LRU cache of the decoded headers and transaction hashes of the recent blocks
+ * @file LedgerCache.h
+ */
+#pragma once
+#include "bcos-framework/protocol/BlockHeader.h"
+#include "bcos-framework/protocol/ProtocolTypeDef.h"
+#include <bcos-crypto/interfaces/crypto/CommonType.h>
+#include <bcos-utilities/LRUCache.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace bcos::ledger
+{
+// The committed blocks never change, the headers and the transaction hashes of the blocks queried
+// repeatedly are read from the storage and decoded only once. The prewritten blocks are kept
+// aside until the storage returns the same block hash for their number, a prewritten block that
+// is never committed is not served. Bounded by the estimated size of the cached blocks.
+class LedgerCache
+{
+public:
+    using Ptr = std::shared_ptr<LedgerCache>;
+    using TxHashes = std::shared_ptr<const std::vector<std::string>>;
+
+    explicit LedgerCache(size_t _capacity, size_t _maxPending = c_maxPending)
+      : m_maxPending(_maxPending),
+        m_blocks(_capacity, 1, [this](auto const&, BlockData const& _data) {
+            if (_data.hash)
+            {
+                m_hashIndex.erase(*_data.hash);
+            }
+        })
+    {}
+
+    // the block of _header is prewritten, _headerSize is the size of the encoded header
+    void prewrite(bcos::protocol::BlockHeader::Ptr _header, size_t _headerSize,
+        TxHashes _txHashes);
+
+    std::optional<bcos::crypto::HashType> hash(bcos::protocol::BlockNumber _number);
+    std::optional<bcos::protocol::BlockNumber> number(bcos::crypto::HashType const& _hash);
+    bcos::protocol::BlockHeader::Ptr header(bcos::protocol::BlockNumber _number);
+    TxHashes txHashes(bcos::protocol::BlockNumber _number);
+
+    // the committed data read from the storage, the prewritten block with the same hash is
+    // committed
+    void putHash(bcos::protocol::BlockNumber _number, bcos::crypto::HashType const& _hash);
+    void putHeader(bcos::protocol::BlockHeader::Ptr _header, size_t _headerSize);
+    void putTxHashes(bcos::protocol::BlockNumber _number, TxHashes _txHashes);
+
+    size_t size() const;
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+
+    constexpr static size_t c_maxPending = 16;
+
+private:
+    struct BlockData
+    {
+        bcos::protocol::BlockNumber number = -1;
+        std::optional<bcos::crypto::HashType> hash;
+        bcos::protocol::BlockHeader::Ptr header;
+        size_t headerSize = 0;
+        TxHashes txHashes;
+    };
+
+    // merges the fields of _data into the cached block, the cached fields are kept
+    void merge(BlockData _data);
+    // commits the prewritten block if its hash is _hash
+    void commitPending(bcos::protocol::BlockNumber _number, bcos::crypto::HashType const& _hash);
+    static size_t dataSize(BlockData const& _data);
+
+    size_t m_maxPending;
+    std::unordered_map<bcos::crypto::HashType, bcos::protocol::BlockNumber> m_hashIndex;
+    // the hash index of the evicted blocks is dropped, all accesses are under m_mutex
+    LRUCache<bcos::protocol::BlockNumber, BlockData> m_blocks;
+    std::map<bcos::protocol::BlockNumber, BlockData> m_pending;
+    mutable std::mutex m_mutex;
+
+    std::atomic<uint64_t> m_hits = {0};
+    std::atomic<uint64_t> m_misses = {0};
+};
+}  // namespace bcos::ledger
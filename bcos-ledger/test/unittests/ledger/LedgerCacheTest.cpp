@@ -0,0 +1,124 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief test for the cache of the recent blocks of the ledger
+ * @file LedgerCacheTest.cpp
+ */
+#include "bcos-ledger/src/libledger/LedgerCache.h"
+#include "common/FakeBlock.h"
+#include <bcos-utilities/testutils/TestPromptFixture.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace bcos;
+using namespace bcos::ledger;
+using namespace bcos::protocol;
+using namespace bcos::crypto;
+
+namespace bcos::test
+{
+namespace
+{
+LedgerCache::TxHashes fakeTxHashes(size_t _size)
+{
+    auto txHashes = std::make_shared<std::vector<std::string>>();
+    for (size_t i = 0; i < _size; ++i)
+    {
+        txHashes->emplace_back(HashType::SIZE, (char)i);
+    }
+    return txHashes;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(LedgerCacheTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testPrewriteAndCommit)
+{
+    auto cryptoSuite = createCryptoSuite();
+    LedgerCache cache(1024 * 1024);
+
+    auto header = testPBBlockHeader(cryptoSuite, 10);
+    auto rejected = testPBBlockHeader(cryptoSuite, 11);
+    auto committed = testPBBlockHeader(cryptoSuite, 11);
+    committed->setTimestamp(rejected->timestamp() + 1);
+    cache.prewrite(header, 100, fakeTxHashes(2));
+    cache.prewrite(rejected, 100, fakeTxHashes(3));
+
+    // the prewritten blocks are not served before committed
+    BOOST_CHECK(!cache.hash(10));
+    BOOST_CHECK(!cache.header(10));
+    BOOST_CHECK(!cache.number(header->hash()));
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+
+    // the storage returns the hash of the prewritten block
+    cache.putHash(10, header->hash());
+    BOOST_CHECK(cache.hash(10).value() == header->hash());
+    BOOST_CHECK(cache.header(10) == header);
+    BOOST_CHECK_EQUAL(cache.txHashes(10)->size(), 2);
+    BOOST_CHECK_EQUAL(cache.number(header->hash()).value(), 10);
+    BOOST_CHECK_EQUAL(cache.size(), HashType::SIZE + 100 + 2 * HashType::SIZE);
+
+    // another block 11 is committed, the prewritten one is dropped
+    cache.putHeader(committed, 120);
+    BOOST_CHECK(cache.header(11) == committed);
+    BOOST_CHECK(cache.hash(11).value() == committed->hash());
+    BOOST_CHECK(!cache.txHashes(11));
+    BOOST_CHECK(!cache.number(rejected->hash()));
+    cache.putTxHashes(11, fakeTxHashes(1));
+    BOOST_CHECK_EQUAL(cache.txHashes(11)->size(), 1);
+
+    BOOST_CHECK_GT(cache.hits(), 0);
+    BOOST_CHECK_GT(cache.misses(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testEvict)
+{
+    auto cryptoSuite = createCryptoSuite();
+    // room for two blocks
+    auto blockSize = 100 + HashType::SIZE;
+    LedgerCache cache(blockSize * 2);
+
+    std::vector<BlockHeader::Ptr> headers;
+    for (BlockNumber i = 0; i < 3; ++i)
+    {
+        headers.push_back(testPBBlockHeader(cryptoSuite, i));
+    }
+    cache.putHeader(headers[0], 100);
+    cache.putHeader(headers[1], 100);
+    // block 0 is the most recently used one
+    BOOST_CHECK(cache.header(0));
+    cache.putHeader(headers[2], 100);
+    BOOST_CHECK_EQUAL(cache.size(), blockSize * 2);
+    BOOST_CHECK(cache.header(0));
+    BOOST_CHECK(cache.header(2));
+    BOOST_CHECK(!cache.header(1));
+    BOOST_CHECK(!cache.number(headers[1]->hash()));
+
+    // the blocks larger than the capacity are not kept
+    cache.putTxHashes(3, fakeTxHashes(100));
+    BOOST_CHECK(!cache.txHashes(3));
+    BOOST_CHECK_LE(cache.size(), blockSize * 2);
+
+    // the stale prewritten blocks are bounded
+    LedgerCache pendingCache(blockSize * 2, 1);
+    pendingCache.prewrite(headers[1], 100, nullptr);
+    pendingCache.prewrite(headers[2], 100, nullptr);
+    pendingCache.putHash(1, headers[1]->hash());
+    BOOST_CHECK(!pendingCache.header(1));
+    pendingCache.putHash(2, headers[2]->hash());
+    BOOST_CHECK(pendingCache.header(2) == headers[2]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace bcos::test
@@ -160,6 +160,17 @@ bcos::protocol::ExecutionMessage::UniquePtr BlockExecutive::buildMessage(
     return message;
 }
 
+bool BlockExecutive::isDAGMessage(
+    protocol::ExecutionMessage const& _message, uint32_t _attribute) const
+{
+    if (_attribute & bcos::protocol::Transaction::Attribute::DAG)
+    {
+        return true;
+    }
+    // the deployments are always sent back by the executors
+    return m_scheduler->m_isOccExecute && !_message.create();
+}
+
 void BlockExecutive::buildExecutivesFromMetaData()
 {
     SCHEDULER_LOG(DEBUG) << BLOCK_NUMBER(number())
@@ -184,7 +195,7 @@ void BlockExecutive::buildExecutivesFromMetaData()
             auto contextID = i + m_startContextID;
             auto message = buildMessage(contextID, (*m_blockTxs)[i]);
             std::string to = {message->to().data(), message->to().size()};
-            bool enableDAG = metaData->attribute() & bcos::protocol::Transaction::Attribute::DAG;
+            bool enableDAG = isDAGMessage(*message, metaData->attribute());
 #pragma omp critical
             m_hasDAG = m_hasDAG || enableDAG;
             saveMessage(to, std::move(message), enableDAG);
@@ -241,7 +252,7 @@ void BlockExecutive::buildExecutivesFromMetaData()
                 message->setGasAvailable(TRANSACTION_GAS);
             }
             message->setStaticCall(false);
-            bool enableDAG = metaData->attribute() & bcos::protocol::Transaction::Attribute::DAG;
+            bool enableDAG = isDAGMessage(*message, metaData->attribute());
 
             std::string to = {message->to().data(), message->to().size()};
 #pragma omp critical
@@ -270,7 +281,7 @@ void BlockExecutive::buildExecutivesFromNormalTransaction()
         auto contextID = i + m_startContextID;
         auto message = buildMessage(contextID, tx);
         std::string to = {message->to().data(), message->to().size()};
-        bool enableDAG = tx->attribute() & bcos::protocol::Transaction::Attribute::DAG;
+        bool enableDAG = isDAGMessage(*message, tx->attribute());
 
 #pragma omp critical
         m_hasDAG = m_hasDAG || enableDAG;
@@ -705,6 +716,18 @@ void BlockExecutive::DAGExecute(std::function<void(Error::UniquePtr)> callback)
     SCHEDULER_LOG(INFO) << LOG_BADGE("DAG") << LOG_BADGE("Stat") << BLOCK_NUMBER(number())
                         << LOG_BADGE("BlockTrace") << "DAGExecute.0:\t>>> Start send to executor";
 
+    // the optimistic execution of a contract's batch reads the state written by the batches
+    // before it, so the batches are sent one by one in the order of the contract addresses
+    auto isSerial = m_scheduler->m_isOccExecute;
+    auto sends = std::make_shared<std::vector<std::function<void()>>>();
+    auto sendNext = [sends](size_t _index) {
+        if (_index < sends->size())
+        {
+            auto send = std::move((*sends)[_index]);
+            send();
+        }
+    };
+
     // string => <tuple<std::string, ContextID> => ExecutiveState::Ptr>::it
     for (auto it = requests.begin(); it != requests.end(); it = requests.upper_bound(it->first))
     {
@@ -736,68 +759,90 @@ void BlockExecutive::DAGExecute(std::function<void(Error::UniquePtr)> callback)
                             << LOG_KV("contract", contractAddress)
                             << LOG_KV("txNum", messages->size());
         auto prepareT = utcTime() - startT;
-        startT = utcTime();
-        executor->dagExecuteTransactions(*messages,
-            [this, contractAddress, messages, startT, prepareT, iterators = std::move(iterators),
-                totalCount, failed, callbackPtr](bcos::Error::UniquePtr error,
-                std::vector<bcos::protocol::ExecutionMessage::UniquePtr> responseMessages) {
-                SCHEDULER_LOG(INFO)
-                    << LOG_BADGE("DAG") << LOG_BADGE("Stat") << BLOCK_NUMBER(number())
-                    << "DAGExecute.2:\t<-- Receive from executor\t"
-                    << LOG_KV("contract", contractAddress) << LOG_KV("txNum", messages->size())
-                    << LOG_KV("costT", utcTime() - startT) << LOG_KV("failed", *failed)
-                    << LOG_KV("totalCount", *totalCount) << LOG_KV("blockNumber", number());
-                if (error)
-                {
-                    ++(*failed);
-                    SCHEDULER_LOG(ERROR)
-                        << BLOCK_NUMBER(number()) << "DAG execute error: " << error->errorMessage()
-                        << LOG_KV("failed", *failed) << LOG_KV("totalCount", *totalCount)
-                        << LOG_KV("blockNumber", number());
-                    if (error->errorCode() == bcos::executor::ExecuteError::SCHEDULER_TERM_ID_ERROR)
+        auto send = [this, executor, contractAddress, messages, prepareT,
+                        iterators = std::move(iterators), totalCount, failed, callbackPtr,
+                        isSerial, sendNext, index = sends->size()]() mutable {
+            auto startT = utcTime();
+            executor->dagExecuteTransactions(*messages,
+                [this, contractAddress, messages, startT, prepareT,
+                    iterators = std::move(iterators), totalCount, failed, callbackPtr, isSerial,
+                    sendNext, index](bcos::Error::UniquePtr error,
+                    std::vector<bcos::protocol::ExecutionMessage::UniquePtr> responseMessages) {
+                    SCHEDULER_LOG(INFO)
+                        << LOG_BADGE("DAG") << LOG_BADGE("Stat") << BLOCK_NUMBER(number())
+                        << "DAGExecute.2:\t<-- Receive from executor\t"
+                        << LOG_KV("contract", contractAddress) << LOG_KV("txNum", messages->size())
+                        << LOG_KV("costT", utcTime() - startT) << LOG_KV("failed", *failed)
+                        << LOG_KV("totalCount", *totalCount) << LOG_KV("blockNumber", number());
+                    if (error)
                     {
-                        triggerSwitch();
+                        ++(*failed);
+                        SCHEDULER_LOG(ERROR)
+                            << BLOCK_NUMBER(number())
+                            << "DAG execute error: " << error->errorMessage()
+                            << LOG_KV("failed", *failed) << LOG_KV("totalCount", *totalCount)
+                            << LOG_KV("blockNumber", number());
+                        if (error->errorCode() ==
+                            bcos::executor::ExecuteError::SCHEDULER_TERM_ID_ERROR)
+                        {
+                            triggerSwitch();
+                        }
                     }
-                }
-                else if (messages->size() != responseMessages.size())
-                {
-                    ++(*failed);
-                    SCHEDULER_LOG(ERROR) << BLOCK_NUMBER(number())
-                                         << "DAG messages size and response size mismatch!";
-                }
-                else
-                {
-#pragma omp parallel for
-                    for (size_t j = 0; j < responseMessages.size(); ++j)
+                    else if (messages->size() != responseMessages.size())
                     {
-                        assert(responseMessages[j]);
-                        iterators[j]->second->message = std::move(responseMessages[j]);
+                        ++(*failed);
+                        SCHEDULER_LOG(ERROR) << BLOCK_NUMBER(number())
+                                             << "DAG messages size and response size mismatch!";
+                    }
+                    else
+                    {
+#pragma omp parallel for
+                        for (size_t j = 0; j < responseMessages.size(); ++j)
+                        {
+                            assert(responseMessages[j]);
+                            iterators[j]->second->message = std::move(responseMessages[j]);
+                        }
                     }
-                }
-
-                if (totalCount->fetch_sub(messages->size()) == messages->size())
-                {
-                    // only one thread can get in this field
-                    SCHEDULER_LOG(DEBUG)
-                        << LOG_BADGE("DAG") << LOG_BADGE("Stat") << BLOCK_NUMBER(number())
-                        << "DAGExecute.3:\t<<< Joint all contract result\t"
-                        << LOG_KV("costT", utcTime() - startT) << LOG_KV("failed", *failed)
-                        << LOG_KV("totalCount", *totalCount) << LOG_KV("blockNumber", number());
 
-                    if (*failed > 0)
+                    if (isSerial)
                     {
-                        (*callbackPtr)(BCOS_ERROR_UNIQUE_PTR(
-                            SchedulerError::DAGError, "Execute dag with errors"));
-                        return;
+                        sendNext(index + 1);
+                    }
+                    if (totalCount->fetch_sub(messages->size()) == messages->size())
+                    {
+                        // only one thread can get in this field
+                        SCHEDULER_LOG(DEBUG)
+                            << LOG_BADGE("DAG") << LOG_BADGE("Stat") << BLOCK_NUMBER(number())
+                            << "DAGExecute.3:\t<<< Joint all contract result\t"
+                            << LOG_KV("costT", utcTime() - startT) << LOG_KV("failed", *failed)
+                            << LOG_KV("totalCount", *totalCount) << LOG_KV("blockNumber", number());
+
+                        if (*failed > 0)
+                        {
+                            (*callbackPtr)(BCOS_ERROR_UNIQUE_PTR(
+                                SchedulerError::DAGError, "Execute dag with errors"));
+                            return;
+                        }
+
+                        SCHEDULER_LOG(INFO)
+                            << BLOCK_NUMBER(number()) << LOG_BADGE("BlockTrace")
+                            << LOG_DESC("DAGExecute finish") << LOG_KV("prepareT", prepareT)
+                            << LOG_KV("execT", (utcTime() - startT));
+                        (*callbackPtr)(nullptr);
                     }
+                });
+        };
+        sends->emplace_back(std::move(send));
+    }
 
-                    SCHEDULER_LOG(INFO)
-                        << BLOCK_NUMBER(number()) << LOG_BADGE("BlockTrace")
-                        << LOG_DESC("DAGExecute finish") << LOG_KV("prepareT", prepareT)
-                        << LOG_KV("execT", (utcTime() - startT));
-                    (*callbackPtr)(nullptr);
-                }
-            });
+    if (isSerial)
+    {
+        sendNext(0);
+        return;
+    }
+    for (size_t i = 0; i < sends->size(); ++i)
+    {
+        sendNext(i);
     }
 }
 
@@ -937,12 +982,17 @@ void BlockExecutive::DMCExecute(
                       << LOG_KV("cost", utcTime() - lastT)
                       << LOG_KV("contractNum", contractAddress.size());
 
-// for each dmcExecutor
-#pragma omp parallel for
-        for (size_t i = 0; i < contractAddress.size(); i++)
+        if (m_staticCall)
+        {
+            // only one static call to send
+            for (auto& address : contractAddress)
+            {
+                m_dmcExecutors[address]->go(executorCallback);
+            }
+        }
+        else
         {
-            auto dmcExecutor = m_dmcExecutors[contractAddress[i]];
-            dmcExecutor->go(executorCallback);
+            batchGoDmcExecutors(contractAddress, std::move(executorCallback));
         }
     }
     catch (bcos::Error& e)
@@ -974,6 +1024,20 @@ void BlockExecutive::onDmcExecuteFinish(
         DMC_LOG(INFO) << BLOCK_NUMBER(number()) << LOG_BADGE("BlockTrace")
                       << LOG_BADGE("DMCRecorder") << " DMCExecute for transaction finished "
                       << LOG_KV("checksum", dmcChecksum);
+
+        // report the cost of the contracts for the placement of the contracts
+        std::map<std::string, ExecutorManager::ContractCost, std::less<>> contractCosts;
+        for (auto& [contract, dmcExecutor] : m_dmcExecutors)
+        {
+            auto& cost = contractCosts[contract];
+            cost = dmcExecutor->cost();
+            auto gasIt = m_contractGasUsed.find(contract);
+            if (gasIt != m_contractGasUsed.end())
+            {
+                cost.gasUsed = gasIt->second;
+            }
+        }
+        m_scheduler->executorManager()->updateContractCosts(contractCosts);
     }
 
     onExecuteFinish(std::move(callback));
@@ -1442,6 +1506,146 @@ DmcExecutor::Ptr BlockExecutive::registerAndGetDmcExecutor(std::string contractA
     }
 }
 
+void BlockExecutive::batchGoDmcExecutors(std::vector<std::string> const& contractAddress,
+    std::function<void(bcos::Error::UniquePtr, DmcExecutor::Status)> executorCallback)
+{
+    // group the dmcExecutors with messages to send by executor, the others and the static calls go
+    // alone
+    std::vector<DmcExecutor::Ptr> singles;
+    std::map<bcos::executor::ParallelTransactionExecutorInterface::Ptr,
+        std::vector<DmcExecutor::Ptr>>
+        executorGroups;
+    for (auto& address : contractAddress)
+    {
+        auto dmcExecutor = m_dmcExecutors[address];
+        if (dmcExecutor->hasFinished() || !dmcExecutor->needSend() ||
+            dmcExecutor->needSendStaticCall())
+        {
+            singles.push_back(std::move(dmcExecutor));
+            continue;
+        }
+        executorGroups[dmcExecutor->executor()].push_back(std::move(dmcExecutor));
+    }
+    std::vector<bcos::executor::ParallelTransactionExecutorInterface::Ptr> batchExecutors;
+    std::vector<std::vector<DmcExecutor::Ptr>> batches;
+    std::vector<std::pair<size_t, size_t>> batchMembers;
+    for (auto& [executor, dmcExecutors] : executorGroups)
+    {
+        if (dmcExecutors.size() == 1)
+        {
+            singles.push_back(std::move(dmcExecutors[0]));
+            continue;
+        }
+        for (size_t i = 0; i < dmcExecutors.size(); ++i)
+        {
+            batchMembers.emplace_back(batches.size(), i);
+        }
+        batchExecutors.push_back(executor);
+        batches.push_back(std::move(dmcExecutors));
+    }
+
+    // taking the messages queries the key locks of every message, the singles go and the batched
+    // dmcExecutors take their messages in parallel like the dmcExecutors going one by one
+    std::vector<std::vector<std::vector<protocol::ExecutionMessage::UniquePtr>>> sends(
+        batches.size());
+    for (size_t i = 0; i < batches.size(); ++i)
+    {
+        sends[i].resize(batches[i].size());
+    }
+#pragma omp parallel for
+    for (size_t i = 0; i < singles.size() + batchMembers.size(); ++i)
+    {
+        if (i < singles.size())
+        {
+            singles[i]->go(executorCallback);
+            continue;
+        }
+        auto [batch, member] = batchMembers[i - singles.size()];
+        sends[batch][member] = batches[batch][member]->takeSendMessages();
+    }
+
+    for (size_t batch = 0; batch < batches.size(); ++batch)
+    {
+        auto const& executor = batchExecutors[batch];
+        auto& dmcExecutors = batches[batch];
+        // the context of a message is held by exactly one dmcExecutor in a round, the outputs are
+        // dispatched back by the context id
+        auto messages = std::make_shared<std::vector<protocol::ExecutionMessage::UniquePtr>>();
+        auto contextOwners = std::make_shared<std::unordered_map<ContextID, size_t>>();
+        for (size_t i = 0; i < dmcExecutors.size(); ++i)
+        {
+            for (auto& message : sends[batch][i])
+            {
+                contextOwners->emplace(message->contextID(), i);
+                messages->push_back(std::move(message));
+            }
+        }
+
+        auto lastT = utcTime();
+        auto startTimeUs = utcSteadyTimeUs();
+        DMC_LOG(DEBUG) << LOG_BADGE("Stat") << "DMCExecute.3:\t --> Send batch to executor\t"
+                       << LOG_KV("round", m_dmcRecorder->getRound())
+                       << LOG_KV("name", dmcExecutors[0]->name())
+                       << LOG_KV("contractNum", dmcExecutors.size())
+                       << LOG_KV("txNum", messages->size()) << BLOCK_NUMBER(number());
+        executor->batchDmcExecuteTransactions(*messages,
+            [this, lastT, startTimeUs, messages, contextOwners, dmcExecutors = dmcExecutors,
+                executorCallback](bcos::Error::UniquePtr error,
+                std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs) {
+                auto timeCost = utcSteadyTimeUs() - startTimeUs;
+                DMC_LOG(DEBUG) << LOG_BADGE("Stat")
+                               << "DMCExecute.4:\t <-- Receive batch from executor\t"
+                               << LOG_KV("name", dmcExecutors[0]->name())
+                               << LOG_KV("contractNum", dmcExecutors.size())
+                               << LOG_KV("txNum", messages->size())
+                               << LOG_KV("outputNum", outputs.size())
+                               << LOG_KV("cost", utcTime() - lastT);
+
+                std::vector<std::vector<bcos::protocol::ExecutionMessage::UniquePtr>>
+                    dispatchedOutputs(dmcExecutors.size());
+                for (auto it = outputs.begin(); !error && it != outputs.end(); ++it)
+                {
+                    auto ownerIt = contextOwners->find((*it)->contextID());
+                    if (ownerIt == contextOwners->end())
+                    {
+                        error = BCOS_ERROR_UNIQUE_PTR(SchedulerError::DMCError,
+                            "Receive output of unknown context: " +
+                                std::to_string((*it)->contextID()));
+                        break;
+                    }
+                    dispatchedOutputs[ownerIt->second].push_back(std::move(*it));
+                }
+
+                if (error)
+                {
+                    SCHEDULER_LOG(ERROR) << "Execute transactions batch error: "
+                                         << error->errorMessage();
+                    if (error->errorCode() == bcos::executor::ExecuteError::SCHEDULER_TERM_ID_ERROR)
+                    {
+                        dmcExecutors[0]->triggerSwitch();
+                    }
+                    for (size_t i = 1; i < dmcExecutors.size(); ++i)
+                    {
+                        executorCallback(
+                            BCOS_ERROR_UNIQUE_PTR(error->errorCode(), error->errorMessage()),
+                            DmcExecutor::Status::ERROR);
+                    }
+                    executorCallback(std::move(error), DmcExecutor::Status::ERROR);
+                    return;
+                }
+
+                for (size_t i = 0; i < dmcExecutors.size(); ++i)
+                {
+                    // share the time cost of the batch by the outputs
+                    dmcExecutors[i]->addTimeCost(timeCost * dispatchedOutputs[i].size() /
+                                                 std::max(outputs.size(), (size_t)1));
+                    dmcExecutors[i]->handleExecutiveOutputs(std::move(dispatchedOutputs[i]));
+                    executorCallback(nullptr, DmcExecutor::Status::PAUSED);
+                }
+            });
+    }
+}
+
 void BlockExecutive::scheduleExecutive(ExecutiveState::Ptr executiveState)
 {
     auto to = std::string(executiveState->message->to());
@@ -1460,6 +1664,10 @@ void BlockExecutive::onTxFinish(bcos::protocol::ExecutionMessage::UniquePtr outp
         txGasUsed = 0;
     }
     m_gasUsed += txGasUsed;
+    {
+        std::lock_guard<std::mutex> lock(x_contractGasUsed);
+        m_contractGasUsed[std::string(output->from())] += txGasUsed;
+    }
     auto receipt = m_scheduler->m_blockFactory->receiptFactory()->createReceipt(txGasUsed,
         output->newEVMContractAddress(),
         std::make_shared<std::vector<bcos::protocol::LogEntry>>(output->takeLogEntries()),
@@ -1,8 +1,9 @@
 #pragma once
 
+#include "DmcExecutor.h"
 #include "Executive.h"
 #include "ExecutorManager.h"
-#include "GraphKeyLocks.h"
+#include "ShardedKeyLocks.h"
 #include "bcos-framework/executor/ExecutionMessage.h"
 #include "bcos-framework/executor/ParallelTransactionExecutorInterface.h"
 #include "bcos-framework/protocol/Block.h"
@@ -29,7 +30,6 @@
 namespace bcos::scheduler
 {
 class SchedulerImpl;
-class DmcExecutor;
 class DmcStepRecorder;
 
 class BlockExecutive : public std::enable_shared_from_this<BlockExecutive>
@@ -138,6 +138,9 @@ protected:
     void DMCExecute(
         std::function<void(Error::UniquePtr, protocol::BlockHeader::Ptr, bool)> callback);
     virtual std::shared_ptr<DmcExecutor> registerAndGetDmcExecutor(std::string contractAddress);
+    // send the messages of all dmcExecutors on the same executor in one batch of this round
+    void batchGoDmcExecutors(std::vector<std::string> const& contractAddress,
+        std::function<void(bcos::Error::UniquePtr, DmcExecutor::Status)> executorCallback);
     void scheduleExecutive(ExecutiveState::Ptr executiveState);
     void onTxFinish(bcos::protocol::ExecutionMessage::UniquePtr output);
     void onDmcExecuteFinish(
@@ -149,6 +152,7 @@ protected:
         ContextID contextID, bcos::protocol::Transaction::ConstPtr tx);
     void buildExecutivesFromMetaData();
     void buildExecutivesFromNormalTransaction();
+    bool isDAGMessage(protocol::ExecutionMessage const& _message, uint32_t _attribute) const;
 
     virtual void serialPrepareExecutor();
     bcos::protocol::TransactionsPtr fetchBlockTxsFromTxPool(
@@ -161,8 +165,11 @@ protected:
     std::vector<ExecutiveResult> m_executiveResults;
 
     size_t m_gasUsed = 0;
+    // the gas used by the txs of each contract, the receipts may be generated concurrently
+    std::map<std::string, uint64_t, std::less<>> m_contractGasUsed;
+    std::mutex x_contractGasUsed;
 
-    GraphKeyLocks::Ptr m_keyLocks = std::make_shared<GraphKeyLocks>();
+    ShardedKeyLocks::Ptr m_keyLocks = std::make_shared<ShardedKeyLocks>();
 
     std::chrono::system_clock::time_point m_currentTimePoint;
 
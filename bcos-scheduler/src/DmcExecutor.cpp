@@ -174,26 +174,8 @@ void DmcExecutor::go(std::function<void(bcos::Error::UniquePtr, Status)> callbac
         return;
     }
 
-    assert(f_onSchedulerOut != nullptr);
-
-    auto messages = std::make_shared<std::vector<protocol::ExecutionMessage::UniquePtr>>();
-
-    m_executivePool.forEachAndClear(MessageHint::NEED_SEND,
-        [this, messages](int64_t contextID, ExecutiveState::Ptr executiveState) {
-            auto& message = executiveState->message;
-
-            auto keyLocks = m_keyLocks->getKeyLocksNotHoldingByContext(message->to(), contextID);
-            message->setKeyLocks(std::move(keyLocks));
-            DMC_LOG(TRACE) << " 4.SendToExecutor:\t >>>> " << executiveState->toString()
-                           << " >>>> [" << m_name << "]:" << m_contractAddress
-                           << ", staticCall:" << message->staticCall();
-            messages->push_back(std::move(message));
-
-            return true;
-        });
-
-    // record all send message for debug
-    m_dmcRecorder->recordSends(m_contractAddress, *messages);
+    auto messages = std::make_shared<std::vector<protocol::ExecutionMessage::UniquePtr>>(
+        takeSendMessages());
 
     if (messages->size() == 1 && (*messages)[0]->staticCall())
     {
@@ -229,6 +211,7 @@ void DmcExecutor::go(std::function<void(bcos::Error::UniquePtr, Status)> callbac
     {
         // is transaction
         auto lastT = utcTime();
+        auto startTimeUs = utcSteadyTimeUs();
         DMC_LOG(DEBUG) << LOG_BADGE("Stat") << "DMCExecute.3:\t --> Send to executor\t\t"
                        << LOG_KV("round", m_dmcRecorder->getRound()) << LOG_KV("name", m_name)
                        << LOG_KV("contract", m_contractAddress) << LOG_KV("txNum", messages->size())
@@ -236,8 +219,10 @@ void DmcExecutor::go(std::function<void(bcos::Error::UniquePtr, Status)> callbac
                        << LOG_KV("cost", utcTime() - lastT);
 
         m_executor->dmcExecuteTransactions(m_contractAddress, *messages,
-            [this, lastT, messages, callback = std::move(callback)](bcos::Error::UniquePtr error,
+            [this, lastT, startTimeUs, messages, callback = std::move(callback)](
+                bcos::Error::UniquePtr error,
                 std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs) {
+                addTimeCost(utcSteadyTimeUs() - startTimeUs);
                 // update batch
                 DMC_LOG(DEBUG) << LOG_BADGE("Stat") << "DMCExecute.4:\t <-- Receive from executor\t"
                                << LOG_KV("round", m_dmcRecorder ? m_dmcRecorder->getRound() : 0)
@@ -268,6 +253,44 @@ void DmcExecutor::go(std::function<void(bcos::Error::UniquePtr, Status)> callbac
     }
 }
 
+bool DmcExecutor::needSendStaticCall()
+{
+    size_t count = 0;
+    bool staticCall = false;
+    m_executivePool.forEach(
+        MessageHint::NEED_SEND, [&count, &staticCall](int64_t, ExecutiveState::Ptr executiveState) {
+            ++count;
+            staticCall = executiveState->message->staticCall();
+            return count < 2;
+        });
+    return count == 1 && staticCall;
+}
+
+std::vector<bcos::protocol::ExecutionMessage::UniquePtr> DmcExecutor::takeSendMessages()
+{
+    assert(f_onSchedulerOut != nullptr);
+
+    std::vector<protocol::ExecutionMessage::UniquePtr> messages;
+
+    m_executivePool.forEachAndClear(MessageHint::NEED_SEND,
+        [this, &messages](int64_t contextID, ExecutiveState::Ptr executiveState) {
+            auto& message = executiveState->message;
+
+            auto keyLocks = m_keyLocks->getKeyLocksNotHoldingByContext(message->to(), contextID);
+            message->setKeyLocks(std::move(keyLocks));
+            DMC_LOG(TRACE) << " 4.SendToExecutor:\t >>>> " << executiveState->toString()
+                           << " >>>> [" << m_name << "]:" << m_contractAddress
+                           << ", staticCall:" << message->staticCall();
+            messages.push_back(std::move(message));
+
+            return true;
+        });
+
+    // record all send message for debug
+    m_dmcRecorder->recordSends(m_contractAddress, messages);
+    return messages;
+}
+
 void DmcExecutor::handleCreateMessage(ExecutiveState::Ptr executiveState)
 {
     auto& message = executiveState->message;
@@ -391,6 +414,7 @@ void DmcExecutor::handleExecutiveOutputs(
     std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs)
 {
     m_dmcRecorder->recordReceives(m_contractAddress, outputs);
+    m_cost.txCount += outputs.size();
 
     for (auto& output : outputs)
     {
@@ -410,6 +434,10 @@ void DmcExecutor::handleExecutiveOutputs(
         }
         else
         {
+            if (executiveState->message->type() == protocol::ExecutionMessage::MESSAGE)
+            {
+                ++m_cost.calls[to];
+            }
             m_executivePool.markAs(contextID, MessageHint::NEED_SCHEDULE_OUT);
             scheduleOut(executiveState);
         }
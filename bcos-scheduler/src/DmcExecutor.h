@@ -25,7 +25,7 @@
 #include "Executive.h"
 #include "ExecutivePool.h"
 #include "ExecutorManager.h"
-#include "GraphKeyLocks.h"
+#include "ShardedKeyLocks.h"
 #include <bcos-framework/protocol/Block.h>
 #include <tbb/concurrent_set.h>
 #include <tbb/concurrent_unordered_map.h>
@@ -52,7 +52,7 @@ public:
 
     DmcExecutor(std::string name, std::string contractAddress, bcos::protocol::Block::Ptr block,
         bcos::executor::ParallelTransactionExecutorInterface::Ptr executor,
-        GraphKeyLocks::Ptr keyLocks, bcos::crypto::Hash::Ptr hashImpl,
+        ShardedKeyLocks::Ptr keyLocks, bcos::crypto::Hash::Ptr hashImpl,
         DmcStepRecorder::Ptr dmcRecorder)
       : m_name(name),
         m_contractAddress(contractAddress),
@@ -71,6 +71,24 @@ public:
 
     void go(std::function<void(bcos::Error::UniquePtr, Status)> callback);
     bool hasFinished() { return m_executivePool.empty(); }
+    bool needSend() { return !m_executivePool.empty(MessageHint::NEED_SEND); }
+    // go() sends a single static call message by dmcCall, such a dmcExecutor is never batched
+    bool needSendStaticCall();
+
+    // take the messages of this round instead of go(), so that the messages of the contracts on
+    // the same executor can be sent in one batch, the outputs must be passed back by
+    // handleExecutiveOutputs()
+    std::vector<bcos::protocol::ExecutionMessage::UniquePtr> takeSendMessages();
+    void handleExecutiveOutputs(std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs);
+    bcos::executor::ParallelTransactionExecutorInterface::Ptr const& executor() const
+    {
+        return m_executor;
+    }
+    std::string const& name() const { return m_name; }
+
+    // the execution cost of the contract in this block, for the placement of the contracts
+    ExecutorManager::ContractCost const& cost() const { return m_cost; }
+    void addTimeCost(uint64_t _timeCost) { m_cost.timeCost += _timeCost; }
 
     void scheduleIn(ExecutiveState::Ptr executive);
 
@@ -110,7 +128,6 @@ public:
 
 private:
     MessageHint handleExecutiveMessage(ExecutiveState::Ptr executive);
-    void handleExecutiveOutputs(std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs);
     void scheduleOut(ExecutiveState::Ptr executiveState);
 
     void handleCreateMessage(ExecutiveState::Ptr executive);
@@ -123,10 +140,11 @@ private:
     std::string m_contractAddress;
     bcos::protocol::Block::Ptr m_block;
     bcos::executor::ParallelTransactionExecutorInterface::Ptr m_executor;
-    GraphKeyLocks::Ptr m_keyLocks;
+    ShardedKeyLocks::Ptr m_keyLocks;
     bcos::crypto::Hash::Ptr m_hashImpl;
     DmcStepRecorder::Ptr m_dmcRecorder;
     ExecutivePool m_executivePool;
+    ExecutorManager::ContractCost m_cost;
 
 
     mutable SharedMutex x_concurrentLock;
@@ -33,8 +33,6 @@ void ExecutorManager::addExecutor(
     {
         return;
     }
-
-    m_executorPriorityQueue.emplace(std::move(executorInfo));
 }
 
 bcos::executor::ParallelTransactionExecutorInterface::Ptr ExecutorManager::dispatchExecutor(
@@ -51,15 +49,24 @@ bcos::executor::ParallelTransactionExecutorInterface::Ptr ExecutorManager::dispa
         return executorIt->second->executor;
     }
     UpgradeGuard ul(l);
-    auto executorInfo = m_executorPriorityQueue.top();
-    m_executorPriorityQueue.pop();
+    ExecutorInfo::Ptr executorInfo;
+    for (auto& it : m_name2Executors)
+    {
+        auto& info = it.second;
+        if (!executorInfo ||
+            std::make_tuple(info->load, info->contracts.size(), std::string_view(info->name)) <
+                std::make_tuple(executorInfo->load, executorInfo->contracts.size(),
+                    std::string_view(executorInfo->name)))
+        {
+            executorInfo = info;
+        }
+    }
 
     auto [contractStr, success] = executorInfo->contracts.insert(std::string(contract));
     if (!success)
     {
         BOOST_THROW_EXCEPTION(BCOS_ERROR(-1, "Insert into contracts fail!"));
     }
-    m_executorPriorityQueue.push(executorInfo);
 
     (void)m_contract2ExecutorInfo.emplace(*contractStr, executorInfo);
 
@@ -101,17 +108,212 @@ void ExecutorManager::removeExecutor(const std::string_view& name)
         }
 
         m_name2Executors.erase(it);
+    }
+    else
+    {
+        BOOST_THROW_EXCEPTION(BCOS_ERROR(-1, "Not found executor: " + std::string(name)));
+    }
+}
 
-        m_executorPriorityQueue = std::priority_queue<ExecutorInfo::Ptr,
-            std::vector<ExecutorInfo::Ptr>, ExecutorInfoComp>();
+void ExecutorManager::updateContractCosts(
+    std::map<std::string, ContractCost, std::less<>> const& costs)
+{
+    WriteGuard lock(m_mutex);
+    for (auto& it : m_contractLoads)
+    {
+        auto& load = it.second;
+        load.timeCost *= (1 - LOAD_DECAY_WEIGHT);
+        load.txCount *= (1 - LOAD_DECAY_WEIGHT);
+        load.gasUsed *= (1 - LOAD_DECAY_WEIGHT);
+        load.partnerCalls *= (1 - LOAD_DECAY_WEIGHT);
+    }
 
+    for (auto const& [contract, cost] : costs)
+    {
+        if (cost.txCount == 0 && cost.timeCost == 0 && cost.gasUsed == 0)
+        {
+            continue;
+        }
+        auto loadIt = m_contractLoads.find(contract);
+        if (loadIt == m_contractLoads.end())
+        {
+            loadIt = m_contractLoads.emplace(contract, ContractLoad()).first;
+        }
+        auto& load = loadIt->second;
+        load.timeCost += LOAD_DECAY_WEIGHT * cost.timeCost;
+        load.txCount += LOAD_DECAY_WEIGHT * cost.txCount;
+        load.gasUsed += LOAD_DECAY_WEIGHT * cost.gasUsed;
+
+        auto partnerIt = std::max_element(cost.calls.begin(), cost.calls.end(),
+            [](auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; });
+        if (partnerIt != cost.calls.end())
+        {
+            auto calls = LOAD_DECAY_WEIGHT * partnerIt->second;
+            if (partnerIt->first == load.partner)
+            {
+                load.partnerCalls += calls;
+            }
+            else if (calls > load.partnerCalls)
+            {
+                load.partner = partnerIt->first;
+                load.partnerCalls = calls;
+            }
+        }
+    }
+
+    // forget the contracts not executed for a long time
+    std::erase_if(m_contractLoads, [](auto const& it) {
+        return it.second.timeCost < 1 && it.second.txCount < 0.01 && it.second.gasUsed < 1;
+    });
+    updateExecutorLoads();
+}
+
+size_t ExecutorManager::rebalance()
+{
+    WriteGuard lock(m_mutex);
+    if (m_name2Executors.size() < 2)
+    {
+        return 0;
+    }
+    updateExecutorLoads();
+
+    double totalLoad = 0;
+    for (auto& it : m_name2Executors)
+    {
+        totalLoad += it.second->load;
+    }
+    if (totalLoad <= 0)
+    {
+        return 0;
+    }
+    auto maxLoad = (totalLoad / m_name2Executors.size()) * (1 + IMBALANCE_THRESHOLD);
+
+    auto contractLoad = [this](std::string_view contract) {
+        auto it = m_contractLoads.find(contract);
+        return it == m_contractLoads.end() ? 0.0 : it->second.timeCost;
+    };
+    auto partnerExecutor = [this](std::string_view contract) -> ExecutorInfo::Ptr {
+        auto it = m_contractLoads.find(contract);
+        if (it == m_contractLoads.end() || it->second.partner.empty())
+        {
+            return nullptr;
+        }
+        auto executorIt = m_contract2ExecutorInfo.find(it->second.partner);
+        return executorIt == m_contract2ExecutorInfo.end() ? nullptr : executorIt->second;
+    };
+
+    size_t moved = 0;
+    while (moved < MAX_MOVES_PER_REBALANCE)
+    {
+        ExecutorInfo::Ptr hot;
+        ExecutorInfo::Ptr cold;
         for (auto& it : m_name2Executors)
         {
-            m_executorPriorityQueue.push(it.second);
+            auto& info = it.second;
+            if (!hot || std::tie(info->load, info->name) > std::tie(hot->load, hot->name))
+            {
+                hot = info;
+            }
+            if (!cold || std::tie(info->load, info->name) < std::tie(cold->load, cold->name))
+            {
+                cold = info;
+            }
+        }
+        if (hot->load <= maxLoad)
+        {
+            break;
+        }
+
+        // move the largest contract that lowers the load of the hot executor without making the
+        // target hotter, keep the contracts calling each other on the same executor if possible
+        std::string candidate;
+        double candidateLoad = 0;
+        ExecutorInfo::Ptr target;
+        for (auto keepAffinity : {true, false})
+        {
+            for (auto const& contract : hot->contracts)
+            {
+                auto load = contractLoad(contract);
+                if (load <= candidateLoad || load >= hot->load - cold->load)
+                {
+                    continue;
+                }
+                auto partner = partnerExecutor(contract);
+                if (keepAffinity && partner == hot)
+                {
+                    continue;
+                }
+                auto to = cold;
+                if (partner && partner != hot && partner->load + load <= maxLoad &&
+                    !partner->movedOutContracts.contains(contract))
+                {
+                    to = partner;
+                }
+                if (to->movedOutContracts.contains(contract))
+                {
+                    continue;
+                }
+                candidate = contract;
+                candidateLoad = load;
+                target = to;
+            }
+            if (target)
+            {
+                break;
+            }
+        }
+        if (!target)
+        {
+            break;
         }
+
+        EXECUTOR_MANAGER_LOG(INFO) << "Rebalance contract" << LOG_KV("contract", candidate)
+                                   << LOG_KV("load", candidateLoad) << LOG_KV("from", hot->name)
+                                   << LOG_KV("to", target->name);
+        moveContract(candidate, hot, target);
+        hot->load -= candidateLoad;
+        target->load += candidateLoad;
+        ++moved;
     }
-    else
+
+    for (auto& it : m_name2Executors)
     {
-        BOOST_THROW_EXCEPTION(BCOS_ERROR(-1, "Not found executor: " + std::string(name)));
+        auto& info = it.second;
+        EXECUTOR_MANAGER_LOG(INFO) << LOG_BADGE("Stat") << "Executor utilization"
+                                   << LOG_KV("name", info->name)
+                                   << LOG_KV("contracts", info->contracts.size())
+                                   << LOG_KV("load(us)", (int64_t)info->load)
+                                   << LOG_KV("share", info->load / totalLoad);
     }
-}
\ No newline at end of file
+    return moved;
+}
+
+void ExecutorManager::updateExecutorLoads()
+{
+    for (auto& it : m_name2Executors)
+    {
+        auto& info = it.second;
+        info->load = 0;
+        for (auto const& contract : info->contracts)
+        {
+            auto loadIt = m_contractLoads.find(contract);
+            if (loadIt != m_contractLoads.end())
+            {
+                info->load += loadIt->second.timeCost;
+            }
+        }
+    }
+}
+
+void ExecutorManager::moveContract(
+    std::string_view contract, ExecutorInfo::Ptr const& from, ExecutorInfo::Ptr const& to)
+{
+    // the key of m_contract2ExecutorInfo refers to the contract in the contracts of the executor
+    std::string contractStr(contract);
+    m_contract2ExecutorInfo.unsafe_erase(std::string_view(contractStr));
+    from->contracts.erase(contractStr);
+    from->movedOutContracts.insert(contractStr);
+    auto [it, success] = to->contracts.insert(std::move(contractStr));
+    boost::ignore_unused(success);
+    (void)m_contract2ExecutorInfo.emplace(*it, to);
+}
@@ -10,7 +10,8 @@
 #include <boost/range/any_range.hpp>
 #include <functional>
 #include <iterator>
-#include <queue>
+#include <map>
+#include <set>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
@@ -30,9 +31,26 @@ public:
     void addExecutor(
         std::string name, bcos::executor::ParallelTransactionExecutorInterface::Ptr executor);
 
+    // dispatch a new contract to the executor with the least load, then the least contracts
     bcos::executor::ParallelTransactionExecutorInterface::Ptr dispatchExecutor(
         const std::string_view& contract);
 
+    // the execution cost of a contract observed in a block
+    struct ContractCost
+    {
+        uint64_t txCount = 0;   // messages executed by the contract
+        uint64_t gasUsed = 0;   // gas used by the transactions sent to the contract
+        uint64_t timeCost = 0;  // wall time of the executor in microseconds
+        std::map<std::string, uint64_t, std::less<>> calls;  // calls to other contracts
+    };
+
+    // decay the loads of the contracts with the costs of a newly executed block
+    void updateContractCosts(std::map<std::string, ContractCost, std::less<>> const& costs);
+
+    // move hot contracts from the overloaded executors to the others, return the moved count
+    // Note: must be called when no block is executing or waiting to commit
+    size_t rebalance();
+
 
     void removeExecutor(const std::string_view& name);
 
@@ -75,8 +93,7 @@ public:
         WriteGuard lock(m_mutex);
         m_contract2ExecutorInfo.clear();
         m_name2Executors.clear();
-        m_executorPriorityQueue = std::priority_queue<ExecutorInfo::Ptr,
-            std::vector<ExecutorInfo::Ptr>, ExecutorInfoComp>();
+        m_contractLoads.clear();
     };
 
     virtual void stop()
@@ -112,6 +129,11 @@ public:
         std::string name;
         bcos::executor::ParallelTransactionExecutorInterface::Ptr executor;
         std::set<std::string> contracts;
+        // the decayed wall time of the contracts
+        double load = 0;
+        // a contract is never moved back to an executor it was moved out from, the key pages and
+        // the cached storage of the executor may still hold the old state of the contract
+        std::set<std::string, std::less<>> movedOutContracts;
     };
 
     ExecutorInfo::Ptr getExecutorInfo(const std::string_view& contract);
@@ -120,21 +142,32 @@ public:
         return m_name2Executors[name];
     };
 
+    // the load of an executor over the average that triggers rebalancing
+    constexpr static double IMBALANCE_THRESHOLD = 0.25;
+    constexpr static size_t MAX_MOVES_PER_REBALANCE = 4;
+    // the weight of the newest block in the decayed loads
+    constexpr static double LOAD_DECAY_WEIGHT = 0.3;
+
 private:
-    struct ExecutorInfoComp
+    struct ContractLoad
     {
-        bool operator()(const ExecutorInfo::Ptr& lhs, const ExecutorInfo::Ptr& rhs) const
-        {
-            return lhs->contracts.size() > rhs->contracts.size();
-        }
+        double timeCost = 0;
+        double txCount = 0;
+        double gasUsed = 0;
+        // the contract called most
+        std::string partner;
+        double partnerCalls = 0;
     };
 
+    void updateExecutorLoads();
+    void moveContract(std::string_view contract, ExecutorInfo::Ptr const& from,
+        ExecutorInfo::Ptr const& to);
+
     tbb::concurrent_unordered_map<std::string_view, ExecutorInfo::Ptr, std::hash<std::string_view>>
         m_contract2ExecutorInfo;
     std::unordered_map<std::string_view, ExecutorInfo::Ptr, std::hash<std::string_view>>
         m_name2Executors;
-    std::priority_queue<ExecutorInfo::Ptr, std::vector<ExecutorInfo::Ptr>, ExecutorInfoComp>
-        m_executorPriorityQueue;
+    std::map<std::string, ContractLoad, std::less<>> m_contractLoads;
     mutable SharedMutex m_mutex;
 
     bcos::executor::ParallelTransactionExecutorInterface::Ptr const& executorView(
@@ -36,6 +36,7 @@ public:
             m_storage, m_executionMessageFactory, m_blockFactory, m_txPool,
             m_transactionSubmitResultFactory, m_hashImpl, m_isAuthCheck, m_isWasm,
             m_isSerialExecute, schedulerTermId);
+        scheduler->setOccExecute(m_isOccExecute);
         scheduler->fetchGasLimit();
 
         scheduler->registerBlockNumberReceiver(m_blockNumberReceiver);
@@ -58,6 +59,8 @@ public:
 
     bcos::ledger::LedgerInterface::Ptr getLedger() { return m_ledger; }
 
+    void setOccExecute(bool _isOccExecute) { m_isOccExecute = _isOccExecute; }
+
 private:
     ExecutorManager::Ptr m_executorManager;
     bcos::ledger::LedgerInterface::Ptr m_ledger;
@@ -70,6 +73,7 @@ private:
     bool m_isAuthCheck;
     bool m_isWasm;
     bool m_isSerialExecute;
+    bool m_isOccExecute = false;
 
     std::function<void(protocol::BlockNumber blockNumber)> m_blockNumberReceiver;
     std::function<void(bcos::protocol::BlockNumber, bcos::protocol::TransactionSubmitResultsPtr,
@@ -507,6 +507,18 @@ void SchedulerImpl::commitBlock(bcos::protocol::BlockHeader::Ptr header,
                         << "Remove committed block after commit: " << number << " success";
                 }
                 removeAllOldPreparedBlock(number);
+
+                // move the contracts between the executors only when no block is in flight
+                if (m_blocks && m_blocks->empty() &&
+                    ++m_committedSinceRebalance >= REBALANCE_PERIOD)
+                {
+                    bcos::ReadGuard preparedLock(x_preparedBlockMutex);
+                    if (m_preparedBlocks.empty())
+                    {
+                        m_committedSinceRebalance = 0;
+                        m_executorManager->rebalance();
+                    }
+                }
             }
 
             asyncGetLedgerConfig([this, startTime, commitLock = std::move(commitLock),
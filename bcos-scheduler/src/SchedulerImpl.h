@@ -107,6 +107,10 @@ public:
 
     ExecutorManager::Ptr executorManager() { return m_executorManager; }
 
+    // send all the transactions except deployments to the executors as dag transactions, the
+    // executors execute the ones without conflict fields optimistically
+    void setOccExecute(bool _isOccExecute) { m_isOccExecute = _isOccExecute; }
+
     inline void fetchGasLimit(protocol::BlockNumber _number = -1)
     {
         SCHEDULER_LOG(INFO) << LOG_DESC("fetch gas limit from storage before execute block")
@@ -246,6 +250,7 @@ private:
     bool m_isAuthCheck = false;
     bool m_isWasm = false;
     bool m_isSerialExecute = false;
+    bool m_isOccExecute = false;
 
     std::function<void(protocol::BlockNumber blockNumber)> m_blockNumberReceiver;
     std::function<void(bcos::protocol::BlockNumber, bcos::protocol::TransactionSubmitResultsPtr,
@@ -253,6 +258,10 @@ private:
         m_txNotifier;
     uint64_t m_lastExecuteFinishTime = 0;
 
+    // rebalance the executors every REBALANCE_PERIOD committed blocks, guarded by m_blocksMutex
+    constexpr static size_t REBALANCE_PERIOD = 10;
+    size_t m_committedSinceRebalance = 0;
+
     int64_t m_schedulerTermId;
 
     bool m_isRunning = false;
@@ -0,0 +1,335 @@
+#include "ShardedKeyLocks.h"
+#include "Common.h"
+#include <bcos-utilities/DataConvertUtility.h>
+#include <bcos-utilities/Error.h>
+#include <boost/format.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <unordered_set>
+
+using namespace bcos::scheduler;
+
+namespace
+{
+enum Color : int
+{
+    WHITE = 0,
+    GRAY,
+    BLACK,
+};
+}  // namespace
+
+ShardedKeyLocks::ShardedKeyLocks(size_t _shardsNum) : m_shards(std::max(_shardsNum, (size_t)1))
+{}
+
+bool ShardedKeyLocks::batchAcquireKeyLock(
+    std::string_view contract, gsl::span<std::string const> keys, ContextID contextID, Seq seq)
+{
+    if (!keys.empty())
+    {
+        for (auto& it : keys)
+        {
+            if (!acquireKeyLock(contract, it, contextID, seq))
+            {
+                auto message = (boost::format("Batch acquire lock failed, contract: %s"
+                                              ", key: %s, contextID: %ld, seq: %ld") %
+                                contract % toHex(it) % contextID % seq)
+                                   .str();
+                SCHEDULER_LOG(ERROR) << message;
+                BOOST_THROW_EXCEPTION(BCOS_ERROR(UnexpectedKeyLockError, message));
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ShardedKeyLocks::acquireKeyLock(
+    std::string_view contract, std::string_view key, int64_t contextID, int64_t seq)
+{
+    std::lock_guard<std::mutex> writerLock(x_writer);
+    auto& keyShard = shard(contract);
+    bcos::WriteGuard shardLock(keyShard.mutex);
+
+    auto contractIt = keyShard.contracts.find(contract);
+    if (contractIt == keyShard.contracts.end())
+    {
+        contractIt = keyShard.contracts.emplace(std::string(contract), ContractKeyLocks()).first;
+    }
+    auto& keyLocks = contractIt->second;
+    auto keyIt = keyLocks.lower_bound(key);
+    if (keyIt == keyLocks.end() || keyIt->first != key)
+    {
+        keyIt = keyLocks.emplace_hint(keyIt, std::string(key), KeyLockEntry());
+    }
+    auto& entry = keyIt->second;
+    auto& contextLocks = m_contexts[contextID];
+
+    if (entry.held() && entry.holder != contextID)
+    {
+        KEY_LOCK_LOG(TRACE) << boost::format(
+                                   "Acquire key lock failed, request: [%s, %s, %ld, %ld] "
+                                   "exists: [%ld]") %
+                                   contract % toHex(key) % contextID % seq % entry.holder;
+
+        // Key lock holding by another context
+        auto wait = std::make_tuple(contextID, seq);
+        if (std::find(entry.waiters.begin(), entry.waiters.end(), wait) == entry.waiters.end())
+        {
+            entry.waiters.emplace_back(wait);
+            contextLocks.push_back({contractIt->first, keyIt->first, &entry, seq, true});
+            addWaitEdge(contextID, entry.holder);
+        }
+        KEY_LOCK_LOG(TRACE) << " [[" << std::string(contract) << ":" << toHex(key) << "]]  -> "
+                            << contextID << " | " << seq;
+        return false;
+    }
+
+    // Remove all wait of the context
+    auto removed = std::erase_if(
+        entry.waiters, [contextID](auto const& wait) { return std::get<0>(wait) == contextID; });
+    std::erase_if(contextLocks,
+        [&entry](ContextLock const& lock) { return lock.waiting && lock.entry == &entry; });
+    m_needRecheck |= m_mayHaveCycle && removed > 0;
+
+    auto newHolder = !entry.held();
+    entry.holder = contextID;
+    if (std::find(entry.holdSeqs.begin(), entry.holdSeqs.end(), seq) == entry.holdSeqs.end())
+    {
+        entry.holdSeqs.push_back(seq);
+        contextLocks.push_back({contractIt->first, keyIt->first, &entry, seq, false});
+    }
+    if (newHolder)
+    {
+        // the contexts still waiting for the key now wait for the new holder
+        for (auto const& [waiter, waitSeq] : entry.waiters)
+        {
+            addWaitEdge(waiter, contextID);
+        }
+    }
+    KEY_LOCK_LOG(TRACE) << " [" << std::string(contract) << ":" << toHex(key) << "]  -> "
+                        << contextID << " | " << seq;
+
+    SCHEDULER_LOG(TRACE) << "Acquire key lock success, contract: " << contract << " key: " << key
+                         << " contextID: " << contextID << " seq: " << seq;
+
+    return true;
+}
+
+std::vector<std::string> ShardedKeyLocks::getKeyLocksNotHoldingByContext(
+    std::string_view contract, int64_t excludeContextID) const
+{
+    std::vector<std::string> keyLocks;
+
+    auto const& keyShard = shard(contract);
+    bcos::ReadGuard shardLock(keyShard.mutex);
+    auto contractIt = keyShard.contracts.find(contract);
+    if (contractIt == keyShard.contracts.end())
+    {
+        return keyLocks;
+    }
+    // the keys are ordered and unique in the map
+    for (auto const& [key, entry] : contractIt->second)
+    {
+        if (entry.held() && entry.holder != excludeContextID)
+        {
+            keyLocks.emplace_back(key);
+        }
+    }
+
+    return keyLocks;
+}
+
+void ShardedKeyLocks::releaseKeyLocks(int64_t contextID, int64_t seq)
+{
+    std::lock_guard<std::mutex> writerLock(x_writer);
+    auto contextIt = m_contexts.find(contextID);
+    if (contextIt == m_contexts.end())
+    {
+        return;
+    }
+
+    SCHEDULER_LOG(TRACE) << "Release key lock, contextID: " << contextID << " seq: " << seq;
+
+    KEY_LOCK_LOG(TRACE) << " [*****] -> " << contextID << " | " << seq;
+    auto& contextLocks = contextIt->second;
+    std::vector<ContextLock> remainLocks;
+    remainLocks.reserve(contextLocks.size());
+    for (auto const& lock : contextLocks)
+    {
+        if (lock.seq != seq)
+        {
+            remainLocks.push_back(lock);
+            continue;
+        }
+        if (bcos::LogLevel::TRACE >= bcos::c_fileLogLevel)
+        {
+            SCHEDULER_LOG(TRACE) << "Releasing key lock, contract: " << lock.contract
+                                 << " key: " << bcos::toHexString(lock.key);
+        }
+
+        auto& keyShard = shard(lock.contract);
+        bcos::WriteGuard shardLock(keyShard.mutex);
+        auto& entry = *lock.entry;
+        if (lock.waiting)
+        {
+            std::erase(entry.waiters, std::make_tuple(contextID, seq));
+        }
+        else
+        {
+            std::erase(entry.holdSeqs, seq);
+        }
+        if (entry.empty())
+        {
+            // no context refers to the key, the views of the lock are invalid after erasing
+            auto contractIt = keyShard.contracts.find(lock.contract);
+            contractIt->second.erase(contractIt->second.find(lock.key));
+            if (contractIt->second.empty())
+            {
+                keyShard.contracts.erase(contractIt);
+            }
+        }
+    }
+
+    // releasing only removes wait edges, the cycles may be broken but never created
+    m_needRecheck |= m_mayHaveCycle && remainLocks.size() != contextLocks.size();
+    if (remainLocks.empty())
+    {
+        m_contexts.erase(contextIt);
+    }
+    else
+    {
+        contextLocks.swap(remainLocks);
+    }
+}
+
+bool ShardedKeyLocks::detectDeadLock(ContextID contextID)
+{
+    std::lock_guard<std::mutex> writerLock(x_writer);
+    auto contextIt = m_contexts.find(contextID);
+    if (contextIt == m_contexts.end())
+    {
+        // No context, may be removed
+        return false;
+    }
+
+    if (std::none_of(contextIt->second.begin(), contextIt->second.end(),
+            [](ContextLock const& lock) { return !lock.waiting; }))
+    {
+        // Not holding key lock
+        return false;
+    }
+
+    if (m_needRecheck)
+    {
+        m_needRecheck = false;
+        std::unordered_map<ContextID, int> colors;
+        m_mayHaveCycle = std::any_of(m_contexts.begin(), m_contexts.end(), [&](auto const& it) {
+            return colors[it.first] == WHITE && searchCycle(it.first, colors);
+        });
+    }
+    if (!m_mayHaveCycle)
+    {
+        return false;
+    }
+
+    std::unordered_map<ContextID, int> colors;
+    auto hasDeadLock = searchCycle(contextID, colors);
+    if (hasDeadLock)
+    {
+        SCHEDULER_LOG(TRACE) << "Detected dead lock from context: " << contextID;
+    }
+    return hasDeadLock;
+}
+
+void ShardedKeyLocks::addWaitEdge(ContextID waiter, ContextID holder)
+{
+    // the graph was acyclic before the edge, a cycle exists only if it goes through the edge
+    if (!m_mayHaveCycle && reachable(holder, waiter))
+    {
+        KEY_LOCK_LOG(TRACE) << "Wait edge closes a cycle: " << waiter << " -> " << holder;
+        m_mayHaveCycle = true;
+    }
+}
+
+template <class Visitor>
+void ShardedKeyLocks::forEachWaitFor(ContextID contextID, Visitor&& visitor) const
+{
+    auto contextIt = m_contexts.find(contextID);
+    if (contextIt == m_contexts.end())
+    {
+        return;
+    }
+    for (auto const& lock : contextIt->second)
+    {
+        if (lock.waiting && lock.entry->held())
+        {
+            visitor(lock.entry->holder);
+        }
+    }
+}
+
+bool ShardedKeyLocks::reachable(ContextID from, ContextID to) const
+{
+    std::unordered_set<ContextID> visited{from};
+    std::vector<ContextID> pending{from};
+    while (!pending.empty())
+    {
+        auto current = pending.back();
+        pending.pop_back();
+        if (current == to)
+        {
+            return true;
+        }
+        forEachWaitFor(current, [&](ContextID next) {
+            if (visited.insert(next).second)
+            {
+                pending.push_back(next);
+            }
+        });
+    }
+    return false;
+}
+
+bool ShardedKeyLocks::searchCycle(
+    ContextID contextID, std::unordered_map<ContextID, int>& colors) const
+{
+    struct Frame
+    {
+        ContextID contextID;
+        std::vector<ContextID> next;
+        size_t index = 0;
+    };
+    auto makeFrame = [this](ContextID id) {
+        Frame frame{id, {}};
+        forEachWaitFor(id, [&frame](ContextID next) { frame.next.push_back(next); });
+        return frame;
+    };
+
+    std::vector<Frame> stack;
+    colors[contextID] = GRAY;
+    stack.push_back(makeFrame(contextID));
+    while (!stack.empty())
+    {
+        auto& frame = stack.back();
+        if (frame.index == frame.next.size())
+        {
+            colors[frame.contextID] = BLACK;
+            stack.pop_back();
+            continue;
+        }
+        auto next = frame.next[frame.index++];
+        auto& color = colors[next];
+        if (color == GRAY)
+        {
+            // back edge
+            return true;
+        }
+        if (color == WHITE)
+        {
+            color = GRAY;
+            stack.push_back(makeFrame(next));
+        }
+    }
+    return false;
+}
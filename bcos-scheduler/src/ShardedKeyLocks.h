@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Common.h"
+#include <bcos-utilities/Common.h>
+#include <gsl/span>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#define KEY_LOCK_LOG(LEVEL) BCOS_LOG(LEVEL) << LOG_BADGE("SCHEDULER") << LOG_BADGE("KEY_LOCK")
+// #define KEY_LOCK_LOG(LEVEL) std::cout << LOG_BADGE("KEY_LOCK")
+
+namespace bcos::scheduler
+{
+// Key locks of the DMC scheduling, hashed by contract into shards. Every (contract, key) keeps its
+// holding context and the contexts waiting for it, every context keeps the list of locks it holds
+// or waits for, so releasing a context only touches its own locks.
+// The wait-for graph between contexts is checked for cycles incrementally: only a new wait edge
+// can close a cycle, so dead lock detection is a no-op until some new wait edge closed one.
+// Acquiring, releasing and detecting are serialized, getKeyLocksNotHoldingByContext only locks
+// the shard of the contract and can run concurrently.
+class ShardedKeyLocks
+{
+public:
+    using Ptr = std::shared_ptr<ShardedKeyLocks>;
+
+    explicit ShardedKeyLocks(size_t _shardsNum = 16);
+    ShardedKeyLocks(const ShardedKeyLocks&) = delete;
+    ShardedKeyLocks(ShardedKeyLocks&&) = delete;
+    ShardedKeyLocks& operator=(const ShardedKeyLocks&) = delete;
+    ShardedKeyLocks& operator=(ShardedKeyLocks&&) = delete;
+
+    bool batchAcquireKeyLock(std::string_view contract, gsl::span<std::string const> keyLocks,
+        ContextID contextID, Seq seq);
+
+    bool acquireKeyLock(
+        std::string_view contract, std::string_view key, ContextID contextID, Seq seq);
+
+    // the keys of the contract held by other contexts, in ascending order
+    std::vector<std::string> getKeyLocksNotHoldingByContext(
+        std::string_view contract, ContextID excludeContextID) const;
+
+    void releaseKeyLocks(ContextID contextID, Seq seq);
+
+    // whether the context holds a key lock and a wait cycle is reachable from it
+    bool detectDeadLock(ContextID contextID);
+
+private:
+    struct KeyLockEntry
+    {
+        ContextID holder = 0;
+        std::vector<Seq> holdSeqs;  // not held if empty
+        std::vector<std::tuple<ContextID, Seq>> waiters;
+
+        bool held() const { return !holdSeqs.empty(); }
+        bool empty() const { return holdSeqs.empty() && waiters.empty(); }
+    };
+    using ContractKeyLocks = std::map<std::string, KeyLockEntry, std::less<>>;
+
+    struct Shard
+    {
+        mutable bcos::SharedMutex mutex;
+        std::map<std::string, ContractKeyLocks, std::less<>> contracts;
+    };
+
+    // the views point to the keys of the shard maps, which are stable until the entry is erased
+    struct ContextLock
+    {
+        std::string_view contract;
+        std::string_view key;
+        KeyLockEntry* entry;
+        Seq seq;
+        bool waiting;
+    };
+
+    Shard& shard(std::string_view contract)
+    {
+        return m_shards[std::hash<std::string_view>()(contract) % m_shards.size()];
+    }
+    Shard const& shard(std::string_view contract) const
+    {
+        return m_shards[std::hash<std::string_view>()(contract) % m_shards.size()];
+    }
+
+    void addWaitEdge(ContextID waiter, ContextID holder);
+    template <class Visitor>
+    void forEachWaitFor(ContextID contextID, Visitor&& visitor) const;
+    bool reachable(ContextID from, ContextID to) const;
+    // depth first search from the context, the colors are shared between the searches
+    bool searchCycle(ContextID contextID, std::unordered_map<ContextID, int>& colors) const;
+
+    std::vector<Shard> m_shards;
+    std::unordered_map<ContextID, std::vector<ContextLock>> m_contexts;
+
+    // true if some new wait edge closed a cycle, false means the wait-for graph is acyclic
+    bool m_mayHaveCycle = false;
+    // some locks have been released since the last check, the cycles may be broken
+    bool m_needRecheck = false;
+    std::mutex x_writer;
+};
+
+}  // namespace bcos::scheduler
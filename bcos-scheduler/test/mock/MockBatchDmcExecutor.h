@@ -0,0 +1,46 @@
+#pragma once
+#include "MockDmcExecutor.h"
+#include <algorithm>
+#include <set>
+
+
+namespace bcos::test
+{
+// records the batches sent by the scheduler, the outputs of a batch are returned in the reverse
+// order or the whole batch fails
+class MockBatchDmcExecutor : public MockDmcExecutor
+{
+public:
+    MockBatchDmcExecutor(const std::string& name, bool batchError = false)
+      : MockDmcExecutor(name), m_batchError(batchError)
+    {}
+
+    void batchDmcExecuteTransactions(gsl::span<bcos::protocol::ExecutionMessage::UniquePtr> inputs,
+        std::function<void(
+            bcos::Error::UniquePtr, std::vector<bcos::protocol::ExecutionMessage::UniquePtr>)>
+            callback) override
+    {
+        std::set<std::string> contracts;
+        for (auto& input : inputs)
+        {
+            contracts.emplace(input->to());
+        }
+        m_batchContracts.push_back(std::move(contracts));
+
+        if (m_batchError)
+        {
+            callback(BCOS_ERROR_UNIQUE_PTR(ExecuteError::EXECUTE_ERROR, "batch is error"), {});
+            return;
+        }
+        ParallelTransactionExecutorInterface::batchDmcExecuteTransactions(inputs,
+            [callback = std::move(callback)](bcos::Error::UniquePtr error,
+                std::vector<bcos::protocol::ExecutionMessage::UniquePtr> outputs) {
+                std::reverse(outputs.begin(), outputs.end());
+                callback(std::move(error), std::move(outputs));
+            });
+    }
+
+    bool m_batchError;
+    std::vector<std::set<std::string>> m_batchContracts;
+};
+}  // namespace bcos::test
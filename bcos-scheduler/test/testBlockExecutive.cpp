@@ -13,6 +13,7 @@
 #include "bcos-table/src/StateStorage.h"
 #include "bcos-table/src/StateStorageInterface.h"
 #include "mock/MockBlockExecutive.h"
+#include "mock/MockBatchDmcExecutor.h"
 #include "mock/MockBlockExecutiveFactory.h"
 #include "mock/MockDmcExecutor.h"
 #include "mock/MockExecutor.h"
@@ -514,5 +515,74 @@ BOOST_AUTO_TEST_CASE(executeWithSystemError)
         });
     BOOST_CHECK(errorFlag);
 }
+
+BOOST_AUTO_TEST_CASE(batchDmcExecute)
+{
+    SCHEDULER_LOG(DEBUG) << "----------batchDmcExecute----------------";
+    auto block = blockFactory->createBlock();
+    block->blockHeader()->setNumber(101);
+    auto executor1 = std::make_shared<MockBatchDmcExecutor>("executor1");
+    executorManager->addExecutor("executor1", executor1);
+
+    // the transactions of 5 contracts on the same executor are sent in one batch
+    for (size_t i = 0; i < 10; i++)
+    {
+        std::string inputStr = "hello world!";
+        bytes input(inputStr.begin(), inputStr.end());
+        auto tx = transactionFactory->createTransaction(20,
+            "contract" + boost::lexical_cast<std::string>(i % 5), input, i, 200, "chainID",
+            "groupID", 400, keyPair);
+        block->appendTransaction(tx);
+    }
+    auto blockExecutive = std::make_shared<bcos::scheduler::BlockExecutive>(
+        block, scheduler.get(), 0, transactionSubmitResultFactory, false, blockFactory, txPool);
+
+    size_t callbackTimes = 0;
+    blockExecutive->asyncExecute(
+        [&](Error::UniquePtr error, protocol::BlockHeader::Ptr header, bool) {
+            ++callbackTimes;
+            BOOST_CHECK(!error);
+            BOOST_CHECK(header);
+        });
+    BOOST_CHECK_EQUAL(callbackTimes, 1);
+    BOOST_REQUIRE_EQUAL(executor1->m_batchContracts.size(), 1);
+    BOOST_CHECK_EQUAL(executor1->m_batchContracts[0].size(), 5);
+    // the reversed outputs are dispatched back to their contracts by the context id
+    BOOST_CHECK_EQUAL(block->receiptsSize(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(batchDmcExecuteWithError)
+{
+    SCHEDULER_LOG(DEBUG) << "----------batchDmcExecuteWithError----------------";
+    auto block = blockFactory->createBlock();
+    block->blockHeader()->setNumber(102);
+    auto executor1 = std::make_shared<MockBatchDmcExecutor>("executor1", true);
+    executorManager->addExecutor("executor1", executor1);
+
+    for (size_t i = 0; i < 5; i++)
+    {
+        std::string inputStr = "hello world!";
+        bytes input(inputStr.begin(), inputStr.end());
+        auto tx = transactionFactory->createTransaction(20,
+            "contract" + boost::lexical_cast<std::string>(i), input, i, 200, "chainID", "groupID",
+            400, keyPair);
+        block->appendTransaction(tx);
+    }
+    auto blockExecutive = std::make_shared<bcos::scheduler::BlockExecutive>(
+        block, scheduler.get(), 0, transactionSubmitResultFactory, false, blockFactory, txPool);
+
+    // the error of the batch is reported by every contract of it, the block fails once
+    size_t callbackTimes = 0;
+    blockExecutive->asyncExecute(
+        [&](Error::UniquePtr error, protocol::BlockHeader::Ptr header, bool) {
+            ++callbackTimes;
+            BOOST_REQUIRE(error);
+            BOOST_CHECK_EQUAL(error->errorCode(), ExecuteError::EXECUTE_ERROR);
+            BOOST_CHECK(!header);
+        });
+    BOOST_CHECK_EQUAL(callbackTimes, 1);
+    BOOST_REQUIRE_EQUAL(executor1->m_batchContracts.size(), 1);
+    BOOST_CHECK_EQUAL(executor1->m_batchContracts[0].size(), 5);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace bcos::test
\ No newline at end of file
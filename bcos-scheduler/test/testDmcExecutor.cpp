@@ -10,7 +10,7 @@
 #include "bcos-protocol/testutils/protocol/FakeBlockHeader.h"
 #include "bcos-scheduler/src/DmcExecutor.h"
 #include "bcos-scheduler/src/DmcStepRecorder.h"
-#include "bcos-scheduler/src/GraphKeyLocks.h"
+#include "bcos-scheduler/src/ShardedKeyLocks.h"
 #include "mock/MockDmcExecutor.h"
 #include <bcos-crypto/hash/Keccak256.h>
 #include <bcos-crypto/hash/SM3.h>
@@ -40,12 +40,12 @@ struct DmcExecutorFixture
         cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
         blockFactory = createBlockFactory(cryptoSuite);
         executor1 = std::make_shared<MockDmcExecutor>("executor1");
-        keyLocks = std::make_shared<GraphKeyLocks>();
+        keyLocks = std::make_shared<ShardedKeyLocks>();
         dmcRecorder = std::make_shared<DmcStepRecorder>();
     }
     bcos::scheduler::DmcExecutor::Ptr dmcExecutor;
     std::shared_ptr<MockDmcExecutor> executor1;
-    bcos::scheduler::GraphKeyLocks::Ptr keyLocks;
+    bcos::scheduler::ShardedKeyLocks::Ptr keyLocks;
     bcos::scheduler::DmcStepRecorder::Ptr dmcRecorder;
     CryptoSuite::Ptr cryptoSuite = nullptr;
     bcos::protocol::BlockFactory::Ptr blockFactory;
@@ -174,5 +174,88 @@ BOOST_AUTO_TEST_CASE(remove)
     BOOST_CHECK_THROW(executorManager->removeExecutor("2"), bcos::Exception);
 }
 
+BOOST_AUTO_TEST_CASE(rebalance)
+{
+    BOOST_CHECK_NO_THROW(
+        executorManager->addExecutor("1", std::make_shared<MockParallelExecutor>("1")));
+    BOOST_CHECK_NO_THROW(
+        executorManager->addExecutor("2", std::make_shared<MockParallelExecutor>("2")));
+
+    auto executorName = [this](std::string_view contract) {
+        return std::dynamic_pointer_cast<MockParallelExecutor>(
+            executorManager->dispatchExecutor(contract))
+            ->name();
+    };
+    for (auto contract : {"a", "b", "c", "d"})
+    {
+        executorManager->dispatchExecutor(contract);
+    }
+    BOOST_CHECK_EQUAL(executorName("a"), "1");
+    BOOST_CHECK_EQUAL(executorName("b"), "2");
+    BOOST_CHECK_EQUAL(executorName("c"), "1");
+    BOOST_CHECK_EQUAL(executorName("d"), "2");
+
+    // the hot contracts a and c are on the same executor
+    std::map<std::string, scheduler::ExecutorManager::ContractCost, std::less<>> costs;
+    costs["a"].timeCost = 1000;
+    costs["b"].timeCost = 10;
+    costs["c"].timeCost = 1000;
+    costs["d"].timeCost = 10;
+    executorManager->updateContractCosts(costs);
+    BOOST_CHECK_EQUAL(executorManager->rebalance(), 1);
+    BOOST_CHECK_EQUAL(executorName("a"), "2");
+    BOOST_CHECK_EQUAL(executorName("c"), "1");
+
+    // balanced
+    BOOST_CHECK_EQUAL(executorManager->rebalance(), 0);
+
+    // a is never moved back to the executor it was moved out from
+    costs.clear();
+    costs["b"].timeCost = 3000;
+    costs["d"].timeCost = 3000;
+    executorManager->updateContractCosts(costs);
+    BOOST_CHECK_EQUAL(executorManager->rebalance(), 1);
+    BOOST_CHECK_EQUAL(executorName("a"), "2");
+    BOOST_CHECK_EQUAL(executorName("b"), "1");
+}
+
+BOOST_AUTO_TEST_CASE(rebalanceNeverMoveBack)
+{
+    BOOST_CHECK_NO_THROW(
+        executorManager->addExecutor("1", std::make_shared<MockParallelExecutor>("1")));
+    BOOST_CHECK_NO_THROW(
+        executorManager->addExecutor("2", std::make_shared<MockParallelExecutor>("2")));
+
+    auto executorName = [this](std::string_view contract) {
+        return std::dynamic_pointer_cast<MockParallelExecutor>(
+            executorManager->dispatchExecutor(contract))
+            ->name();
+    };
+    for (auto contract : {"a", "d", "c"})
+    {
+        executorManager->dispatchExecutor(contract);
+    }
+    std::map<std::string, scheduler::ExecutorManager::ContractCost, std::less<>> costs;
+    costs["a"].timeCost = 1000;
+    costs["c"].timeCost = 1000;
+    executorManager->updateContractCosts(costs);
+    BOOST_CHECK_EQUAL(executorManager->rebalance(), 1);
+    BOOST_CHECK_EQUAL(executorName("a"), "2");
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        BOOST_CHECK_EQUAL(executorManager->rebalance(), 0);
+    }
+
+    // a is not moved back to the executor it was moved out from long ago, d is moved instead
+    costs.clear();
+    costs["a"].timeCost = 10000;
+    costs["d"].timeCost = 1000;
+    executorManager->updateContractCosts(costs);
+    BOOST_CHECK_EQUAL(executorManager->rebalance(), 1);
+    BOOST_CHECK_EQUAL(executorName("a"), "2");
+    BOOST_CHECK_EQUAL(executorName("d"), "1");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace bcos::test
\ No newline at end of file
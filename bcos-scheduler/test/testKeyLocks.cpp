@@ -1,4 +1,4 @@
-#include "GraphKeyLocks.h"
+#include "ShardedKeyLocks.h"
 #include "mock/MockExecutor.h"
 #include <bcos-utilities/Common.h>
 #include <boost/lexical_cast.hpp>
@@ -12,7 +12,7 @@ struct KeyLocksFixture
 {
     KeyLocksFixture() {}
 
-    scheduler::GraphKeyLocks keyLocks;
+    scheduler::ShardedKeyLocks keyLocks;
 };
 
 BOOST_FIXTURE_TEST_SUITE(TestKeyLocks, KeyLocksFixture)
@@ -110,5 +110,60 @@ BOOST_AUTO_TEST_CASE(deadLock)
     BOOST_CHECK(keyLocks.detectDeadLock(1001));
 }
 
+BOOST_AUTO_TEST_CASE(deadLockBrokenByRelease)
+{
+    std::string to = "contract1";
+    std::string key1 = "key1";
+    std::string key2 = "key2";
+
+    BOOST_CHECK(keyLocks.acquireKeyLock(to, key1, 1000, 1));
+    BOOST_CHECK(keyLocks.acquireKeyLock(to, key2, 1001, 1));
+    BOOST_CHECK(!keyLocks.acquireKeyLock(to, key2, 1000, 2));
+    BOOST_CHECK(!keyLocks.acquireKeyLock(to, key1, 1001, 2));
+    BOOST_CHECK(keyLocks.detectDeadLock(1000));
+    BOOST_CHECK(keyLocks.detectDeadLock(1001));
+
+    // Revert 1001, the dead lock is broken
+    keyLocks.releaseKeyLocks(1001, 1);
+    keyLocks.releaseKeyLocks(1001, 2);
+    BOOST_CHECK(!keyLocks.detectDeadLock(1000));
+    BOOST_CHECK(!keyLocks.detectDeadLock(1001));
+}
+
+BOOST_AUTO_TEST_CASE(deadLockByNewHolder)
+{
+    std::string to = "contract1";
+    std::string key1 = "key1";
+    std::string key2 = "key2";
+
+    BOOST_CHECK(keyLocks.acquireKeyLock(to, key1, 1000, 1));
+    BOOST_CHECK(keyLocks.acquireKeyLock(to, key2, 1002, 1));
+    BOOST_CHECK(!keyLocks.acquireKeyLock(to, key2, 1000, 2));
+    BOOST_CHECK(!keyLocks.detectDeadLock(1000));
+
+    // 1000 keeps waiting for key2 after 1002 released it, 1001 holds key2 and waits for key1
+    keyLocks.releaseKeyLocks(1002, 1);
+    BOOST_CHECK(keyLocks.acquireKeyLock(to, key2, 1001, 1));
+    BOOST_CHECK(!keyLocks.acquireKeyLock(to, key1, 1001, 2));
+    BOOST_CHECK(keyLocks.detectDeadLock(1000));
+    BOOST_CHECK(keyLocks.detectDeadLock(1001));
+
+    // 1003 holds a key and waits for the dead locked contexts
+    BOOST_CHECK(keyLocks.acquireKeyLock("contract2", key1, 1003, 1));
+    BOOST_CHECK(!keyLocks.acquireKeyLock(to, key1, 1003, 2));
+    BOOST_CHECK(keyLocks.detectDeadLock(1003));
+    BOOST_CHECK_EQUAL(keyLocks.getKeyLocksNotHoldingByContext(to, 1003).size(), 2);
+    BOOST_CHECK_EQUAL(keyLocks.getKeyLocksNotHoldingByContext("contract2", 1003).size(), 0);
+    BOOST_CHECK_EQUAL(keyLocks.getKeyLocksNotHoldingByContext("contract2", 1000).size(), 1);
+
+    // 1001 acquires key1 after 1000 released it
+    keyLocks.releaseKeyLocks(1000, 1);
+    BOOST_CHECK(!keyLocks.detectDeadLock(1001));
+    BOOST_CHECK(!keyLocks.detectDeadLock(1003));
+    BOOST_CHECK(keyLocks.acquireKeyLock(to, key1, 1001, 2));
+    BOOST_CHECK(!keyLocks.detectDeadLock(1001));
+    BOOST_CHECK(!keyLocks.detectDeadLock(1003));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace bcos::test
\ No newline at end of file
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <bcos-framework/ledger/LedgerTypeDef.h>
 #include <bcos-framework/storage/StorageInterface.h>
 
 namespace bcos::storage
@@ -45,4 +46,29 @@ inline bool isValid(const std::string_view& tableName, const std::string_view&)
     return !tableName.empty();
 }
 
+// the tables are grouped by access pattern, every group can be stored in its own column family
+enum class TableCategory : uint8_t
+{
+    SYSTEM = 0,   // small and frequently updated system tables, such as s_config
+    STATE = 1,    // contract state tables, point lookup heavy
+    HISTORY = 2,  // append-only block history, such as transactions and receipts
+};
+constexpr static size_t TABLE_CATEGORY_COUNT = 3;
+
+inline TableCategory getTableCategory(const std::string_view& tableName)
+{
+    if (tableName == ledger::SYS_HASH_2_TX || tableName == ledger::SYS_HASH_2_RECEIPT ||
+        tableName == ledger::SYS_NUMBER_2_BLOCK_HEADER || tableName == ledger::SYS_NUMBER_2_TXS ||
+        tableName == ledger::SYS_NUMBER_2_HASH || tableName == ledger::SYS_HASH_2_NUMBER ||
+        tableName == ledger::SYS_BLOCK_NUMBER_2_NONCES)
+    {
+        return TableCategory::HISTORY;
+    }
+    if (tableName.size() > 2 && tableName[0] == 's' && tableName[1] == '_')
+    {
+        return TableCategory::SYSTEM;
+    }
+    return TableCategory::STATE;
+}
+
 }  // namespace bcos::storage
@@ -0,0 +1,346 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief column family layout and tuning profiles of RocksDBStorage
+ * @file RocksDBColumnFamily.cpp
+ */
+#include "RocksDBColumnFamily.h"
+#include <bcos-utilities/BoostLog.h>
+#include <bcos-utilities/Common.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/convenience.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/table.h>
+#include <rocksdb/write_batch.h>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <set>
+
+using namespace bcos::storage;
+
+#define STORAGE_ROCKSDB_LOG(LEVEL) BCOS_LOG(LEVEL) << "[STORAGE-RocksDB]"
+
+namespace
+{
+// the prefix of a db key is the table name and the split, see toDBKey
+class TablePrefixTransform : public rocksdb::SliceTransform
+{
+public:
+    const char* Name() const override { return "bcos.TablePrefixTransform"; }
+
+    rocksdb::Slice Transform(const rocksdb::Slice& key) const override
+    {
+        auto keyView = std::string_view(key.data(), key.size());
+        auto pos = keyView.find(TABLE_KEY_SPLIT);
+        return rocksdb::Slice(key.data(), pos + 1);
+    }
+
+    bool InDomain(const rocksdb::Slice& key) const override
+    {
+        return std::string_view(key.data(), key.size()).find(TABLE_KEY_SPLIT) !=
+               std::string_view::npos;
+    }
+};
+
+rocksdb::ColumnFamilyOptions systemOptions(
+    const rocksdb::Options& baseOptions, const RocksDBProfile& profile)
+{
+    rocksdb::ColumnFamilyOptions options(baseOptions);
+    rocksdb::BlockBasedTableOptions tableOptions;
+    tableOptions.block_cache = rocksdb::NewLRUCache(profile.systemBlockCacheSize);
+    tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+    return options;
+}
+
+rocksdb::ColumnFamilyOptions stateOptions(
+    const rocksdb::Options& baseOptions, const RocksDBProfile& profile)
+{
+    rocksdb::ColumnFamilyOptions options(baseOptions);
+    rocksdb::BlockBasedTableOptions tableOptions;
+    tableOptions.block_cache = rocksdb::NewLRUCache(profile.stateBlockCacheSize);
+    tableOptions.cache_index_and_filter_blocks = true;
+    tableOptions.pin_l0_filter_and_index_blocks_in_cache = true;
+    if (profile.stateBloomBitsPerKey > 0)
+    {
+        tableOptions.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(profile.stateBloomBitsPerKey, false));
+        tableOptions.whole_key_filtering = true;
+        options.prefix_extractor = std::make_shared<TablePrefixTransform>();
+    }
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+    options.compression = rocksdb::kLZ4Compression;
+    options.bottommost_compression = rocksdb::kZSTD;
+    return options;
+}
+
+rocksdb::ColumnFamilyOptions historyOptions(
+    const rocksdb::Options& baseOptions, const RocksDBProfile& profile)
+{
+    rocksdb::ColumnFamilyOptions options(baseOptions);
+    rocksdb::BlockBasedTableOptions tableOptions;
+    tableOptions.block_cache = rocksdb::NewLRUCache(profile.historyBlockCacheSize);
+    tableOptions.block_size = profile.historyBlockSize;
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+    options.compression = rocksdb::kZSTD;
+    options.bottommost_compression = rocksdb::kZSTD;
+    if (profile.historyUniversalCompaction)
+    {
+        options.compaction_style = rocksdb::kCompactionStyleUniversal;
+    }
+    return options;
+}
+}  // namespace
+
+std::vector<rocksdb::ColumnFamilyDescriptor> bcos::storage::columnFamilyDescriptors(
+    const rocksdb::Options& baseOptions, const RocksDBProfile& profile)
+{
+    std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+    descriptors.reserve(TABLE_CATEGORY_COUNT);
+    descriptors.emplace_back(
+        rocksdb::kDefaultColumnFamilyName, systemOptions(baseOptions, profile));
+    descriptors.emplace_back(std::string(STATE_COLUMN_FAMILY), stateOptions(baseOptions, profile));
+    descriptors.emplace_back(
+        std::string(HISTORY_COLUMN_FAMILY), historyOptions(baseOptions, profile));
+    return descriptors;
+}
+
+std::pair<RocksDBPtr, std::vector<rocksdb::ColumnFamilyHandle*>> bcos::storage::openRocksDB(
+    const std::string& path, rocksdb::Options options, const RocksDBProfile& profile)
+{
+    std::vector<std::string> existsColumnFamilies;
+    auto listStatus = rocksdb::DB::ListColumnFamilies(options, path, &existsColumnFamilies);
+    // the layout of an existing database is decided by the column families it already has
+    bool useColumnFamily = profile.enableColumnFamily;
+    if (listStatus.ok())
+    {
+        useColumnFamily =
+            std::find(existsColumnFamilies.begin(), existsColumnFamilies.end(),
+                std::string(STATE_COLUMN_FAMILY)) != existsColumnFamilies.end();
+        if (profile.enableColumnFamily && !useColumnFamily)
+        {
+            STORAGE_ROCKSDB_LOG(WARNING)
+                << LOG_DESC("the database is created without column families, ignore the config")
+                << LOG_KV("path", path);
+        }
+    }
+
+    // all the column families must be opened, including the staging one
+    bool hasStaging =
+        listStatus.ok() && std::find(existsColumnFamilies.begin(), existsColumnFamilies.end(),
+                               std::string(SNAPSHOT_STAGING_COLUMN_FAMILY)) !=
+                               existsColumnFamilies.end();
+
+    rocksdb::DB* db = nullptr;
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    rocksdb::Status status;
+    if (useColumnFamily || hasStaging)
+    {
+        std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+        if (useColumnFamily)
+        {
+            options.create_missing_column_families = true;
+            descriptors = columnFamilyDescriptors(options, profile);
+        }
+        else
+        {
+            descriptors.emplace_back(
+                rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions(options));
+        }
+        if (hasStaging)
+        {
+            descriptors.emplace_back(std::string(SNAPSHOT_STAGING_COLUMN_FAMILY),
+                rocksdb::ColumnFamilyOptions(options));
+        }
+        status = rocksdb::DB::Open(options, path, descriptors, &handles, &db);
+    }
+    else
+    {
+        status = rocksdb::DB::Open(options, path, &db);
+    }
+    if (!status.ok())
+    {
+        STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("open rocksDB failed")
+                                   << LOG_KV("error", status.ToString());
+        BOOST_THROW_EXCEPTION(std::runtime_error("open rocksDB failed, err:" + status.ToString()));
+    }
+    rocksdb::ColumnFamilyHandle* staging = nullptr;
+    if (hasStaging)
+    {
+        staging = handles.back();
+        handles.pop_back();
+    }
+    if (!useColumnFamily)
+    {
+        for (auto* handle : handles)
+        {
+            db->DestroyColumnFamilyHandle(handle);
+        }
+        handles.assign(TABLE_CATEGORY_COUNT, db->DefaultColumnFamily());
+    }
+    if (staging)
+    {
+        // the publish interrupted by the restart is finished, the unfinished import starts over
+        std::string marker;
+        auto publishing =
+            db->Get(rocksdb::ReadOptions(), staging,
+                  rocksdb::Slice(SNAPSHOT_PUBLISHING_KEY.data(), SNAPSHOT_PUBLISHING_KEY.size()),
+                  &marker)
+                .ok();
+        if (publishing)
+        {
+            std::array<rocksdb::ColumnFamilyHandle*, TABLE_CATEGORY_COUNT> categoryHandles;
+            std::copy(handles.begin(), handles.end(), categoryHandles.begin());
+            auto publishStatus = publishStagingColumnFamily(*db, categoryHandles, staging);
+            if (!publishStatus.ok())
+            {
+                STORAGE_ROCKSDB_LOG(ERROR) << LOG_DESC("finish the snapshot publish failed")
+                                           << LOG_KV("error", publishStatus.ToString());
+                BOOST_THROW_EXCEPTION(std::runtime_error(
+                    "finish the snapshot publish failed, err:" + publishStatus.ToString()));
+            }
+        }
+        auto dropStatus = db->DropColumnFamily(staging);
+        db->DestroyColumnFamilyHandle(staging);
+        STORAGE_ROCKSDB_LOG(INFO) << LOG_DESC("drop the staged snapshot rows")
+                                  << LOG_KV("published", publishing)
+                                  << LOG_KV("status", dropStatus.ToString());
+    }
+    STORAGE_ROCKSDB_LOG(INFO) << LOG_DESC("open rocksDB") << LOG_KV("path", path)
+                              << LOG_KV("columnFamily", useColumnFamily);
+
+    auto uniqueDB = RocksDBPtr(db, [](rocksdb::DB* db) {
+        CancelAllBackgroundWork(db, true);
+        delete db;
+    });
+    return {std::move(uniqueDB), std::move(handles)};
+}
+
+rocksdb::Status bcos::storage::publishStagingColumnFamily(rocksdb::DB& db,
+    std::array<rocksdb::ColumnFamilyHandle*, TABLE_CATEGORY_COUNT> const& handles,
+    rocksdb::ColumnFamilyHandle* staging, size_t maxBatchSize)
+{
+    auto start = utcTime();
+    rocksdb::WriteBatch writeBatch;
+    auto write = [&db, &writeBatch](size_t _minSize) {
+        if (writeBatch.Count() == 0 || writeBatch.GetDataSize() < _minSize)
+        {
+            return rocksdb::Status::OK();
+        }
+        auto status = db.Write(rocksdb::WriteOptions(), &writeBatch);
+        writeBatch.Clear();
+        return status;
+    };
+
+    // the rows of the system and state tables not in the snapshot are deleted
+    size_t deletedRows = 0;
+    std::set<rocksdb::ColumnFamilyHandle*> visited;
+    for (auto category : {TableCategory::SYSTEM, TableCategory::STATE})
+    {
+        auto* handle = handles[static_cast<size_t>(category)];
+        if (!visited.insert(handle).second)
+        {
+            continue;
+        }
+        rocksdb::ReadOptions readOptions;
+        readOptions.total_order_seek = true;
+        std::unique_ptr<rocksdb::Iterator> iter(db.NewIterator(readOptions, handle));
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next())
+        {
+            auto dbKey = std::string_view(iter->key().data(), iter->key().size());
+            auto split = dbKey.find(TABLE_KEY_SPLIT);
+            if (split == std::string_view::npos ||
+                getTableCategory(dbKey.substr(0, split)) == TableCategory::HISTORY)
+            {
+                continue;
+            }
+            rocksdb::PinnableSlice staged;
+            auto status = db.Get(readOptions, staging, iter->key(), &staged);
+            if (status.ok())
+            {
+                continue;
+            }
+            if (!status.IsNotFound())
+            {
+                return status;
+            }
+            writeBatch.Delete(handle, iter->key());
+            ++deletedRows;
+            if (status = write(maxBatchSize); !status.ok())
+            {
+                return status;
+            }
+        }
+        if (!iter->status().ok())
+        {
+            return iter->status();
+        }
+    }
+
+    // the staged values are encrypted already
+    size_t stagedRows = 0;
+    auto currentStatePrefix = toDBKey(ledger::SYS_CURRENT_STATE, "");
+    std::vector<std::pair<std::string, std::string>> currentState;
+    std::unique_ptr<rocksdb::Iterator> iter(db.NewIterator(rocksdb::ReadOptions(), staging));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next())
+    {
+        auto dbKey = std::string_view(iter->key().data(), iter->key().size());
+        auto split = dbKey.find(TABLE_KEY_SPLIT);
+        if (split == std::string_view::npos)
+        {
+            continue;
+        }
+        if (dbKey.starts_with(currentStatePrefix))
+        {
+            currentState.emplace_back(iter->key().ToString(), iter->value().ToString());
+            continue;
+        }
+        writeBatch.Put(handles[static_cast<size_t>(getTableCategory(dbKey.substr(0, split)))],
+            iter->key(), iter->value());
+        ++stagedRows;
+        if (auto status = write(maxBatchSize); !status.ok())
+        {
+            return status;
+        }
+    }
+    if (!iter->status().ok())
+    {
+        return iter->status();
+    }
+    iter.reset();
+    if (auto status = write(0); !status.ok())
+    {
+        return status;
+    }
+
+    // the current block number marks the new state complete
+    auto* currentStateHandle =
+        handles[static_cast<size_t>(getTableCategory(ledger::SYS_CURRENT_STATE))];
+    for (auto const& [key, value] : currentState)
+    {
+        writeBatch.Put(currentStateHandle, key, value);
+    }
+    if (auto status = write(0); !status.ok())
+    {
+        return status;
+    }
+    STORAGE_ROCKSDB_LOG(INFO) << LOG_DESC("publishStagingColumnFamily")
+                              << LOG_KV("stagedRows", stagedRows)
+                              << LOG_KV("deletedRows", deletedRows)
+                              << LOG_KV("currentStateRows", currentState.size())
+                              << LOG_KV("time(ms)", utcTime() - start);
+    return rocksdb::Status::OK();
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief column family layout and tuning profiles of RocksDBStorage
+ * @file RocksDBColumnFamily.h
+ */
+#pragma once
+
+#include "Common.h"
+#include <rocksdb/db.h>
+#include <rocksdb/options.h>
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace bcos::storage
+{
+// the name of the column family of every TableCategory, SYSTEM stays in the default column family
+constexpr static std::string_view STATE_COLUMN_FAMILY{"state"};
+constexpr static std::string_view HISTORY_COLUMN_FAMILY{"history"};
+// the rows of a state snapshot being imported, created on demand and dropped when the import is
+// published or abandoned
+constexpr static std::string_view SNAPSHOT_STAGING_COLUMN_FAMILY{"snapshot_staging"};
+// written to the staging column family with the rows of the current state when the publish starts,
+// a publish interrupted after it is finished instead of dropped
+constexpr static std::string_view SNAPSHOT_PUBLISHING_KEY{"publishing"};
+constexpr static size_t SNAPSHOT_PUBLISH_BATCH_SIZE = 32 * 1024 * 1024;
+
+struct RocksDBProfile
+{
+    // store system, state and history tables in separate column families, only take effect when
+    // the database is created, an existing database keeps its original layout
+    bool enableColumnFamily = false;
+    size_t systemBlockCacheSize = 16 * 1024 * 1024;
+    size_t stateBlockCacheSize = 128 * 1024 * 1024;
+    size_t historyBlockCacheSize = 32 * 1024 * 1024;
+    // bits per key of the bloom filter of the state column family, 0 to disable
+    int stateBloomBitsPerKey = 10;
+    size_t historyBlockSize = 64 * 1024;
+    // use universal compaction for the append-only history tables to reduce write amplification
+    bool historyUniversalCompaction = true;
+};
+
+using RocksDBPtr = std::unique_ptr<rocksdb::DB, std::function<void(rocksdb::DB*)>>;
+
+// the options of every column family, indexed by TableCategory
+std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilyDescriptors(
+    const rocksdb::Options& baseOptions, const RocksDBProfile& profile);
+
+// open the database at path, the returned handles are indexed by TableCategory, all of them are
+// the default column family when the database does not use column families; the rows staged by
+// an unfinished snapshot import are dropped, an interrupted publish of them is finished
+std::pair<RocksDBPtr, std::vector<rocksdb::ColumnFamilyHandle*>> openRocksDB(
+    const std::string& path, rocksdb::Options options, const RocksDBProfile& profile);
+
+// replaces the rows of the system and state tables by the rows of the staging column family in
+// write batches of at most maxBatchSize bytes; the rows of the current state table are written in
+// the last batch, so the new block number is visible only when the rest is written, and the
+// publish can be run again until the staging column family is dropped
+rocksdb::Status publishStagingColumnFamily(rocksdb::DB& db,
+    std::array<rocksdb::ColumnFamilyHandle*, TABLE_CATEGORY_COUNT> const& handles,
+    rocksdb::ColumnFamilyHandle* staging, size_t maxBatchSize = SNAPSHOT_PUBLISH_BATCH_SIZE);
+}  // namespace bcos::storage
@@ -20,6 +20,7 @@
  */
 #include "RocksDBStorage.h"
 #include "Common.h"
+#include "RocksDBColumnFamily.h"
 #include "bcos-framework/protocol/ProtocolTypeDef.h"
 #include "bcos-framework/storage/Table.h"
 #include <bcos-utilities/Error.h>
@@ -27,12 +28,14 @@
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
 #include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/spin_mutex.h>
 #include <boost/algorithm/hex.hpp>
 #include <csignal>
 #include <exception>
 #include <future>
 #include <optional>
+#include <set>
 
 using namespace bcos::storage;
 using namespace bcos::protocol;
@@ -45,12 +48,68 @@ RocksDBStorage::RocksDBStorage(std::unique_ptr<rocksdb::DB, std::function<void(r
     const bcos::security::DataEncryptInterface::Ptr dataEncryption)
   : m_db(std::move(db)), m_dataEncryption(dataEncryption)
 {
-    m_writeBatch = std::make_shared<WriteBatch>();
+    m_columnFamilies.fill(m_db->DefaultColumnFamily());
+}
+
+RocksDBStorage::RocksDBStorage(std::unique_ptr<rocksdb::DB, std::function<void(rocksdb::DB*)>>&& db,
+    std::vector<rocksdb::ColumnFamilyHandle*> columnFamilies,
+    const bcos::security::DataEncryptInterface::Ptr dataEncryption)
+  : m_db(std::move(db)), m_dataEncryption(dataEncryption)
+{
+    if (columnFamilies.size() != TABLE_CATEGORY_COUNT)
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("invalid column families size"));
+    }
+    std::copy(columnFamilies.begin(), columnFamilies.end(), m_columnFamilies.begin());
+}
+
+RocksDBStorage::~RocksDBStorage()
+{
+    // the column family handles must be released before the db
+    std::set<rocksdb::ColumnFamilyHandle*> handles(
+        m_columnFamilies.begin(), m_columnFamilies.end());
+    for (auto* handle : handles)
+    {
+        if (handle != m_db->DefaultColumnFamily())
+        {
+            m_db->DestroyColumnFamilyHandle(handle);
+        }
+    }
+    // the staged rows are dropped when the database is opened again
+    if (m_stagingColumnFamily)
+    {
+        m_db->DestroyColumnFamilyHandle(m_stagingColumnFamily);
+    }
+}
+
+void RocksDBStorage::setEntryValue(Entry& entry, std::shared_ptr<PinnedValue> value) const
+{
+    // Storage Security
+    if (!value->slice.empty() && nullptr != m_dataEncryption)
+    {
+        entry.set(m_dataEncryption->decrypt(value->slice.ToString()));
+        return;
+    }
+    // small values are copied to release the pinned block as soon as possible
+    if (value->slice.size() <= (size_t)Entry::MEDIUM_SIZE)
+    {
+        entry.set(value->slice.ToString());
+        return;
+    }
+    value->view = std::string_view(value->slice.data(), value->slice.size());
+    entry.setPinned(std::shared_ptr<const std::string_view>(value, &value->view));
 }
 
 void RocksDBStorage::asyncGetPrimaryKeys(std::string_view _table,
     const std::optional<Condition const>& _condition,
     std::function<void(Error::UniquePtr, std::vector<std::string>)> _callback)
+{
+    asyncGetPrimaryKeys(ReadOptions(), _table, _condition, std::move(_callback));
+}
+
+void RocksDBStorage::asyncGetPrimaryKeys(const rocksdb::ReadOptions& options,
+    std::string_view _table, const std::optional<Condition const>& _condition,
+    std::function<void(Error::UniquePtr, std::vector<std::string>)> _callback)
 {
     auto start = utcTime();
     std::vector<std::string> result;
@@ -58,9 +117,9 @@ void RocksDBStorage::asyncGetPrimaryKeys(std::string_view _table,
     std::string keyPrefix;
     keyPrefix = string(_table) + TABLE_KEY_SPLIT;
 
-    ReadOptions read_options;
+    ReadOptions read_options = options;
     read_options.total_order_seek = true;
-    auto iter = m_db->NewIterator(read_options);
+    auto iter = m_db->NewIterator(read_options, columnFamily(_table));
 
     // FIXME: check performance and add limit of primary keys
     for (iter->Seek(keyPrefix); iter->Valid() && iter->key().starts_with(keyPrefix); iter->Next())
@@ -84,6 +143,12 @@ void RocksDBStorage::asyncGetPrimaryKeys(std::string_view _table,
 
 void RocksDBStorage::asyncGetRow(std::string_view _table, std::string_view _key,
     std::function<void(Error::UniquePtr, std::optional<Entry>)> _callback)
+{
+    asyncGetRow(ReadOptions(), _table, _key, std::move(_callback));
+}
+
+void RocksDBStorage::asyncGetRow(const rocksdb::ReadOptions& options, std::string_view _table,
+    std::string_view _key, std::function<void(Error::UniquePtr, std::optional<Entry>)> _callback)
 {
     try
     {
@@ -95,14 +160,11 @@ void RocksDBStorage::asyncGetRow(std::string_view _table, std::string_view _key,
             return;
         }
         auto start = utcTime();
-        std::string value;
+        auto value = std::make_shared<PinnedValue>();
         auto dbKey = toDBKey(_table, _key);
 
         auto status = m_db->Get(
-            ReadOptions(), m_db->DefaultColumnFamily(), Slice(dbKey.data(), dbKey.size()), &value);
-
-        if (false == value.empty() && nullptr != m_dataEncryption)
-            value = m_dataEncryption->decrypt(value);
+            options, columnFamily(_table), Slice(dbKey.data(), dbKey.size()), &value->slice);
 
         if (!status.ok())
         {
@@ -135,7 +197,7 @@ void RocksDBStorage::asyncGetRow(std::string_view _table, std::string_view _key,
 
         std::optional<Entry> entry((Entry()));
 
-        entry->set(std::move(value));
+        setEntryValue(*entry, std::move(value));
 
         _callback(nullptr, entry);
 
@@ -159,6 +221,14 @@ void RocksDBStorage::asyncGetRows(std::string_view _table,
     const std::variant<const gsl::span<std::string_view const>, const gsl::span<std::string const>>&
         _keys,
     std::function<void(Error::UniquePtr, std::vector<std::optional<Entry>>)> _callback)
+{
+    asyncGetRows(ReadOptions(), _table, _keys, std::move(_callback));
+}
+
+void RocksDBStorage::asyncGetRows(const rocksdb::ReadOptions& options, std::string_view _table,
+    const std::variant<const gsl::span<std::string_view const>, const gsl::span<std::string const>>&
+        _keys,
+    std::function<void(Error::UniquePtr, std::vector<std::optional<Entry>>)> _callback)
 {
     try
     {
@@ -187,7 +257,7 @@ void RocksDBStorage::asyncGetRows(std::string_view _table,
 
                 std::vector<PinnableSlice> values(keys.size());
                 std::vector<Status> statusList(keys.size());
-                m_db->MultiGet(ReadOptions(), m_db->DefaultColumnFamily(), slices.size(),
+                m_db->MultiGet(options, columnFamily(_table), slices.size(),
                     slices.data(), values.data(), statusList.data());
                 auto end = utcTime();
                 tbb::parallel_for(tbb::blocked_range<size_t>(0, keys.size()),
@@ -201,13 +271,9 @@ void RocksDBStorage::asyncGetRows(std::string_view _table,
                             {
                                 entries[i] = std::make_optional(Entry());
 
-                                std::string v(value.data(), value.size());
-
-                                // Storage Security
-                                if (false == v.empty() && nullptr != m_dataEncryption)
-                                    v = m_dataEncryption->decrypt(v);
-
-                                entries[i]->set(std::move(v));
+                                auto pinnedValue = std::make_shared<PinnedValue>();
+                                pinnedValue->slice = std::move(value);
+                                setEntryValue(*entries[i], std::move(pinnedValue));
                             }
                             else
                             {
@@ -265,7 +331,7 @@ void RocksDBStorage::asyncSetRow(std::string_view _table, std::string_view _key,
             STORAGE_ROCKSDB_LOG(TRACE)
                 << LOG_DESC("asyncSetRow delete") << LOG_KV("table", _table)
                 << LOG_KV("key", boost::algorithm::hex_lower(std::string(_key)));
-            status = m_db->Delete(options, dbKey);
+            status = m_db->Delete(options, columnFamily(_table), dbKey);
         }
         else
         {
@@ -279,7 +345,7 @@ void RocksDBStorage::asyncSetRow(std::string_view _table, std::string_view _key,
             if (false == value.empty() && nullptr != m_dataEncryption)
                 value = m_dataEncryption->encrypt(value);
 
-            status = m_db->Put(options, dbKey, std::move(value));
+            status = m_db->Put(options, columnFamily(_table), dbKey, value);
         }
 
         if (!status.ok())
@@ -302,24 +368,28 @@ void RocksDBStorage::asyncSetRow(std::string_view _table, std::string_view _key,
     }
 }
 
+namespace
+{
+struct WriteOperation
+{
+    rocksdb::ColumnFamilyHandle* columnFamily;
+    std::string key;
+    std::optional<std::string> value;  // std::nullopt means delete
+};
+}  // namespace
+
 void RocksDBStorage::asyncPrepare(const TwoPCParams& param, const TraverseStorageInterface& storage,
     std::function<void(Error::Ptr, uint64_t startTS)> callback)
 {
-    std::ignore = param;
     try
     {
         STORAGE_ROCKSDB_LOG(INFO) << LOG_DESC("asyncPrepare") << LOG_KV("number", param.number);
         auto start = utcTime();
-        {
-            tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
-            if (!m_writeBatch)
-            {
-                m_writeBatch = std::make_shared<WriteBatch>();
-            }
-        }
         std::atomic_uint64_t putCount{0};
         std::atomic_uint64_t deleteCount{0};
         atomic_bool isTableValid = true;
+        // every traverse thread collects its own operations, no lock on the hot path
+        tbb::enumerable_thread_specific<std::vector<WriteOperation>> localOperations;
         storage.parallelTraverse(true,
             [&](const std::string_view& table, const std::string_view& key, Entry const& entry) {
                 if (!isValid(table, key))
@@ -337,8 +407,8 @@ void RocksDBStorage::asyncPrepare(const TwoPCParams& param, const TraverseStorag
                                                    << LOG_KV("key", toHex(key));
                     }
                     ++deleteCount;
-                    tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
-                    m_writeBatch->Delete(dbKey);
+                    localOperations.local().push_back(
+                        {columnFamily(table), std::move(dbKey), std::nullopt});
                 }
                 else
                 {
@@ -349,7 +419,6 @@ void RocksDBStorage::asyncPrepare(const TwoPCParams& param, const TraverseStorag
                             << LOG_KV("key", toHex(key)) << LOG_KV("size", entry.size());
                     }
                     ++putCount;
-                    tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
 
                     std::string value(entry.get().data(), entry.get().size());
 
@@ -357,7 +426,8 @@ void RocksDBStorage::asyncPrepare(const TwoPCParams& param, const TraverseStorag
                     if (false == value.empty() && nullptr != m_dataEncryption)
                         value = m_dataEncryption->encrypt(value);
 
-                    auto status = m_writeBatch->Put(dbKey, std::move(value));
+                    localOperations.local().push_back(
+                        {columnFamily(table), std::move(dbKey), std::move(value)});
                 }
                 return true;
             });
@@ -365,14 +435,47 @@ void RocksDBStorage::asyncPrepare(const TwoPCParams& param, const TraverseStorag
         if (!isTableValid)
         {
             {
-                tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
-                m_writeBatch = nullptr;
+                std::unique_lock lock(m_writeBatchMutex);
+                m_writeBatches.erase(param.number);
             }
             STORAGE_ROCKSDB_LOG(ERROR)
                 << LOG_DESC("asyncPrepare invalidTable") << LOG_KV("number", param.number);
             callback(BCOS_ERROR_UNIQUE_PTR(TableNotExists, "empty tableName or key"), 0);
             return;
         }
+
+        // the batch of one block may be prepared by the scheduler and the executors sharing
+        // this storage, all of them are merged into the same slot
+        size_t pendingBlocks = 0;
+        {
+            std::unique_lock lock(m_writeBatchMutex);
+            auto& writeBatch = m_writeBatches[param.number];
+            if (!writeBatch)
+            {
+                writeBatch = std::make_shared<WriteBatch>();
+            }
+            for (auto& operations : localOperations)
+            {
+                for (auto& operation : operations)
+                {
+                    if (operation.value)
+                    {
+                        writeBatch->Put(operation.columnFamily, operation.key, *operation.value);
+                    }
+                    else
+                    {
+                        writeBatch->Delete(operation.columnFamily, operation.key);
+                    }
+                }
+            }
+            pendingBlocks = m_writeBatches.size();
+        }
+        if (pendingBlocks > MAX_PENDING_WRITE_BATCHES)
+        {
+            STORAGE_ROCKSDB_LOG(WARNING)
+                << LOG_DESC("asyncPrepare too many uncommitted blocks")
+                << LOG_KV("number", param.number) << LOG_KV("pending", pendingBlocks);
+        }
         auto end = utcTime();
         callback(nullptr, 0);
         STORAGE_ROCKSDB_LOG(INFO) << LOG_DESC("asyncPrepare") << LOG_KV("number", param.number)
@@ -392,29 +495,50 @@ void RocksDBStorage::asyncCommit(
 {
     size_t count = 0;
     auto start = utcTime();
-    std::ignore = params;
+    // only one block is written at a time to keep the commit order, but the write is done out of
+    // m_writeBatchMutex so the next block can be prepared meanwhile
+    std::unique_lock commitLock(m_commitMutex);
+    protocol::BlockNumber number = params.number;
+    std::shared_ptr<WriteBatch> writeBatch;
+    {
+        std::unique_lock lock(m_writeBatchMutex);
+        // number 0 without a matching batch means the caller does not specify the block
+        auto it = m_writeBatches.find(number);
+        if (it == m_writeBatches.end() && number == 0 && !m_writeBatches.empty())
+        {
+            it = m_writeBatches.begin();
+        }
+        if (it != m_writeBatches.end())
+        {
+            number = it->first;
+            writeBatch = std::move(it->second);
+            m_writeBatches.erase(it);
+        }
+    }
+    if (writeBatch)
     {
-        tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
-        if (m_writeBatch)
+        WriteOptions options;
+        // options.sync = true;
+        count = writeBatch->Count();
+        auto status = m_db->Write(options, writeBatch.get());
+        auto err = checkStatus(status);
+        if (err)
         {
-            WriteOptions options;
-            // options.sync = true;
-            count = m_writeBatch->Count();
-            auto status = m_db->Write(options, m_writeBatch.get());
-            auto err = checkStatus(status);
-            if (err)
+            STORAGE_ROCKSDB_LOG(WARNING)
+                << LOG_DESC("asyncCommit failed") << LOG_KV("number", params.number)
+                << LOG_KV("message", err->errorMessage()) << LOG_KV("startTS", params.timestamp)
+                << LOG_KV("time(ms)", utcTime() - start);
             {
-                STORAGE_ROCKSDB_LOG(WARNING)
-                    << LOG_DESC("asyncCommit failed") << LOG_KV("number", params.number)
-                    << LOG_KV("message", err->errorMessage()) << LOG_KV("startTS", params.timestamp)
-                    << LOG_KV("time(ms)", utcTime() - start);
-                lock.release();
-                callback(err, 0);
-                return;
+                // keep the batch for retry or rollback
+                std::unique_lock lock(m_writeBatchMutex);
+                m_writeBatches.emplace(number, std::move(writeBatch));
             }
-            m_writeBatch = nullptr;
+            commitLock.unlock();
+            callback(err, 0);
+            return;
         }
     }
+    commitLock.unlock();
     auto end = utcTime();
     callback(nullptr, 0);
     STORAGE_ROCKSDB_LOG(INFO) << LOG_DESC("asyncCommit") << LOG_KV("number", params.number)
@@ -429,10 +553,10 @@ void RocksDBStorage::asyncRollback(
 {
     auto start = utcTime();
 
-    std::ignore = params;
     {
-        tbb::spin_mutex::scoped_lock lock(m_writeBatchMutex);
-        m_writeBatch = nullptr;
+        std::unique_lock lock(m_writeBatchMutex);
+        // the blocks after the rollback one are prepared on top of it, drop them too
+        m_writeBatches.erase(m_writeBatches.lower_bound(params.number), m_writeBatches.end());
     }
     auto end = utcTime();
     callback(nullptr);
@@ -444,6 +568,12 @@ void RocksDBStorage::asyncRollback(
 
 bcos::Error::Ptr RocksDBStorage::setRows(
     std::string_view table, std::vector<std::string> keys, std::vector<std::string> values) noexcept
+{
+    return writeRows(columnFamily(table), table, std::move(keys), std::move(values));
+}
+
+bcos::Error::Ptr RocksDBStorage::writeRows(rocksdb::ColumnFamilyHandle* handle,
+    std::string_view table, std::vector<std::string> keys, std::vector<std::string> values)
 {
     if (table.empty())
     {
@@ -483,11 +613,11 @@ bcos::Error::Ptr RocksDBStorage::setRows(
         // Storage Security
         if (m_dataEncryption)
         {
-            writeBatch.Put(std::move(realKeys[i]), std::move(encryptedValues[i]));
+            writeBatch.Put(handle, realKeys[i], encryptedValues[i]);
         }
         else
         {
-            writeBatch.Put(std::move(realKeys[i]), std::move(values[i]));
+            writeBatch.Put(handle, realKeys[i], values[i]);
         }
     }
     WriteOptions options;
@@ -527,3 +657,238 @@ bcos::Error::Ptr RocksDBStorage::checkStatus(rocksdb::Status const& status)
         return BCOS_ERROR_PTR(DatabaseRetryable, errorInfo);
     }
 }
+
+std::string RocksDBStorage::readStateRows(const rocksdb::ReadOptions& options,
+    std::string_view _from,
+    std::function<bool(std::string_view, std::string_view, std::string_view)> _onRow) const
+{
+    constexpr static std::array<TableCategory, 2> categories{
+        TableCategory::SYSTEM, TableCategory::STATE};
+    ReadOptions readOptions = options;
+    readOptions.total_order_seek = true;
+    // the column families are merged, so the rows are read in the order of the db keys whatever
+    // the layout of the database
+    std::vector<std::unique_ptr<Iterator>> iterators;
+    std::set<rocksdb::ColumnFamilyHandle*> handles;
+    for (auto category : categories)
+    {
+        auto* handle = m_columnFamilies[static_cast<size_t>(category)];
+        if (!handles.insert(handle).second)
+        {
+            continue;
+        }
+        auto& iter = iterators.emplace_back(m_db->NewIterator(readOptions, handle));
+        if (_from.empty())
+        {
+            iter->SeekToFirst();
+        }
+        else
+        {
+            iter->Seek(Slice(_from.data(), _from.size()));
+        }
+    }
+    while (true)
+    {
+        Iterator* iter = nullptr;
+        for (auto& it : iterators)
+        {
+            if (!it->status().ok())
+            {
+                BOOST_THROW_EXCEPTION(std::runtime_error(
+                    "readStateRows failed, status: " + it->status().ToString()));
+            }
+            if (it->Valid() && (!iter || it->key().compare(iter->key()) < 0))
+            {
+                iter = it.get();
+            }
+        }
+        if (!iter)
+        {
+            return {};
+        }
+        auto dbKey = std::string_view(iter->key().data(), iter->key().size());
+        auto split = dbKey.find(TABLE_KEY_SPLIT);
+        auto table = dbKey.substr(0, split);
+        // the history tables sharing the column family are skipped
+        if (split != std::string_view::npos && getTableCategory(table) != TableCategory::HISTORY)
+        {
+            auto value = std::string_view(iter->value().data(), iter->value().size());
+            std::string decryptedValue;
+            if (!value.empty() && m_dataEncryption)
+            {
+                decryptedValue = m_dataEncryption->decrypt(std::string(value));
+                value = decryptedValue;
+            }
+            if (!_onRow(table, dbKey.substr(split + 1), value))
+            {
+                return std::string(dbKey);
+            }
+        }
+        iter->Next();
+    }
+}
+
+class RocksDBStorage::Snapshot : public StateSnapshotInterface
+{
+public:
+    explicit Snapshot(std::shared_ptr<RocksDBStorage> storage)
+      : m_storage(std::move(storage)), m_snapshot(m_storage->m_db->GetSnapshot())
+    {
+        m_options.snapshot = m_snapshot;
+    }
+    Snapshot(const Snapshot&) = delete;
+    Snapshot(Snapshot&&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    Snapshot& operator=(Snapshot&&) = delete;
+    ~Snapshot() override { m_storage->m_db->ReleaseSnapshot(m_snapshot); }
+
+    void asyncGetPrimaryKeys(std::string_view table,
+        const std::optional<Condition const>& _condition,
+        std::function<void(Error::UniquePtr, std::vector<std::string>)> _callback) override
+    {
+        m_storage->asyncGetPrimaryKeys(m_options, table, _condition, std::move(_callback));
+    }
+
+    void asyncGetRow(std::string_view table, std::string_view _key,
+        std::function<void(Error::UniquePtr, std::optional<Entry>)> _callback) override
+    {
+        m_storage->asyncGetRow(m_options, table, _key, std::move(_callback));
+    }
+
+    void asyncGetRows(std::string_view table,
+        const std::variant<const gsl::span<std::string_view const>,
+            const gsl::span<std::string const>>& _keys,
+        std::function<void(Error::UniquePtr, std::vector<std::optional<Entry>>)> _callback)
+        override
+    {
+        m_storage->asyncGetRows(m_options, table, _keys, std::move(_callback));
+    }
+
+    void asyncSetRow(std::string_view, std::string_view, Entry,
+        std::function<void(Error::UniquePtr)> callback) override
+    {
+        callback(BCOS_ERROR_UNIQUE_PTR(WriteError, "The snapshot is read only"));
+    }
+
+    std::string readStateRows(std::string_view _from,
+        std::function<bool(std::string_view, std::string_view, std::string_view)> _onRow)
+        const override
+    {
+        return m_storage->readStateRows(m_options, _from, std::move(_onRow));
+    }
+
+private:
+    std::shared_ptr<RocksDBStorage> m_storage;
+    const rocksdb::Snapshot* m_snapshot;
+    ReadOptions m_options;
+};
+
+StorageInterface::Ptr RocksDBStorage::snapshot()
+{
+    return std::make_shared<Snapshot>(shared_from_this());
+}
+
+bcos::Error::Ptr RocksDBStorage::stageRows(std::string_view _table,
+    std::vector<std::string> _keys, std::vector<std::string> _values) noexcept
+{
+    std::unique_lock lock(m_stagingMutex);
+    if (!m_stagingColumnFamily)
+    {
+        auto status = m_db->CreateColumnFamily(rocksdb::ColumnFamilyOptions(),
+            std::string(SNAPSHOT_STAGING_COLUMN_FAMILY), &m_stagingColumnFamily);
+        if (!status.ok())
+        {
+            m_stagingColumnFamily = nullptr;
+            STORAGE_ROCKSDB_LOG(WARNING) << LOG_DESC("create the staging column family failed")
+                                         << LOG_KV("status", status.ToString());
+            return BCOS_ERROR_PTR(DatabaseError,
+                "create the staging column family failed, status: " + status.ToString());
+        }
+    }
+    return writeRows(m_stagingColumnFamily, _table, std::move(_keys), std::move(_values));
+}
+
+bcos::Error::Ptr RocksDBStorage::publishStagedRows(std::vector<std::string> _currentStateKeys,
+    std::vector<std::string> _currentStateValues) noexcept
+{
+    if (_currentStateKeys.size() != _currentStateValues.size())
+    {
+        return BCOS_ERROR_PTR(WriteError, "publishStagedRows values size mismatch keys size");
+    }
+    std::unique_lock lock(m_stagingMutex);
+    if (!m_stagingColumnFamily)
+    {
+        return BCOS_ERROR_PTR(WriteError, "No staged rows to publish");
+    }
+    try
+    {
+        // the rows of the current state are staged with the marker in one write, a publish
+        // interrupted from now on is finished by the next publish or by the restart
+        WriteBatch writeBatch;
+        for (size_t i = 0; i < _currentStateKeys.size(); ++i)
+        {
+            writeBatch.Put(m_stagingColumnFamily,
+                toDBKey(ledger::SYS_CURRENT_STATE, _currentStateKeys[i]),
+                m_dataEncryption ? m_dataEncryption->encrypt(_currentStateValues[i]) :
+                                   _currentStateValues[i]);
+        }
+        writeBatch.Put(m_stagingColumnFamily,
+            Slice(SNAPSHOT_PUBLISHING_KEY.data(), SNAPSHOT_PUBLISHING_KEY.size()), Slice());
+        auto status = m_db->Write(WriteOptions(), &writeBatch);
+        if (status.ok())
+        {
+            status = publishStagingColumnFamily(*m_db, m_columnFamilies, m_stagingColumnFamily);
+        }
+        if (auto error = checkStatus(status))
+        {
+            STORAGE_ROCKSDB_LOG(WARNING) << LOG_DESC("publishStagedRows failed")
+                                         << LOG_KV("message", error->errorMessage());
+            return error;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        return BCOS_ERROR_PTR(WriteError, boost::diagnostic_information(e));
+    }
+    return dropStagingColumnFamily();
+}
+
+bcos::Error::Ptr RocksDBStorage::dropStagedRows() noexcept
+{
+    std::unique_lock lock(m_stagingMutex);
+    if (!m_stagingColumnFamily)
+    {
+        return nullptr;
+    }
+    // the rows deleted by an interrupted publish can not be restored, the publish is finished
+    PinnableSlice marker;
+    auto status = m_db->Get(ReadOptions(), m_stagingColumnFamily,
+        Slice(SNAPSHOT_PUBLISHING_KEY.data(), SNAPSHOT_PUBLISHING_KEY.size()), &marker);
+    if (status.ok())
+    {
+        status = publishStagingColumnFamily(*m_db, m_columnFamilies, m_stagingColumnFamily);
+    }
+    else if (status.IsNotFound())
+    {
+        status = rocksdb::Status::OK();
+    }
+    if (auto error = checkStatus(status))
+    {
+        STORAGE_ROCKSDB_LOG(WARNING) << LOG_DESC("dropStagedRows failed")
+                                     << LOG_KV("message", error->errorMessage());
+        return error;
+    }
+    return dropStagingColumnFamily();
+}
+
+bcos::Error::Ptr RocksDBStorage::dropStagingColumnFamily()
+{
+    if (!m_stagingColumnFamily)
+    {
+        return nullptr;
+    }
+    auto status = m_db->DropColumnFamily(m_stagingColumnFamily);
+    m_db->DestroyColumnFamilyHandle(m_stagingColumnFamily);
+    m_stagingColumnFamily = nullptr;
+    return checkStatus(status);
+}
@@ -23,10 +23,14 @@
  */
 #pragma once
 
+#include "Common.h"
 #include <bcos-framework/storage/StorageInterface.h>
 #include <bcos-security/bcos-security/DataEncryption.h>
 #include <rocksdb/db.h>
 #include <tbb/parallel_for.h>
+#include <array>
+#include <map>
+#include <mutex>
 
 namespace rocksdb
 {
@@ -35,14 +39,21 @@ class WriteBatch;
 
 namespace bcos::storage
 {
-class RocksDBStorage : public TransactionalStorageInterface
+class RocksDBStorage : public TransactionalStorageInterface,
+                       public StateSnapshotImportInterface,
+                       public std::enable_shared_from_this<RocksDBStorage>
 {
 public:
     using Ptr = std::shared_ptr<RocksDBStorage>;
     explicit RocksDBStorage(std::unique_ptr<rocksdb::DB, std::function<void(rocksdb::DB*)>>&& db,
         const bcos::security::DataEncryptInterface::Ptr dataEncryption);
 
-    ~RocksDBStorage() {}
+    // columnFamilies are indexed by TableCategory and owned by the storage after construction
+    RocksDBStorage(std::unique_ptr<rocksdb::DB, std::function<void(rocksdb::DB*)>>&& db,
+        std::vector<rocksdb::ColumnFamilyHandle*> columnFamilies,
+        const bcos::security::DataEncryptInterface::Ptr dataEncryption);
+
+    ~RocksDBStorage();
 
     void asyncGetPrimaryKeys(std::string_view _table,
         const std::optional<Condition const>& _condition,
@@ -72,11 +83,60 @@ public:
     Error::Ptr setRows(std::string_view table, std::vector<std::string> keys,
         std::vector<std::string> values) noexcept override;
 
+    // reads the data at the moment of the call, the storage must be created by make_shared; the
+    // snapshot also implements StateSnapshotInterface
+    StorageInterface::Ptr snapshot() override;
+
+    // the staged rows are kept in a column family of their own, created by the first call
+    Error::Ptr stageRows(std::string_view _table, std::vector<std::string> _keys,
+        std::vector<std::string> _values) noexcept override;
+    Error::Ptr publishStagedRows(std::vector<std::string> _currentStateKeys,
+        std::vector<std::string> _currentStateValues) noexcept override;
+    Error::Ptr dropStagedRows() noexcept override;
+
 private:
+    class Snapshot;
+
+    void asyncGetPrimaryKeys(const rocksdb::ReadOptions& options, std::string_view _table,
+        const std::optional<Condition const>& _condition,
+        std::function<void(Error::UniquePtr, std::vector<std::string>)> _callback);
+    void asyncGetRow(const rocksdb::ReadOptions& options, std::string_view table,
+        std::string_view _key,
+        std::function<void(Error::UniquePtr, std::optional<Entry>)> _callback);
+    void asyncGetRows(const rocksdb::ReadOptions& options, std::string_view table,
+        const std::variant<const gsl::span<std::string_view const>,
+            const gsl::span<std::string const>>& _keys,
+        std::function<void(Error::UniquePtr, std::vector<std::optional<Entry>>)> _callback);
+    // the position is the db key of the row
+    std::string readStateRows(const rocksdb::ReadOptions& options, std::string_view _from,
+        std::function<bool(std::string_view, std::string_view, std::string_view)> _onRow) const;
+
+    // a value read from rocksdb, the slice may pin the data block in the block cache
+    struct PinnedValue
+    {
+        rocksdb::PinnableSlice slice;
+        std::string_view view;
+    };
+    void setEntryValue(Entry& entry, std::shared_ptr<PinnedValue> value) const;
+
     Error::Ptr checkStatus(rocksdb::Status const& status);
-    std::shared_ptr<rocksdb::WriteBatch> m_writeBatch = nullptr;
-    tbb::spin_mutex m_writeBatchMutex;
+    Error::Ptr writeRows(rocksdb::ColumnFamilyHandle* handle, std::string_view table,
+        std::vector<std::string> keys, std::vector<std::string> values);
+    Error::Ptr dropStagingColumnFamily();
+    rocksdb::ColumnFamilyHandle* columnFamily(std::string_view table) const
+    {
+        return m_columnFamilies[static_cast<size_t>(getTableCategory(table))];
+    }
+
+    // the prepared but uncommitted batches, by block number
+    constexpr static size_t MAX_PENDING_WRITE_BATCHES = 2;
+    std::map<protocol::BlockNumber, std::shared_ptr<rocksdb::WriteBatch>> m_writeBatches;
+    std::mutex m_writeBatchMutex;
+    std::mutex m_commitMutex;
     std::unique_ptr<rocksdb::DB, std::function<void(rocksdb::DB*)>> m_db;
+    std::array<rocksdb::ColumnFamilyHandle*, TABLE_CATEGORY_COUNT> m_columnFamilies;
+    rocksdb::ColumnFamilyHandle* m_stagingColumnFamily = nullptr;
+    std::mutex m_stagingMutex;
 
     // Security Storage
     bcos::security::DataEncryptInterface::Ptr m_dataEncryption{nullptr};
@@ -1,6 +1,7 @@
 #include "bcos-framework/storage/StorageInterface.h"
 #include "bcos-table/src/StateStorage.h"
 #include "boost/filesystem.hpp"
+#include <bcos-storage/RocksDBColumnFamily.h>
 #include <bcos-storage/RocksDBStorage.h>
 #include <bcos-utilities/DataConvertUtility.h>
 #include <rocksdb/write_batch.h>
@@ -18,6 +19,7 @@
 #include <boost/test/unit_test.hpp>
 #include <future>
 #include <optional>
+#include <set>
 
 using namespace bcos::storage;
 using namespace std;
@@ -692,6 +694,407 @@ BOOST_AUTO_TEST_CASE(commitAndCheck)
             params, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
     }
 }
+BOOST_AUTO_TEST_CASE(columnFamily)
+{
+    std::string cfPath = "./unittestdb_cf";
+    BOOST_CHECK(getTableCategory(bcos::ledger::SYS_HASH_2_RECEIPT) == TableCategory::HISTORY);
+    BOOST_CHECK(getTableCategory(bcos::ledger::SYS_CONFIG) == TableCategory::SYSTEM);
+    BOOST_CHECK(getTableCategory("/apps/test") == TableCategory::STATE);
+
+    RocksDBProfile profile;
+    profile.enableColumnFamily = true;
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    {
+        auto [db, handles] = openRocksDB(cfPath, options, profile);
+        BOOST_CHECK_EQUAL(handles.size(), TABLE_CATEGORY_COUNT);
+        BOOST_CHECK(handles[1] != db->DefaultColumnFamily());
+        auto storage = std::make_shared<RocksDBStorage>(std::move(db), handles, nullptr);
+
+        auto state = std::make_shared<StateStorage>(nullptr);
+        for (auto table : {std::string_view("/apps/test"), bcos::ledger::SYS_HASH_2_TX,
+                 bcos::ledger::SYS_CONFIG})
+        {
+            Entry entry;
+            entry.importFields({std::string(table)});
+            state->asyncSetRow(
+                table, "key", std::move(entry), [](Error::UniquePtr error) { BOOST_CHECK(!error); });
+        }
+        bcos::protocol::TwoPCParams params;
+        params.number = 1;
+        storage->asyncPrepare(
+            params, *state, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+        storage->asyncCommit(params, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+    }
+
+    // reopen without the config, the layout of the existing database is kept
+    {
+        auto [db, handles] = openRocksDB(cfPath, options, RocksDBProfile());
+        BOOST_CHECK(handles[2] != db->DefaultColumnFamily());
+        auto storage = std::make_shared<RocksDBStorage>(std::move(db), handles, nullptr);
+        for (auto table : {std::string_view("/apps/test"), bcos::ledger::SYS_HASH_2_TX,
+                 bcos::ledger::SYS_CONFIG})
+        {
+            storage->asyncGetRow(table, "key", [&](Error::UniquePtr error, std::optional<Entry> entry) {
+                BOOST_CHECK(!error);
+                BOOST_CHECK(entry);
+                BOOST_CHECK_EQUAL(entry->getField(0), table);
+            });
+        }
+        storage->asyncGetPrimaryKeys(bcos::ledger::SYS_HASH_2_TX, {},
+            [](Error::UniquePtr error, std::vector<std::string> keys) {
+                BOOST_CHECK(!error);
+                BOOST_CHECK_EQUAL(keys.size(), 1);
+            });
+    }
+    boost::filesystem::remove_all(cfPath);
+}
+BOOST_AUTO_TEST_CASE(pipelinedPrepareCommit)
+{
+    // block 2 is prepared before block 1 is committed
+    std::vector<std::shared_ptr<StateStorage>> states;
+    for (size_t number = 1; number <= 2; ++number)
+    {
+        auto state = std::make_shared<StateStorage>(nullptr);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            Entry entry;
+            entry.importFields({boost::lexical_cast<std::string>(number)});
+            state->asyncSetRow(testTableName, "key" + boost::lexical_cast<std::string>(i),
+                std::move(entry), [](Error::UniquePtr error) { BOOST_CHECK(!error); });
+        }
+        bcos::protocol::TwoPCParams params;
+        params.number = number;
+        rocksDBStorage->asyncPrepare(
+            params, *state, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+        states.push_back(state);
+    }
+
+    auto checkValue = [this](const std::string& expected) {
+        rocksDBStorage->asyncGetRow(
+            testTableName, "key0", [&](Error::UniquePtr error, std::optional<Entry> entry) {
+                BOOST_CHECK(!error);
+                BOOST_CHECK(entry);
+                BOOST_CHECK_EQUAL(entry->getField(0), expected);
+            });
+    };
+
+    bcos::protocol::TwoPCParams params;
+    params.number = 1;
+    rocksDBStorage->asyncCommit(params, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+    checkValue("1");
+    // commit the same block again, such as an executor sharing the storage, is a no-op
+    rocksDBStorage->asyncCommit(params, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+    checkValue("1");
+
+    params.number = 2;
+    rocksDBStorage->asyncCommit(params, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+    checkValue("2");
+
+    // rollback drops the block and the blocks prepared on top of it
+    params.number = 3;
+    rocksDBStorage->asyncPrepare(
+        params, *states[0], [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+    rocksDBStorage->asyncRollback(params, [](Error::Ptr error) { BOOST_CHECK(!error); });
+    rocksDBStorage->asyncCommit(params, [](Error::Ptr error, uint64_t) { BOOST_CHECK(!error); });
+    checkValue("2");
+}
+BOOST_AUTO_TEST_CASE(pinnedLargeValue)
+{
+    std::string largeValue(4096, 'a');
+    Entry entry;
+    entry.importFields({largeValue});
+    rocksDBStorage->asyncSetRow(
+        testTableName, "large", entry, [](Error::UniquePtr error) { BOOST_CHECK(!error); });
+
+    std::optional<Entry> pinned;
+    rocksDBStorage->asyncGetRow(
+        testTableName, "large", [&](Error::UniquePtr error, std::optional<Entry> entry) {
+            BOOST_CHECK(!error);
+            pinned = std::move(entry);
+        });
+    std::vector<std::optional<Entry>> pinnedRows;
+    std::vector<std::string> keys{"large"};
+    rocksDBStorage->asyncGetRows(testTableName, keys,
+        [&](Error::UniquePtr error, std::vector<std::optional<Entry>> entries) {
+            BOOST_CHECK(!error);
+            pinnedRows = std::move(entries);
+        });
+
+    // the read entries keep their value after the key is overwritten
+    Entry newEntry;
+    newEntry.importFields({std::string(4096, 'b')});
+    rocksDBStorage->asyncSetRow(
+        testTableName, "large", newEntry, [](Error::UniquePtr error) { BOOST_CHECK(!error); });
+    BOOST_CHECK(pinned);
+    BOOST_CHECK_EQUAL(pinned->get(), largeValue);
+    BOOST_CHECK_EQUAL(pinned->size(), largeValue.size());
+    BOOST_CHECK_EQUAL(pinnedRows.size(), 1);
+    BOOST_CHECK_EQUAL(pinnedRows[0]->get(), largeValue);
+
+    auto copied = *pinned;
+    pinned.reset();
+    BOOST_CHECK_EQUAL(copied.get(), largeValue);
+}
+BOOST_AUTO_TEST_CASE(snapshot)
+{
+    auto setValue = [&](std::string_view key, std::string value) {
+        Entry entry;
+        entry.importFields({std::move(value)});
+        rocksDBStorage->asyncSetRow(
+            testTableName, key, entry, [](Error::UniquePtr error) { BOOST_CHECK(!error); });
+    };
+    setValue("key1", "value1");
+    auto snapshot = rocksDBStorage->snapshot();
+    BOOST_REQUIRE(snapshot);
+
+    // the later writes are not visible in the snapshot
+    setValue("key1", "value2");
+    setValue("key2", "value2");
+    snapshot->asyncGetRow(
+        testTableName, "key1", [](Error::UniquePtr error, std::optional<Entry> entry) {
+            BOOST_CHECK(!error);
+            BOOST_CHECK(entry);
+            BOOST_CHECK_EQUAL(entry->getField(0), "value1");
+        });
+    std::vector<std::string> keys{"key1", "key2"};
+    snapshot->asyncGetRows(testTableName, keys,
+        [](Error::UniquePtr error, std::vector<std::optional<Entry>> entries) {
+            BOOST_CHECK(!error);
+            BOOST_CHECK_EQUAL(entries.size(), 2);
+            BOOST_CHECK(entries[0]);
+            BOOST_CHECK(!entries[1]);
+        });
+    snapshot->asyncSetRow(testTableName, "key3", Entry(),
+        [](Error::UniquePtr error) { BOOST_CHECK(error); });
+
+    rocksDBStorage->asyncGetRow(
+        testTableName, "key1", [](Error::UniquePtr error, std::optional<Entry> entry) {
+            BOOST_CHECK(!error);
+            BOOST_CHECK_EQUAL(entry->getField(0), "value2");
+        });
+}
+BOOST_AUTO_TEST_CASE(stateSnapshotRows)
+{
+    std::string snapshotPath = "./unittestdb_snapshot";
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    for (auto enableColumnFamily : {false, true})
+    {
+        boost::filesystem::remove_all(snapshotPath);
+        RocksDBProfile profile;
+        profile.enableColumnFamily = enableColumnFamily;
+        auto [db, handles] = openRocksDB(snapshotPath, options, profile);
+        auto storage = std::make_shared<RocksDBStorage>(std::move(db), handles, nullptr);
+        auto setRow = [&](std::string_view table, std::string key, std::string value) {
+            BOOST_CHECK(!storage->setRows(table, {std::move(key)}, {std::move(value)}));
+        };
+        for (size_t i = 0; i < 10; ++i)
+        {
+            auto index = boost::lexical_cast<std::string>(i);
+            setRow("/apps/test", "key" + index, "value" + index);
+            setRow(bcos::ledger::SYS_HASH_2_TX, "tx" + index, "tx" + index);
+        }
+        setRow(bcos::ledger::SYS_CONFIG, "tx_count_limit", "1000");
+
+        auto snapshot = std::dynamic_pointer_cast<StateSnapshotInterface>(storage->snapshot());
+        BOOST_REQUIRE(snapshot);
+        setRow("/apps/test", "key0", "changed");
+        setRow("/apps/test", "key10", "value10");
+
+        // the later writes and the history rows are not read, the rows are in the same order
+        // with or without the column families
+        std::vector<std::tuple<std::string, std::string, std::string>> rows;
+        std::string position;
+        size_t chunks = 0;
+        do
+        {
+            size_t size = 0;
+            position = snapshot->readStateRows(position,
+                [&rows, &size](
+                    std::string_view table, std::string_view key, std::string_view value) {
+                    if (size >= 40)
+                    {
+                        return false;
+                    }
+                    size += table.size() + key.size() + value.size() + 1;
+                    rows.emplace_back(table, key, value);
+                    return true;
+                });
+            ++chunks;
+        } while (!position.empty());
+        BOOST_CHECK_EQUAL(chunks, 6);
+        BOOST_REQUIRE_EQUAL(rows.size(), 11);
+        for (size_t i = 0; i < 10; ++i)
+        {
+            auto index = boost::lexical_cast<std::string>(i);
+            BOOST_CHECK_EQUAL(std::get<0>(rows[i]), "/apps/test");
+            BOOST_CHECK_EQUAL(std::get<1>(rows[i]), "key" + index);
+            BOOST_CHECK_EQUAL(std::get<2>(rows[i]), "value" + index);
+        }
+        BOOST_CHECK_EQUAL(std::get<0>(rows[10]), bcos::ledger::SYS_CONFIG);
+        BOOST_CHECK_EQUAL(std::get<2>(rows[10]), "1000");
+    }
+    boost::filesystem::remove_all(snapshotPath);
+}
+BOOST_AUTO_TEST_CASE(stageAndPublishRows)
+{
+    std::string stagingPath = "./unittestdb_staging";
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    for (auto enableColumnFamily : {false, true})
+    {
+        boost::filesystem::remove_all(stagingPath);
+        RocksDBProfile profile;
+        profile.enableColumnFamily = enableColumnFamily;
+        auto open = [&]() {
+            auto [db, handles] = openRocksDB(stagingPath, options, profile);
+            return std::make_shared<RocksDBStorage>(std::move(db), handles, nullptr);
+        };
+        auto storage = open();
+        auto getRow = [&storage](std::string_view table, std::string_view key) {
+            std::optional<std::string> value;
+            storage->asyncGetRow(
+                table, key, [&value](Error::UniquePtr error, std::optional<Entry> entry) {
+                    BOOST_CHECK(!error);
+                    if (entry)
+                    {
+                        value = std::string(entry->get());
+                    }
+                });
+            return value;
+        };
+        BOOST_CHECK(!storage->setRows("/apps/test", {"key0", "stale"}, {"old", "stale"}));
+        BOOST_CHECK(!storage->setRows(bcos::ledger::SYS_CONFIG, {"stale"}, {"stale"}));
+        BOOST_CHECK(!storage->setRows(bcos::ledger::SYS_HASH_2_TX, {"tx0"}, {"tx0"}));
+        BOOST_CHECK(!storage->setRows(bcos::ledger::SYS_CURRENT_STATE,
+            {std::string(bcos::ledger::SYS_KEY_CURRENT_NUMBER),
+                std::string(bcos::ledger::SYS_KEY_TOTAL_TRANSACTION_COUNT)},
+            {"5", "100"}));
+
+        // the staged rows are not visible, and dropped when dropped or reopened
+        BOOST_CHECK(!storage->stageRows("/apps/test", {"key1"}, {"value1"}));
+        BOOST_CHECK(!getRow("/apps/test", "key1"));
+        BOOST_CHECK(!storage->dropStagedRows());
+        BOOST_CHECK(storage->publishStagedRows({}, {}));
+        BOOST_CHECK(!storage->stageRows("/apps/test", {"key1"}, {"value1"}));
+        storage.reset();
+        storage = open();
+        BOOST_CHECK(storage->publishStagedRows({}, {}));
+        BOOST_CHECK_EQUAL(getRow("/apps/test", "key0").value_or(""), "old");
+
+        BOOST_CHECK(
+            !storage->stageRows("/apps/test", {"key0", "key1"}, {"value0", "value1"}));
+        BOOST_CHECK(!storage->stageRows(bcos::ledger::SYS_CONFIG, {"tx_count_limit"}, {"1000"}));
+        BOOST_CHECK(!storage->publishStagedRows(
+            {std::string(bcos::ledger::SYS_KEY_CURRENT_NUMBER)}, {"10"}));
+        // the system and state rows not in the snapshot are deleted, the history rows are kept
+        BOOST_CHECK_EQUAL(getRow("/apps/test", "key0").value_or(""), "value0");
+        BOOST_CHECK_EQUAL(getRow("/apps/test", "key1").value_or(""), "value1");
+        BOOST_CHECK(!getRow("/apps/test", "stale"));
+        BOOST_CHECK(!getRow(bcos::ledger::SYS_CONFIG, "stale"));
+        BOOST_CHECK_EQUAL(getRow(bcos::ledger::SYS_CONFIG, "tx_count_limit").value_or(""), "1000");
+        BOOST_CHECK_EQUAL(getRow(bcos::ledger::SYS_HASH_2_TX, "tx0").value_or(""), "tx0");
+        BOOST_CHECK_EQUAL(getRow(bcos::ledger::SYS_CURRENT_STATE,
+                              bcos::ledger::SYS_KEY_CURRENT_NUMBER)
+                              .value_or(""),
+            "10");
+        BOOST_CHECK(!getRow(
+            bcos::ledger::SYS_CURRENT_STATE, bcos::ledger::SYS_KEY_TOTAL_TRANSACTION_COUNT));
+        // the staged rows are dropped after published
+        BOOST_CHECK(storage->publishStagedRows({}, {}));
+    }
+    boost::filesystem::remove_all(stagingPath);
+}
+BOOST_AUTO_TEST_CASE(resumePublishStagedRows)
+{
+    std::string stagingPath = "./unittestdb_resume";
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    for (auto enableColumnFamily : {false, true})
+    {
+        boost::filesystem::remove_all(stagingPath);
+        RocksDBProfile profile;
+        profile.enableColumnFamily = enableColumnFamily;
+        {
+            auto [db, handles] = openRocksDB(stagingPath, options, profile);
+            std::array<rocksdb::ColumnFamilyHandle*, TABLE_CATEGORY_COUNT> categoryHandles;
+            std::copy(handles.begin(), handles.end(), categoryHandles.begin());
+            auto put = [&](rocksdb::ColumnFamilyHandle* handle, std::string_view table,
+                           std::string_view key, std::string_view value) {
+                auto dbKey = toDBKey(table, key);
+                BOOST_CHECK(db->Put(rocksdb::WriteOptions(), handle, dbKey,
+                                  rocksdb::Slice(value.data(), value.size()))
+                                .ok());
+            };
+            auto* stateHandle = categoryHandles[static_cast<size_t>(TableCategory::STATE)];
+            put(stateHandle, "/apps/test", "stale", "stale");
+            put(categoryHandles[static_cast<size_t>(TableCategory::SYSTEM)],
+                bcos::ledger::SYS_CURRENT_STATE, bcos::ledger::SYS_KEY_CURRENT_NUMBER, "5");
+
+            rocksdb::ColumnFamilyHandle* staging = nullptr;
+            BOOST_CHECK(db->CreateColumnFamily(rocksdb::ColumnFamilyOptions(),
+                              std::string(SNAPSHOT_STAGING_COLUMN_FAMILY), &staging)
+                            .ok());
+            for (size_t i = 0; i < 100; ++i)
+            {
+                put(staging, "/apps/test", "key" + std::to_string(i), "value");
+            }
+            put(staging, bcos::ledger::SYS_CURRENT_STATE, bcos::ledger::SYS_KEY_CURRENT_NUMBER,
+                "10");
+            // published in batches of one row, and again as after an interrupted publish
+            BOOST_CHECK(publishStagingColumnFamily(*db, categoryHandles, staging, 1).ok());
+            BOOST_CHECK(publishStagingColumnFamily(*db, categoryHandles, staging, 1).ok());
+            std::string value;
+            BOOST_CHECK(db->Get(rocksdb::ReadOptions(), stateHandle, toDBKey("/apps/test", "key99"),
+                              &value)
+                            .ok());
+            BOOST_CHECK_EQUAL(value, "value");
+            BOOST_CHECK(db->Get(rocksdb::ReadOptions(), stateHandle,
+                              toDBKey("/apps/test", "stale"), &value)
+                            .IsNotFound());
+
+            // the publish is finished when reopened if the marker is written
+            put(staging, "/apps/test", "resumed", "resumed");
+            BOOST_CHECK(db->Put(rocksdb::WriteOptions(), staging,
+                              rocksdb::Slice(SNAPSHOT_PUBLISHING_KEY.data(),
+                                  SNAPSHOT_PUBLISHING_KEY.size()),
+                              rocksdb::Slice())
+                            .ok());
+            db->DestroyColumnFamilyHandle(staging);
+            std::set<rocksdb::ColumnFamilyHandle*> uniqueHandles(handles.begin(), handles.end());
+            for (auto* handle : uniqueHandles)
+            {
+                if (handle != db->DefaultColumnFamily())
+                {
+                    db->DestroyColumnFamilyHandle(handle);
+                }
+            }
+        }
+        auto [db, handles] = openRocksDB(stagingPath, options, profile);
+        auto storage = std::make_shared<RocksDBStorage>(std::move(db), handles, nullptr);
+        auto getRow = [&storage](std::string_view table, std::string_view key) {
+            std::optional<std::string> value;
+            storage->asyncGetRow(
+                table, key, [&value](Error::UniquePtr error, std::optional<Entry> entry) {
+                    BOOST_CHECK(!error);
+                    if (entry)
+                    {
+                        value = std::string(entry->get());
+                    }
+                });
+            return value;
+        };
+        BOOST_CHECK_EQUAL(getRow("/apps/test", "resumed").value_or(""), "resumed");
+        BOOST_CHECK_EQUAL(getRow(bcos::ledger::SYS_CURRENT_STATE,
+                              bcos::ledger::SYS_KEY_CURRENT_NUMBER)
+                              .value_or(""),
+            "10");
+        // the staging column family is dropped
+        BOOST_CHECK(storage->publishStagedRows({}, {}));
+    }
+    boost::filesystem::remove_all(stagingPath);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace bcos::test
\ No newline at end of file
@@ -38,10 +38,17 @@ BlockSync::BlockSync(BlockSyncConfig::Ptr _config, unsigned _idleWaitMs)
 {
     m_downloadBlockProcessor = std::make_shared<bcos::ThreadPool>("Download", 1);
     m_sendBlockProcessor = std::make_shared<bcos::ThreadPool>("SyncSend", 1);
+    m_encodedBlockCache = std::make_shared<EncodedBlockCache>(c_encodedBlockCacheSize);
+    m_downloadScheduler = std::make_shared<DownloadScheduler>(
+        m_config->maxRequestBlocks(), m_config->maxShardPerPeer());
     m_downloadingTimer = std::make_shared<Timer>(m_config->downloadTimeout(), "downloadTimer");
     m_downloadingTimer->registerTimeoutHandler(boost::bind(&BlockSync::onDownloadTimeout, this));
     m_downloadingQueue->registerNewBlockHandler(
         boost::bind(&BlockSync::onNewBlock, this, boost::placeholders::_1));
+    m_downloadingQueue->registerBlocksVerifiedHandler(
+        boost::bind(&BlockSync::onBlocksVerified, this, boost::placeholders::_1));
+    m_downloadingQueue->registerBlocksDroppedHandler(
+        boost::bind(&BlockSync::onBlocksDropped, this, boost::placeholders::_1));
     initSendResponseHandler();
 }
 
@@ -96,6 +103,24 @@ void BlockSync::enableAsMaster(bool _masterNode)
     m_masterNode = _masterNode;
 }
 
+void BlockSync::enableStateSnapshot(bcos::storage::TransactionalStorageInterface::Ptr _storage,
+    BlockNumber _interval, BlockNumber _ledgerWindow,
+    StateSnapshotExporter::ValueNormalizer _normalizer)
+{
+    if (_interval <= 0)
+    {
+        return;
+    }
+    auto hashImpl = m_config->blockFactory()->cryptoSuite()->hashImpl();
+    m_snapshotExporter =
+        std::make_shared<StateSnapshotExporter>(_storage, hashImpl, _interval, _ledgerWindow);
+    m_snapshotExporter->setValueNormalizer(std::move(_normalizer));
+    m_snapshotImporter = std::make_shared<StateSnapshotImporter>(_storage, hashImpl,
+        m_config->blockFactory()->blockHeaderFactory(), m_config->maxShardPerPeer());
+    BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("enableStateSnapshot")
+                      << LOG_KV("interval", _interval) << LOG_KV("ledgerWindow", _ledgerWindow);
+}
+
 void BlockSync::initSendResponseHandler()
 {
     // set the sendResponse callback
@@ -348,6 +373,18 @@ void BlockSync::asyncNotifyBlockSyncMessage(Error::Ptr _error, NodeIDPtr _nodeID
             onPeerBlocks(_nodeID, syncMsg);
             break;
         }
+        case BlockSyncPacketType::SnapshotManifestRequestPacket:
+        case BlockSyncPacketType::SnapshotChunkRequestPacket:
+        {
+            onPeerSnapshotRequest(_nodeID, syncMsg);
+            break;
+        }
+        case BlockSyncPacketType::SnapshotManifestResponsePacket:
+        case BlockSyncPacketType::SnapshotChunkResponsePacket:
+        {
+            onPeerSnapshotResponse(_nodeID, syncMsg);
+            break;
+        }
         default:
         {
             BLKSYNC_LOG(WARNING) << LOG_DESC(
@@ -391,6 +428,10 @@ void BlockSync::onNewBlock(bcos::ledger::LedgerConfig::Ptr _ledgerConfig)
     m_config->resetConfig(_ledgerConfig);
     broadcastSyncStatus();
     m_downloadingQueue->clearExpiredQueueCache();
+    if (m_snapshotExporter)
+    {
+        m_snapshotExporter->onCommitted(_ledgerConfig->blockNumber());
+    }
 }
 
 void BlockSync::onPeerStatus(NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg)
@@ -409,13 +450,49 @@ void BlockSync::onPeerStatus(NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _sync
 void BlockSync::onPeerBlocks(NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg)
 {
     auto blockMsg = m_config->msgFactory()->createBlocksMsg(_syncMsg);
+    size_t msgSize = 0;
+    for (size_t i = 0; i < blockMsg->blocksSize(); i++)
+    {
+        msgSize += blockMsg->blockData(i).size();
+    }
     BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                        << LOG_DESC("Receive peer block packet")
-                       << LOG_KV("peer", _nodeID->shortHex());
-    m_downloadingQueue->push(blockMsg);
+                       << LOG_KV("peer", _nodeID->shortHex()) << LOG_KV("from", blockMsg->number())
+                       << LOG_KV("blocks", blockMsg->blocksSize()) << LOG_KV("msgSize", msgSize);
+    // the blocks not requested from the peer, or received already, are dropped, they are neither
+    // queued nor credited to the peer
+    if (!m_downloadScheduler->expects(_nodeID, blockMsg->number(), blockMsg->blocksSize()))
+    {
+        BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                           << LOG_DESC("Drop the unrequested blocks")
+                           << LOG_KV("peer", _nodeID->shortHex())
+                           << LOG_KV("from", blockMsg->number())
+                           << LOG_KV("blocks", blockMsg->blocksSize());
+        return;
+    }
+    m_downloadingQueue->push(blockMsg, _nodeID);
     m_signalled.notify_all();
 }
 
+void BlockSync::onBlocksVerified(std::vector<DownloadingQueue::VerifiedBlock> const& _blocks)
+{
+    auto now = utcSteadyTime();
+    for (auto const& block : _blocks)
+    {
+        m_downloadScheduler->onBlocksReceived(block.peer, block.number, 1, block.bytes, now);
+    }
+    // the download timeout only fires when no verified blocks arrive any more
+    if (isSyncing())
+    {
+        m_downloadingTimer->restart();
+    }
+}
+
+void BlockSync::onBlocksDropped(std::vector<BlockNumber> const& _numbers)
+{
+    m_downloadScheduler->onBlocksDropped(_numbers, utcSteadyTime());
+}
+
 void BlockSync::onPeerBlocksRequest(NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg)
 {
     auto blockRequest = m_config->msgFactory()->createBlockRequest(_syncMsg);
@@ -450,21 +527,159 @@ void BlockSync::onPeerBlocksRequest(NodeIDPtr _nodeID, BlockSyncMsgInterface::Pt
                          << LOG_KV("size", blockRequest->size());
 }
 
+void BlockSync::onPeerSnapshotRequest(NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg)
+{
+    if (!m_snapshotExporter || !m_config->existsInGroup(_nodeID))
+    {
+        return;
+    }
+    auto request = m_config->msgFactory()->createBlockRequest(_syncMsg);
+    if (request->packetType() == BlockSyncPacketType::SnapshotManifestRequestPacket)
+    {
+        auto manifest = m_snapshotExporter->manifest();
+        if (!manifest)
+        {
+            return;
+        }
+        auto manifestMsg = m_config->msgFactory()->createBlocksMsg();
+        manifestMsg->setPacketType(BlockSyncPacketType::SnapshotManifestResponsePacket);
+        encodeSnapshotManifest(manifestMsg, *manifest);
+        auto encodedData = manifestMsg->encode();
+        m_config->frontService()->asyncSendMessageByNodeID(
+            ModuleID::BlockSync, _nodeID, ref(*encodedData), 0, nullptr);
+        BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("send snapshot manifest")
+                          << LOG_KV("number", manifest->number)
+                          << LOG_KV("chunks", manifest->chunkHashes.size())
+                          << LOG_KV("peer", _nodeID->shortHex());
+        return;
+    }
+    // the chunk is read from the storage snapshot by the send thread
+    m_sendBlockProcessor->enqueue([this, _nodeID, number = request->number(),
+                                      index = request->size()]() {
+        try
+        {
+            auto chunk = m_snapshotExporter->chunk(number, index);
+            if (!chunk)
+            {
+                BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                                     << LOG_DESC("the requested snapshot chunk not found")
+                                     << LOG_KV("number", number) << LOG_KV("index", index)
+                                     << LOG_KV("peer", _nodeID->shortHex());
+                return;
+            }
+            auto chunkMsg = m_config->msgFactory()->createBlocksMsg();
+            chunkMsg->setPacketType(BlockSyncPacketType::SnapshotChunkResponsePacket);
+            chunkMsg->setNumber(number);
+            chunkMsg->appendBlockData(std::move(*chunk));
+            auto encodedData = chunkMsg->encode();
+            m_config->frontService()->asyncSendMessageByNodeID(
+                ModuleID::BlockSync, _nodeID, ref(*encodedData), 0, nullptr);
+            BLKSYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("send snapshot chunk")
+                               << LOG_KV("number", number) << LOG_KV("index", index)
+                               << LOG_KV("size", encodedData->size())
+                               << LOG_KV("peer", _nodeID->shortHex());
+        }
+        catch (std::exception const& e)
+        {
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("send snapshot chunk failed")
+                                 << LOG_KV("number", number) << LOG_KV("index", index)
+                                 << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    });
+}
+
+void BlockSync::onPeerSnapshotResponse(NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg)
+{
+    if (!m_snapshotImporter)
+    {
+        return;
+    }
+    auto blocksMsg = m_config->msgFactory()->createBlocksMsg(_syncMsg);
+    if (blocksMsg->packetType() == BlockSyncPacketType::SnapshotManifestResponsePacket)
+    {
+        // only the consensus nodes vote for the snapshot
+        auto consensusNodes = m_config->consensusNodeList();
+        if (std::none_of(consensusNodes.begin(), consensusNodes.end(), [&_nodeID](auto&& _node) {
+                return _node->nodeID()->data() == _nodeID->data();
+            }))
+        {
+            return;
+        }
+        auto manifest = decodeSnapshotManifest(
+            m_config->blockFactory()->cryptoSuite()->hashImpl(), blocksMsg);
+        if (!manifest)
+        {
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("invalid snapshot manifest")
+                                 << LOG_KV("peer", _nodeID->shortHex());
+            return;
+        }
+        BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("receive snapshot manifest")
+                          << LOG_KV("number", manifest->number)
+                          << LOG_KV("chunks", manifest->chunkHashes.size())
+                          << LOG_KV("digest", manifest->digest.abridged())
+                          << LOG_KV("peer", _nodeID->shortHex());
+        m_snapshotImporter->onManifest(_nodeID, std::move(*manifest));
+        m_signalled.notify_all();
+        return;
+    }
+    if (blocksMsg->blocksSize() == 0)
+    {
+        return;
+    }
+    // the chunks are imported one at a time by the download thread
+    m_downloadBlockProcessor->enqueue([this, _nodeID, blocksMsg]() {
+        try
+        {
+            auto error =
+                m_snapshotImporter->onChunk(_nodeID, blocksMsg->number(), blocksMsg->blockData(0));
+            if (error)
+            {
+                BLKSYNC_LOG(WARNING)
+                    << LOG_BADGE("Snapshot") << LOG_DESC("import snapshot chunk failed")
+                    << LOG_KV("number", blocksMsg->number()) << LOG_KV("peer", _nodeID->shortHex())
+                    << LOG_KV("code", error->errorCode()) << LOG_KV("msg", error->errorMessage());
+                return;
+            }
+            if (m_snapshotImporter->imported())
+            {
+                BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot")
+                                  << LOG_DESC("the state snapshot is imported, restart the node "
+                                              "to sync the remaining blocks")
+                                  << LOG_KV("number", blocksMsg->number());
+            }
+            m_signalled.notify_all();
+        }
+        catch (std::exception const& e)
+        {
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("import snapshot exception")
+                                 << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    });
+}
+
 void BlockSync::onDownloadTimeout()
 {
     // stop the timer and reset the state to idle
     m_downloadingTimer->stop();
+    // the outstanding requests are sent again in the next round
+    m_downloadScheduler->onTimeout(utcSteadyTime());
     m_state = SyncState::Idle;
 }
 
 void BlockSync::downloadFinish()
 {
     m_downloadingTimer->stop();
+    m_downloadScheduler->clear();
     m_state = SyncState::Idle;
 }
 
 void BlockSync::tryToRequestBlocks()
 {
+    if (syncingSnapshot())
+    {
+        requestSnapshot();
+        return;
+    }
     // wait the downloaded block commit to the ledger, and enable the next batch requests
     if (m_config->blockNumber() < m_config->executedBlock() &&
         m_downloadingQueue->commitQueueSize() > 0)
@@ -476,10 +691,12 @@ void BlockSync::tryToRequestBlocks()
     {
         downloadFinish();
     }
-    if (!shouldSyncing() || isSyncing())
+    // keep requesting while downloading, the scheduled blocks are not requested again
+    if (!shouldSyncing())
     {
         return;
     }
+    m_downloadScheduler->expire(m_config->blockNumber());
     auto requestToNumber = m_config->knownHighestNumber();
     m_config->consensus()->notifyHighestSyncingNumber(requestToNumber);
     auto topBlock = m_downloadingQueue->top();
@@ -502,63 +719,134 @@ void BlockSync::tryToRequestBlocks()
     requestBlocks(currentNumber, requestToNumber);
 }
 
-void BlockSync::requestBlocks(BlockNumber _from, BlockNumber _to)
+bool BlockSync::syncingSnapshot()
 {
-    BLKSYNC_LOG(INFO) << LOG_BADGE("Download") << LOG_BADGE("requestBlocks")
-                      << LOG_KV("from", _from) << LOG_KV("to", _to);
-    m_state = SyncState::Downloading;
-    m_downloadingTimer->start();
-
-    auto blockSizePerShard = m_config->maxRequestBlocks();
-    auto shardNumber = (_to - _from + blockSizePerShard - 1) / blockSizePerShard;
-    size_t shard = 0;
-    // at most request `maxShardPerPeer` shards every time
-    for (size_t loop = 0; loop < m_config->maxShardPerPeer() && shard < shardNumber; loop++)
-    {
-        bool findPeer = false;
-        m_syncStatus->foreachPeerRandom([&](PeerStatus::Ptr _p) {
-            if (_p->number() < m_config->knownHighestNumber())
-            {
-                // Only send request to nodes which are not syncing(has max number)
-                return true;
-            }
-            // shard: [from, to]
-            BlockNumber from = _from + 1 + shard * blockSizePerShard;
-            BlockNumber to = std::min((BlockNumber)(from + blockSizePerShard - 1), _to);
-            if (_p->number() < to)
-            {
-                return true;  // to next peer
-            }
-            // found a peer
-            findPeer = true;
-            auto blockRequest = m_config->msgFactory()->createBlockRequest();
-            blockRequest->setNumber(from);
-            blockRequest->setSize(to - from + 1);
-            auto encodedData = blockRequest->encode();
-            m_config->frontService()->asyncSendMessageByNodeID(
-                ModuleID::BlockSync, _p->nodeId(), ref(*encodedData), 0, nullptr);
-
-            m_maxRequestNumber = std::max(m_maxRequestNumber.load(), to);
+    if (!m_snapshotImporter || m_snapshotSyncGiveUp)
+    {
+        return false;
+    }
+    if (m_snapshotImporter->imported() || m_snapshotImporter->manifest())
+    {
+        return true;
+    }
+    // only the node with no blocks joins from a snapshot
+    return m_config->blockNumber() == 0 &&
+           m_config->knownHighestNumber() >= m_snapshotExporter->interval();
+}
 
-            BLKSYNC_LOG(INFO) << LOG_BADGE("Download") << LOG_BADGE("Request")
-                              << LOG_DESC("Request blocks") << LOG_KV("from", from)
-                              << LOG_KV("to", to) << LOG_KV("curNum", m_config->blockNumber())
-                              << LOG_KV("peer", _p->nodeId()->shortHex())
-                              << LOG_KV("maxRequestNumber", m_maxRequestNumber)
-                              << LOG_KV("node", m_config->nodeID()->shortHex());
+void BlockSync::requestSnapshot()
+{
+    // wait for the restart
+    if (m_snapshotImporter->imported())
+    {
+        return;
+    }
+    auto now = utcSteadyTime();
+    if (!m_snapshotImporter->manifest())
+    {
+        if (m_snapshotSyncStartTime == 0)
+        {
+            m_snapshotSyncStartTime = now;
+        }
+        if (now - m_snapshotSyncStartTime > c_snapshotManifestTimeout)
+        {
+            m_snapshotSyncGiveUp = true;
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                                 << LOG_DESC("no snapshot agreed by the consensus nodes, "
+                                             "sync the blocks instead");
+            return;
+        }
+        if (now - m_lastManifestRequestTime >= c_snapshotManifestRequestInterval)
+        {
+            m_lastManifestRequestTime = now;
+            auto manifestRequest = m_config->msgFactory()->createBlockRequest();
+            manifestRequest->setPacketType(BlockSyncPacketType::SnapshotManifestRequestPacket);
+            auto encodedData = manifestRequest->encode();
+            m_config->frontService()->asyncSendBroadcastMessage(
+                bcos::protocol::NodeType::CONSENSUS_NODE, ModuleID::BlockSync, ref(*encodedData));
+        }
+    }
+    // at least one honest node among the consensus nodes agreeing on the snapshot
+    auto consensusNodes = m_config->consensusNodeList();
+    auto quorum = consensusNodes.size() / 3 + 1;
+    // the checkpoint header is trusted only if signed by the consensus nodes known before
+    m_snapshotImporter->setTrustedSealers(consensusNodes);
+    auto requests = m_snapshotImporter->schedule(quorum, now);
+    for (auto const& request : requests)
+    {
+        auto chunkRequest = m_config->msgFactory()->createBlockRequest();
+        chunkRequest->setPacketType(BlockSyncPacketType::SnapshotChunkRequestPacket);
+        chunkRequest->setNumber(request.number);
+        chunkRequest->setSize(request.index);
+        auto encodedData = chunkRequest->encode();
+        m_config->frontService()->asyncSendMessageByNodeID(
+            ModuleID::BlockSync, request.peer, ref(*encodedData), 0, nullptr);
+    }
+    if (!requests.empty())
+    {
+        BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("request snapshot chunks")
+                          << LOG_KV("number", requests.front().number)
+                          << LOG_KV("requests", requests.size())
+                          << LOG_KV("imported", m_snapshotImporter->importedChunks());
+    }
+}
 
-            ++shard;  // shard move
-            return shard < shardNumber;
-        });
-        if (!findPeer)
+void BlockSync::requestBlocks(BlockNumber _from, BlockNumber _to)
+{
+    // Note: the peers are visited randomly to spread the requests among the equally rated peers
+    DownloadScheduler::Peers peers;
+    m_syncStatus->foreachPeerRandom([&](PeerStatus::Ptr _p) {
+        if (_p->nodeId()->data() != m_config->nodeID()->data())
+        {
+            peers.emplace_back(_p->nodeId(), _p->number());
+        }
+        return true;
+    });
+    // at most maxDownloadingBlockQueueSize blocks ahead of the ledger
+    auto requestTo = std::min(_to, (BlockNumber)(_from + m_config->maxDownloadingBlockQueueSize()));
+    auto now = utcSteadyTime();
+    auto requests = m_downloadScheduler->hedge(peers, now);
+    auto hedgedSize = requests.size();
+    auto stripes = m_downloadScheduler->schedule(_from + 1, requestTo, peers, now);
+    requests.insert(requests.end(), stripes.begin(), stripes.end());
+    if (requests.empty())
+    {
+        if (m_downloadScheduler->pendingShards() == 0)
         {
-            BlockNumber from = _from + shard * blockSizePerShard;
-            BlockNumber to = std::min((BlockNumber)(from + blockSizePerShard - 1), _to);
             BLKSYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Request")
                                  << LOG_DESC("Couldn't find any peers to request blocks")
-                                 << LOG_KV("from", from) << LOG_KV("to", to);
-            break;
+                                 << LOG_KV("from", _from + 1) << LOG_KV("to", requestTo);
         }
+        return;
+    }
+    BLKSYNC_LOG(INFO) << LOG_BADGE("Download") << LOG_BADGE("requestBlocks")
+                      << LOG_KV("from", _from) << LOG_KV("to", _to)
+                      << LOG_KV("requests", requests.size()) << LOG_KV("hedged", hedgedSize);
+    if (!isSyncing())
+    {
+        m_state = SyncState::Downloading;
+        m_downloadingTimer->start();
+    }
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        auto const& request = requests[i];
+        auto blockRequest = m_config->msgFactory()->createBlockRequest();
+        blockRequest->setNumber(request.from);
+        blockRequest->setSize(request.size);
+        auto encodedData = blockRequest->encode();
+        m_config->frontService()->asyncSendMessageByNodeID(
+            ModuleID::BlockSync, request.peer, ref(*encodedData), 0, nullptr);
+
+        BlockNumber to = request.from + request.size - 1;
+        m_maxRequestNumber = std::max(m_maxRequestNumber.load(), to);
+
+        BLKSYNC_LOG(INFO) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                          << LOG_DESC(i < hedgedSize ? "Hedge blocks" : "Request blocks")
+                          << LOG_KV("from", request.from) << LOG_KV("to", to)
+                          << LOG_KV("curNum", m_config->blockNumber())
+                          << LOG_KV("peer", request.peer->shortHex())
+                          << LOG_KV("maxRequestNumber", m_maxRequestNumber)
+                          << LOG_KV("node", m_config->nodeID()->shortHex());
     }
 }
 
@@ -648,63 +936,134 @@ void BlockSync::maintainBlockRequest()
                                << LOG_KV("from", blocksReq->fromNumber())
                                << LOG_KV("size", blocksReq->size()) << LOG_KV("to", numberLimit - 1)
                                << LOG_KV("peer", _p->nodeId()->shortHex());
-            for (BlockNumber number = blocksReq->fromNumber(); number < numberLimit; number++)
-            {
-                fetchAndSendBlock(reqQueue, _p->nodeId(), number);
-            }
+            fetchAndSendBlocks(reqQueue, _p->nodeId(), blocksReq->fromNumber(), blocksReq->size());
         }
         return true;
     });
 }
 
-void BlockSync::fetchAndSendBlock(
-    DownloadRequestQueue::Ptr _reqQueue, PublicPtr _peer, BlockNumber _number)
+void BlockSync::fetchAndSendBlocks(
+    DownloadRequestQueue::Ptr _reqQueue, PublicPtr _peer, BlockNumber _from, size_t _size)
 {
+    auto blocks = std::make_shared<std::vector<EncodedBlock>>(_size);
+    std::vector<BlockNumber> missingBlocks;
+    for (size_t i = 0; i < _size; i++)
+    {
+        (*blocks)[i] = m_encodedBlockCache->get(_from + i).value_or(nullptr);
+        if (!(*blocks)[i])
+        {
+            missingBlocks.emplace_back(_from + i);
+        }
+    }
+    BLKSYNC_LOG(DEBUG) << LOG_DESC("fetchAndSendBlocks") << LOG_KV("from", _from)
+                       << LOG_KV("size", _size) << LOG_KV("missing", missingBlocks.size())
+                       << LOG_KV("cacheHits", m_encodedBlockCache->hits())
+                       << LOG_KV("cacheMisses", m_encodedBlockCache->misses())
+                       << LOG_KV("cacheSize", m_encodedBlockCache->size());
+    if (missingBlocks.empty())
+    {
+        sendBlocks(_peer, _from, *blocks);
+        return;
+    }
+
+    // read the missing blocks at the same time, send the range when the last one is read
     // only fetch blockHeader and transactions
     auto blockFlag = HEADER | TRANSACTIONS;
     auto self = std::weak_ptr<BlockSync>(shared_from_this());
-    m_config->ledger()->asyncGetBlockDataByNumber(_number, blockFlag,
-        [self, _reqQueue, _peer, _number](Error::Ptr _error, Block::Ptr _block) {
-            if (_error != nullptr)
-            {
-                BLKSYNC_LOG(WARNING)
-                    << LOG_DESC("fetchAndSendBlock failed for asyncGetBlockDataByNumber failed")
-                    << LOG_KV("number", _number) << LOG_KV("errorCode", _error->errorCode())
-                    << LOG_KV("errorMessage", _error->errorMessage());
-                _reqQueue->push(_number, 1);
-                return;
-            }
-            try
-            {
+    auto pending = std::make_shared<std::atomic_size_t>(missingBlocks.size());
+    for (auto number : missingBlocks)
+    {
+        m_config->ledger()->asyncGetBlockDataByNumber(number, blockFlag,
+            [self, _reqQueue, _peer, _from, number, blocks, pending](
+                Error::Ptr _error, Block::Ptr _block) {
                 auto sync = self.lock();
                 if (!sync)
                 {
                     return;
                 }
-                auto blockHeader = _block->blockHeader();
-                auto signature = blockHeader->signatureList();
-                auto config = sync->m_config;
-                auto blocksReq = config->msgFactory()->createBlocksMsg();
-                bytesPointer blockData = std::make_shared<bytes>();
-                _block->encode(*blockData);
-                blocksReq->appendBlockData(std::move(*blockData));
-                blocksReq->setNumber(_number);
-                config->frontService()->asyncSendMessageByNodeID(
-                    ModuleID::BlockSync, _peer, ref(*(blocksReq->encode())), 0, nullptr);
-                BLKSYNC_LOG(DEBUG)
-                    << LOG_DESC("fetchAndSendBlock: response block")
-                    << LOG_KV("toPeer", _peer->shortHex()) << LOG_KV("number", _number)
-                    << LOG_KV("hash", blockHeader->hash().abridged())
-                    << LOG_KV("signatureSize", signature.size())
-                    << LOG_KV("transactionsSize", _block->transactionsSize());
-            }
-            catch (std::exception const& e)
-            {
-                BLKSYNC_LOG(WARNING)
-                    << LOG_DESC("fetchAndSendBlock exception") << LOG_KV("number", _number)
-                    << LOG_KV("error", boost::diagnostic_information(e));
-            }
-        });
+                if (_error != nullptr)
+                {
+                    BLKSYNC_LOG(WARNING)
+                        << LOG_DESC("fetchAndSendBlocks: asyncGetBlockDataByNumber failed")
+                        << LOG_KV("number", number) << LOG_KV("errorCode", _error->errorCode())
+                        << LOG_KV("errorMessage", _error->errorMessage());
+                    _reqQueue->push(number, 1);
+                }
+                else
+                {
+                    try
+                    {
+                        auto blockData = std::make_shared<bytes>();
+                        _block->encode(*blockData);
+                        sync->m_encodedBlockCache->tryInsert(number, blockData, blockData->size());
+                        (*blocks)[number - _from] = std::move(blockData);
+                    }
+                    catch (std::exception const& e)
+                    {
+                        BLKSYNC_LOG(WARNING)
+                            << LOG_DESC("fetchAndSendBlocks exception") << LOG_KV("number", number)
+                            << LOG_KV("error", boost::diagnostic_information(e));
+                    }
+                }
+                if (--(*pending) == 0)
+                {
+                    sync->sendBlocks(_peer, _from, *blocks);
+                }
+            });
+    }
+}
+
+void BlockSync::sendBlocks(
+    PublicPtr _peer, BlockNumber _from, std::vector<EncodedBlock> const& _blocks)
+{
+    BlocksMsgInterface::Ptr blocksMsg;
+    size_t msgSize = 0;
+    auto sendBlocksMsg = [&]() {
+        if (!blocksMsg)
+        {
+            return;
+        }
+        try
+        {
+            m_config->frontService()->asyncSendMessageByNodeID(
+                ModuleID::BlockSync, _peer, ref(*(blocksMsg->encode())), 0, nullptr);
+            BLKSYNC_LOG(DEBUG) << LOG_DESC("sendBlocks: response blocks")
+                               << LOG_KV("toPeer", _peer->shortHex())
+                               << LOG_KV("from", blocksMsg->number())
+                               << LOG_KV("blocks", blocksMsg->blocksSize())
+                               << LOG_KV("msgSize", msgSize);
+        }
+        catch (std::exception const& e)
+        {
+            BLKSYNC_LOG(WARNING) << LOG_DESC("sendBlocks exception")
+                                 << LOG_KV("from", blocksMsg->number())
+                                 << LOG_KV("error", boost::diagnostic_information(e));
+        }
+        blocksMsg = nullptr;
+        msgSize = 0;
+    };
+    for (size_t i = 0; i < _blocks.size(); i++)
+    {
+        auto const& blockData = _blocks[i];
+        // the blocks in a message are consecutive
+        if (!blockData)
+        {
+            sendBlocksMsg();
+            continue;
+        }
+        if (blocksMsg && msgSize + blockData->size() > m_config->maxBlocksMsgSize())
+        {
+            sendBlocksMsg();
+        }
+        if (!blocksMsg)
+        {
+            blocksMsg = m_config->msgFactory()->createBlocksMsg();
+            blocksMsg->setNumber(_from + i);
+        }
+        blocksMsg->appendBlockData(*blockData);
+        msgSize += blockData->size();
+    }
+    sendBlocksMsg();
 }
 
 void BlockSync::maintainPeersConnection()
@@ -736,6 +1095,11 @@ void BlockSync::maintainPeersConnection()
     for (auto node : peersToDelete)
     {
         m_syncStatus->deletePeer(node);
+        m_downloadScheduler->removePeer(node);
+        if (m_snapshotImporter)
+        {
+            m_snapshotImporter->removePeer(node);
+        }
     }
     // Add new peers
     auto groupNodeList = m_config->groupNodeList();
@@ -807,6 +1171,13 @@ void BlockSync::asyncGetSyncInfo(std::function<void(Error::Ptr, std::string)> _o
     syncInfo["latestHash"] = *toHexString(m_config->hash());
     syncInfo["knownHighestNumber"] = m_config->knownHighestNumber();
     syncInfo["knownLatestHash"] = *toHexString(m_config->knownLatestHash());
+    auto snapshotManifest = m_snapshotImporter ? m_snapshotImporter->manifest() : std::nullopt;
+    if (snapshotManifest)
+    {
+        syncInfo["snapshotNumber"] = snapshotManifest->number;
+        syncInfo["snapshotChunks"] = Json::UInt64(snapshotManifest->chunkHashes.size());
+        syncInfo["snapshotImportedChunks"] = Json::UInt64(m_snapshotImporter->importedChunks());
+    }
 
     Json::Value peersInfo(Json::arrayValue);
     m_syncStatus->foreachPeer([&](PeerStatus::Ptr _p) {
@@ -820,6 +1191,14 @@ void BlockSync::asyncGetSyncInfo(std::function<void(Error::Ptr, std::string)> _o
         info["genesisHash"] = *toHexString(_p->genesisHash());
         info["blockNumber"] = Json::UInt64(_p->number());
         info["latestHash"] = *toHexString(_p->hash());
+        auto downloadRate = m_downloadScheduler->peerRate(_p->nodeId());
+        if (downloadRate)
+        {
+            // bytes and blocks per second, and milliseconds
+            info["downloadRate"] = Json::UInt64(downloadRate->bytesRate);
+            info["downloadBlocksRate"] = downloadRate->blocksRate;
+            info["downloadLatency"] = Json::UInt64(downloadRate->latency);
+        }
         peersInfo.append(info);
         return true;
     });
@@ -20,7 +20,11 @@
  */
 #pragma once
 #include "bcos-sync/BlockSyncConfig.h"
+#include "bcos-sync/state/DownloadScheduler.h"
 #include "bcos-sync/state/DownloadingQueue.h"
+#include "bcos-sync/state/EncodedBlockCache.h"
+#include "bcos-sync/state/StateSnapshotExporter.h"
+#include "bcos-sync/state/StateSnapshotImporter.h"
 #include "bcos-sync/state/SyncPeerStatus.h"
 #include <bcos-framework/sync/BlockSyncInterface.h>
 #include <bcos-utilities/ThreadPool.h>
@@ -76,6 +80,13 @@ public:
 
     void enableAsMaster(bool _masterNode);
 
+    // exports the state snapshot every _interval blocks, and a node with no blocks joins from the
+    // latest snapshot agreed by the consensus nodes when at least _interval blocks behind; the
+    // node must be restarted after the snapshot is imported
+    void enableStateSnapshot(bcos::storage::TransactionalStorageInterface::Ptr _storage,
+        bcos::protocol::BlockNumber _interval, bcos::protocol::BlockNumber _ledgerWindow,
+        StateSnapshotExporter::ValueNormalizer _normalizer = nullptr);
+
 protected:
     virtual void asyncNotifyBlockSyncMessage(Error::Ptr _error, bcos::crypto::NodeIDPtr _nodeID,
         bytesConstRef _data, std::function<void(bytesConstRef _respData)> _sendResponse,
@@ -89,11 +100,21 @@ protected:
     virtual void onPeerBlocks(bcos::crypto::NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg);
     virtual void onPeerBlocksRequest(
         bcos::crypto::NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg);
+    virtual void onPeerSnapshotRequest(
+        bcos::crypto::NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg);
+    virtual void onPeerSnapshotResponse(
+        bcos::crypto::NodeIDPtr _nodeID, BlockSyncMsgInterface::Ptr _syncMsg);
 
     virtual bool shouldSyncing();
     virtual bool isSyncing();
     virtual void tryToRequestBlocks();
+    // download the state snapshot rather than the blocks
+    virtual bool syncingSnapshot();
+    virtual void requestSnapshot();
     virtual void onDownloadTimeout();
+    // the requested blocks passed the pre-verification are credited to their peers
+    virtual void onBlocksVerified(std::vector<DownloadingQueue::VerifiedBlock> const& _blocks);
+    virtual void onBlocksDropped(std::vector<bcos::protocol::BlockNumber> const& _numbers);
     // block execute and submit
     virtual void maintainDownloadingQueue();
     virtual void maintainDownloadingBuffer();
@@ -110,8 +131,13 @@ protected:
 
 protected:
     void requestBlocks(bcos::protocol::BlockNumber _from, bcos::protocol::BlockNumber _to);
-    void fetchAndSendBlock(DownloadRequestQueue::Ptr _reqQueue, bcos::crypto::PublicPtr _peer,
-        bcos::protocol::BlockNumber _number);
+    // answer the requested range with the cached encoded blocks and the blocks read from the
+    // ledger, the failed blocks are pushed back to the request queue
+    void fetchAndSendBlocks(DownloadRequestQueue::Ptr _reqQueue, bcos::crypto::PublicPtr _peer,
+        bcos::protocol::BlockNumber _from, size_t _size);
+    // send the consecutive blocks in messages of at most maxBlocksMsgSize
+    void sendBlocks(bcos::crypto::PublicPtr _peer, bcos::protocol::BlockNumber _from,
+        std::vector<EncodedBlock> const& _blocks);
     void printSyncInfo();
 
 protected:
@@ -125,7 +151,20 @@ protected:
 
     bcos::ThreadPool::Ptr m_downloadBlockProcessor = nullptr;
     bcos::ThreadPool::Ptr m_sendBlockProcessor = nullptr;
+    // the encoded blocks recently sent to the peers
+    constexpr static size_t c_encodedBlockCacheSize = 64 * 1024 * 1024;
+    EncodedBlockCache::Ptr m_encodedBlockCache;
+    // the block requests sent to the peers and the download rates of the peers
+    DownloadScheduler::Ptr m_downloadScheduler;
     std::shared_ptr<Timer> m_downloadingTimer;
+    StateSnapshotExporter::Ptr m_snapshotExporter;
+    StateSnapshotImporter::Ptr m_snapshotImporter;
+    // the block sync is used if no snapshot is agreed in time
+    constexpr static int64_t c_snapshotManifestTimeout = 60000;
+    constexpr static int64_t c_snapshotManifestRequestInterval = 3000;
+    std::atomic<int64_t> m_snapshotSyncStartTime = {0};
+    std::atomic<int64_t> m_lastManifestRequestTime = {0};
+    std::atomic_bool m_snapshotSyncGiveUp = {false};
 
     std::atomic_bool m_running = {false};
     std::atomic<SyncState> m_state = {SyncState::Idle};
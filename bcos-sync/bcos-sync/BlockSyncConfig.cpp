@@ -136,6 +136,16 @@ void BlockSyncConfig::setMaxDownloadRequestQueueSize(size_t _maxDownloadRequestQ
     m_maxDownloadRequestQueueSize = _maxDownloadRequestQueueSize;
 }
 
+void BlockSyncConfig::setMaxBlocksMsgSize(size_t _maxBlocksMsgSize)
+{
+    m_maxBlocksMsgSize = _maxBlocksMsgSize;
+}
+
+void BlockSyncConfig::setMaxPreVerifyBlocks(size_t _maxPreVerifyBlocks)
+{
+    m_maxPreVerifyBlocks = std::max(_maxPreVerifyBlocks, (size_t)1);
+}
+
 void BlockSyncConfig::setExecutedBlock(BlockNumber _executedBlock)
 {
     if (m_blockNumber <= _executedBlock)
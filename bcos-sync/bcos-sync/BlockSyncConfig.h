@@ -94,6 +94,14 @@ public:
     size_t maxRequestBlocks() const { return m_maxRequestBlocks; }
     size_t maxShardPerPeer() const { return m_maxShardPerPeer; }
 
+    // the max size of the encoded blocks in one BlocksMsg sent to a peer
+    size_t maxBlocksMsgSize() const { return m_maxBlocksMsgSize; }
+    void setMaxBlocksMsgSize(size_t _maxBlocksMsgSize);
+
+    // the max number of the buffered blocks decoded and pre-verified in parallel at a time
+    size_t maxPreVerifyBlocks() const { return m_maxPreVerifyBlocks; }
+    void setMaxPreVerifyBlocks(size_t _maxPreVerifyBlocks);
+
     void setExecutedBlock(bcos::protocol::BlockNumber _executedBlock);
     bcos::protocol::BlockNumber executedBlock() { return m_executedBlock; }
 
@@ -170,6 +178,8 @@ private:
     std::atomic<size_t> m_maxRequestBlocks = {8};
 
     std::atomic<size_t> m_maxShardPerPeer = {2};
+    std::atomic<size_t> m_maxBlocksMsgSize = {4 * 1024 * 1024};
+    std::atomic<size_t> m_maxPreVerifyBlocks = {64};
 
     std::atomic<bcos::protocol::BlockNumber> m_committedProposalNumber = {0};
 
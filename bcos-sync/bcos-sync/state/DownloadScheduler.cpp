@@ -0,0 +1,379 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief stripes the block requests across the peers by their download rates
+ * @file DownloadScheduler.cpp
+ */
+#include "DownloadScheduler.h"
+#include <algorithm>
+
+using namespace bcos;
+using namespace bcos::sync;
+using namespace bcos::protocol;
+using namespace bcos::crypto;
+
+DownloadScheduler::DownloadScheduler(
+    size_t _shardSize, size_t _maxPendingPerPeer, int64_t _minHedgeTimeout)
+  : m_shardSize(std::max(_shardSize, (size_t)1)),
+    m_maxPendingPerPeer(std::max(_maxPendingPerPeer, (size_t)1)),
+    m_minHedgeTimeout(_minHedgeTimeout)
+{}
+
+std::vector<DownloadScheduler::Request> DownloadScheduler::schedule(
+    BlockNumber _first, BlockNumber _last, Peers const& _peers, int64_t _now)
+{
+    std::vector<Request> requests;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto loads = peerLoads();
+    auto from = _first;
+    while (from <= _last)
+    {
+        auto next = m_shards.upper_bound(from);
+        if (next != m_shards.begin() && std::prev(next)->second.to() >= from)
+        {
+            // skip the scheduled blocks
+            from = std::prev(next)->second.to() + 1;
+            continue;
+        }
+        auto to = std::min((BlockNumber)(from + m_shardSize - 1), _last);
+        if (next != m_shards.end())
+        {
+            to = std::min(to, next->first - 1);
+        }
+        size_t size = to - from + 1;
+        auto peer = choosePeer(_peers, loads, to, size, nullptr);
+        if (!peer)
+        {
+            break;
+        }
+        auto& shard = m_shards[from];
+        shard.from = from;
+        shard.received.resize(size, false);
+        shard.attempts.push_back(Attempt{peer, _now});
+        auto& load = loads[peer];
+        ++load.requests;
+        load.blocks += size;
+        requests.push_back(Request{peer, from, size});
+        from = to + 1;
+    }
+    return requests;
+}
+
+std::vector<DownloadScheduler::Request> DownloadScheduler::hedge(Peers const& _peers, int64_t _now)
+{
+    std::vector<Request> requests;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto loads = peerLoads();
+    for (auto& [from, shard] : m_shards)
+    {
+        if (shard.done() || shard.attempts.size() != 1)
+        {
+            continue;
+        }
+        auto& attempt = shard.attempts.front();
+        auto expected = expectedTime(attempt.peer, shard.received.size());
+        auto timeout = std::max((double)m_minHedgeTimeout, c_hedgeFactor * expected);
+        if ((double)(_now - attempt.sendTime) <= timeout)
+        {
+            continue;
+        }
+        auto missing = std::find(shard.received.begin(), shard.received.end(), false) -
+                       shard.received.begin();
+        size_t size = shard.received.size() - missing;
+        auto peer = choosePeer(_peers, loads, shard.to(), size, attempt.peer);
+        if (!peer)
+        {
+            continue;
+        }
+        // rated by the blocks received so far, the slow peer is chosen less afterwards
+        rate(attempt, _now);
+        shard.attempts.push_back(Attempt{peer, _now});
+        auto& load = loads[peer];
+        ++load.requests;
+        load.blocks += size;
+        requests.push_back(Request{peer, from + missing, size});
+    }
+    return requests;
+}
+
+bool DownloadScheduler::expects(PublicPtr _peer, BlockNumber _from, size_t _blocks) const
+{
+    if (_blocks == 0)
+    {
+        return false;
+    }
+    BlockNumber last = _from + _blocks - 1;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_shards.upper_bound(_from);
+    if (it != m_shards.begin())
+    {
+        --it;
+    }
+    for (; it != m_shards.end() && it->first <= last; ++it)
+    {
+        auto const& shard = it->second;
+        auto begin = std::max(_from, shard.from);
+        auto end = std::min(last, shard.to());
+        auto requested = std::any_of(shard.attempts.begin(), shard.attempts.end(),
+            [&_peer](Attempt const& _attempt) { return _attempt.peer->data() == _peer->data(); });
+        if (begin > end || !requested)
+        {
+            continue;
+        }
+        for (auto number = begin; number <= end; ++number)
+        {
+            if (!shard.received[number - shard.from])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void DownloadScheduler::onBlocksReceived(
+    PublicPtr _peer, BlockNumber _from, size_t _blocks, size_t _bytes, int64_t _now)
+{
+    if (_blocks == 0)
+    {
+        return;
+    }
+    BlockNumber last = _from + _blocks - 1;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_shards.upper_bound(_from);
+    if (it != m_shards.begin())
+    {
+        --it;
+    }
+    for (; it != m_shards.end() && it->first <= last; ++it)
+    {
+        auto& shard = it->second;
+        auto begin = std::max(_from, shard.from);
+        auto end = std::min(last, shard.to());
+        // the blocks of the shards not requested from the peer are ignored
+        auto attempt = std::find_if(shard.attempts.begin(), shard.attempts.end(),
+            [&_peer](Attempt const& _attempt) { return _attempt.peer->data() == _peer->data(); });
+        if (begin > end || attempt == shard.attempts.end())
+        {
+            continue;
+        }
+        for (auto number = begin; number <= end; ++number)
+        {
+            if (!shard.received[number - shard.from])
+            {
+                shard.received[number - shard.from] = true;
+                ++shard.receivedBlocks;
+            }
+        }
+        size_t blocks = end - begin + 1;
+        attempt->blocks += blocks;
+        attempt->bytes += _bytes * blocks / _blocks;
+        if (attempt->firstResponseTime == 0)
+        {
+            attempt->firstResponseTime = _now;
+        }
+        if (!shard.done())
+        {
+            continue;
+        }
+        for (auto& finished : shard.attempts)
+        {
+            if (finished.blocks > 0)
+            {
+                rate(finished, _now);
+            }
+        }
+        shard.attempts.clear();
+    }
+}
+
+void DownloadScheduler::onBlocksDropped(std::vector<BlockNumber> const& _numbers, int64_t _now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto number : _numbers)
+    {
+        auto it = m_shards.upper_bound(number);
+        if (it == m_shards.begin() || std::prev(it)->second.to() < number)
+        {
+            continue;
+        }
+        --it;
+        // the requested peers do not send the dropped blocks again, the shard is scheduled again
+        for (auto& attempt : it->second.attempts)
+        {
+            if (attempt.blocks > 0)
+            {
+                rate(attempt, _now);
+            }
+        }
+        m_shards.erase(it);
+    }
+}
+
+void DownloadScheduler::onTimeout(int64_t _now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [from, shard] : m_shards)
+    {
+        for (auto& attempt : shard.attempts)
+        {
+            rate(attempt, _now);
+        }
+    }
+    m_shards.clear();
+}
+
+void DownloadScheduler::expire(BlockNumber _number)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // the shards are not overlapping, their last blocks are ordered too
+    while (!m_shards.empty() && m_shards.begin()->second.to() <= _number)
+    {
+        m_shards.erase(m_shards.begin());
+    }
+}
+
+void DownloadScheduler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shards.clear();
+}
+
+void DownloadScheduler::removePeer(PublicPtr _peer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rates.erase(_peer);
+}
+
+std::optional<DownloadScheduler::PeerRate> DownloadScheduler::peerRate(PublicPtr _peer) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rates.find(_peer);
+    if (it == m_rates.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+size_t DownloadScheduler::pendingShards() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_shards.begin(), m_shards.end(),
+        [](auto const& _shard) { return !_shard.second.done(); });
+}
+
+DownloadScheduler::PeerLoads DownloadScheduler::peerLoads() const
+{
+    PeerLoads loads;
+    for (auto const& [from, shard] : m_shards)
+    {
+        for (auto const& attempt : shard.attempts)
+        {
+            auto& load = loads[attempt.peer];
+            ++load.requests;
+            load.blocks += shard.received.size() - shard.receivedBlocks;
+        }
+    }
+    return loads;
+}
+
+PublicPtr DownloadScheduler::choosePeer(Peers const& _peers, PeerLoads const& _loads,
+    BlockNumber _to, size_t _blocks, PublicPtr const& _excluded) const
+{
+    PublicPtr chosen;
+    double chosenTime = 0;
+    for (auto const& [peer, number] : _peers)
+    {
+        if (number < _to || (_excluded && peer->data() == _excluded->data()))
+        {
+            continue;
+        }
+        PeerLoad load;
+        auto it = _loads.find(peer);
+        if (it != _loads.end())
+        {
+            load = it->second;
+        }
+        if (load.requests >= m_maxPendingPerPeer)
+        {
+            continue;
+        }
+        // the owed blocks are served before the new ones
+        auto time = expectedTime(peer, load.blocks + _blocks);
+        if (!chosen || time < chosenTime)
+        {
+            chosen = peer;
+            chosenTime = time;
+        }
+    }
+    return chosen;
+}
+
+double DownloadScheduler::expectedTime(PublicPtr const& _peer, size_t _blocks) const
+{
+    PeerRate average;
+    for (auto const& [peer, rate] : m_rates)
+    {
+        average.blocksRate += rate.blocksRate / m_rates.size();
+        average.latency += rate.latency / m_rates.size();
+    }
+    PeerRate peerRate;
+    auto it = m_rates.find(_peer);
+    if (it != m_rates.end())
+    {
+        peerRate = it->second;
+    }
+    else if (!m_rates.empty())
+    {
+        // the peers not rated yet are assumed average
+        peerRate = average;
+    }
+    else
+    {
+        peerRate.blocksRate = 1;
+    }
+    // the rate is floored, a peer timed out once is still chosen when the others owe enough
+    // blocks and its requests are still hedged, so it is probed again and may recover
+    auto minRate = std::max(c_minRateShare * average.blocksRate, c_minBlocksRate);
+    return peerRate.latency + _blocks * 1000 / std::max(peerRate.blocksRate, minRate);
+}
+
+void DownloadScheduler::rate(Attempt& _attempt, int64_t _now)
+{
+    if (_attempt.rated)
+    {
+        return;
+    }
+    _attempt.rated = true;
+    auto elapsed = (double)std::max(_now - _attempt.sendTime, (int64_t)1);
+    PeerRate sample;
+    sample.blocksRate = _attempt.blocks * 1000 / elapsed;
+    sample.bytesRate = _attempt.bytes * 1000 / elapsed;
+    sample.latency = _attempt.firstResponseTime > 0 ?
+                         (double)(_attempt.firstResponseTime - _attempt.sendTime) :
+                         elapsed;
+    auto& peerRate = m_rates[_attempt.peer];
+    if (peerRate.samples == 0)
+    {
+        sample.samples = 1;
+        peerRate = sample;
+        return;
+    }
+    peerRate.blocksRate += c_rateWeight * (sample.blocksRate - peerRate.blocksRate);
+    peerRate.bytesRate += c_rateWeight * (sample.bytesRate - peerRate.bytesRate);
+    peerRate.latency += c_rateWeight * (sample.latency - peerRate.latency);
+    ++peerRate.samples;
+}
@@ -0,0 +1,151 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief stripes the block requests across the peers by their download rates
+ * @file DownloadScheduler.h
+ */
+#pragma once
+#include <bcos-crypto/interfaces/crypto/KeyInterface.h>
+#include <bcos-framework/protocol/ProtocolTypeDef.h>
+#include <bcos-utilities/Common.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace bcos
+{
+namespace sync
+{
+// The missing blocks are cut into shards of at most shardSize blocks, every shard is requested
+// from the peer expected to finish it first, judged by the download rate and the latency measured
+// from the former responses of the peer and by the blocks it still owes, so the faster peers serve
+// proportionally more shards. A shard outstanding much longer than expected is requested again
+// from another peer (hedged), the blocks of whichever responds first fill the shard.
+// The shards are kept until expired by the committed number, the scheduled range is never
+// requested twice except by hedging.
+class DownloadScheduler
+{
+public:
+    using Ptr = std::shared_ptr<DownloadScheduler>;
+    // the peers and their block numbers
+    using Peers = std::vector<std::pair<bcos::crypto::PublicPtr, bcos::protocol::BlockNumber>>;
+
+    struct Request
+    {
+        bcos::crypto::PublicPtr peer;
+        bcos::protocol::BlockNumber from;
+        size_t size;
+    };
+
+    // exponentially weighted averages of the completed requests of the peer
+    struct PeerRate
+    {
+        double blocksRate = 0;  // blocks per second
+        double bytesRate = 0;   // bytes per second
+        double latency = 0;     // milliseconds before the first response
+        uint64_t samples = 0;
+    };
+
+    constexpr static int64_t c_minHedgeTimeout = 1000;
+
+    DownloadScheduler(
+        size_t _shardSize, size_t _maxPendingPerPeer, int64_t _minHedgeTimeout = c_minHedgeTimeout);
+
+    // the requests of the unscheduled blocks in [_first, _last], stops at the first shard no peer
+    // can serve
+    std::vector<Request> schedule(bcos::protocol::BlockNumber _first,
+        bcos::protocol::BlockNumber _last, Peers const& _peers, int64_t _now);
+    // the requests of the missing blocks of the shards outstanding longer than hedgeFactor times
+    // the expected time, every shard is hedged at most once
+    std::vector<Request> hedge(Peers const& _peers, int64_t _now);
+
+    // whether _peer has an outstanding request of a missing block in [_from, _from + _blocks)
+    bool expects(
+        bcos::crypto::PublicPtr _peer, bcos::protocol::BlockNumber _from, size_t _blocks) const;
+    // the blocks are marked received and credited to the peer only in the shards the peer is
+    // requested, called once the blocks pass the pre-verification
+    void onBlocksReceived(bcos::crypto::PublicPtr _peer, bcos::protocol::BlockNumber _from,
+        size_t _blocks, size_t _bytes, int64_t _now);
+    // the shards of the blocks dropped after received are dropped to be scheduled again, the
+    // peers are rated by the blocks received so far
+    void onBlocksDropped(std::vector<bcos::protocol::BlockNumber> const& _numbers, int64_t _now);
+    // the peers of the outstanding requests are rated by the blocks received so far, then all the
+    // shards are dropped to be requested again
+    void onTimeout(int64_t _now);
+    // drop the shards no later than the committed number
+    void expire(bcos::protocol::BlockNumber _number);
+    void clear();
+    void removePeer(bcos::crypto::PublicPtr _peer);
+
+    std::optional<PeerRate> peerRate(bcos::crypto::PublicPtr _peer) const;
+    // the shards still waiting for blocks
+    size_t pendingShards() const;
+
+private:
+    constexpr static double c_rateWeight = 0.25;
+    constexpr static double c_hedgeFactor = 2;
+    // the floor of the rate of a peer, as a share of the average rate and in blocks per second
+    constexpr static double c_minRateShare = 0.1;
+    constexpr static double c_minBlocksRate = 0.1;
+
+    struct Attempt
+    {
+        bcos::crypto::PublicPtr peer;
+        int64_t sendTime;
+        int64_t firstResponseTime = 0;
+        size_t blocks = 0;
+        size_t bytes = 0;
+        bool rated = false;
+    };
+    struct Shard
+    {
+        bcos::protocol::BlockNumber from;
+        std::vector<bool> received;
+        size_t receivedBlocks = 0;
+        // empty once all the blocks are received
+        std::vector<Attempt> attempts;
+
+        bcos::protocol::BlockNumber to() const { return from + received.size() - 1; }
+        bool done() const { return receivedBlocks == received.size(); }
+    };
+    // the incomplete requests and the blocks still owed by every peer
+    struct PeerLoad
+    {
+        size_t requests = 0;
+        size_t blocks = 0;
+    };
+    using PeerLoads = std::map<bcos::crypto::PublicPtr, PeerLoad, bcos::crypto::KeyCompare>;
+
+    PeerLoads peerLoads() const;
+    // the peer having the block _to and expected to finish _blocks blocks first
+    bcos::crypto::PublicPtr choosePeer(Peers const& _peers, PeerLoads const& _loads,
+        bcos::protocol::BlockNumber _to, size_t _blocks,
+        bcos::crypto::PublicPtr const& _excluded) const;
+    double expectedTime(bcos::crypto::PublicPtr const& _peer, size_t _blocks) const;
+    void rate(Attempt& _attempt, int64_t _now);
+
+    size_t m_shardSize;
+    size_t m_maxPendingPerPeer;
+    int64_t m_minHedgeTimeout;
+
+    // ordered and not overlapping, keyed by the first block of the shard
+    std::map<bcos::protocol::BlockNumber, Shard> m_shards;
+    std::map<bcos::crypto::PublicPtr, PeerRate, bcos::crypto::KeyCompare> m_rates;
+    mutable std::mutex m_mutex;
+};
+}  // namespace sync
+}  // namespace bcos
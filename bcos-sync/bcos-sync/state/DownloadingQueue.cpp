@@ -21,27 +21,35 @@
 #include "DownloadingQueue.h"
 #include "bcos-sync/utilities/Common.h"
 #include <bcos-framework/dispatcher/SchedulerTypeDef.h>
+#include <algorithm>
 #include <future>
+#include <numeric>
 
 using namespace std;
 using namespace bcos;
 using namespace bcos::protocol;
 using namespace bcos::sync;
 using namespace bcos::ledger;
+using namespace bcos::crypto;
 
-void DownloadingQueue::push(BlocksMsgInterface::Ptr _blocksData)
+void DownloadingQueue::push(BlocksMsgInterface::Ptr _blocksData, NodeIDPtr _peer)
 {
-    // push to the blockBuffer firstly
-    UpgradableGuard l(x_blockBuffer);
-    if (m_blockBuffer->size() >= m_config->maxDownloadingBlockQueueSize())
     {
+        // push to the blockBuffer firstly
+        UpgradableGuard l(x_blockBuffer);
+        if (m_blockBuffer->size() < m_config->maxDownloadingBlockQueueSize())
+        {
+            UpgradeGuard ul(l);
+            m_blockBuffer->emplace_back(_peer, _blocksData);
+            return;
+        }
         BLKSYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                              << LOG_DESC("DownloadingBlockQueueBuffer is full")
                              << LOG_KV("queueSize", m_blockBuffer->size());
-        return;
     }
-    UpgradeGuard ul(l);
-    m_blockBuffer->emplace_back(_blocksData);
+    std::vector<BlockNumber> droppedBlocks(_blocksData->blocksSize());
+    std::iota(droppedBlocks.begin(), droppedBlocks.end(), _blocksData->number());
+    onBlocksDropped(droppedBlocks);
 }
 
 bool DownloadingQueue::empty()
@@ -87,79 +95,253 @@ void DownloadingQueue::clear()
     {
         WriteGuard l(x_blockBuffer);
         m_blockBuffer->clear();
+        ++m_clearTimes;
     }
     clearQueue();
 }
 
 void DownloadingQueue::clearQueue()
 {
-    WriteGuard l(x_blocks);
-    BlockQueue emptyQueue;
-    swap(m_blocks, emptyQueue);  // Does memory leak here ?
+    std::vector<BlockNumber> droppedBlocks;
+    {
+        WriteGuard l(x_blocks);
+        BlockQueue emptyQueue;
+        swap(m_blocks, emptyQueue);  // Does memory leak here ?
+        for (; !emptyQueue.empty(); emptyQueue.pop())
+        {
+            droppedBlocks.emplace_back(emptyQueue.top()->blockHeader()->number());
+        }
+    }
+    onBlocksDropped(droppedBlocks);
 }
 
 void DownloadingQueue::flushBufferToQueue()
 {
-    WriteGuard l(x_blockBuffer);
-    bool ret = true;
-    while (m_blockBuffer->size() > 0 && ret)
+    while (true)
     {
-        auto blocksShard = m_blockBuffer->front();
-        m_blockBuffer->pop_front();
-        ret = flushOneShard(blocksShard);
+        size_t space = 0;
+        {
+            ReadGuard queueLock(x_blocks);
+            if (m_blocks.size() >= m_config->maxDownloadingBlockQueueSize())
+            {
+                BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                   << LOG_DESC("DownloadingBlockQueueBuffer is full")
+                                   << LOG_KV("queueSize", m_blocks.size());
+                return;
+            }
+            space = m_config->maxDownloadingBlockQueueSize() - m_blocks.size();
+        }
+        // the shards of the next maxPreVerifyBlocks blocks are decoded and verified together, no
+        // more than the space left in the queue
+        auto maxBlocks = std::min(space, m_config->maxPreVerifyBlocks());
+        std::vector<BlocksMsgInterface::Ptr> shards;
+        std::vector<NodeIDPtr> peers;
+        size_t blocksSize = 0;
+        uint64_t clearTimes = 0;
+        {
+            WriteGuard l(x_blockBuffer);
+            if (m_blockBuffer->empty())
+            {
+                return;
+            }
+            while (!m_blockBuffer->empty() && (shards.empty() || blocksSize < maxBlocks))
+            {
+                auto const& [peer, shard] = m_blockBuffer->front();
+                blocksSize += shard->blocksSize();
+                peers.emplace_back(peer);
+                shards.emplace_back(shard);
+                m_blockBuffer->pop_front();
+            }
+            clearTimes = m_clearTimes;
+        }
+        // verified without holding the buffer, the blocks received meanwhile are still buffered
+        auto startT = utcTime();
+        auto blocks = preVerifyBlocks(shards);
+        // a shard may exceed the space left, and the queue may be filled during the
+        // verification, the lowest blocks are kept and the others dropped to be downloaded again
+        std::sort(blocks.begin(), blocks.end(), [](auto const& _first, auto const& _second) {
+            return _first->blockHeader()->number() < _second->blockHeader()->number();
+        });
+        std::vector<VerifiedBlock> verifiedBlocks;
+        std::vector<BlockNumber> droppedBlocks;
+        {
+            // pop buffer into queue
+            WriteGuard queueLock(x_blocks);
+            size_t pushed = 0;
+            // the queue is cleared during the verification, the blocks are dropped with it
+            if (clearTimes == m_clearTimes)
+            {
+                for (; pushed < blocks.size() &&
+                       m_blocks.size() < m_config->maxDownloadingBlockQueueSize();
+                     ++pushed)
+                {
+                    m_blocks.push(blocks[pushed]);
+                }
+            }
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                auto number = blocks[i]->blockHeader()->number();
+                if (i >= pushed)
+                {
+                    droppedBlocks.emplace_back(number);
+                    continue;
+                }
+                // credited to the peer of the shard the block is found at
+                for (size_t j = 0; j < shards.size(); ++j)
+                {
+                    auto from = shards[j]->number();
+                    auto to = from + (BlockNumber)shards[j]->blocksSize();
+                    if (peers[j] && number >= from && number < to)
+                    {
+                        verifiedBlocks.emplace_back(VerifiedBlock{
+                            peers[j], number, shards[j]->blockData(number - from).size()});
+                        break;
+                    }
+                }
+            }
+            if (!droppedBlocks.empty())
+            {
+                BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                   << LOG_DESC("Drop the blocks exceeding the block queue")
+                                   << LOG_KV("dropped", droppedBlocks.size())
+                                   << LOG_KV("from", droppedBlocks.front())
+                                   << LOG_KV("queueSize", m_blocks.size());
+            }
+            if (!m_blocks.empty())
+            {
+                BLKSYNC_LOG(DEBUG)
+                    << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                    << LOG_DESC("Flush buffer to block queue") << LOG_KV("rcv", blocksSize)
+                    << LOG_KV("verified", blocks.size()) << LOG_KV("pushed", pushed)
+                    << LOG_KV("top", m_blocks.top()->blockHeader()->number())
+                    << LOG_KV("downloadBlockQueue", m_blocks.size())
+                    << LOG_KV("timeCost", (utcTime() - startT))
+                    << LOG_KV("nodeId", m_config->nodeID()->shortHex());
+            }
+        }
+        if (!verifiedBlocks.empty() && m_blocksVerifiedHandler)
+        {
+            m_blocksVerifiedHandler(verifiedBlocks);
+        }
+        onBlocksDropped(droppedBlocks);
+        if (clearTimes != m_clearTimes)
+        {
+            return;
+        }
     }
 }
 
-bool DownloadingQueue::flushOneShard(BlocksMsgInterface::Ptr _blocksData)
+void DownloadingQueue::onBlocksDropped(std::vector<BlockNumber> const& _numbers)
 {
-    // pop buffer into queue
-    WriteGuard l(x_blocks);
-    if (m_blocks.size() >= m_config->maxDownloadingBlockQueueSize())
+    if (!_numbers.empty() && m_blocksDroppedHandler)
     {
-        BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                           << LOG_DESC("DownloadingBlockQueueBuffer is full")
-                           << LOG_KV("queueSize", m_blocks.size());
-
-        return false;
+        m_blocksDroppedHandler(_numbers);
     }
-    BLKSYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                       << LOG_DESC("Decoding block buffer")
-                       << LOG_KV("blocksShardSize", _blocksData->blocksSize());
-    size_t blocksSize = _blocksData->blocksSize();
-    for (size_t i = 0; i < blocksSize; i++)
+}
+
+Blocks DownloadingQueue::preVerifyBlocks(std::vector<BlocksMsgInterface::Ptr> const& _shards)
+{
+    std::vector<std::pair<BlocksMsgInterface::Ptr, size_t>> blocksData;
+    for (auto const& shard : _shards)
     {
-        try
+        for (size_t i = 0; i < shard->blocksSize(); i++)
         {
-            auto block =
-                m_config->blockFactory()->createBlock(_blocksData->blockData(i), true, true);
-            auto blockHeader = block->blockHeader();
-            if (isNewerBlock(block))
+            blocksData.emplace_back(shard, i);
+        }
+    }
+    BLKSYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                       << LOG_DESC("Decoding block buffer") << LOG_KV("shards", _shards.size())
+                       << LOG_KV("blocksSize", blocksData.size());
+    Blocks blocks(blocksData.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, blocksData.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
             {
-                m_blocks.push(block);
-                BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                   << LOG_DESC("Flush block to the queue")
-                                   << LOG_KV("number", blockHeader->number())
-                                   << LOG_KV("nodeId", m_config->nodeID()->shortHex());
+                auto const& [shard, index] = blocksData[i];
+                try
+                {
+                    auto block =
+                        m_config->blockFactory()->createBlock(shard->blockData(index), true, true);
+                    if (isNewerBlock(block) && preVerifyBlock(block))
+                    {
+                        blocks[i] = std::move(block);
+                    }
+                }
+                catch (std::exception const& e)
+                {
+                    BLKSYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                         << LOG_DESC("Invalid block data")
+                                         << LOG_KV("reason", boost::diagnostic_information(e))
+                                         << LOG_KV("blockDataSize", shard->blockData(index).size());
+                }
             }
-        }
-        catch (std::exception const& e)
+        });
+    std::erase(blocks, nullptr);
+    return blocks;
+}
+
+bool DownloadingQueue::preVerifyBlock(Block::Ptr _block)
+{
+    // Note: must hold blockHeader here to ensure the life cycle of the signature list
+    auto blockHeader = _block->blockHeader();
+    // the signatures are checked against the sealers of the header, whether the sealers and the
+    // signature weights match the chain is checked by the consensus before commit
+    auto signatureImpl = m_config->blockFactory()->cryptoSuite()->signatureImpl();
+    auto sealerList = blockHeader->sealerList();
+    for (auto const& signature : blockHeader->signatureList())
+    {
+        if (signature.index < 0 || (size_t)signature.index >= sealerList.size() ||
+            !signatureImpl->verify(
+                std::shared_ptr<const bytes>(&sealerList[signature.index], [](const bytes*) {}),
+                blockHeader->hash(), ref(signature.signature)))
         {
-            BLKSYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                 << LOG_DESC("Invalid block data")
-                                 << LOG_KV("reason", boost::diagnostic_information(e))
-                                 << LOG_KV("blockDataSize", _blocksData->blockData(i).size());
-            continue;
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Download")
+                                 << LOG_DESC("preVerifyBlock: invalid block signature")
+                                 << LOG_KV("number", blockHeader->number())
+                                 << LOG_KV("hash", blockHeader->hash().abridged())
+                                 << LOG_KV("sealerIdx", signature.index);
+            return false;
         }
     }
-    if (m_blocks.size() == 0)
+    // recover the senders rather than trusting the ones encoded by the peer
+    std::atomic_bool txsValid = true;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _block->transactionsSize()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end() && txsValid; ++i)
+            {
+                // maintain lifetime for tx
+                auto tx = _block->transaction(i);
+                try
+                {
+                    tx->forceSender(bytes());
+                    tx->verify();
+                }
+                catch (std::exception const& e)
+                {
+                    BLKSYNC_LOG(WARNING) << LOG_BADGE("Download")
+                                         << LOG_DESC("preVerifyBlock: invalid tx signature")
+                                         << LOG_KV("number", blockHeader->number())
+                                         << LOG_KV("tx", tx->hash().abridged())
+                                         << LOG_KV("reason", boost::diagnostic_information(e));
+                    txsValid = false;
+                }
+            }
+        });
+    if (!txsValid)
+    {
+        return false;
+    }
+    // calculated from the tx hashes recalculated by verify
+    auto txsRoot = _block->calculateTransactionRoot();
+    if (txsRoot != blockHeader->txsRoot())
     {
-        return true;
+        BLKSYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_DESC("preVerifyBlock: invalid txsRoot")
+                             << LOG_KV("number", blockHeader->number())
+                             << LOG_KV("hash", blockHeader->hash().abridged())
+                             << LOG_KV("txsRoot", blockHeader->txsRoot().abridged())
+                             << LOG_KV("calculatedTxsRoot", txsRoot.abridged());
+        return false;
     }
-    BLKSYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                       << LOG_DESC("Flush buffer to block queue") << LOG_KV("rcv", blocksSize)
-                       << LOG_KV("top", m_blocks.top()->blockHeader()->number())
-                       << LOG_KV("downloadBlockQueue", m_blocks.size())
-                       << LOG_KV("nodeId", m_config->nodeID()->shortHex());
     return true;
 }
 
@@ -23,6 +23,7 @@
 #include "bcos-sync/interfaces/BlocksMsgInterface.h"
 #include <bcos-framework/protocol/Block.h>
 #include <bcos-tool/LedgerConfigFetcher.h>
+#include <atomic>
 #include <queue>
 namespace bcos
 {
@@ -43,8 +44,17 @@ using BlockQueue =
 class DownloadingQueue : public std::enable_shared_from_this<DownloadingQueue>
 {
 public:
-    using BlocksMessageQueue = std::list<BlocksMsgInterface::Ptr>;
+    // the blocks messages and the peers sent them
+    using BlocksMessageQueue =
+        std::list<std::pair<bcos::crypto::NodeIDPtr, BlocksMsgInterface::Ptr>>;
     using BlocksMessageQueuePtr = std::shared_ptr<BlocksMessageQueue>;
+    // a block passed the pre-verification and queued, with the peer sent it and its encoded size
+    struct VerifiedBlock
+    {
+        bcos::crypto::NodeIDPtr peer;
+        bcos::protocol::BlockNumber number;
+        size_t bytes;
+    };
 
     using Ptr = std::shared_ptr<DownloadingQueue>;
     explicit DownloadingQueue(BlockSyncConfig::Ptr _config)
@@ -54,7 +64,9 @@ public:
     }
     virtual ~DownloadingQueue() {}
 
-    virtual void push(BlocksMsgInterface::Ptr _blocksData);
+    // _peer is the peer sent the blocks, nullptr if unknown
+    virtual void push(
+        BlocksMsgInterface::Ptr _blocksData, bcos::crypto::NodeIDPtr _peer = nullptr);
     // Is the queue empty?
     virtual bool empty();
 
@@ -79,6 +91,20 @@ public:
         m_newBlockHandler = _newBlockHandler;
     }
 
+    // called with the blocks of the known peers queued after the pre-verification
+    virtual void registerBlocksVerifiedHandler(
+        std::function<void(std::vector<VerifiedBlock> const&)> _blocksVerifiedHandler)
+    {
+        m_blocksVerifiedHandler = _blocksVerifiedHandler;
+    }
+    // called with the numbers of the received blocks dropped without being verified or after
+    // being queued, except the invalid and the expired ones, to download them again
+    virtual void registerBlocksDroppedHandler(
+        std::function<void(std::vector<bcos::protocol::BlockNumber> const&)> _blocksDroppedHandler)
+    {
+        m_blocksDroppedHandler = _blocksDroppedHandler;
+    }
+
     // flush m_buffer into queue
     virtual void flushBufferToQueue();
     virtual void clearExpiredQueueCache();
@@ -95,8 +121,14 @@ protected:
     // clear queue
     virtual void clearQueue();
     virtual void clearExpiredCache(BlockQueue& _queue, SharedMutex& _lock);
-    virtual bool flushOneShard(BlocksMsgInterface::Ptr _blocksData);
+    // decode the blocks of the shards and pre-verify them in parallel, the invalid and the
+    // expired blocks are dropped
+    virtual bcos::protocol::Blocks preVerifyBlocks(
+        std::vector<BlocksMsgInterface::Ptr> const& _shards);
+    // check the signatures of the header and the txs, and the txs root of the decoded block
+    virtual bool preVerifyBlock(bcos::protocol::Block::Ptr _block);
     virtual bool isNewerBlock(bcos::protocol::Block::Ptr _block);
+    void onBlocksDropped(std::vector<bcos::protocol::BlockNumber> const& _numbers);
 
     virtual void commitBlock(bcos::protocol::Block::Ptr _block);
     virtual void commitBlockState(bcos::protocol::Block::Ptr _block);
@@ -121,11 +153,15 @@ private:
 
     BlocksMessageQueuePtr m_blockBuffer;
     mutable SharedMutex x_blockBuffer;
+    // the blocks verified before the last clear are not pushed into the queue
+    std::atomic<uint64_t> m_clearTimes = {0};
 
     BlockQueue m_commitQueue;
     mutable SharedMutex x_commitQueue;
 
     std::function<void(bcos::ledger::LedgerConfig::Ptr)> m_newBlockHandler;
+    std::function<void(std::vector<VerifiedBlock> const&)> m_blocksVerifiedHandler;
+    std::function<void(std::vector<bcos::protocol::BlockNumber> const&)> m_blocksDroppedHandler;
 
     std::shared_ptr<bcos::tool::LedgerConfigFetcher> m_ledgerFetcher;
 };
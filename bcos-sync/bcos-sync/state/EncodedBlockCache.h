@@ -0,0 +1,34 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief LRU cache of the encoded blocks served to the peers
+ * @file EncodedBlockCache.h
+ */
+#pragma once
+#include <bcos-framework/protocol/ProtocolTypeDef.h>
+#include <bcos-utilities/Common.h>
+#include <bcos-utilities/LRUCache.h>
+#include <memory>
+
+namespace bcos
+{
+namespace sync
+{
+using EncodedBlock = std::shared_ptr<const bytes>;
+// the committed blocks never change, the blocks requested by several lagging peers are read from
+// the ledger and encoded only once; bounded by the total size of the encoded blocks
+using EncodedBlockCache = LRUCache<bcos::protocol::BlockNumber, EncodedBlock>;
+}  // namespace sync
+}  // namespace bcos
@@ -0,0 +1,144 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the manifest and the chunks of the state snapshots
+ * @file StateSnapshot.cpp
+ */
+#include "StateSnapshot.h"
+
+using namespace bcos;
+using namespace bcos::sync;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+namespace
+{
+void appendSize(bytes& _out, uint64_t _size, size_t _length)
+{
+    for (size_t i = _length; i > 0; --i)
+    {
+        _out.push_back((byte)(_size >> ((i - 1) * 8)));
+    }
+}
+
+void appendField(bytes& _out, std::string_view _field)
+{
+    appendSize(_out, _field.size(), sizeof(uint32_t));
+    _out.insert(_out.end(), _field.begin(), _field.end());
+}
+
+bool readField(bytesConstRef _data, size_t& _offset, std::string_view& _field)
+{
+    if (_data.size() - _offset < sizeof(uint32_t))
+    {
+        return false;
+    }
+    uint32_t size = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        size = (size << 8) | _data[_offset + i];
+    }
+    _offset += sizeof(uint32_t);
+    if (_data.size() - _offset < size)
+    {
+        return false;
+    }
+    _field = std::string_view((char const*)_data.data() + _offset, size);
+    _offset += size;
+    return true;
+}
+}  // namespace
+
+HashType bcos::sync::snapshotDigest(Hash::Ptr _hashImpl, BlockNumber _number,
+    HashType const& _blockHash, HashList const& _chunkHashes)
+{
+    bytes data;
+    data.reserve(sizeof(uint64_t) + HashType::SIZE * (_chunkHashes.size() + 1));
+    appendSize(data, (uint64_t)_number, sizeof(uint64_t));
+    data.insert(data.end(), _blockHash.begin(), _blockHash.end());
+    for (auto const& chunkHash : _chunkHashes)
+    {
+        data.insert(data.end(), chunkHash.begin(), chunkHash.end());
+    }
+    return _hashImpl->hash(ref(data));
+}
+
+void bcos::sync::encodeSnapshotManifest(
+    BlocksMsgInterface::Ptr _msg, SnapshotManifest const& _manifest)
+{
+    _msg->setNumber(_manifest.number);
+    _msg->appendBlockData(_manifest.blockHash.asBytes());
+    for (auto const& chunkHash : _manifest.chunkHashes)
+    {
+        _msg->appendBlockData(chunkHash.asBytes());
+    }
+}
+
+std::optional<SnapshotManifest> bcos::sync::decodeSnapshotManifest(
+    Hash::Ptr _hashImpl, BlocksMsgInterface::Ptr _msg)
+{
+    // at least one chunk of the state tables
+    if (_msg->number() <= 0 || _msg->blocksSize() < 2)
+    {
+        return std::nullopt;
+    }
+    SnapshotManifest manifest;
+    manifest.number = _msg->number();
+    for (size_t i = 0; i < _msg->blocksSize(); ++i)
+    {
+        auto data = _msg->blockData(i);
+        if (data.size() != HashType::SIZE)
+        {
+            return std::nullopt;
+        }
+        if (i == 0)
+        {
+            manifest.blockHash = HashType(data);
+            continue;
+        }
+        manifest.chunkHashes.emplace_back(data);
+    }
+    manifest.digest =
+        snapshotDigest(_hashImpl, manifest.number, manifest.blockHash, manifest.chunkHashes);
+    return manifest;
+}
+
+void bcos::sync::encodeSnapshotRow(
+    bytes& _chunk, std::string_view _table, std::string_view _key, std::string_view _value)
+{
+    appendField(_chunk, _table);
+    appendField(_chunk, _key);
+    appendField(_chunk, _value);
+}
+
+bool bcos::sync::decodeSnapshotRows(bytesConstRef _chunk,
+    std::function<void(std::string_view _table, std::string_view _key, std::string_view _value)>
+        const& _onRow)
+{
+    size_t offset = 0;
+    while (offset < _chunk.size())
+    {
+        std::string_view table;
+        std::string_view key;
+        std::string_view value;
+        if (!readField(_chunk, offset, table) || !readField(_chunk, offset, key) ||
+            !readField(_chunk, offset, value))
+        {
+            return false;
+        }
+        _onRow(table, key, value);
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the manifest and the chunks of the state snapshots
+ * @file StateSnapshot.h
+ */
+#pragma once
+#include "bcos-sync/interfaces/BlocksMsgInterface.h"
+#include <bcos-crypto/interfaces/crypto/CommonType.h>
+#include <bcos-crypto/interfaces/crypto/Hash.h>
+#include <bcos-framework/protocol/ProtocolTypeDef.h>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+namespace bcos
+{
+namespace sync
+{
+// The state at a checkpoint block is cut into chunks of rows, the chunks of the system and state
+// tables come first, followed by the chunks of the ledger rows of the latest blocks. The chunks
+// are deterministic, so the nodes having committed the checkpoint block report the same manifest.
+struct SnapshotManifest
+{
+    bcos::protocol::BlockNumber number = -1;
+    bcos::crypto::HashType blockHash;
+    bcos::crypto::HashList chunkHashes;
+    // of the fields above, identifies the snapshot
+    bcos::crypto::HashType digest;
+};
+
+bcos::crypto::HashType snapshotDigest(bcos::crypto::Hash::Ptr _hashImpl,
+    bcos::protocol::BlockNumber _number, bcos::crypto::HashType const& _blockHash,
+    bcos::crypto::HashList const& _chunkHashes);
+
+// the manifest is carried by the blocks message: the block hash followed by the chunk hashes
+void encodeSnapshotManifest(BlocksMsgInterface::Ptr _msg, SnapshotManifest const& _manifest);
+std::optional<SnapshotManifest> decodeSnapshotManifest(
+    bcos::crypto::Hash::Ptr _hashImpl, BlocksMsgInterface::Ptr _msg);
+
+// every row is the table, the key and the value, each prefixed by its big endian 4 bytes size
+void encodeSnapshotRow(
+    bytes& _chunk, std::string_view _table, std::string_view _key, std::string_view _value);
+// false if the chunk is malformed
+bool decodeSnapshotRows(bytesConstRef _chunk,
+    std::function<void(std::string_view _table, std::string_view _key, std::string_view _value)>
+        const& _onRow);
+}  // namespace sync
+}  // namespace bcos
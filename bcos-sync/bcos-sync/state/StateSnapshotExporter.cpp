@@ -0,0 +1,232 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief exports the state snapshots of the checkpoint blocks
+ * @file StateSnapshotExporter.cpp
+ */
+#include "StateSnapshotExporter.h"
+#include "bcos-sync/utilities/Common.h"
+#include <bcos-framework/ledger/LedgerTypeDef.h>
+#include <boost/lexical_cast.hpp>
+#include <future>
+
+using namespace bcos;
+using namespace bcos::sync;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+using namespace bcos::storage;
+using namespace bcos::ledger;
+
+namespace
+{
+std::optional<std::string> readRow(
+    StorageInterface& _storage, std::string_view _table, std::string_view _key)
+{
+    std::promise<std::pair<Error::UniquePtr, std::optional<Entry>>> promise;
+    _storage.asyncGetRow(_table, _key, [&promise](Error::UniquePtr _error, auto&& _entry) {
+        promise.set_value({std::move(_error), std::forward<decltype(_entry)>(_entry)});
+    });
+    auto [error, entry] = promise.get_future().get();
+    if (error)
+    {
+        BOOST_THROW_EXCEPTION(*error);
+    }
+    if (!entry)
+    {
+        return std::nullopt;
+    }
+    return std::string(entry->get());
+}
+}  // namespace
+
+StateSnapshotExporter::StateSnapshotExporter(TransactionalStorageInterface::Ptr _storage,
+    Hash::Ptr _hashImpl, BlockNumber _interval, BlockNumber _ledgerWindow, size_t _chunkSize)
+  : m_storage(std::move(_storage)),
+    m_hashImpl(std::move(_hashImpl)),
+    m_interval(_interval),
+    m_ledgerWindow(std::max(_ledgerWindow, (BlockNumber)1)),
+    m_chunkSize(_chunkSize),
+    m_worker(std::make_shared<ThreadPool>("SnapshotExport", 1))
+{}
+
+void StateSnapshotExporter::onCommitted(BlockNumber _number)
+{
+    if (m_interval <= 0 || _number % m_interval != 0 || _number <= m_exportingNumber)
+    {
+        return;
+    }
+    auto snapshot = std::dynamic_pointer_cast<StateSnapshotInterface>(m_storage->snapshot());
+    if (!snapshot)
+    {
+        BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                             << LOG_DESC("the storage does not support the state snapshots")
+                             << LOG_KV("number", _number);
+        return;
+    }
+    m_exportingNumber = _number;
+    auto self = std::weak_ptr<StateSnapshotExporter>(shared_from_this());
+    m_worker->enqueue([self, snapshot, _number]() {
+        try
+        {
+            auto exporter = self.lock();
+            if (!exporter)
+            {
+                return;
+            }
+            exporter->exportSnapshot(snapshot, _number);
+        }
+        catch (std::exception const& e)
+        {
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("exportSnapshot exception")
+                                 << LOG_KV("number", _number)
+                                 << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    });
+}
+
+bool StateSnapshotExporter::exportSnapshot(
+    StateSnapshotInterface::Ptr _snapshot, BlockNumber _number)
+{
+    auto start = utcTime();
+    auto numberStr = boost::lexical_cast<std::string>(_number);
+    // a later block may have been committed before the snapshot was taken
+    auto currentNumber = readRow(*_snapshot, SYS_CURRENT_STATE, SYS_KEY_CURRENT_NUMBER);
+    auto blockHash = readRow(*_snapshot, SYS_NUMBER_2_HASH, numberStr);
+    if (!currentNumber || *currentNumber != numberStr || !blockHash)
+    {
+        BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot")
+                          << LOG_DESC("the snapshot is not at the checkpoint, skip it")
+                          << LOG_KV("number", _number)
+                          << LOG_KV("currentNumber", currentNumber.value_or(""));
+        return false;
+    }
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->storage = _snapshot;
+    auto& manifest = snapshot->manifest;
+    manifest.number = _number;
+    manifest.blockHash = HashType(*blockHash, HashType::FromBinary);
+    std::string position;
+    do
+    {
+        snapshot->statePositions.push_back(position);
+        bytes chunk;
+        position = readStateRows(*_snapshot, position, chunk);
+        manifest.chunkHashes.push_back(m_hashImpl->hash(ref(chunk)));
+    } while (!position.empty());
+    // the genesis block is not exported
+    auto block = std::max(_number - m_ledgerWindow + 1, (BlockNumber)1);
+    while (block <= _number)
+    {
+        snapshot->ledgerBlocks.push_back(block);
+        bytes chunk;
+        block = readLedgerRows(*_snapshot, block, _number, chunk);
+        manifest.chunkHashes.push_back(m_hashImpl->hash(ref(chunk)));
+    }
+    manifest.digest =
+        snapshotDigest(m_hashImpl, manifest.number, manifest.blockHash, manifest.chunkHashes);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_snapshots.push_back(std::move(snapshot));
+        // the snapshot being imported by the peers is kept until the next one is exported
+        while (m_snapshots.size() > 2)
+        {
+            m_snapshots.pop_front();
+        }
+    }
+    BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("exportSnapshot success")
+                      << LOG_KV("number", _number) << LOG_KV("hash", manifest.blockHash.abridged())
+                      << LOG_KV("chunks", manifest.chunkHashes.size())
+                      << LOG_KV("digest", manifest.digest.abridged())
+                      << LOG_KV("timeCost", utcTime() - start);
+    return true;
+}
+
+std::optional<SnapshotManifest> StateSnapshotExporter::manifest() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_snapshots.empty())
+    {
+        return std::nullopt;
+    }
+    return m_snapshots.back()->manifest;
+}
+
+std::optional<bytes> StateSnapshotExporter::chunk(BlockNumber _number, size_t _index) const
+{
+    Snapshot::Ptr snapshot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto const& it : m_snapshots)
+        {
+            if (it->manifest.number == _number)
+            {
+                snapshot = it;
+            }
+        }
+    }
+    if (!snapshot || _index >= snapshot->manifest.chunkHashes.size())
+    {
+        return std::nullopt;
+    }
+    bytes chunk;
+    if (_index < snapshot->statePositions.size())
+    {
+        readStateRows(*snapshot->storage, snapshot->statePositions[_index], chunk);
+        return chunk;
+    }
+    auto block = snapshot->ledgerBlocks[_index - snapshot->statePositions.size()];
+    readLedgerRows(*snapshot->storage, block, _number, chunk);
+    return chunk;
+}
+
+std::string StateSnapshotExporter::readStateRows(
+    StateSnapshotInterface const& _snapshot, std::string_view _position, bytes& _chunk) const
+{
+    // the chunks are cut by the size of the normalized rows, not by how they are stored
+    return _snapshot.readStateRows(_position,
+        [this, &_chunk](std::string_view _table, std::string_view _key, std::string_view _value) {
+            if (_chunk.size() >= m_chunkSize)
+            {
+                return false;
+            }
+            auto value = m_valueNormalizer ? m_valueNormalizer(_table, _key, _value) :
+                                             std::nullopt;
+            encodeSnapshotRow(_chunk, _table, _key, value ? std::string_view(*value) : _value);
+            return true;
+        });
+}
+
+BlockNumber StateSnapshotExporter::readLedgerRows(
+    StorageInterface& _snapshot, BlockNumber _from, BlockNumber _last, bytes& _chunk) const
+{
+    auto block = _from;
+    for (; block <= _last && _chunk.size() < m_chunkSize; ++block)
+    {
+        auto numberStr = boost::lexical_cast<std::string>(block);
+        if (auto hash = readRow(_snapshot, SYS_NUMBER_2_HASH, numberStr))
+        {
+            encodeSnapshotRow(_chunk, SYS_NUMBER_2_HASH, numberStr, *hash);
+            encodeSnapshotRow(_chunk, SYS_HASH_2_NUMBER, *hash, numberStr);
+        }
+        for (auto table : {SYS_NUMBER_2_BLOCK_HEADER, SYS_BLOCK_NUMBER_2_NONCES})
+        {
+            if (auto value = readRow(_snapshot, table, numberStr))
+            {
+                encodeSnapshotRow(_chunk, table, numberStr, *value);
+            }
+        }
+    }
+    return block;
+}
@@ -0,0 +1,103 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief exports the state snapshots of the checkpoint blocks
+ * @file StateSnapshotExporter.h
+ */
+#pragma once
+#include "bcos-sync/state/StateSnapshot.h"
+#include <bcos-framework/storage/StorageInterface.h>
+#include <bcos-utilities/ThreadPool.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace bcos
+{
+namespace sync
+{
+// Every block whose number is a multiple of the interval is a checkpoint, a storage snapshot is
+// taken when it is committed and its manifest is built in the background. The snapshots of the
+// latest two checkpoints are kept for the peers to download, the chunks are read again from the
+// storage snapshot on every request rather than kept in memory.
+class StateSnapshotExporter : public std::enable_shared_from_this<StateSnapshotExporter>
+{
+public:
+    using Ptr = std::shared_ptr<StateSnapshotExporter>;
+    constexpr static size_t c_chunkSize = 4 * 1024 * 1024;
+    // converts a value to the form hashed and sent to the peers, such as a key page written in
+    // an older format, nullopt if the value is kept as is
+    using ValueNormalizer = std::function<std::optional<std::string>(
+        std::string_view _table, std::string_view _key, std::string_view _value)>;
+
+    // _ledgerWindow: the number of the latest blocks whose ledger rows are exported, such as the
+    // nonces needed to check the replayed transactions; the nodes must agree on all the arguments
+    StateSnapshotExporter(bcos::storage::TransactionalStorageInterface::Ptr _storage,
+        bcos::crypto::Hash::Ptr _hashImpl, bcos::protocol::BlockNumber _interval,
+        bcos::protocol::BlockNumber _ledgerWindow, size_t _chunkSize = c_chunkSize);
+    virtual ~StateSnapshotExporter() = default;
+
+    bcos::protocol::BlockNumber interval() const { return m_interval; }
+    // the nodes storing the same rows in different formats then report the same manifest
+    void setValueNormalizer(ValueNormalizer _normalizer)
+    {
+        m_valueNormalizer = std::move(_normalizer);
+    }
+
+    void onCommitted(bcos::protocol::BlockNumber _number);
+    // builds the manifest of the snapshot, false if the snapshot is not at the block _number
+    bool exportSnapshot(
+        bcos::storage::StateSnapshotInterface::Ptr _snapshot, bcos::protocol::BlockNumber _number);
+
+    // the manifest of the latest snapshot
+    std::optional<SnapshotManifest> manifest() const;
+    std::optional<bytes> chunk(bcos::protocol::BlockNumber _number, size_t _index) const;
+
+private:
+    struct Snapshot
+    {
+        using Ptr = std::shared_ptr<Snapshot const>;
+        bcos::storage::StateSnapshotInterface::Ptr storage;
+        SnapshotManifest manifest;
+        // where the chunks of the state tables start
+        std::vector<std::string> statePositions;
+        // the first blocks of the chunks of the ledger rows
+        std::vector<bcos::protocol::BlockNumber> ledgerBlocks;
+    };
+    // reads the rows of the state tables from _position until the chunk exceeds the chunk size,
+    // returns the position of the next chunk
+    std::string readStateRows(bcos::storage::StateSnapshotInterface const& _snapshot,
+        std::string_view _position, bytes& _chunk) const;
+    // reads the ledger rows of the blocks from _from until the chunk exceeds the chunk size,
+    // returns the next block
+    bcos::protocol::BlockNumber readLedgerRows(bcos::storage::StorageInterface& _snapshot,
+        bcos::protocol::BlockNumber _from, bcos::protocol::BlockNumber _last,
+        bytes& _chunk) const;
+
+    bcos::storage::TransactionalStorageInterface::Ptr m_storage;
+    bcos::crypto::Hash::Ptr m_hashImpl;
+    bcos::protocol::BlockNumber m_interval;
+    bcos::protocol::BlockNumber m_ledgerWindow;
+    size_t m_chunkSize;
+    ValueNormalizer m_valueNormalizer;
+
+    std::atomic<bcos::protocol::BlockNumber> m_exportingNumber = {0};
+    bcos::ThreadPool::Ptr m_worker;
+    // the latest snapshot at the back
+    std::deque<Snapshot::Ptr> m_snapshots;
+    mutable std::mutex m_mutex;
+};
+}  // namespace sync
+}  // namespace bcos
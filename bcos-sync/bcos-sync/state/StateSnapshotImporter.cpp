@@ -0,0 +1,420 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief downloads and imports a state snapshot agreed by the peers
+ * @file StateSnapshotImporter.cpp
+ */
+#include "StateSnapshotImporter.h"
+#include "bcos-sync/utilities/Common.h"
+#include <bcos-framework/ledger/LedgerTypeDef.h>
+#include <bcos-framework/protocol/CommonError.h>
+#include <boost/lexical_cast.hpp>
+#include <future>
+#include <set>
+
+using namespace bcos;
+using namespace bcos::sync;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+using namespace bcos::storage;
+using namespace bcos::ledger;
+
+StateSnapshotImporter::StateSnapshotImporter(StorageInterface::Ptr _storage, Hash::Ptr _hashImpl,
+    BlockHeaderFactory::Ptr _blockHeaderFactory, size_t _maxPendingPerPeer,
+    int64_t _chunkTimeout)
+  : m_storage(std::move(_storage)),
+    m_importStorage(std::dynamic_pointer_cast<StateSnapshotImportInterface>(m_storage)),
+    m_hashImpl(std::move(_hashImpl)),
+    m_blockHeaderFactory(std::move(_blockHeaderFactory)),
+    m_maxPendingPerPeer(std::max(_maxPendingPerPeer, (size_t)1)),
+    m_chunkTimeout(_chunkTimeout)
+{
+    // the rows staged before a restart belong to an unfinished import
+    dropStagedRows();
+}
+
+void StateSnapshotImporter::setTrustedSealers(consensus::ConsensusNodeList const& _sealers)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_trustedSealers.clear();
+    for (auto const& sealer : _sealers)
+    {
+        m_trustedSealers[sealer->nodeID()->data()] = sealer->weight();
+    }
+}
+
+void StateSnapshotImporter::onManifest(PublicPtr _peer, SnapshotManifest _manifest)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // the peers agreeing on the chosen manifest keep serving it after exporting a later one
+    auto it = m_peerManifests.find(_peer);
+    if (m_manifest && it != m_peerManifests.end() && it->second.digest == m_manifest->digest)
+    {
+        return;
+    }
+    m_peerManifests[_peer] = std::move(_manifest);
+}
+
+std::vector<StateSnapshotImporter::Request> StateSnapshotImporter::schedule(
+    size_t _quorum, int64_t _now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_imported)
+    {
+        return {};
+    }
+    if (!m_manifest)
+    {
+        std::map<HashType, size_t> votes;
+        for (auto const& [peer, manifest] : m_peerManifests)
+        {
+            ++votes[manifest.digest];
+        }
+        for (auto const& [peer, manifest] : m_peerManifests)
+        {
+            if (votes[manifest.digest] >= std::max(_quorum, (size_t)1) &&
+                (!m_manifest || manifest.number > m_manifest->number))
+            {
+                m_manifest = manifest;
+            }
+        }
+        if (!m_manifest)
+        {
+            return {};
+        }
+        m_chunks.assign(m_manifest->chunkHashes.size(), Chunk());
+        for (size_t i = 0; i < m_manifest->chunkHashes.size(); ++i)
+        {
+            m_chunkIndexes.emplace(m_manifest->chunkHashes[i], i);
+        }
+        BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("choose the snapshot")
+                          << LOG_KV("number", m_manifest->number)
+                          << LOG_KV("hash", m_manifest->blockHash.abridged())
+                          << LOG_KV("chunks", m_chunks.size())
+                          << LOG_KV("peers", votes[m_manifest->digest]);
+    }
+    // the outstanding requests of the peers agreeing on the manifest
+    std::map<PublicPtr, size_t, KeyCompare> loads;
+    for (auto const& [peer, manifest] : m_peerManifests)
+    {
+        if (manifest.digest == m_manifest->digest)
+        {
+            loads[peer] = 0;
+        }
+    }
+    for (auto const& chunk : m_chunks)
+    {
+        if (!chunk.imported && chunk.peer && _now - chunk.sendTime <= m_chunkTimeout &&
+            loads.count(chunk.peer))
+        {
+            ++loads[chunk.peer];
+        }
+    }
+    std::vector<Request> requests;
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+    {
+        auto& chunk = m_chunks[i];
+        if (chunk.imported || (chunk.peer && _now - chunk.sendTime <= m_chunkTimeout))
+        {
+            continue;
+        }
+        // the least loaded peer, the timed out chunk is requested from another peer
+        PublicPtr chosen;
+        size_t chosenLoad = 0;
+        for (auto const& [peer, load] : loads)
+        {
+            if (load >= m_maxPendingPerPeer ||
+                (chunk.peer && loads.size() > 1 && peer->data() == chunk.peer->data()))
+            {
+                continue;
+            }
+            if (!chosen || load < chosenLoad)
+            {
+                chosen = peer;
+                chosenLoad = load;
+            }
+        }
+        if (!chosen)
+        {
+            break;
+        }
+        ++loads[chosen];
+        chunk.peer = chosen;
+        chunk.sendTime = _now;
+        requests.push_back(Request{chosen, m_manifest->number, i});
+    }
+    return requests;
+}
+
+Error::Ptr StateSnapshotImporter::onChunk(
+    PublicPtr _peer, BlockNumber _number, bytesConstRef _chunk)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_importStorage)
+    {
+        return BCOS_ERROR_PTR(
+            CommonError::InvalidSnapshot, "The storage does not support importing snapshots");
+    }
+    if (!m_manifest || _number != m_manifest->number)
+    {
+        return BCOS_ERROR_PTR(CommonError::InvalidSnapshotChunk, "Unexpected snapshot chunk");
+    }
+    auto it = m_chunkIndexes.find(m_hashImpl->hash(_chunk));
+    if (it == m_chunkIndexes.end())
+    {
+        return BCOS_ERROR_PTR(
+            CommonError::InvalidSnapshotChunk, "The snapshot chunk does not match the manifest");
+    }
+    auto& chunk = m_chunks[it->second];
+    if (chunk.imported)
+    {
+        return nullptr;
+    }
+    using Rows = std::pair<std::vector<std::string>, std::vector<std::string>>;
+    std::map<std::string, Rows, std::less<>> tableRows;
+    std::vector<std::pair<std::string, std::string>> currentState;
+    auto numberStr = boost::lexical_cast<std::string>(m_manifest->number);
+    std::optional<std::string> checkpointHeader;
+    auto decoded = decodeSnapshotRows(
+        _chunk, [&](std::string_view _table, std::string_view _key, std::string_view _value) {
+            if (_table == SYS_CURRENT_STATE)
+            {
+                currentState.emplace_back(_key, _value);
+                return;
+            }
+            // the staged header is not visible before published
+            if (_table == SYS_NUMBER_2_BLOCK_HEADER && _key == numberStr)
+            {
+                checkpointHeader.emplace(_value);
+            }
+            auto rows = tableRows.find(_table);
+            if (rows == tableRows.end())
+            {
+                rows = tableRows.emplace(std::string(_table), Rows()).first;
+            }
+            rows->second.first.emplace_back(_key);
+            rows->second.second.emplace_back(_value);
+        });
+    if (!decoded)
+    {
+        return BCOS_ERROR_PTR(CommonError::InvalidSnapshotChunk, "Malformed snapshot chunk");
+    }
+    try
+    {
+        for (auto& [table, rows] : tableRows)
+        {
+            if (auto error = m_importStorage->stageRows(
+                    table, std::move(rows.first), std::move(rows.second)))
+            {
+                return error;
+            }
+        }
+    }
+    catch (std::exception const& e)
+    {
+        return BCOS_ERROR_PTR(CommonError::InvalidSnapshot, boost::diagnostic_information(e));
+    }
+    if (checkpointHeader)
+    {
+        m_checkpointHeader = std::move(checkpointHeader);
+    }
+    for (auto& [key, value] : currentState)
+    {
+        m_currentStateKeys.push_back(std::move(key));
+        m_currentStateValues.push_back(std::move(value));
+    }
+    chunk.imported = true;
+    ++m_importedChunks;
+    BLKSYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("stage snapshot chunk")
+                       << LOG_KV("index", it->second) << LOG_KV("size", _chunk.size())
+                       << LOG_KV("tables", tableRows.size()) << LOG_KV("peer", _peer->shortHex())
+                       << LOG_KV("imported", m_importedChunks)
+                       << LOG_KV("chunks", m_chunks.size());
+    if (m_importedChunks < m_chunks.size())
+    {
+        return nullptr;
+    }
+    return finishImport();
+}
+
+Error::Ptr StateSnapshotImporter::finishImport()
+{
+    // the checkpoint header is in the snapshot or already in the ledger
+    if (!m_checkpointHeader)
+    {
+        auto numberStr = boost::lexical_cast<std::string>(m_manifest->number);
+        std::promise<std::pair<Error::UniquePtr, std::optional<Entry>>> promise;
+        m_storage->asyncGetRow(SYS_NUMBER_2_BLOCK_HEADER, numberStr,
+            [&promise](Error::UniquePtr _error, std::optional<Entry> _entry) {
+                promise.set_value({std::move(_error), std::move(_entry)});
+            });
+        auto [error, entry] = promise.get_future().get();
+        if (error)
+        {
+            return BCOS_ERROR_WITH_PREV_PTR(
+                CommonError::InvalidSnapshot, "Read the checkpoint header failed", *error);
+        }
+        if (entry)
+        {
+            m_checkpointHeader.emplace(entry->get());
+        }
+    }
+    bool matched = false;
+    if (m_checkpointHeader)
+    {
+        try
+        {
+            auto const& value = *m_checkpointHeader;
+            auto header = m_blockHeaderFactory->createBlockHeader(
+                bytesConstRef((byte const*)value.data(), value.size()));
+            // the hash is computed from the fields, not taken from the encoded header
+            header->setNumber(header->number());
+            matched = header->number() == m_manifest->number &&
+                      header->hash() == m_manifest->blockHash && checkpointHeaderSigned(header);
+        }
+        catch (std::exception const& e)
+        {
+            BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                                 << LOG_DESC("decode the checkpoint header failed")
+                                 << LOG_KV("error", boost::diagnostic_information(e));
+        }
+    }
+    if (!matched)
+    {
+        BLKSYNC_LOG(ERROR) << LOG_BADGE("Snapshot")
+                           << LOG_DESC("the checkpoint header does not match the snapshot")
+                           << LOG_KV("number", m_manifest->number)
+                           << LOG_KV("hash", m_manifest->blockHash.abridged());
+        reset();
+        return BCOS_ERROR_PTR(
+            CommonError::InvalidSnapshot, "The checkpoint header does not match the snapshot");
+    }
+    if (auto error = m_importStorage->publishStagedRows(m_currentStateKeys, m_currentStateValues))
+    {
+        BLKSYNC_LOG(ERROR) << LOG_BADGE("Snapshot") << LOG_DESC("publish the snapshot failed")
+                           << LOG_KV("number", m_manifest->number)
+                           << LOG_KV("error", error->errorMessage());
+        return error;
+    }
+    m_imported = true;
+    BLKSYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("import snapshot success")
+                      << LOG_KV("number", m_manifest->number)
+                      << LOG_KV("hash", m_manifest->blockHash.abridged())
+                      << LOG_KV("chunks", m_chunks.size());
+    return nullptr;
+}
+
+bool StateSnapshotImporter::checkpointHeaderSigned(BlockHeader::Ptr _header) const
+{
+    uint64_t totalWeight = 0;
+    for (auto const& [nodeID, weight] : m_trustedSealers)
+    {
+        totalWeight += weight;
+    }
+    if (totalWeight == 0)
+    {
+        return false;
+    }
+    auto signatureImpl = _header->cryptoSuite()->signatureImpl();
+    auto sealerList = _header->sealerList();
+    std::set<bytes> signedSealers;
+    uint64_t signedWeight = 0;
+    for (auto const& signature : _header->signatureList())
+    {
+        if (signature.index < 0 || (size_t)signature.index >= sealerList.size())
+        {
+            continue;
+        }
+        auto const& sealer = sealerList[signature.index];
+        auto it = m_trustedSealers.find(sealer);
+        if (it == m_trustedSealers.end() || signedSealers.count(sealer) ||
+            !signatureImpl->verify(std::shared_ptr<const bytes>(&sealer, [](const bytes*) {}),
+                _header->hash(), ref(signature.signature)))
+        {
+            continue;
+        }
+        signedSealers.insert(sealer);
+        signedWeight += it->second;
+    }
+    auto minRequiredWeight = totalWeight - (totalWeight - 1) / 3;
+    if (signedWeight < minRequiredWeight)
+    {
+        BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                             << LOG_DESC("the checkpoint header is not signed by the quorum")
+                             << LOG_KV("signedWeight", signedWeight)
+                             << LOG_KV("minRequiredWeight", minRequiredWeight);
+        return false;
+    }
+    return true;
+}
+
+void StateSnapshotImporter::reset()
+{
+    // the peers reporting the rejected manifest are not trusted any more
+    for (auto it = m_peerManifests.begin(); it != m_peerManifests.end();)
+    {
+        if (it->second.digest == m_manifest->digest)
+        {
+            it = m_peerManifests.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    m_manifest.reset();
+    m_chunks.clear();
+    m_chunkIndexes.clear();
+    m_importedChunks = 0;
+    m_currentStateKeys.clear();
+    m_currentStateValues.clear();
+    m_checkpointHeader.reset();
+    dropStagedRows();
+}
+
+void StateSnapshotImporter::dropStagedRows()
+{
+    if (!m_importStorage)
+    {
+        return;
+    }
+    if (auto error = m_importStorage->dropStagedRows())
+    {
+        BLKSYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("drop the staged rows failed")
+                             << LOG_KV("error", error->errorMessage());
+    }
+}
+
+void StateSnapshotImporter::removePeer(PublicPtr _peer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_peerManifests.erase(_peer);
+}
+
+std::optional<SnapshotManifest> StateSnapshotImporter::manifest() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_manifest;
+}
+
+size_t StateSnapshotImporter::importedChunks() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_importedChunks;
+}
+
+bool StateSnapshotImporter::imported() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_imported;
+}
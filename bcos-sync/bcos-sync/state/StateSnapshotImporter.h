@@ -0,0 +1,113 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief downloads and imports a state snapshot agreed by the peers
+ * @file StateSnapshotImporter.h
+ */
+#pragma once
+#include "bcos-sync/state/StateSnapshot.h"
+#include <bcos-crypto/interfaces/crypto/KeyInterface.h>
+#include <bcos-framework/consensus/ConsensusNodeInterface.h>
+#include <bcos-framework/protocol/BlockHeaderFactory.h>
+#include <bcos-framework/storage/StorageInterface.h>
+#include <bcos-utilities/Error.h>
+#include <map>
+#include <mutex>
+
+namespace bcos
+{
+namespace sync
+{
+// The manifest reported by at least quorum peers is imported, its chunks are requested from
+// these peers in parallel and every chunk is checked against its hash in the manifest before its
+// rows are staged outside the live tables. After the header of the checkpoint block is checked
+// against the block hash and the signatures of the trusted sealers, the staged rows replace the
+// system and state tables in bounded writes, the rows of the current state, such as the current
+// block number, are written last, so the node never reports a partially imported or rejected
+// state; a publish interrupted by a restart is finished when the storage is opened again.
+// The staged rows are dropped when the snapshot is rejected and when the importer is created.
+class StateSnapshotImporter
+{
+public:
+    using Ptr = std::shared_ptr<StateSnapshotImporter>;
+    struct Request
+    {
+        bcos::crypto::PublicPtr peer;
+        bcos::protocol::BlockNumber number;
+        size_t index;
+    };
+    constexpr static int64_t c_chunkTimeout = 30000;
+
+    StateSnapshotImporter(bcos::storage::StorageInterface::Ptr _storage,
+        bcos::crypto::Hash::Ptr _hashImpl,
+        bcos::protocol::BlockHeaderFactory::Ptr _blockHeaderFactory,
+        size_t _maxPendingPerPeer = 2, int64_t _chunkTimeout = c_chunkTimeout);
+    virtual ~StateSnapshotImporter() = default;
+
+    // the consensus nodes known before the import, the checkpoint header must be signed by the
+    // nodes of at least the pbft quorum of their weights
+    void setTrustedSealers(bcos::consensus::ConsensusNodeList const& _sealers);
+    void onManifest(bcos::crypto::PublicPtr _peer, SnapshotManifest _manifest);
+    // chooses the latest manifest reported by at least _quorum peers if not chosen yet, returns
+    // the requests of the chunks not requested or timed out
+    std::vector<Request> schedule(size_t _quorum, int64_t _now);
+    Error::Ptr onChunk(bcos::crypto::PublicPtr _peer, bcos::protocol::BlockNumber _number,
+        bytesConstRef _chunk);
+    void removePeer(bcos::crypto::PublicPtr _peer);
+
+    // the chosen manifest
+    std::optional<SnapshotManifest> manifest() const;
+    size_t importedChunks() const;
+    bool imported() const;
+
+private:
+    struct Chunk
+    {
+        bool imported = false;
+        bcos::crypto::PublicPtr peer;
+        int64_t sendTime = 0;
+    };
+    // checks the checkpoint header and publishes the staged rows with the current state
+    Error::Ptr finishImport();
+    bool checkpointHeaderSigned(bcos::protocol::BlockHeader::Ptr _header) const;
+    // drops the chosen manifest, its peers and the staged rows
+    void reset();
+    void dropStagedRows();
+
+    bcos::storage::StorageInterface::Ptr m_storage;
+    // nullptr if the storage can not import snapshots
+    bcos::storage::StateSnapshotImportInterface::Ptr m_importStorage;
+    bcos::crypto::Hash::Ptr m_hashImpl;
+    bcos::protocol::BlockHeaderFactory::Ptr m_blockHeaderFactory;
+    size_t m_maxPendingPerPeer;
+    int64_t m_chunkTimeout;
+
+    // the node id to the weight of the trusted sealers
+    std::map<bytes, uint64_t> m_trustedSealers;
+    std::map<bcos::crypto::PublicPtr, SnapshotManifest, bcos::crypto::KeyCompare> m_peerManifests;
+    std::optional<SnapshotManifest> m_manifest;
+    std::vector<Chunk> m_chunks;
+    std::map<bcos::crypto::HashType, size_t> m_chunkIndexes;
+    size_t m_importedChunks = 0;
+    // the rows of the current state table, published with the staged rows
+    std::vector<std::string> m_currentStateKeys;
+    std::vector<std::string> m_currentStateValues;
+    // the encoded header of the checkpoint block
+    std::optional<std::string> m_checkpointHeader;
+    bool m_imported = false;
+    mutable std::mutex m_mutex;
+};
+}  // namespace sync
+}  // namespace bcos
@@ -32,6 +32,12 @@ enum BlockSyncPacketType : int32_t
     BlockStatusPacket = 0x00,
     BlockRequestPacket = 0x01,
     BlockResponsePacket = 0x02,
+    // the state snapshot sync, the chunk is requested by the number of the checkpoint block and
+    // its index in the manifest
+    SnapshotManifestRequestPacket = 0x03,
+    SnapshotManifestResponsePacket = 0x04,
+    SnapshotChunkRequestPacket = 0x05,
+    SnapshotChunkResponsePacket = 0x06,
 };
 enum SyncState : int32_t
 {
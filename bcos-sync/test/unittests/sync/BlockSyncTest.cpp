@@ -22,6 +22,7 @@
 #include <bcos-crypto/hash/Keccak256.h>
 #include <bcos-crypto/hash/SM3.h>
 #include <bcos-crypto/signature/secp256k1/Secp256k1Crypto.h>
+#include <bcos-protocol/protobuf/PBTransaction.h>
 #include <bcos-utilities/testutils/TestPromptFixture.h>
 #include <boost/test/unit_test.hpp>
 
@@ -33,6 +34,38 @@ namespace bcos
 {
 namespace test
 {
+// records the messages of the sync module instead of delivering them
+class RecordingGateWay : public FakeGateWay
+{
+public:
+    using Ptr = std::shared_ptr<RecordingGateWay>;
+    void asyncSendMessageByNodeID(int _moduleId, NodeIDPtr, NodeIDPtr, bytesConstRef _data,
+        uint32_t, CallbackFunc) override
+    {
+        if (_moduleId == ModuleID::BlockSync)
+        {
+            m_messages.emplace_back(_data.toBytes());
+        }
+    }
+
+    // the first block number and the blocks count of the recorded blocks messages
+    std::vector<std::pair<BlockNumber, size_t>> takeBlocksMessages(
+        BlockSyncMsgFactory::Ptr _msgFactory)
+    {
+        std::vector<std::pair<BlockNumber, size_t>> blocksMessages;
+        for (auto const& message : m_messages)
+        {
+            auto blocksMsg = _msgFactory->createBlocksMsg(bcos::ref(message));
+            blocksMessages.emplace_back(blocksMsg->number(), blocksMsg->blocksSize());
+        }
+        m_messages.clear();
+        return blocksMessages;
+    }
+
+private:
+    std::vector<bytes> m_messages;
+};
+
 BOOST_FIXTURE_TEST_SUITE(BlockSyncTest, TestPromptFixture)
 void testRequestAndDownloadBlock(CryptoSuite::Ptr _cryptoSuite)
 {
@@ -205,6 +238,139 @@ BOOST_AUTO_TEST_CASE(testNonSMRequestAndDownloadBlock)
     testRequestAndDownloadBlock(cryptoSuite);
     testComplicatedCase(cryptoSuite);
 }
+BOOST_AUTO_TEST_CASE(testDropTamperedBlocks)
+{
+    auto hashImpl = std::make_shared<Keccak256>();
+    auto signatureImpl = std::make_shared<Secp256k1Crypto>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto gateWay = std::make_shared<FakeGateWay>();
+    auto newerPeer = std::make_shared<SyncFixture>(cryptoSuite, gateWay, 7);
+    auto lowerPeer = std::make_shared<SyncFixture>(cryptoSuite, gateWay, 1);
+    lowerPeer->init();
+
+    auto blockFactory = lowerPeer->syncConfig()->blockFactory();
+    auto ledgerData = newerPeer->ledger()->ledgerData();
+    // the blocks of the fake ledger are not signed, the copies are signed by fake sealers
+    std::vector<KeyPairInterface::Ptr> keyPairs;
+    auto sealerList = fakeSealerList(keyPairs, signatureImpl, 4);
+    auto copyBlock = [&](BlockNumber _number) {
+        bytes data;
+        ledgerData[_number]->encode(data);
+        auto block = blockFactory->createBlock(data, true, false);
+        auto blockHeader = block->blockHeader();
+        blockHeader->setSealerList(sealerList);
+        blockHeader->setSignatureList(
+            fakeSignatureList(signatureImpl, keyPairs, blockHeader->hash()));
+        return block;
+    };
+    auto copyTx = [&](Transaction::ConstPtr _tx) {
+        bytes data;
+        _tx->encode(data);
+        return blockFactory->transactionFactory()->createTransaction(data, false);
+    };
+
+    // the signature of the header does not match its sealer
+    auto badSignature = copyBlock(1);
+    auto signatures = badSignature->blockHeader()->signatureList();
+    SignatureList signatureList(signatures.begin(), signatures.end());
+    signatureList[0].signature[0] ^= 0xff;
+    badSignature->blockHeader()->setSignatureList(signatureList);
+    // the sealer index of the signature is out of the sealer list
+    auto badSealerIndex = copyBlock(2);
+    signatures = badSealerIndex->blockHeader()->signatureList();
+    signatureList.assign(signatures.begin(), signatures.end());
+    signatureList[0].index = badSealerIndex->blockHeader()->sealerList().size();
+    badSealerIndex->blockHeader()->setSignatureList(signatureList);
+    // the sender of a transaction can not be recovered
+    auto badTxSignature = copyBlock(3);
+    auto tx = copyTx(badTxSignature->transaction(0));
+    bytes invalidSignature(65, 0);
+    std::dynamic_pointer_cast<PBTransaction>(tx)->updateSignature(
+        bcos::ref(invalidSignature), bytes());
+    badTxSignature->setTransaction(0, tx);
+    // a transaction is added after the header is signed
+    auto badTxsRoot = copyBlock(4);
+    badTxsRoot->appendTransaction(copyTx(ledgerData[5]->transaction(0)));
+
+    auto blocksMsg = lowerPeer->syncConfig()->msgFactory()->createBlocksMsg();
+    for (auto const& block :
+        {badSignature, badSealerIndex, badTxSignature, badTxsRoot, copyBlock(5), copyBlock(6)})
+    {
+        bytes data;
+        block->encode(data);
+        blocksMsg->appendBlockData(std::move(data));
+    }
+    auto downloadingQueue = lowerPeer->sync()->downloadingQueue();
+    downloadingQueue->push(blocksMsg);
+
+    // only the untampered blocks are queued
+    auto top = downloadingQueue->top(true);
+    BOOST_REQUIRE(top);
+    BOOST_CHECK_EQUAL(top->blockHeader()->number(), 5);
+    BOOST_CHECK_EQUAL(downloadingQueue->size(), 2);
+
+    // the verified blocks exceeding the space left in the queue are dropped
+    downloadingQueue->clear();
+    lowerPeer->syncConfig()->setMaxDownloadingBlockQueueSize(1);
+    downloadingQueue->push(blocksMsg);
+    top = downloadingQueue->top(true);
+    BOOST_REQUIRE(top);
+    BOOST_CHECK_EQUAL(top->blockHeader()->number(), 5);
+    BOOST_CHECK_EQUAL(downloadingQueue->size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(testSendBlocks)
+{
+    auto hashImpl = std::make_shared<Keccak256>();
+    auto signatureImpl = std::make_shared<Secp256k1Crypto>();
+    auto cryptoSuite = std::make_shared<CryptoSuite>(hashImpl, signatureImpl, nullptr);
+    auto gateWay = std::make_shared<RecordingGateWay>();
+    auto peer = std::make_shared<SyncFixture>(cryptoSuite, gateWay, 7);
+    auto sync = peer->sync();
+    auto config = peer->syncConfig();
+    auto requester = signatureImpl->generateKeyPair()->publicKey();
+    using BlocksMessages = std::vector<std::pair<BlockNumber, size_t>>;
+
+    std::vector<EncodedBlock> blocks;
+    size_t maxBlockSize = 0;
+    for (BlockNumber number = 1; number <= 6; ++number)
+    {
+        auto blockData = std::make_shared<bytes>();
+        peer->ledger()->ledgerData()[number]->encode(*blockData);
+        maxBlockSize = std::max(maxBlockSize, blockData->size());
+        blocks.emplace_back(std::move(blockData));
+    }
+
+    // every message is capped by maxBlocksMsgSize
+    config->setMaxBlocksMsgSize(maxBlockSize * 2);
+    sync->sendBlocks(requester, 1, blocks);
+    BOOST_CHECK(gateWay->takeBlocksMessages(config->msgFactory()) ==
+                BlocksMessages({{1, 2}, {3, 2}, {5, 2}}));
+
+    // the blocks in a message are consecutive, the range is split at the failed block
+    config->setMaxBlocksMsgSize(maxBlockSize * 10);
+    blocks[2] = nullptr;
+    sync->sendBlocks(requester, 1, blocks);
+    BOOST_CHECK(gateWay->takeBlocksMessages(config->msgFactory()) ==
+                BlocksMessages({{1, 2}, {4, 3}}));
+
+    // the cached blocks and the blocks read from the ledger are merged into one message
+    auto reqQueue = std::make_shared<DownloadRequestQueue>(config, requester);
+    sync->fetchAndSendBlocks(reqQueue, requester, 2, 2);
+    BOOST_CHECK(gateWay->takeBlocksMessages(config->msgFactory()) == BlocksMessages({{2, 2}}));
+    sync->fetchAndSendBlocks(reqQueue, requester, 1, 6);
+    BOOST_CHECK(gateWay->takeBlocksMessages(config->msgFactory()) == BlocksMessages({{1, 6}}));
+    BOOST_CHECK(reqQueue->empty());
+
+    // the blocks failed to read are requested again
+    sync->fetchAndSendBlocks(reqQueue, requester, 5, 4);
+    BOOST_CHECK(gateWay->takeBlocksMessages(config->msgFactory()) == BlocksMessages({{5, 2}}));
+    auto request = reqQueue->topAndPop();
+    BOOST_REQUIRE(request);
+    BOOST_CHECK_EQUAL(request->fromNumber(), 7);
+    BOOST_CHECK_EQUAL(request->size(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace bcos
\ No newline at end of file
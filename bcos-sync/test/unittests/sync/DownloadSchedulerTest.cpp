@@ -0,0 +1,219 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief test for the scheduler of the block requests
+ * @file DownloadSchedulerTest.cpp
+ */
+#include "bcos-sync/state/DownloadScheduler.h"
+#include <bcos-crypto/signature/key/KeyImpl.h>
+#include <bcos-utilities/testutils/TestPromptFixture.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace bcos;
+using namespace bcos::sync;
+using namespace bcos::crypto;
+
+namespace bcos
+{
+namespace test
+{
+namespace
+{
+PublicPtr fakePeer(byte _id)
+{
+    return std::make_shared<KeyImpl>(bytes(64, _id));
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(DownloadSchedulerTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testStripeByRate)
+{
+    auto peerA = fakePeer(1);
+    auto peerB = fakePeer(2);
+    DownloadScheduler::Peers peers{{peerA, 100}, {peerB, 100}};
+    DownloadScheduler scheduler(4, 2);
+
+    // the peers not rated yet share the shards evenly
+    auto requests = scheduler.schedule(1, 16, peers, 0);
+    BOOST_CHECK_EQUAL(requests.size(), 4);
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(requests[i].from, 1 + 4 * i);
+        BOOST_CHECK_EQUAL(requests[i].size, 4);
+        BOOST_CHECK(requests[i].peer == (i % 2 == 0 ? peerA : peerB));
+    }
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 4);
+    // the scheduled blocks are not requested again
+    BOOST_CHECK(scheduler.schedule(1, 16, peers, 0).empty());
+
+    scheduler.onBlocksReceived(peerA, 1, 4, 4000, 100);
+    scheduler.onBlocksReceived(peerB, 5, 4, 4000, 1000);
+    scheduler.onBlocksReceived(peerA, 9, 2, 2000, 150);
+    scheduler.onBlocksReceived(peerA, 11, 2, 2000, 200);
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 1);
+    auto rateA = scheduler.peerRate(peerA);
+    auto rateB = scheduler.peerRate(peerB);
+    BOOST_REQUIRE(rateA && rateB);
+    BOOST_CHECK_EQUAL(rateA->samples, 2);
+    BOOST_CHECK_EQUAL(rateB->blocksRate, 4);
+    BOOST_CHECK_EQUAL(rateB->bytesRate, 4000);
+    BOOST_CHECK_EQUAL(rateB->latency, 1000);
+    BOOST_CHECK_GT(rateA->blocksRate, rateB->blocksRate);
+
+    // the faster peer serves more shards, every peer has at most two requests in flight
+    requests = scheduler.schedule(1, 40, peers, 1000);
+    BOOST_REQUIRE_EQUAL(requests.size(), 3);
+    BOOST_CHECK(requests[0].peer == peerA);
+    BOOST_CHECK_EQUAL(requests[0].from, 17);
+    BOOST_CHECK(requests[1].peer == peerA);
+    BOOST_CHECK_EQUAL(requests[1].from, 21);
+    BOOST_CHECK(requests[2].peer == peerB);
+    BOOST_CHECK_EQUAL(requests[2].from, 25);
+
+    scheduler.expire(12);
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 4);
+    BOOST_CHECK(!scheduler.peerRate(fakePeer(3)));
+    scheduler.removePeer(peerB);
+    BOOST_CHECK(!scheduler.peerRate(peerB));
+}
+
+BOOST_AUTO_TEST_CASE(testHedge)
+{
+    auto peerA = fakePeer(1);
+    auto peerB = fakePeer(2);
+    DownloadScheduler::Peers peers{{peerA, 100}, {peerB, 100}};
+    DownloadScheduler scheduler(4, 2, 1000);
+
+    auto requests = scheduler.schedule(1, 8, peers, 0);
+    BOOST_REQUIRE_EQUAL(requests.size(), 2);
+    scheduler.onBlocksReceived(peerB, 5, 4, 400, 100);
+    scheduler.onBlocksReceived(peerA, 1, 1, 100, 200);
+    BOOST_CHECK(scheduler.hedge(peers, 900).empty());
+
+    // the missing blocks of the slow shard are requested from the other peer
+    requests = scheduler.hedge(peers, 1500);
+    BOOST_REQUIRE_EQUAL(requests.size(), 1);
+    BOOST_CHECK(requests[0].peer == peerB);
+    BOOST_CHECK_EQUAL(requests[0].from, 2);
+    BOOST_CHECK_EQUAL(requests[0].size, 3);
+    auto rateA = scheduler.peerRate(peerA);
+    BOOST_REQUIRE(rateA);
+    BOOST_CHECK_LT(rateA->blocksRate, scheduler.peerRate(peerB)->blocksRate);
+    // hedged only once
+    BOOST_CHECK(scheduler.hedge(peers, 5000).empty());
+
+    scheduler.onBlocksReceived(peerB, 2, 3, 300, 1600);
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 0);
+    BOOST_CHECK_EQUAL(scheduler.peerRate(peerB)->samples, 2);
+    // the late blocks of the slow peer are ignored
+    scheduler.onBlocksReceived(peerA, 2, 3, 300, 2000);
+    BOOST_CHECK_EQUAL(scheduler.peerRate(peerA)->samples, 1);
+}
+
+BOOST_AUTO_TEST_CASE(testPeerNumberAndTimeout)
+{
+    auto peerA = fakePeer(1);
+    auto peerB = fakePeer(2);
+    DownloadScheduler::Peers peers{{peerA, 4}, {peerB, 100}};
+    DownloadScheduler scheduler(4, 1);
+
+    BOOST_CHECK(scheduler.schedule(1, 8, {}, 0).empty());
+    // only the peer having the blocks is requested
+    auto requests = scheduler.schedule(1, 12, peers, 0);
+    BOOST_REQUIRE_EQUAL(requests.size(), 2);
+    BOOST_CHECK(requests[0].peer == peerA);
+    BOOST_CHECK(requests[1].peer == peerB);
+    BOOST_CHECK_EQUAL(requests[1].from, 5);
+
+    // the timed out shards are rated and requested again
+    scheduler.onTimeout(2000);
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 0);
+    BOOST_CHECK_EQUAL(scheduler.peerRate(peerA)->blocksRate, 0);
+    BOOST_CHECK_EQUAL(scheduler.peerRate(peerB)->latency, 2000);
+    requests = scheduler.schedule(1, 12, peers, 2000);
+    BOOST_CHECK_EQUAL(requests.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testPeerRecover)
+{
+    auto peerA = fakePeer(1);
+    auto peerB = fakePeer(2);
+    DownloadScheduler::Peers peers{{peerA, 1000}, {peerB, 1000}};
+    DownloadScheduler scheduler(4, 64);
+
+    auto requests = scheduler.schedule(1, 8, peers, 0);
+    BOOST_REQUIRE_EQUAL(requests.size(), 2);
+    scheduler.onBlocksReceived(peerB, 5, 4, 400, 1000);
+    scheduler.onTimeout(2000);
+    BOOST_CHECK_EQUAL(scheduler.peerRate(peerA)->blocksRate, 0);
+
+    // the timed out peer is still requested once the faster peer owes enough blocks
+    requests = scheduler.schedule(1, 200, peers, 2000);
+    auto requestOfA = std::find_if(requests.begin(), requests.end(),
+        [&peerA](auto const& _request) { return _request.peer == peerA; });
+    BOOST_REQUIRE(requestOfA != requests.end());
+    auto requestsOfA = std::count_if(requests.begin(), requests.end(),
+        [&peerA](auto const& _request) { return _request.peer == peerA; });
+    BOOST_CHECK_LT(requestsOfA * 2, requests.size());
+
+    // the probed peer responds fast and is rated above the other one again
+    scheduler.onBlocksReceived(peerA, requestOfA->from, 4, 400, 2100);
+    BOOST_CHECK_GT(scheduler.peerRate(peerA)->blocksRate, scheduler.peerRate(peerB)->blocksRate);
+    scheduler.clear();
+    requests = scheduler.schedule(1, 8, peers, 3000);
+    BOOST_REQUIRE(!requests.empty());
+    BOOST_CHECK(requests[0].peer == peerA);
+}
+
+BOOST_AUTO_TEST_CASE(testUnrequestedAndDroppedBlocks)
+{
+    auto peerA = fakePeer(1);
+    auto peerB = fakePeer(2);
+    auto peerC = fakePeer(3);
+    DownloadScheduler::Peers peers{{peerA, 100}, {peerB, 100}};
+    DownloadScheduler scheduler(4, 2);
+
+    auto requests = scheduler.schedule(1, 8, peers, 0);
+    BOOST_REQUIRE_EQUAL(requests.size(), 2);
+    BOOST_CHECK(scheduler.expects(peerA, 1, 4));
+    BOOST_CHECK(scheduler.expects(peerA, 3, 4));
+    BOOST_CHECK(!scheduler.expects(peerA, 5, 4));
+    BOOST_CHECK(!scheduler.expects(peerC, 1, 8));
+
+    // the blocks of the peers not requested are neither received nor credited
+    scheduler.onBlocksReceived(peerA, 5, 4, 400, 100);
+    scheduler.onBlocksReceived(peerC, 1, 8, 800, 100);
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 2);
+    BOOST_CHECK(!scheduler.peerRate(peerC));
+
+    scheduler.onBlocksReceived(peerB, 5, 4, 400, 1000);
+    BOOST_CHECK_EQUAL(scheduler.pendingShards(), 1);
+    BOOST_CHECK(!scheduler.expects(peerB, 5, 4));
+    BOOST_CHECK_EQUAL(scheduler.peerRate(peerB)->samples, 1);
+
+    // the shard of the dropped block is requested again
+    BOOST_CHECK(scheduler.schedule(1, 8, peers, 1000).empty());
+    scheduler.onBlocksDropped({6}, 1000);
+    requests = scheduler.schedule(1, 8, peers, 1000);
+    BOOST_REQUIRE_EQUAL(requests.size(), 1);
+    BOOST_CHECK_EQUAL(requests[0].from, 5);
+    BOOST_CHECK_EQUAL(requests[0].size, 4);
+    BOOST_CHECK(scheduler.expects(requests[0].peer, 6, 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
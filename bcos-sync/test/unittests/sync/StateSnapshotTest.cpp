@@ -0,0 +1,445 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief test for the import of the state snapshots
+ * @file StateSnapshotTest.cpp
+ */
+#include "bcos-protocol/testutils/protocol/FakeBlock.h"
+#include "bcos-sync/state/StateSnapshotExporter.h"
+#include "bcos-sync/state/StateSnapshotImporter.h"
+#include <bcos-crypto/hash/Sha256.h>
+#include <bcos-crypto/signature/key/KeyImpl.h>
+#include <bcos-framework/consensus/ConsensusNode.h>
+#include <bcos-framework/ledger/LedgerTypeDef.h>
+#include <bcos-framework/protocol/CommonError.h>
+#include <bcos-table/src/StateStorage.h>
+#include <bcos-utilities/testutils/TestPromptFixture.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace bcos;
+using namespace bcos::sync;
+using namespace bcos::crypto;
+using namespace bcos::storage;
+
+namespace bcos
+{
+namespace test
+{
+namespace
+{
+PublicPtr fakePeer(byte _id)
+{
+    return std::make_shared<KeyImpl>(bytes(64, _id));
+}
+
+// the staged rows are kept in a map, the history tables are not replaced on publish
+class FakeStorage : public StateStorage, public StateSnapshotImportInterface
+{
+public:
+    FakeStorage() : StateStorageInterface(nullptr), StateStorage(nullptr) {}
+    Error::Ptr setRows(std::string_view _table, std::vector<std::string> _keys,
+        std::vector<std::string> _values) override
+    {
+        for (size_t i = 0; i < _keys.size(); ++i)
+        {
+            Entry entry;
+            entry.set(std::move(_values[i]));
+            asyncSetRow(_table, _keys[i], std::move(entry), [](Error::UniquePtr) {});
+        }
+        return nullptr;
+    }
+    std::optional<std::string> row(std::string_view _table, std::string_view _key)
+    {
+        std::optional<std::string> value;
+        asyncGetRow(_table, _key, [&value](Error::UniquePtr, std::optional<Entry> _entry) {
+            if (_entry)
+            {
+                value = std::string(_entry->get());
+            }
+        });
+        return value;
+    }
+
+    Error::Ptr stageRows(std::string_view _table, std::vector<std::string> _keys,
+        std::vector<std::string> _values) override
+    {
+        for (size_t i = 0; i < _keys.size(); ++i)
+        {
+            m_staged[{std::string(_table), std::move(_keys[i])}] = std::move(_values[i]);
+        }
+        return nullptr;
+    }
+    Error::Ptr publishStagedRows(std::vector<std::string> _currentStateKeys,
+        std::vector<std::string> _currentStateValues) override
+    {
+        std::set<std::pair<std::string, std::string>> rewritten;
+        for (auto const& key : _currentStateKeys)
+        {
+            rewritten.emplace(ledger::SYS_CURRENT_STATE, key);
+        }
+        std::vector<std::pair<std::string, std::string>> deleted;
+        std::mutex mutex;
+        parallelTraverse(false, [&](auto const& _table, auto const& _key, Entry const& _entry) {
+            auto row = std::make_pair(std::string(_table), std::string(_key));
+            if (_entry.status() != Entry::DELETED && _table != ledger::SYS_NUMBER_2_BLOCK_HEADER &&
+                !m_staged.count(row) && !rewritten.count(row))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                deleted.push_back(std::move(row));
+            }
+            return true;
+        });
+        for (auto& [table, key] : deleted)
+        {
+            Entry entry;
+            entry.setStatus(Entry::DELETED);
+            asyncSetRow(table, key, std::move(entry), [](Error::UniquePtr) {});
+        }
+        for (auto& [row, value] : m_staged)
+        {
+            setRows(row.first, {row.second}, {std::move(value)});
+        }
+        m_staged.clear();
+        return setRows(ledger::SYS_CURRENT_STATE, std::move(_currentStateKeys),
+            std::move(_currentStateValues));
+    }
+    Error::Ptr dropStagedRows() override
+    {
+        m_staged.clear();
+        return nullptr;
+    }
+
+    std::map<std::pair<std::string, std::string>, std::string> m_staged;
+};
+
+// the rows are read in the order of the table and the key, the block hashes are history rows
+class FakeSnapshot : public StateStorage, public StateSnapshotInterface
+{
+public:
+    FakeSnapshot() : StateStorageInterface(nullptr), StateStorage(nullptr) {}
+    void setRow(std::string_view _table, std::string_view _key, std::string _value)
+    {
+        Entry entry;
+        entry.set(std::move(_value));
+        asyncSetRow(_table, _key, std::move(entry), [](Error::UniquePtr) {});
+    }
+    std::string readStateRows(std::string_view _from,
+        std::function<bool(std::string_view, std::string_view, std::string_view)> _onRow)
+        const override
+    {
+        std::map<std::string, std::tuple<std::string, std::string, std::string>, std::less<>> rows;
+        std::mutex mutex;
+        parallelTraverse(false, [&](auto const& _table, auto const& _key, Entry const& _entry) {
+            if (_table != ledger::SYS_NUMBER_2_HASH)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                rows[std::string(_table) + ":" + std::string(_key)] = {
+                    std::string(_table), std::string(_key), std::string(_entry.get())};
+            }
+            return true;
+        });
+        for (auto it = rows.lower_bound(_from); it != rows.end(); ++it)
+        {
+            auto const& [table, key, value] = it->second;
+            if (!_onRow(table, key, value))
+            {
+                return it->first;
+            }
+        }
+        return {};
+    }
+};
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(StateSnapshotTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testSnapshotRows)
+{
+    bytes chunk;
+    encodeSnapshotRow(chunk, "/apps/test", "key0", "value0");
+    encodeSnapshotRow(chunk, ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER, "");
+    std::vector<std::tuple<std::string, std::string, std::string>> rows;
+    BOOST_CHECK(decodeSnapshotRows(ref(chunk), [&rows](auto _table, auto _key, auto _value) {
+        rows.emplace_back(_table, _key, _value);
+    }));
+    BOOST_REQUIRE_EQUAL(rows.size(), 2);
+    BOOST_CHECK_EQUAL(std::get<0>(rows[0]), "/apps/test");
+    BOOST_CHECK_EQUAL(std::get<2>(rows[0]), "value0");
+    BOOST_CHECK_EQUAL(std::get<1>(rows[1]), ledger::SYS_KEY_CURRENT_NUMBER);
+    BOOST_CHECK(std::get<2>(rows[1]).empty());
+
+    // a truncated chunk is rejected
+    chunk.pop_back();
+    BOOST_CHECK(!decodeSnapshotRows(ref(chunk), [](auto, auto, auto) {}));
+}
+
+BOOST_AUTO_TEST_CASE(testExportSnapshot)
+{
+    auto hashImpl = std::make_shared<Sha256>();
+    // the rows of the second snapshot are stored in a legacy format for the even keys
+    auto current = std::make_shared<FakeSnapshot>();
+    auto legacy = std::make_shared<FakeSnapshot>();
+    auto blockHash = hashImpl->hash(bytesConstRef("checkpoint"));
+    for (auto snapshot : {current, legacy})
+    {
+        snapshot->setRow(ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER, "10");
+        snapshot->setRow(
+            ledger::SYS_NUMBER_2_HASH, "10", std::string(blockHash.begin(), blockHash.end()));
+        for (size_t i = 0; i < 10; ++i)
+        {
+            auto index = std::to_string(i);
+            snapshot->setRow("/apps/test", "key" + index,
+                (snapshot == legacy && i % 2 == 0 ? "legacy-value" : "value") + index);
+        }
+    }
+    auto exportSnapshot = [&](std::shared_ptr<FakeSnapshot> _snapshot,
+                              StateSnapshotExporter::ValueNormalizer _normalizer) {
+        auto exporter = std::make_shared<StateSnapshotExporter>(nullptr, hashImpl, 10, 1, 64);
+        exporter->setValueNormalizer(std::move(_normalizer));
+        BOOST_CHECK(exporter->exportSnapshot(_snapshot, 10));
+        return exporter;
+    };
+    auto normalizer = [](std::string_view, std::string_view,
+                          std::string_view _value) -> std::optional<std::string> {
+        if (_value.starts_with("legacy-"))
+        {
+            return std::string(_value.substr(7));
+        }
+        return std::nullopt;
+    };
+    auto currentExporter = exportSnapshot(current, nullptr);
+    auto manifest = currentExporter->manifest();
+    BOOST_REQUIRE(manifest);
+    // two rows in every chunk of the state tables, followed by a chunk of the ledger rows
+    BOOST_CHECK_EQUAL(manifest->chunkHashes.size(), 7);
+    BOOST_CHECK(exportSnapshot(legacy, nullptr)->manifest()->digest != manifest->digest);
+
+    // the rows stored in the legacy format are exported as the current ones
+    auto legacyExporter = exportSnapshot(legacy, normalizer);
+    BOOST_CHECK(legacyExporter->manifest()->digest == manifest->digest);
+    for (size_t i = 0; i < manifest->chunkHashes.size(); ++i)
+    {
+        auto chunk = legacyExporter->chunk(10, i);
+        BOOST_REQUIRE(chunk);
+        BOOST_CHECK(*chunk == *currentExporter->chunk(10, i));
+        BOOST_CHECK(hashImpl->hash(ref(*chunk)) == manifest->chunkHashes[i]);
+    }
+    BOOST_CHECK(!legacyExporter->chunk(10, manifest->chunkHashes.size()));
+    BOOST_CHECK(!legacyExporter->chunk(20, 0));
+}
+
+BOOST_AUTO_TEST_CASE(testImportSnapshot)
+{
+    auto hashImpl = std::make_shared<Sha256>();
+    auto storage = std::make_shared<FakeStorage>();
+    storage->setRows("/apps/test", {"stale"}, {"stale"});
+    // the rows staged before the restart are dropped
+    storage->stageRows("/apps/test", {"unfinished"}, {"unfinished"});
+    StateSnapshotImporter importer(storage, hashImpl, nullptr, 1, 1000);
+    BOOST_CHECK(storage->m_staged.empty());
+
+    bytes stateChunk;
+    encodeSnapshotRow(stateChunk, "/apps/test", "key0", "value0");
+    encodeSnapshotRow(stateChunk, ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER, "10");
+    bytes ledgerChunk;
+    encodeSnapshotRow(ledgerChunk, ledger::SYS_NUMBER_2_HASH, "10", "hash");
+
+    SnapshotManifest manifest;
+    manifest.number = 10;
+    manifest.blockHash = hashImpl->hash(bytesConstRef("checkpoint"));
+    manifest.chunkHashes = {hashImpl->hash(ref(stateChunk)), hashImpl->hash(ref(ledgerChunk))};
+    manifest.digest =
+        snapshotDigest(hashImpl, manifest.number, manifest.blockHash, manifest.chunkHashes);
+    auto forged = manifest;
+    forged.number = 20;
+    forged.digest = snapshotDigest(hashImpl, forged.number, forged.blockHash, forged.chunkHashes);
+
+    auto peerA = fakePeer(1);
+    auto peerB = fakePeer(2);
+    auto peerC = fakePeer(3);
+    importer.onManifest(peerA, manifest);
+    importer.onManifest(peerB, manifest);
+    importer.onManifest(peerC, forged);
+    // the later manifest is reported by one peer only
+    BOOST_CHECK(importer.schedule(3, 0).empty());
+    auto requests = importer.schedule(2, 0);
+    BOOST_REQUIRE(importer.manifest());
+    BOOST_CHECK_EQUAL(importer.manifest()->number, 10);
+    // one request in flight per agreeing peer
+    BOOST_REQUIRE_EQUAL(requests.size(), 2);
+    BOOST_CHECK_EQUAL(requests[0].index, 0);
+    BOOST_CHECK_EQUAL(requests[1].index, 1);
+    BOOST_CHECK(requests[0].peer != peerC && requests[1].peer != peerC);
+    BOOST_CHECK(requests[0].peer->data() != requests[1].peer->data());
+    auto ledgerChunkPeer = requests[1].peer;
+    BOOST_CHECK(importer.schedule(2, 500).empty());
+
+    // the chunks not matching the manifest are rejected
+    bytes invalidChunk{1, 2, 3};
+    auto error = importer.onChunk(peerA, 10, ref(invalidChunk));
+    BOOST_REQUIRE(error);
+    BOOST_CHECK_EQUAL(error->errorCode(), protocol::CommonError::InvalidSnapshotChunk);
+    BOOST_CHECK(importer.onChunk(peerA, 20, ref(stateChunk)));
+
+    BOOST_CHECK(!importer.onChunk(requests[0].peer, 10, ref(stateChunk)));
+    BOOST_CHECK_EQUAL(importer.importedChunks(), 1);
+    // the rows are staged until all the chunks are imported
+    BOOST_CHECK_EQUAL(storage->m_staged.size(), 1);
+    BOOST_CHECK(!storage->row("/apps/test", "key0"));
+    BOOST_CHECK(!storage->row(ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER));
+
+    // the timed out chunk is requested from another peer
+    requests = importer.schedule(2, 2000);
+    BOOST_REQUIRE_EQUAL(requests.size(), 1);
+    BOOST_CHECK_EQUAL(requests[0].index, 1);
+    BOOST_CHECK(requests[0].peer->data() != ledgerChunkPeer->data());
+
+    // no checkpoint header matches the manifest, the snapshot and its peers are dropped
+    error = importer.onChunk(peerA, 10, ref(ledgerChunk));
+    BOOST_REQUIRE(error);
+    BOOST_CHECK_EQUAL(error->errorCode(), protocol::CommonError::InvalidSnapshot);
+    BOOST_CHECK(!importer.imported());
+    BOOST_CHECK(!importer.manifest());
+    // the rejected rows are dropped, the live rows are untouched
+    BOOST_CHECK(storage->m_staged.empty());
+    BOOST_CHECK(!storage->row("/apps/test", "key0"));
+    BOOST_CHECK_EQUAL(storage->row("/apps/test", "stale").value_or(""), "stale");
+    BOOST_CHECK(!storage->row(ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER));
+    BOOST_CHECK(importer.schedule(2, 3000).empty());
+    requests = importer.schedule(1, 3000);
+    BOOST_REQUIRE_EQUAL(requests.size(), 1);
+    BOOST_CHECK(requests[0].peer->data() == peerC->data());
+    BOOST_CHECK_EQUAL(importer.manifest()->number, 20);
+}
+
+BOOST_AUTO_TEST_CASE(testPublishSnapshot)
+{
+    auto cryptoSuite = createNormalCryptoSuite();
+    auto hashImpl = cryptoSuite->hashImpl();
+    auto blockHeaderFactory = createBlockFactory(cryptoSuite)->blockHeaderFactory();
+    auto signatureImpl = cryptoSuite->signatureImpl();
+    auto header = blockHeaderFactory->createBlockHeader();
+    header->setNumber(10);
+    std::vector<KeyPairInterface::Ptr> keyPairs;
+    header->setSealerList(fakeSealerList(keyPairs, signatureImpl, 4));
+    consensus::ConsensusNodeList sealers;
+    for (auto const& keyPair : keyPairs)
+    {
+        sealers.push_back(std::make_shared<consensus::ConsensusNode>(keyPair->publicKey()));
+    }
+    // three of the four sealers have signed the checkpoint header
+    keyPairs.pop_back();
+    header->setSignatureList(fakeSignatureList(signatureImpl, keyPairs, header->hash()));
+    bytes encodedHeader;
+    header->encode(encodedHeader);
+
+    auto storage = std::make_shared<FakeStorage>();
+    storage->setRows("/apps/test", {"key0", "stale"}, {"old", "stale"});
+    storage->setRows(std::string(ledger::SYS_CURRENT_STATE),
+        {std::string(ledger::SYS_KEY_CURRENT_NUMBER),
+            std::string(ledger::SYS_KEY_TOTAL_TRANSACTION_COUNT)},
+        {"5", "100"});
+    StateSnapshotImporter importer(storage, hashImpl, blockHeaderFactory, 1, 1000);
+    importer.setTrustedSealers(sealers);
+
+    bytes chunk;
+    encodeSnapshotRow(chunk, "/apps/test", "key0", "value0");
+    encodeSnapshotRow(chunk, ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER, "10");
+    // the checkpoint header is checked before published
+    encodeSnapshotRow(chunk, ledger::SYS_NUMBER_2_BLOCK_HEADER, "10",
+        std::string_view((char const*)encodedHeader.data(), encodedHeader.size()));
+    SnapshotManifest manifest;
+    manifest.number = 10;
+    manifest.blockHash = header->hash();
+    manifest.chunkHashes = {hashImpl->hash(ref(chunk))};
+    manifest.digest =
+        snapshotDigest(hashImpl, manifest.number, manifest.blockHash, manifest.chunkHashes);
+    auto peer = fakePeer(1);
+    importer.onManifest(peer, manifest);
+    BOOST_REQUIRE_EQUAL(importer.schedule(1, 0).size(), 1);
+
+    BOOST_CHECK(!importer.onChunk(peer, 10, ref(chunk)));
+    BOOST_CHECK(importer.imported());
+    BOOST_CHECK(storage->m_staged.empty());
+    // the state is replaced by the snapshot, the live rows not in the snapshot are deleted
+    BOOST_CHECK_EQUAL(storage->row("/apps/test", "key0").value_or(""), "value0");
+    BOOST_CHECK(!storage->row("/apps/test", "stale"));
+    BOOST_CHECK_EQUAL(
+        storage->row(ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER).value_or(""),
+        "10");
+    BOOST_CHECK(!storage->row(ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_TOTAL_TRANSACTION_COUNT));
+    BOOST_CHECK(storage->row(ledger::SYS_NUMBER_2_BLOCK_HEADER, "10"));
+}
+
+BOOST_AUTO_TEST_CASE(testCheckpointSignatures)
+{
+    auto cryptoSuite = createNormalCryptoSuite();
+    auto hashImpl = cryptoSuite->hashImpl();
+    auto signatureImpl = cryptoSuite->signatureImpl();
+    auto blockHeaderFactory = createBlockFactory(cryptoSuite)->blockHeaderFactory();
+    auto header = blockHeaderFactory->createBlockHeader();
+    header->setNumber(10);
+    std::vector<KeyPairInterface::Ptr> keyPairs;
+    header->setSealerList(fakeSealerList(keyPairs, signatureImpl, 4));
+    header->setSignatureList(fakeSignatureList(signatureImpl, keyPairs, header->hash()));
+    bytes encodedHeader;
+    header->encode(encodedHeader);
+
+    bytes chunk;
+    encodeSnapshotRow(chunk, ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER, "10");
+    encodeSnapshotRow(chunk, ledger::SYS_NUMBER_2_BLOCK_HEADER, "10",
+        std::string_view((char const*)encodedHeader.data(), encodedHeader.size()));
+    SnapshotManifest manifest;
+    manifest.number = 10;
+    manifest.blockHash = header->hash();
+    manifest.chunkHashes = {hashImpl->hash(ref(chunk))};
+    manifest.digest =
+        snapshotDigest(hashImpl, manifest.number, manifest.blockHash, manifest.chunkHashes);
+
+    // only two of the four trusted sealers have signed the header, the others are unknown
+    consensus::ConsensusNodeList sealers;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        auto nodeID =
+            i < 2 ? keyPairs[i]->publicKey() : signatureImpl->generateKeyPair()->publicKey();
+        sealers.push_back(std::make_shared<consensus::ConsensusNode>(nodeID));
+    }
+    auto storage = std::make_shared<FakeStorage>();
+    StateSnapshotImporter importer(storage, hashImpl, blockHeaderFactory, 1, 1000);
+    importer.setTrustedSealers(sealers);
+    importer.onManifest(fakePeer(1), manifest);
+    BOOST_REQUIRE_EQUAL(importer.schedule(1, 0).size(), 1);
+    auto error = importer.onChunk(fakePeer(1), 10, ref(chunk));
+    BOOST_REQUIRE(error);
+    BOOST_CHECK_EQUAL(error->errorCode(), protocol::CommonError::InvalidSnapshot);
+    BOOST_CHECK(!importer.imported());
+    BOOST_CHECK(!storage->row(ledger::SYS_CURRENT_STATE, ledger::SYS_KEY_CURRENT_NUMBER));
+
+    // the same header is accepted once all its sealers are trusted
+    sealers.resize(2);
+    for (size_t i = 2; i < 4; ++i)
+    {
+        sealers.push_back(std::make_shared<consensus::ConsensusNode>(keyPairs[i]->publicKey()));
+    }
+    importer.setTrustedSealers(sealers);
+    importer.onManifest(fakePeer(2), manifest);
+    BOOST_REQUIRE_EQUAL(importer.schedule(1, 0).size(), 1);
+    BOOST_CHECK(!importer.onChunk(fakePeer(2), 10, ref(chunk)));
+    BOOST_CHECK(importer.imported());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
@@ -54,6 +54,9 @@ public:
     void executeWorker() override { BlockSync::executeWorker(); }
     void maintainPeersConnection() override { BlockSync::maintainPeersConnection(); }
     SyncPeerStatus::Ptr syncStatus() { return m_syncStatus; }
+    DownloadingQueue::Ptr downloadingQueue() { return m_downloadingQueue; }
+    using BlockSync::fetchAndSendBlocks;
+    using BlockSync::sendBlocks;
 };
 
 class FakeTxPoolForSync : public FakeTxPool
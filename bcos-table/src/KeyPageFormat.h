@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the flat binary format of the pages and table metas of KeyPageStorage
+ * @file KeyPageFormat.h
+ *
+ * page:  magic(4) | count(4) | offset(4) * count | (keyLen(4) | key | valueLen(4) | value) * count
+ * meta:  magic(4) | count(4) | (keyLen(4) | pageKey | count(2) | size(2)) * count
+ *
+ * the records of a page are sorted by key, a key is found by binary search over the offsets
+ * without decoding the other records. All integers are little endian. The first 4 bytes of the
+ * boost archive format is the entry or page count, which never reaches the magic number, so the
+ * two formats can be told apart when reading an existing database.
+ */
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bcos::storage
+{
+constexpr static std::array<char, 4> FLAT_PAGE_MAGIC{'\xff', 'K', 'P', '\x01'};
+constexpr static std::array<char, 4> FLAT_META_MAGIC{'\xff', 'K', 'M', '\x01'};
+constexpr static size_t FLAT_MAGIC_SIZE = 4;
+constexpr static size_t FLAT_HEADER_SIZE = 8;
+
+inline void appendUint32(std::string& out, uint32_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+inline void appendUint16(std::string& out, uint16_t value)
+{
+    out.push_back(static_cast<char>(value & 0xff));
+    out.push_back(static_cast<char>((value >> 8) & 0xff));
+}
+
+inline void writeUint32(char* out, uint32_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        out[i] = static_cast<char>((value >> (i * 8)) & 0xff);
+    }
+}
+
+inline uint32_t readUint32(const char* in)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << (i * 8);
+    }
+    return value;
+}
+
+inline uint16_t readUint16(const char* in)
+{
+    return static_cast<uint16_t>(
+        static_cast<uint8_t>(in[0]) | (static_cast<uint16_t>(static_cast<uint8_t>(in[1])) << 8));
+}
+
+inline bool hasMagic(std::string_view value, const std::array<char, 4>& magic)
+{
+    return value.size() >= FLAT_HEADER_SIZE &&
+           std::memcmp(value.data(), magic.data(), magic.size()) == 0;
+}
+
+// writes a flat page, the records must be added in ascending order of key
+class FlatPageWriter
+{
+public:
+    explicit FlatPageWriter(uint32_t count, size_t payloadSize = 0) : m_count(count)
+    {
+        m_buffer.reserve(FLAT_HEADER_SIZE + count * sizeof(uint32_t) * 3 + payloadSize);
+        m_buffer.append(FLAT_PAGE_MAGIC.data(), FLAT_PAGE_MAGIC.size());
+        appendUint32(m_buffer, count);
+        m_buffer.resize(FLAT_HEADER_SIZE + count * sizeof(uint32_t));
+    }
+
+    void add(std::string_view key, std::string_view value)
+    {
+        writeUint32(m_buffer.data() + FLAT_HEADER_SIZE + m_index * sizeof(uint32_t),
+            static_cast<uint32_t>(m_buffer.size()));
+        ++m_index;
+        appendUint32(m_buffer, static_cast<uint32_t>(key.size()));
+        m_buffer.append(key);
+        appendUint32(m_buffer, static_cast<uint32_t>(value.size()));
+        m_buffer.append(value);
+    }
+
+    std::string finish()
+    {
+        assert(m_index == m_count);
+        return std::move(m_buffer);
+    }
+
+private:
+    std::string m_buffer;
+    uint32_t m_count = 0;
+    uint32_t m_index = 0;
+};
+
+// a read only view of an encoded flat page, the encoded bytes must outlive the view
+class FlatPageView
+{
+public:
+    FlatPageView() = default;
+    explicit FlatPageView(std::string_view encoded) : m_encoded(encoded)
+    {
+        m_count = readUint32(m_encoded.data() + FLAT_MAGIC_SIZE);
+    }
+
+    uint32_t count() const { return m_count; }
+    // the size of all keys and values
+    size_t payloadSize() const
+    {
+        return m_encoded.size() - FLAT_HEADER_SIZE - m_count * sizeof(uint32_t) * 3;
+    }
+
+    std::string_view key(uint32_t index) const
+    {
+        auto record = m_encoded.data() + offset(index);
+        return std::string_view(record + sizeof(uint32_t), readUint32(record));
+    }
+
+    std::string_view value(uint32_t index) const
+    {
+        auto record = m_encoded.data() + offset(index);
+        auto keySize = readUint32(record);
+        record += sizeof(uint32_t) + keySize;
+        return std::string_view(record + sizeof(uint32_t), readUint32(record));
+    }
+
+    std::optional<std::string_view> find(std::string_view key) const
+    {
+        uint32_t low = 0;
+        uint32_t high = m_count;
+        while (low < high)
+        {
+            auto mid = low + (high - low) / 2;
+            auto midKey = this->key(mid);
+            if (midKey < key)
+            {
+                low = mid + 1;
+            }
+            else if (key < midKey)
+            {
+                high = mid;
+            }
+            else
+            {
+                return value(mid);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // the encoded bytes are not checked when reading, check them once before use
+    static bool valid(std::string_view encoded)
+    {
+        if (!hasMagic(encoded, FLAT_PAGE_MAGIC))
+        {
+            return false;
+        }
+        auto count = readUint32(encoded.data() + FLAT_MAGIC_SIZE);
+        if ((encoded.size() - FLAT_HEADER_SIZE) / sizeof(uint32_t) < count)
+        {
+            return false;
+        }
+        size_t expected = FLAT_HEADER_SIZE + count * sizeof(uint32_t);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (readUint32(encoded.data() + FLAT_HEADER_SIZE + i * sizeof(uint32_t)) != expected)
+            {
+                return false;
+            }
+            for (size_t field = 0; field < 2; ++field)
+            {
+                if (encoded.size() - expected < sizeof(uint32_t))
+                {
+                    return false;
+                }
+                auto size = readUint32(encoded.data() + expected);
+                expected += sizeof(uint32_t);
+                if (encoded.size() - expected < size)
+                {
+                    return false;
+                }
+                expected += size;
+            }
+        }
+        return expected == encoded.size();
+    }
+
+private:
+    uint32_t offset(uint32_t index) const
+    {
+        return readUint32(m_encoded.data() + FLAT_HEADER_SIZE + index * sizeof(uint32_t));
+    }
+
+    std::string_view m_encoded;
+    uint32_t m_count = 0;
+};
+}  // namespace bcos::storage
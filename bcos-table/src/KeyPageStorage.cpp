@@ -250,7 +250,7 @@ void KeyPageStorage::parallelTraverse(bool onlyDirty,
                     auto meta = &std::get<1>(it.second->data);
                     auto readLock = meta->rLock();
                     Entry entry;
-                    entry.setObject(*meta);
+                    entry.set(meta->encode());
                     readLock.unlock();
                     if (!m_readOnly)
                     {
@@ -291,7 +291,7 @@ void KeyPageStorage::parallelTraverse(bool onlyDirty,
                     }
                     else
                     {
-                        entry.setObject(*page);
+                        entry.set(page->encode());
                         entry.setStatus(it.second->entry.status());
                         if (!m_readOnly)
                         {
@@ -342,57 +342,102 @@ void KeyPageStorage::parallelTraverse(bool onlyDirty,
     }
 }
 
+void KeyPageStorage::invalidateCache() const
+{
+    if (!m_cache)
+    {
+        return;
+    }
+    m_cache->increaseVersion();
+    for (auto& bucket : m_buckets)
+    {
+        for (auto& it : bucket.container)
+        {
+            if (!it.second->entry.dirty())
+            {
+                continue;
+            }
+            m_cache->erase(it.first);
+            if (it.second->type == Data::Type::Page)
+            {  // the old page keys are deleted from the storage
+                auto page = &std::get<0>(it.second->data);
+                for (auto& key : page->invalidKeySet())
+                {
+                    m_cache->erase(DataCacheKey(it.first.first, key));
+                }
+            }
+        }
+    }
+}
+
 crypto::HashType KeyPageStorage::hash(const bcos::crypto::Hash::Ptr& hashImpl) const
 {
-    bcos::crypto::HashType pagesHash(0);
-    bcos::crypto::HashType entriesHash(0);
-    int64_t pageCount = 0;
-    int64_t entrycount = 0;
+    auto hashes = tableHashes(hashImpl);
+    bcos::crypto::HashType totalHash(0);
+    for (auto& it : hashes)
+    {
+        totalHash ^= it.second;
+    }
+    KeyPage_LOG(INFO) << LOG_DESC("hash") << LOG_KV("readLength", m_readLength)
+                      << LOG_KV("writeLength", m_writeLength)
+                      << LOG_KV("tableCount", hashes.size())
+                      << LOG_KV("totalHash", totalHash.hex());
+    return totalHash;
+}
+
+std::map<std::string, crypto::HashType, std::less<>> KeyPageStorage::tableHashes(
+    const bcos::crypto::Hash::Ptr& hashImpl) const
+{
     std::vector<const Data*> allData;
     for (size_t i = 0; i < m_buckets.size(); ++i)
     {
         auto& bucket = m_buckets[i];
         for (auto& it : bucket.container)
         {
-            allData.push_back(it.second.get());
+            if (it.second->entry.dirty() && it.second->type != Data::Type::TableMeta)
+            {
+                allData.push_back(it.second.get());
+            }
         }
     }
+    std::vector<TableHash> dataHashes(allData.size());
 #pragma omp parallel for
     for (size_t i = 0; i < allData.size(); ++i)
     {
         auto data = allData[i];
-        auto& entry = data->entry;
-        if (entry.dirty() && data->type != Data::Type::TableMeta)
+        if (data->type == Data::Type::Page)
         {
-            if (data->type == Data::Type::Page)
-            {
-                auto page = &std::get<0>(data->data);
-                auto pageHash = page->hash(data->table, hashImpl);
-#pragma omp critical
-                pagesHash ^= pageHash;
-                ++pageCount;
-            }
-            else
-            {  // sys table
-                auto hash = hashImpl->hash(data->table);
-                hash ^= hashImpl->hash(data->key);
-                hash ^= entry.hash(data->table, data->key, hashImpl);
-#pragma omp critical
-                entriesHash ^= hash;
-                ++entrycount;
-            }
+            auto page = &std::get<0>(data->data);
+            page->hash(dataHashes[i], data->table, hashImpl);
+        }
+        else
+        {  // sys table
+            dataHashes[i].add(data->table, data->key, data->entry, hashImpl);
         }
     }
-    bcos::crypto::HashType totalHash(0);
-    totalHash ^= pagesHash;
-    totalHash ^= entriesHash;
-    KeyPage_LOG(INFO) << LOG_DESC("hash") << LOG_KV("size", allData.size())
-                      << LOG_KV("readLength", m_readLength) << LOG_KV("writeLength", m_writeLength)
-                      << LOG_KV("pageCount", pageCount) << LOG_KV("entrycount", entrycount)
-                      << LOG_KV("entriesHash", entriesHash.hex())
-                      << LOG_KV("pagesHash", pagesHash.hex())
-                      << LOG_KV("totalHash", totalHash.hex());
-    return totalHash;
+    int64_t pageCount = 0;
+    int64_t entryCount = 0;
+    std::map<std::string_view, TableHash> allTableHashes;
+    for (size_t i = 0; i < allData.size(); ++i)
+    {
+        if (allData[i]->type == Data::Type::Page)
+        {
+            ++pageCount;
+        }
+        entryCount += dataHashes[i].count();
+        allTableHashes[allData[i]->table].merge(dataHashes[i]);
+    }
+    std::map<std::string, crypto::HashType, std::less<>> hashes;
+    for (auto& it : allTableHashes)
+    {
+        auto table = std::string(it.first);
+        auto hash = it.second.hash(table, hashImpl);
+        hashes.emplace(std::move(table), hash);
+    }
+    KeyPage_LOG(DEBUG) << LOG_DESC("tableHashes") << LOG_KV("size", allData.size())
+                       << LOG_KV("pageCount", pageCount) << LOG_KV("entryCount", entryCount)
+                       << LOG_KV("tableCount", hashes.size());
+    return hashes;
 }
 
 void KeyPageStorage::rollback(const Recoder& recoder)
@@ -591,6 +636,17 @@ std::tuple<Error::UniquePtr, std::optional<KeyPageStorage::Data*>> KeyPageStorag
         }
         else
         {
+            if (m_cache)
+            {
+                auto cached = m_cache->get(DataCacheKey(tableView, key));
+                if (cached)
+                {
+                    d = std::make_shared<Data>(**cached);
+                    d->entry.setStatus(Entry::Status::NORMAL);
+                    break;
+                }
+            }
+            auto cacheVersion = m_cache ? m_cache->version() : 0;
             auto [error, entry] = getRawEntryFromStorage(tableView, key);
             if (error)
             {
@@ -608,8 +664,16 @@ std::tuple<Error::UniquePtr, std::optional<KeyPageStorage::Data*>> KeyPageStorag
             if (entry)
             {
                 entry->setStatus(Entry::Status::NORMAL);
+                auto size = entry->size();
                 d = std::make_shared<Data>(std::string(tableView), std::string(key),
                     std::move(*entry), key.empty() ? Data::Type::TableMeta : Data::Type::Page);
+                if (m_cache)
+                {  // the cached data only keeps the decoded page or meta
+                    auto cached = std::make_shared<Data>(*d);
+                    cached->entry = Entry();
+                    m_cache->insert(DataCacheKey(tableView, key), std::move(cached),
+                        size + tableView.size() + key.size(), cacheVersion);
+                }
                 break;
             }
         }
@@ -675,7 +739,7 @@ std::pair<Error::UniquePtr, std::optional<Entry>> KeyPageStorage::getEntryFromPa
             if (data.value()->entry.dirty())
             {
                 Entry entry;
-                entry.setObject(*meta);
+                entry.set(meta->encode());
                 entry.setStatus(data.value()->entry.status());
                 return std::make_pair(nullptr, std::move(entry));
             }
@@ -750,7 +814,7 @@ std::pair<Error::UniquePtr, std::optional<Entry>> KeyPageStorage::getEntryFromPa
                         << LOG_KV("dirty", data.value()->entry.dirty());
                 }
                 Entry entry;
-                entry.setObject(*page);
+                entry.set(page->encode());
                 entry.setStatus(pageData->entry.status());
                 return std::make_pair(nullptr, std::move(entry));
             }
@@ -1003,4 +1067,28 @@ Entry KeyPageStorage::importExistingEntry(std::string_view table, std::string_vi
 
     return it->second->entry;
 }
+
+std::optional<std::string> KeyPageStorage::toFlatValue(
+    std::string_view key, std::string_view value)
+{
+    if (value.empty())
+    {
+        return std::nullopt;
+    }
+    if (key == TABLE_META_KEY)
+    {
+        if (hasMagic(value, FLAT_META_MAGIC))
+        {
+            return std::nullopt;
+        }
+        return TableMeta(value).encode();
+    }
+    if (FlatPageView::valid(value))
+    {
+        return std::nullopt;
+    }
+    Entry entry;
+    entry.set(std::string(value));
+    return Page(entry, key).encode();
+}
 }  // namespace bcos::storage
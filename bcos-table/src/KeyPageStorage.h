@@ -20,10 +20,13 @@
  */
 #pragma once
 
+#include "KeyPageFormat.h"
 #include "StateStorageInterface.h"
+#include <bcos-utilities/LRUCache.h>
 #include <boost/archive/basic_archive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/container_hash/hash.hpp>
 #include <boost/core/ignore_unused.hpp>
 #include <boost/format.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
@@ -88,17 +91,23 @@ class KeyPageStorage : public virtual storage::StateStorageInterface
 {
 public:
     using Ptr = std::shared_ptr<KeyPageStorage>;
+    struct Data;
+    // the decoded pages and table metas of the committed state, shared by all storages of blocks
+    using DataCacheKey = std::pair<std::string, std::string>;
+    using DataCache =
+        LRUCache<DataCacheKey, std::shared_ptr<const Data>, boost::hash<DataCacheKey>>;
 
     explicit KeyPageStorage(std::shared_ptr<StorageInterface> _prev, size_t _pageSize = 1024,
         std::shared_ptr<const std::set<std::string, std::less<>>> _ignoreTables = nullptr,
-        bool _ignoreNotExist = false)
+        bool _ignoreNotExist = false, std::shared_ptr<DataCache> _cache = nullptr)
       : storage::StateStorageInterface(_prev),
         m_pageSize(_pageSize > MIN_PAGE_SIZE ? _pageSize : MIN_PAGE_SIZE),
         m_splitSize(m_pageSize / 3 * 2),
         m_mergeSize(m_pageSize / 4),
         m_buckets(std::thread::hardware_concurrency()),
         m_ignoreTables(_ignoreTables),
-        m_ignoreNotExist(_ignoreNotExist)
+        m_ignoreNotExist(_ignoreNotExist),
+        m_cache(std::move(_cache))
     {
         if (!m_ignoreTables.get())
         {
@@ -146,9 +155,18 @@ public:
 
     crypto::HashType hash(const bcos::crypto::Hash::Ptr& hashImpl) const override;
 
+    std::map<std::string, crypto::HashType, std::less<>> tableHashes(
+        const bcos::crypto::Hash::Ptr& hashImpl) const override;
+
     void rollback(const Recoder& recoder) override;
 
-    struct Data;
+    // invalidate the cached data modified by this storage, call it after this storage is committed
+    void invalidateCache() const;
+
+    // converts a page or a table meta of a key page table from the boost format to the flat format,
+    // nullopt if it is in the flat format already; the same rows are then encoded the same
+    static std::optional<std::string> toFlatValue(std::string_view key, std::string_view value);
+
     class PageInfo
     {  // all methods is not thread safe
     public:
@@ -239,6 +257,11 @@ public:
             {
                 return;
             }
+            if (hasMagic(value, FLAT_META_MAGIC) && decodeFlat(value))
+            {
+                return;
+            }
+            // the meta written before the flat format
             boost::iostreams::stream<boost::iostreams::array_source> inputStream(
                 value.data(), value.size());
             boost::archive::binary_iarchive archive(inputStream, ARCHIVE_FLAG);
@@ -461,10 +484,82 @@ public:
             os << "]";
             return os;
         }
+        // encode to the flat format and remove the empty pages, the caller should hold the lock
+        std::string encode() const
+        {
+            int invalid = 0;
+            m_rows = 0;
+            size_t keysSize = 0;
+            for (auto it = pages->begin(); it != pages->end();)
+            {
+                if (it->getCount() == 0 || it->getPageKey().empty())
+                {
+                    KeyPage_LOG(DEBUG)
+                        << LOG_DESC("TableMeta empty page")
+                        << LOG_KV("pageKey", toHex(it->getPageKey()))
+                        << LOG_KV("count", it->getCount()) << LOG_KV("size", it->getSize());
+                    it = pages->erase(it);
+                    ++invalid;
+                }
+                else
+                {
+                    m_rows += it->getCount();
+                    keysSize += it->getPageKey().size();
+                    ++it;
+                }
+            }
+            std::string value;
+            value.reserve(FLAT_HEADER_SIZE + pages->size() * 8 + keysSize);
+            value.append(FLAT_META_MAGIC.data(), FLAT_META_MAGIC.size());
+            appendUint32(value, static_cast<uint32_t>(pages->size()));
+            for (auto& pageInfo : *pages)
+            {
+                auto pageKey = pageInfo.getPageKey();
+                appendUint32(value, static_cast<uint32_t>(pageKey.size()));
+                value.append(pageKey);
+                appendUint16(value, pageInfo.getCount());
+                appendUint16(value, pageInfo.getSize());
+            }
+            KeyPage_LOG(DEBUG) << LOG_DESC("Encode meta") << LOG_KV("valid", pages->size())
+                               << LOG_KV("invalid", invalid);
+            return value;
+        }
         double hitRate() { return hit / (double)getPageInfoCount; }
         uint64_t rowCount() { return m_rows; }
 
     private:
+        bool decodeFlat(std::string_view value)
+        {
+            auto count = readUint32(value.data() + FLAT_MAGIC_SIZE);
+            auto decoded = std::make_unique<std::vector<PageInfo>>();
+            decoded->reserve(std::min<size_t>(count, value.size() / 8));
+            size_t offset = FLAT_HEADER_SIZE;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (value.size() - offset < sizeof(uint32_t))
+                {
+                    return false;
+                }
+                auto keySize = readUint32(value.data() + offset);
+                offset += sizeof(uint32_t);
+                if (value.size() - offset < keySize + sizeof(uint16_t) * 2)
+                {
+                    return false;
+                }
+                std::string pageKey(value.data() + offset, keySize);
+                offset += keySize;
+                auto pageCount = readUint16(value.data() + offset);
+                auto pageSize = readUint16(value.data() + offset + sizeof(uint16_t));
+                offset += sizeof(uint16_t) * 2;
+                decoded->emplace_back(std::move(pageKey), pageCount, pageSize, nullptr);
+            }
+            if (offset != value.size())
+            {
+                return false;
+            }
+            pages = std::move(decoded);
+            return true;
+        }
         uint32_t getPageInfoCount = 0;
         uint32_t hit = 0;
         mutable uint64_t m_rows = 0;
@@ -530,29 +625,48 @@ public:
     {
         Page() : m_size(0) {}
         ~Page() = default;
-        Page(const std::string_view& value, const std::string_view& pageKey)
+        // a flat encoded page is kept encoded and read by binary search, the entries are only
+        // decoded when the page is modified
+        Page(const Entry& value, const std::string_view& pageKey)
         {
-            if (value.empty())
+            auto view = value.get();
+            if (view.empty())
             {
                 return;
             }
-            boost::iostreams::stream<boost::iostreams::array_source> inputStream(
-                value.data(), value.size());
-            boost::archive::binary_iarchive archive(inputStream, ARCHIVE_FLAG);
-            archive >> *this;
-            if (pageKey != entries.rbegin()->first)
+            if (FlatPageView::valid(view))
+            {
+                // the page is cached, the value pinned by the backend is copied
+                auto encoded = std::make_shared<Entry>(value);
+                encoded->unpin();
+                m_encoded = std::move(encoded);
+                m_view = FlatPageView(m_encoded->get());
+                m_validCount = m_view.count();
+                m_size = m_view.payloadSize();
+            }
+            else
+            {  // the page written before the flat format, it is rewritten when modified
+                boost::iostreams::stream<boost::iostreams::array_source> inputStream(
+                    view.data(), view.size());
+                boost::archive::binary_iarchive archive(inputStream, ARCHIVE_FLAG);
+                archive >> *this;
+            }
+            auto validPageKey = endKeyNoLock();
+            if (pageKey != validPageKey)
             {
                 KeyPage_LOG(INFO) << LOG_DESC("load page with invalid pageKey")
                                   << LOG_KV("pageKey", toHex(pageKey))
-                                  << LOG_KV("validPageKey", toHex(entries.rbegin()->first))
+                                  << LOG_KV("validPageKey", toHex(validPageKey))
                                   << LOG_KV("valid", m_validCount)
-                                  << LOG_KV("count", entries.size());
+                                  << LOG_KV("count", countNoLock());
                 m_invalidPageKeys.insert(std::string(pageKey));
             }
         }
         Page(const Page& p)
         {
             entries = p.entries;
+            m_encoded = p.m_encoded;
+            m_view = p.m_view;
             m_size = p.m_size;
             m_validCount = p.m_validCount;
             m_invalidPageKeys = p.m_invalidPageKeys;
@@ -562,6 +676,8 @@ public:
             if (this != &p)
             {
                 entries = p.entries;
+                m_encoded = p.m_encoded;
+                m_view = p.m_view;
                 m_size = p.m_size;
                 m_validCount = p.m_validCount;
                 m_invalidPageKeys = p.m_invalidPageKeys;
@@ -571,6 +687,8 @@ public:
         Page(Page&& p)
         {
             entries = std::move(p.entries);
+            m_encoded = std::move(p.m_encoded);
+            m_view = p.m_view;
             m_size = p.m_size;
             m_validCount = p.m_validCount;
             m_invalidPageKeys = std::move(p.m_invalidPageKeys);
@@ -580,6 +698,8 @@ public:
             if (this != &p)
             {
                 entries = std::move(p.entries);
+                m_encoded = std::move(p.m_encoded);
+                m_view = p.m_view;
                 m_size = p.m_size;
                 m_validCount = p.m_validCount;
                 m_invalidPageKeys = std::move(p.m_invalidPageKeys);
@@ -590,6 +710,28 @@ public:
         std::optional<Entry> getEntry(std::string_view key)
         {
             std::shared_lock lock(mutex);
+            if (m_encoded)
+            {
+                auto value = m_view.find(key);
+                if (!value)
+                {
+                    return std::nullopt;
+                }
+                Entry entry;
+                if (value->size() <= (size_t)Entry::MEDIUM_SIZE)
+                {
+                    entry.set(std::string(*value));
+                }
+                else
+                {  // refer to the encoded page without copy
+                    auto pinned = std::make_shared<std::pair<std::shared_ptr<const Entry>,
+                        std::string_view>>(m_encoded, *value);
+                    entry.setPinned(
+                        std::shared_ptr<const std::string_view>(pinned, &pinned->second));
+                }
+                entry.setStatus(Entry::Status::NORMAL);
+                return entry;
+            }
             auto it = entries.find(key);
             if (it != entries.end())
             {
@@ -627,6 +769,7 @@ public:
         getEntries()
         {
             std::unique_lock lock(mutex);
+            decodeNoLock();
             return std::make_pair(std::ref(entries), std::move(lock));
         }
         inline std::tuple<std::optional<Entry>, bool> setEntry(
@@ -636,6 +779,7 @@ public:
             bool pageInfoChanged = false;
             std::optional<Entry> ret;
             std::unique_lock lock(mutex);
+            decodeNoLock();
             auto it = entries.lower_bound(key);
             m_size += entry.size();
             if (it != entries.end() && it->first == key)
@@ -722,7 +866,7 @@ public:
         size_t count() const
         {
             std::shared_lock lock(mutex);
-            return entries.size();
+            return countNoLock();
         }
         const std::set<std::string>& invalidKeySet() const
         {
@@ -733,6 +877,10 @@ public:
         std::string startKey() const
         {
             std::shared_lock lock(mutex);
+            if (m_encoded)
+            {
+                return m_view.count() > 0 ? std::string(m_view.key(0)) : "";
+            }
             if (entries.empty())
             {
                 return "";
@@ -742,16 +890,13 @@ public:
         std::string endKey() const
         {
             std::shared_lock lock(mutex);
-            if (entries.empty())
-            {
-                return "";
-            }
-            return entries.rbegin()->first;
+            return endKeyNoLock();
         }
         auto split(size_t threshold)
         {
             auto page = Page();
             std::unique_lock lock(mutex);
+            decodeNoLock();
             // split this page to two pages
             auto iter = entries.begin();
             while (iter != entries.end())
@@ -801,6 +946,8 @@ public:
             if (this != &p)
             {
                 std::unique_lock lock(mutex);
+                decodeNoLock();
+                p.decodeNoLock();
                 for (auto iter = p.entries.begin(); iter != p.entries.end();)
                 {
                     m_size += iter->second.size();
@@ -829,6 +976,7 @@ public:
         void clean(const std::string_view& pageKey)
         {
             std::unique_lock lock(mutex);
+            decodeNoLock();
             for (auto iter = entries.begin(); iter != entries.end();)
             {
                 if (iter->second.status() != Entry::Status::DELETED)
@@ -857,34 +1005,23 @@ public:
                     << LOG_KV("count", entries.size());
             }
         }
-        crypto::HashType hash(
-            const std::string& table, const bcos::crypto::Hash::Ptr& hashImpl) const
+        void hash(TableHash& tableHash, const std::string& table,
+            const bcos::crypto::Hash::Ptr& hashImpl) const
         {
-            bcos::crypto::HashType pageHash(0);
-            auto hash = hashImpl->hash(table);
             // std::shared_lock lock(mutex);
             for (auto iter = entries.cbegin(); iter != entries.cend(); ++iter)
             {
                 if (iter->second.dirty())
                 {
-                    auto entryHash = hash ^ hashImpl->hash(iter->first) ^
-                                     iter->second.hash(table, iter->first, hashImpl);
-                    // if (c_fileLogLevel >= TRACE)
-                    // {
-                    //     KeyPage_LOG(TRACE)
-                    //         << "Storage hash: " << LOG_KV("table", table)
-                    //         << LOG_KV("key", toHex(iter->first)) << LOG_KV("hash",
-                    //         entryHash.hex());
-                    // }
-                    pageHash ^= entryHash;
+                    tableHash.add(table, iter->first, iter->second, hashImpl);
                 }
             }
-            return pageHash;
         }
 
         void rollback(const Recoder::Change& change)
         {
             std::unique_lock lock(mutex);
+            decodeNoLock();
             auto it = entries.find(change.key);
             if (change.entry)
             {
@@ -959,13 +1096,74 @@ public:
                 }
             }
         }
+        // encode the valid entries to the flat format, the caller should hold the lock
+        std::string encode() const
+        {
+            if (m_encoded)
+            {
+                return std::string(m_encoded->get());
+            }
+            size_t payloadSize = 0;
+            for (auto& i : entries)
+            {
+                if (i.second.status() != Entry::Status::DELETED)
+                {
+                    payloadSize += i.first.size() + i.second.size();
+                }
+            }
+            FlatPageWriter writer(m_validCount, payloadSize);
+            for (auto& i : entries)
+            {
+                if (i.second.status() == Entry::Status::DELETED)
+                {  // skip deleted entry
+                    continue;
+                }
+                writer.add(i.first, i.second.get());
+            }
+            return writer.finish();
+        }
         std::unique_lock<std::shared_mutex> lock() { return std::unique_lock(mutex); }
         std::shared_lock<std::shared_mutex> rLock() { return std::shared_lock(mutex); }
 
     private:
+        std::string endKeyNoLock() const
+        {
+            if (m_encoded)
+            {
+                return m_view.count() > 0 ? std::string(m_view.key(m_view.count() - 1)) : "";
+            }
+            if (entries.empty())
+            {
+                return "";
+            }
+            return entries.rbegin()->first;
+        }
+        size_t countNoLock() const { return m_encoded ? m_view.count() : entries.size(); }
+        // decode all entries of the flat encoded page before modifying it
+        void decodeNoLock()
+        {
+            if (!m_encoded)
+            {
+                return;
+            }
+            auto iter = entries.begin();
+            for (uint32_t i = 0; i < m_view.count(); ++i)
+            {
+                Entry e;
+                e.set(std::string(m_view.value(i)));
+                e.setStatus(Entry::Status::NORMAL);
+                iter = entries.emplace_hint(iter, std::string(m_view.key(i)), std::move(e));
+            }
+            m_view = FlatPageView();
+            m_encoded.reset();
+        }
+
         //   PageInfo* pageInfo;
         mutable std::shared_mutex mutex;
         std::map<std::string, Entry, std::less<>> entries;
+        // the encoded flat page and a view of it, valid until the entries are decoded
+        std::shared_ptr<const Entry> m_encoded;
+        FlatPageView m_view;
         uint32_t m_size = 0;        // page real size
         uint32_t m_validCount = 0;  // valid entry count
         friend class boost::serialization::access;
@@ -1044,7 +1242,7 @@ public:
             }
             else if (type == Type::Page)
             {
-                auto page = KeyPageStorage::Page(entry.get(), key);
+                auto page = KeyPageStorage::Page(entry, key);
                 if (c_fileLogLevel >= TRACE)
                 {
                     KeyPage_LOG(TRACE)
@@ -1109,6 +1307,15 @@ public:
         {
             return prevKeyPage->copyData(table, key);
         }
+        if (m_cache)
+        {
+            auto cached = m_cache->get(DataCacheKey(table, key));
+            if (cached)
+            {
+                return std::make_optional(std::make_shared<Data>(**cached));
+            }
+        }
+        auto cacheVersion = m_cache ? m_cache->version() : 0;
         auto [error, entry] = getRawEntryFromStorage(table, key);
         if (error)
         {
@@ -1126,8 +1333,17 @@ public:
         if (entry)
         {
             entry->setStatus(Entry::Status::NORMAL);
-            return std::make_optional(std::make_shared<Data>(std::string(table), std::string(key),
-                std::move(*entry), key.empty() ? Data::Type::TableMeta : Data::Type::Page));
+            auto size = entry->size();
+            auto data = std::make_shared<Data>(std::string(table), std::string(key),
+                std::move(*entry), key.empty() ? Data::Type::TableMeta : Data::Type::Page);
+            if (m_cache)
+            {
+                auto cached = std::make_shared<Data>(*data);
+                cached->entry = Entry();
+                m_cache->insert(DataCacheKey(table, key), std::move(cached),
+                    size + table.size() + key.size(), cacheVersion);
+            }
+            return std::make_optional(std::move(data));
         }
         return std::nullopt;
     }
@@ -1244,6 +1460,7 @@ private:
     std::vector<Bucket> m_buckets;
     std::shared_ptr<const std::set<std::string, std::less<>>> m_ignoreTables;
     bool m_ignoreNotExist = false;
+    std::shared_ptr<DataCache> m_cache;
 };
 
 }  // namespace bcos::storage
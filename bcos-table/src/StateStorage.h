@@ -447,28 +447,57 @@ public:
     crypto::HashType hash(const bcos::crypto::Hash::Ptr& hashImpl) const override
     {
         bcos::crypto::HashType totalHash(0);
+        for (auto& it : tableHashes(hashImpl))
+        {
+            totalHash ^= it.second;
+        }
+
+        return totalHash;
+    }
+
+    std::map<std::string, crypto::HashType, std::less<>> tableHashes(
+        const bcos::crypto::Hash::Ptr& hashImpl) const override
+    {
+        std::vector<std::map<std::string_view, TableHash>> bucketHashes(m_buckets.size());
 
 #pragma omp parallel for
         for (size_t i = 0; i < m_buckets.size(); ++i)
         {
             auto& bucket = m_buckets[i];
-            bcos::crypto::HashType bucketHash(0);
+            auto& bucketHash = bucketHashes[i];
+            std::pair<std::string_view, TableHash*> last;
 
             for (auto& it : bucket.container)
             {
                 auto& entry = it.entry;
                 if (entry.dirty())
                 {
-                    auto entryHash = hashImpl->hash(it.table) ^ hashImpl->hash(it.key) ^
-                                     entry.hash(it.table, it.key, hashImpl);
-                    bucketHash ^= entryHash;
+                    if (last.second == nullptr || last.first != it.table)
+                    {
+                        last = std::make_pair(
+                            std::string_view(it.table), &bucketHash[std::string_view(it.table)]);
+                    }
+                    last.second->add(it.table, it.key, entry, hashImpl);
                 }
             }
-#pragma omp critical
-            totalHash ^= bucketHash;
         }
 
-        return totalHash;
+        std::map<std::string_view, TableHash> allTableHashes;
+        for (auto& bucketHash : bucketHashes)
+        {
+            for (auto& it : bucketHash)
+            {
+                allTableHashes[it.first].merge(it.second);
+            }
+        }
+        std::map<std::string, crypto::HashType, std::less<>> hashes;
+        for (auto& it : allTableHashes)
+        {
+            auto table = std::string(it.first);
+            auto hash = it.second.hash(table, hashImpl);
+            hashes.emplace(std::move(table), hash);
+        }
+        return hashes;
     }
 
 
@@ -564,6 +593,10 @@ private:
 
         // entry.setDirty(false);
         entry.setStatus(Entry::NORMAL);
+        if constexpr (enableLRU)
+        {  // the entries outlive the read, the values pinned by the prev storage are copied
+            entry.unpin();
+        }
 
         auto updateCapacity = entry.size();
 
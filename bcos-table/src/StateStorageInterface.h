@@ -27,6 +27,7 @@
 #include <bcos-utilities/Error.h>
 #include <boost/throw_exception.hpp>
 #include <future>
+#include <map>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
@@ -64,6 +65,34 @@ private:
     std::list<Change> m_changes;
 };
 
+// accumulate the state hash of the dirty entries of a table, the xor of
+// hash(table) ^ hash(key) ^ entry.hash() of each entry. hash(table) cancels out in pairs, so it is
+// only calculated once per table when the number of entries is odd
+class TableHash
+{
+public:
+    void add(const std::string& table, const std::string& key, const Entry& entry,
+        const bcos::crypto::Hash::Ptr& hashImpl)
+    {
+        m_hash ^= hashImpl->hash(key) ^ entry.hash(table, key, hashImpl);
+        ++m_count;
+    }
+    void merge(const TableHash& other)
+    {
+        m_hash ^= other.m_hash;
+        m_count += other.m_count;
+    }
+    crypto::HashType hash(const std::string& table, const bcos::crypto::Hash::Ptr& hashImpl) const
+    {
+        return m_count % 2 == 0 ? m_hash : m_hash ^ hashImpl->hash(table);
+    }
+    size_t count() const { return m_count; }
+
+private:
+    crypto::HashType m_hash{0};
+    size_t m_count = 0;
+};
+
 class StateStorageInterface : public virtual storage::TraverseStorageInterface
 
 {
@@ -102,6 +131,9 @@ public:
     }
 
     virtual crypto::HashType hash(const bcos::crypto::Hash::Ptr& hashImpl) const = 0;
+    // the hash of the dirty entries of each table, hash() is the xor of them
+    virtual std::map<std::string, crypto::HashType, std::less<>> tableHashes(
+        const bcos::crypto::Hash::Ptr& hashImpl) const = 0;
     virtual void setPrev(std::shared_ptr<StorageInterface> prev)
     {
         std::unique_lock<std::shared_mutex> lock(m_prevMutex);
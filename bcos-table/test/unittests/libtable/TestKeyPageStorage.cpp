@@ -2705,6 +2705,259 @@ BOOST_AUTO_TEST_CASE(insertAndDelete)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sharedCache)
+{
+    auto valueFields = "value1";
+    auto pageSize = 512;
+    auto stateStorage0 = make_shared<StateStorage>(nullptr);
+    StateStorageInterface::Ptr prev0 = stateStorage0;
+    auto cache = std::make_shared<KeyPageStorage::DataCache>(16 * 1024 * 1024);
+
+    auto tableName = "table_0";
+    BOOST_REQUIRE(prev0->createTable(tableName, valueFields));
+
+    size_t count = 10;
+    auto keyCount = 100;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto tableStorage0 =
+            std::make_shared<KeyPageStorage>(prev0, pageSize, nullptr, false, cache);
+        auto table0 = tableStorage0->openTable(tableName);
+        BOOST_REQUIRE(table0);
+
+        // the values written by the last block must be read, not the stale cached pages
+        for (int k = 0; k < keyCount; ++k)
+        {
+            auto key = boost::lexical_cast<std::string>(k);
+            auto entry = table0->getRow(key);
+            if (i == 0)
+            {
+                BOOST_REQUIRE(!entry);
+                continue;
+            }
+            BOOST_REQUIRE(entry);
+            BOOST_REQUIRE_EQUAL(entry->getField(0),
+                boost::lexical_cast<std::string>(i - 1) + "_" + boost::lexical_cast<std::string>(k));
+        }
+        // only the even keys are updated, the pages of the odd keys may be reused
+        for (int k = 0; k < keyCount; ++k)
+        {
+            if (i > 0 && k % 2 == 1)
+            {
+                continue;
+            }
+            auto key = boost::lexical_cast<std::string>(k);
+            auto entry = std::make_optional(table0->newEntry());
+            entry->setField(0,
+                boost::lexical_cast<std::string>(i) + "_" + boost::lexical_cast<std::string>(k));
+            BOOST_REQUIRE_NO_THROW(table0->setRow(key, *entry));
+        }
+        if (i > 0)
+        {
+            for (int k = 1; k < keyCount; k += 2)
+            {
+                auto key = boost::lexical_cast<std::string>(k);
+                auto entry = std::make_optional(table0->newEntry());
+                entry->setField(0, boost::lexical_cast<std::string>(i) + "_" +
+                                       boost::lexical_cast<std::string>(k));
+                BOOST_REQUIRE_NO_THROW(table0->setRow(key, *entry));
+            }
+        }
+        tableStorage0->invalidateCache();
+        tableStorage0->setReadOnly(true);
+        stateStorage0->merge(true, *tableStorage0);
+    }
+    BOOST_REQUIRE_GT(cache->misses(), 0);
+    // every page is modified by every block, so the pages are cached again by the reads below
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto tableStorage0 =
+            std::make_shared<KeyPageStorage>(prev0, pageSize, nullptr, false, cache);
+        auto table0 = tableStorage0->openTable(tableName);
+        BOOST_REQUIRE(table0);
+        for (int k = 0; k < keyCount; ++k)
+        {
+            auto key = boost::lexical_cast<std::string>(k);
+            auto entry = table0->getRow(key);
+            BOOST_REQUIRE(entry);
+            BOOST_REQUIRE_EQUAL(entry->getField(0), boost::lexical_cast<std::string>(count - 1) +
+                                                        "_" + boost::lexical_cast<std::string>(k));
+        }
+    }
+    BOOST_REQUIRE_GT(cache->size(), 0);
+    BOOST_REQUIRE_GT(cache->hits(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(flatPageFormat)
+{
+    KeyPageStorage::Page page;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto key = boost::lexical_cast<std::string>(1000 + i);
+        Entry entry;
+        // the large values are referred by the decoded entries without copy
+        entry.set(std::string(i % 2 == 0 ? 8 : 128, 'a' + i % 26));
+        if (i % 10 == 9)
+        {
+            entry.setStatus(Entry::Status::DELETED);
+        }
+        page.setEntry(key, std::move(entry));
+    }
+    // the last key is deleted, so it is not the key of the encoded page
+    std::string pageKey = "1098";
+    Entry encoded;
+    encoded.set(page.encode());
+    BOOST_REQUIRE(FlatPageView::valid(encoded.get()));
+    BOOST_REQUIRE(!FlatPageView::valid(encoded.get().substr(0, encoded.size() - 1)));
+
+    auto checkPage = [&](KeyPageStorage::Page& decoded) {
+        BOOST_REQUIRE_EQUAL(decoded.validCount(), page.validCount());
+        // the size of the valid keys and values
+        BOOST_REQUIRE_EQUAL(decoded.size(), 90 * 4 + 50 * 8 + 40 * 128);
+        BOOST_REQUIRE_EQUAL(decoded.startKey(), page.startKey());
+        for (int i = 0; i < 100; ++i)
+        {
+            auto key = boost::lexical_cast<std::string>(1000 + i);
+            auto entry = decoded.getEntry(key);
+            if (i % 10 == 9)
+            {
+                BOOST_REQUIRE(!entry);
+                continue;
+            }
+            BOOST_REQUIRE(entry);
+            BOOST_REQUIRE_EQUAL(entry->status(), Entry::Status::NORMAL);
+            BOOST_REQUIRE_EQUAL(entry->get(), std::string(i % 2 == 0 ? 8 : 128, 'a' + i % 26));
+        }
+        BOOST_REQUIRE(!decoded.getEntry("0"));
+        BOOST_REQUIRE(!decoded.getEntry("2000"));
+    };
+    // pages are read without decoding the entries
+    KeyPageStorage::Page flat(encoded, pageKey);
+    BOOST_REQUIRE(flat.invalidKeySet().empty());
+    checkPage(flat);
+    BOOST_REQUIRE_EQUAL(flat.encode(), encoded.get());
+    // modifying a page decodes all of its entries
+    Entry entry;
+    entry.set("new");
+    flat.setEntry("1001", std::move(entry));
+    BOOST_REQUIRE_EQUAL(flat.getEntry("1001")->get(), "new");
+    BOOST_REQUIRE_EQUAL(flat.getEntry("1002")->get(), std::string(8, 'c'));
+    BOOST_REQUIRE_EQUAL(flat.count(), 90);
+
+    // the pages written by boost serialization can still be read
+    Entry legacy;
+    KeyPageStorage::Page legacySource(encoded, pageKey);
+    legacySource.getEntries();
+    legacy.setObject(legacySource);
+    BOOST_REQUIRE(!FlatPageView::valid(legacy.get()));
+    KeyPageStorage::Page legacyPage(legacy, pageKey);
+    checkPage(legacyPage);
+    BOOST_REQUIRE_EQUAL(legacyPage.encode(), encoded.get());
+
+    KeyPageStorage::TableMeta meta;
+    meta.insertPageInfoNoLock(KeyPageStorage::PageInfo("100", 10, 1000, nullptr));
+    meta.insertPageInfoNoLock(KeyPageStorage::PageInfo("200", 20, 2000, nullptr));
+    auto checkMeta = [](KeyPageStorage::TableMeta& decoded) {
+        auto& pages = decoded.getAllPageInfoNoLock();
+        BOOST_REQUIRE_EQUAL(pages.size(), 2);
+        BOOST_REQUIRE_EQUAL(pages[1].getPageKey(), "200");
+        BOOST_REQUIRE_EQUAL(pages[1].getCount(), 20);
+        BOOST_REQUIRE_EQUAL(pages[1].getSize(), 2000);
+    };
+    auto metaValue = meta.encode();
+    KeyPageStorage::TableMeta flatMeta(metaValue);
+    checkMeta(flatMeta);
+    Entry legacyMeta;
+    legacyMeta.setObject(meta);
+    KeyPageStorage::TableMeta boostMeta(legacyMeta.get());
+    checkMeta(boostMeta);
+}
+
+BOOST_AUTO_TEST_CASE(toFlatValue)
+{
+    KeyPageStorage::Page page;
+    for (int i = 0; i < 10; ++i)
+    {
+        Entry entry;
+        entry.set(std::string(16, 'a' + i));
+        page.setEntry(boost::lexical_cast<std::string>(1000 + i), std::move(entry));
+    }
+    auto flatPage = page.encode();
+    Entry legacyPage;
+    legacyPage.setObject(page);
+    // the pages and metas written by boost serialization are converted, the flat ones are kept
+    BOOST_REQUIRE_EQUAL(
+        KeyPageStorage::toFlatValue("1009", legacyPage.get()).value_or(""), flatPage);
+    BOOST_REQUIRE(!KeyPageStorage::toFlatValue("1009", flatPage));
+
+    KeyPageStorage::TableMeta meta;
+    meta.insertPageInfoNoLock(KeyPageStorage::PageInfo("1009", 10, 160, nullptr));
+    auto flatMeta = meta.encode();
+    Entry legacyMeta;
+    legacyMeta.setObject(meta);
+    BOOST_REQUIRE_EQUAL(
+        KeyPageStorage::toFlatValue(TABLE_META_KEY, legacyMeta.get()).value_or(""), flatMeta);
+    BOOST_REQUIRE(!KeyPageStorage::toFlatValue(TABLE_META_KEY, flatMeta));
+    BOOST_REQUIRE(!KeyPageStorage::toFlatValue("1009", ""));
+}
+
+BOOST_AUTO_TEST_CASE(pinnedValueCopiedByCaches)
+{
+    KeyPageStorage::Page page;
+    for (int i = 0; i < 10; ++i)
+    {
+        Entry entry;
+        entry.set(std::string(128, 'a' + i));
+        page.setEntry(boost::lexical_cast<std::string>(1000 + i), std::move(entry));
+    }
+    // a value pinned by the backend, the owner lives as long as the pinned entries
+    auto pin = [](std::string value, std::weak_ptr<std::string>& owner) {
+        auto buffer = std::make_shared<std::pair<std::string, std::string_view>>();
+        buffer->first = std::move(value);
+        buffer->second = buffer->first;
+        owner = std::shared_ptr<std::string>(buffer, &buffer->first);
+        Entry entry;
+        entry.setPinned(std::shared_ptr<const std::string_view>(buffer, &buffer->second));
+        entry.setStatus(Entry::Status::NORMAL);
+        return entry;
+    };
+
+    // the cached pages do not keep the pinned value
+    std::weak_ptr<std::string> pageOwner;
+    auto encoded = pin(page.encode(), pageOwner);
+    BOOST_REQUIRE(encoded.pinned());
+    KeyPageStorage::Page cachedPage(encoded, "1009");
+    encoded = Entry();
+    BOOST_REQUIRE(pageOwner.expired());
+    BOOST_REQUIRE_EQUAL(cachedPage.getEntry("1003")->get(), std::string(128, 'd'));
+
+    // the rows imported by the LRU storage do not keep the pinned value
+    std::weak_ptr<std::string> rowOwner;
+    auto prev = std::make_shared<StateStorage>(nullptr);
+    prev->asyncSetRow("table", "key", pin(std::string(128, 'x'), rowOwner),
+        [](Error::UniquePtr error) { BOOST_REQUIRE(!error); });
+    auto lru = std::make_shared<LRUStateStorage>(prev);
+    auto getRow = [&lru]() {
+        std::optional<Entry> row;
+        lru->asyncGetRow(
+            "table", "key", [&row](Error::UniquePtr error, std::optional<Entry> entry) {
+                BOOST_REQUIRE(!error);
+                row = std::move(entry);
+            });
+        return row;
+    };
+    auto entry = getRow();
+    BOOST_REQUIRE(entry);
+    BOOST_REQUIRE(!entry->pinned());
+    BOOST_REQUIRE_EQUAL(entry->get(), std::string(128, 'x'));
+    entry.reset();
+    Entry newEntry;
+    newEntry.set("new");
+    prev->asyncSetRow(
+        "table", "key", std::move(newEntry), [](Error::UniquePtr error) { BOOST_REQUIRE(!error); });
+    BOOST_REQUIRE(rowOwner.expired());
+    BOOST_REQUIRE_EQUAL(getRow()->get(), std::string(128, 'x'));
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
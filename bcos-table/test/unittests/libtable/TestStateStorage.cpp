@@ -523,6 +523,43 @@ BOOST_AUTO_TEST_CASE(hash)
     // tableFactory->asyncCommit([](Error::Ptr, size_t) {});
 }
 
+BOOST_AUTO_TEST_CASE(tableHashes)
+{
+    BOOST_TEST(tableFactory->createTable("t_hash0", valueField));
+    BOOST_TEST(tableFactory->createTable("t_hash1", valueField));
+    for (auto tableName : {"t_hash0", "t_hash1"})
+    {
+        auto table = tableFactory->openTable(tableName);
+        // odd and even entry counts
+        auto count = std::string(tableName) == "t_hash0" ? 3 : 4;
+        for (int i = 0; i < count; ++i)
+        {
+            auto entry = table->newEntry();
+            entry.setField(0, "value" + boost::lexical_cast<std::string>(i));
+            BOOST_CHECK_NO_THROW(table->setRow("key" + boost::lexical_cast<std::string>(i), entry));
+        }
+    }
+
+    std::map<std::string, crypto::HashType, std::less<>> expected;
+    std::mutex mutex;
+    tableFactory->parallelTraverse(true, [&](auto&& table, auto&& key, auto&& entry) {
+        auto hash = hashImpl->hash(std::string(table)) ^ hashImpl->hash(std::string(key)) ^
+                    entry.hash(std::string(table), std::string(key), hashImpl);
+        std::unique_lock lock(mutex);
+        expected[std::string(table)] ^= hash;
+        return true;
+    });
+    auto hashes = tableFactory->tableHashes(hashImpl);
+    BOOST_TEST(hashes.size() == expected.size());
+    crypto::HashType totalHash(0);
+    for (auto& it : expected)
+    {
+        BOOST_TEST(hashes[it.first].hex() == it.second.hex());
+        totalHash ^= it.second;
+    }
+    BOOST_TEST(tableFactory->hash(hashImpl).hex() == totalHash.hex());
+}
+
 BOOST_AUTO_TEST_CASE(open_sysTables)
 {
     auto table = tableFactory->openTable(StorageInterface::SYS_TABLES);
@@ -269,6 +269,57 @@ void ExecutorServiceClient::dmcExecuteTransactions(std::string contractAddress,
         new Callback(std::move(callback)), contractAddress, tarsInputs);
 }
 
+void ExecutorServiceClient::batchDmcExecuteTransactions(
+    gsl::span<bcos::protocol::ExecutionMessage::UniquePtr> inputs,
+    std::function<void(
+        bcos::Error::UniquePtr, std::vector<bcos::protocol::ExecutionMessage::UniquePtr>)>
+        callback)
+{
+    class Callback : public ExecutorServicePrxCallback
+    {
+    public:
+        Callback(std::function<void(bcos::Error::UniquePtr,
+                std::vector<bcos::protocol::ExecutionMessage::UniquePtr>)>&& _callback)
+          : m_callback(std::move(_callback))
+        {}
+        ~Callback() override {}
+
+        void callback_batchDmcExecuteTransactions(const bcostars::Error& ret,
+            std::vector<bcostars::ExecutionMessage> const& executionMessages) override
+        {
+            std::vector<bcos::protocol::ExecutionMessage::UniquePtr> inputList;
+            for (auto const& it : executionMessages)
+            {
+                auto bcosExecutionMessage =
+                    std::make_unique<bcostars::protocol::ExecutionMessageImpl>(
+                        [m_executionMessage = it]() mutable { return &m_executionMessage; });
+                inputList.emplace_back(std::move(bcosExecutionMessage));
+            }
+            m_callback(toUniqueBcosError(ret), std::move(inputList));
+        }
+
+        void callback_batchDmcExecuteTransactions_exception(tars::Int32 ret) override
+        {
+            m_callback(
+                toUniqueBcosError(ret), std::vector<bcos::protocol::ExecutionMessage::UniquePtr>());
+        }
+
+    private:
+        std::function<void(
+            bcos::Error::UniquePtr, std::vector<bcos::protocol::ExecutionMessage::UniquePtr>)>
+            m_callback;
+    };
+    std::vector<bcostars::ExecutionMessage> tarsInputs;
+    for (auto const& it : inputs)
+    {
+        auto executionMsgImpl = std::move((bcostars::protocol::ExecutionMessageImpl::UniquePtr&)it);
+        tarsInputs.emplace_back(executionMsgImpl->inner());
+    }
+    // timeout is 30s
+    m_prx->tars_set_timeout(30000)->async_batchDmcExecuteTransactions(
+        new Callback(std::move(callback)), tarsInputs);
+}
+
 void ExecutorServiceClient::dagExecuteTransactions(
     gsl::span<bcos::protocol::ExecutionMessage::UniquePtr> inputs,
     std::function<void(
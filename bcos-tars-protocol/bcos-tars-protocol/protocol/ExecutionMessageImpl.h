@@ -28,11 +28,13 @@
 #include <bcos-framework/protocol/LogEntry.h>
 #include <bcos-tars-protocol/tars/ExecutionMessage.h>
 #include <bcos-tars-protocol/tars/TransactionReceipt.h>
+#include <bcos-utilities/FixedSizePool.h>
 namespace bcostars
 {
 namespace protocol
 {
-class ExecutionMessageImpl : public bcos::protocol::ExecutionMessage
+class ExecutionMessageImpl : public bcos::protocol::ExecutionMessage,
+                             public bcos::PoolAllocated<ExecutionMessageImpl>
 {
 public:
     using Ptr = std::shared_ptr<ExecutionMessageImpl>;
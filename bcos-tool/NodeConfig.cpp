@@ -67,6 +67,7 @@ void NodeConfig::loadConfig(boost::property_tree::ptree const& _pt, bool _enforc
     loadSealerConfig(_pt);
     loadStorageConfig(_pt);
     loadConsensusConfig(_pt);
+    loadSyncConfig(_pt);
     loadOthersConfig(_pt);
 }
 
@@ -450,6 +451,12 @@ void NodeConfig::loadTxPoolConfig(boost::property_tree::ptree const& _pt)
         BOOST_THROW_EXCEPTION(InvalidConfig() << errinfo_comment(
                                   "Please set txpool.verify_worker_num to positive !"));
     }
+    m_verifyBatchSize = checkAndGetValue(_pt, "txpool.verify_batch_size", "256");
+    if (m_verifyBatchSize <= 0)
+    {
+        BOOST_THROW_EXCEPTION(InvalidConfig() << errinfo_comment(
+                                  "Please set txpool.verify_batch_size to positive !"));
+    }
     // the txs expiration time, in second
     auto txsExpirationTime = checkAndGetValue(_pt, "txpool.txs_expiration_time", "600");
     if (txsExpirationTime * 1000 <= DEFAULT_MIN_CONSENSUS_TIME_MS)
@@ -469,6 +476,7 @@ void NodeConfig::loadTxPoolConfig(boost::property_tree::ptree const& _pt)
     NodeConfig_LOG(INFO) << LOG_DESC("loadTxPoolConfig") << LOG_KV("txpoolLimit", m_txpoolLimit)
                          << LOG_KV("notifierWorkers", m_notifyWorkerNum)
                          << LOG_KV("verifierWorkers", m_verifierWorkerNum)
+                         << LOG_KV("verifyBatchSize", m_verifyBatchSize)
                          << LOG_KV("txsExpirationTime(ms)", m_txsExpirationTime);
 }
 
@@ -565,10 +573,19 @@ void NodeConfig::loadStorageConfig(boost::property_tree::ptree const& _pt)
     boost::split(m_pd_addrs, pd_addrs, boost::is_any_of(","));
     m_enableLRUCacheStorage = _pt.get<bool>("storage.enable_cache", true);
     m_cacheSize = _pt.get<ssize_t>("storage.cache_size", DEFAULT_CACHE_SIZE);
+    m_enableColumnFamily = _pt.get<bool>("storage.enable_column_family", false);
+    // in MB
+    m_stateBlockCacheSize = _pt.get<size_t>("storage.state_block_cache_size", 128) * 1024 * 1024;
+    m_historyBlockCacheSize =
+        _pt.get<size_t>("storage.history_block_cache_size", 32) * 1024 * 1024;
+    m_historyUniversalCompaction = _pt.get<bool>("storage.history_universal_compaction", true);
     NodeConfig_LOG(INFO) << LOG_DESC("loadStorageConfig") << LOG_KV("storagePath", m_storagePath)
                          << LOG_KV("KeyPage", m_keyPageSize) << LOG_KV("storageType", m_storageType)
                          << LOG_KV("pd_addrs", pd_addrs)
-                         << LOG_KV("enableLRUCacheStorage", m_enableLRUCacheStorage);
+                         << LOG_KV("enableLRUCacheStorage", m_enableLRUCacheStorage)
+                         << LOG_KV("enableColumnFamily", m_enableColumnFamily)
+                         << LOG_KV("stateBlockCacheSize", m_stateBlockCacheSize)
+                         << LOG_KV("historyBlockCacheSize", m_historyBlockCacheSize);
 }
 
 // Note: In components that do not require failover, do not need to set member_id
@@ -626,6 +643,19 @@ void NodeConfig::loadConsensusConfig(boost::property_tree::ptree const& _pt)
                          << LOG_KV("checkPointTimeoutInterval", m_checkPointTimeoutInterval);
 }
 
+void NodeConfig::loadSyncConfig(boost::property_tree::ptree const& _pt)
+{
+    // all the nodes of the chain must use the same interval to agree on the snapshots
+    m_snapshotInterval = _pt.get<int64_t>("sync.snapshot_interval", 0);
+    if (m_snapshotInterval < 0)
+    {
+        BOOST_THROW_EXCEPTION(InvalidConfig() << errinfo_comment(
+                                  "Please set sync.snapshot_interval to non-negative!"));
+    }
+    NodeConfig_LOG(INFO) << LOG_DESC("loadSyncConfig")
+                         << LOG_KV("snapshotInterval", m_snapshotInterval);
+}
+
 void NodeConfig::loadLedgerConfig(boost::property_tree::ptree const& _genesisConfig)
 {
     // consensus type
@@ -741,6 +771,11 @@ void NodeConfig::generateGenesisData()
     versionData = m_compatibilityVersionStr + "-";
     std::stringstream ss;
     ss << m_isWasm << "-" << m_isAuthCheck << "-" << m_authAdminAddress << "-" << m_isSerialExecute;
+    // only appended when enabled, keep the genesis data of the existing chains unchanged
+    if (m_isOccExecute)
+    {
+        ss << "-occ";
+    }
     executorConfig = ss.str();
 
     std::stringstream s;
@@ -760,11 +795,13 @@ void NodeConfig::loadExecutorConfig(boost::property_tree::ptree const& _genesisC
     m_isWasm = _genesisConfig.get<bool>("executor.is_wasm", false);
     m_isAuthCheck = _genesisConfig.get<bool>("executor.is_auth_check", false);
     m_isSerialExecute = _genesisConfig.get<bool>("executor.is_serial_execute", false);
+    m_isOccExecute = _genesisConfig.get<bool>("executor.is_occ_execute", false);
     m_authAdminAddress = _genesisConfig.get<std::string>("executor.auth_admin_account", "");
     NodeConfig_LOG(INFO) << METRIC << LOG_DESC("loadExecutorConfig") << LOG_KV("isWasm", m_isWasm)
                          << LOG_KV("isAuthCheck", m_isAuthCheck)
                          << LOG_KV("authAdminAccount", m_authAdminAddress)
-                         << LOG_KV("ismSerialExecute", m_isSerialExecute);
+                         << LOG_KV("ismSerialExecute", m_isSerialExecute)
+                         << LOG_KV("isOccExecute", m_isOccExecute);
 }
 
 // Note: make sure the consensus param checker is consistent with the precompiled param checker
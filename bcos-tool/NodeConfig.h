@@ -97,6 +97,7 @@ public:
     size_t txpoolLimit() const { return m_txpoolLimit; }
     size_t notifyWorkerNum() const { return m_notifyWorkerNum; }
     size_t verifierWorkerNum() const { return m_verifierWorkerNum; }
+    size_t verifyBatchSize() const { return m_verifyBatchSize; }
     int64_t txsExpirationTime() const { return m_txsExpirationTime; }
 
     bool smCryptoType() const { return m_smCryptoType; }
@@ -108,11 +109,16 @@ public:
 
     size_t minSealTime() const { return m_minSealTime; }
     size_t checkPointTimeoutInterval() const { return m_checkPointTimeoutInterval; }
+    int64_t snapshotInterval() const { return m_snapshotInterval; }
 
     std::string const& storagePath() const { return m_storagePath; }
     std::string const& storageType() const { return m_storageType; }
     size_t keyPageSize() const { return m_keyPageSize; }
     std::vector<std::string> const& pdAddrs() const { return m_pd_addrs; }
+    bool enableColumnFamily() const { return m_enableColumnFamily; }
+    size_t stateBlockCacheSize() const { return m_stateBlockCacheSize; }
+    size_t historyBlockCacheSize() const { return m_historyBlockCacheSize; }
+    bool historyUniversalCompaction() const { return m_historyUniversalCompaction; }
     std::string const& storageDBName() const { return m_storageDBName; }
     std::string const& stateDBName() const { return m_stateDBName; }
 
@@ -127,6 +133,7 @@ public:
     bool isWasm() const { return m_isWasm; }
     bool isAuthCheck() const { return m_isAuthCheck; }
     bool isSerialExecute() const { return m_isSerialExecute; }
+    bool isOccExecute() const { return m_isOccExecute; }
     std::string const& authAdminAddress() const { return m_authAdminAddress; }
 
     std::string const& rpcServiceName() const { return m_rpcServiceName; }
@@ -224,6 +231,7 @@ protected:
 
     virtual void loadStorageConfig(boost::property_tree::ptree const& _pt);
     virtual void loadConsensusConfig(boost::property_tree::ptree const& _pt);
+    virtual void loadSyncConfig(boost::property_tree::ptree const& _pt);
     virtual void loadFailOverConfig(
         boost::property_tree::ptree const& _pt, bool _enforceMemberID = true);
     virtual void loadOthersConfig(boost::property_tree::ptree const& _pt);
@@ -255,8 +263,11 @@ private:
     size_t m_txpoolLimit;
     size_t m_notifyWorkerNum;
     size_t m_verifierWorkerNum;
+    size_t m_verifyBatchSize;
     int64_t m_txsExpirationTime;
-    // TODO: the block sync module need some configurations?
+    // block sync configuration, the state snapshots are exported every m_snapshotInterval blocks,
+    // 0 to disable the snapshot sync
+    int64_t m_snapshotInterval = 0;
 
     // chain configuration
     bool m_smCryptoType;
@@ -288,6 +299,10 @@ private:
     std::string m_storageType = "RocksDB";
     size_t m_keyPageSize = 8192;
     std::vector<std::string> m_pd_addrs;
+    bool m_enableColumnFamily = false;
+    size_t m_stateBlockCacheSize = 128 * 1024 * 1024;
+    size_t m_historyBlockCacheSize = 32 * 1024 * 1024;
+    bool m_historyUniversalCompaction = true;
     std::string m_storageDBName = "storage";
     std::string m_stateDBName = "state";
 
@@ -295,6 +310,7 @@ private:
     bool m_isWasm = false;
     bool m_isAuthCheck = false;
     bool m_isSerialExecute = false;
+    bool m_isOccExecute = false;
     std::string m_authAdminAddress;
 
     // Pro and Max versions run do not apply to tars admin site
@@ -66,9 +66,13 @@ void TxPool::stop()
 
 void TxPool::asyncSubmit(bytesPointer _txData, TxSubmitCallback _txSubmitCallback)
 {
+    {
+        std::lock_guard<std::mutex> l(x_pendingTxs);
+        m_pendingTxs.emplace_back(std::move(_txData), std::move(_txSubmitCallback));
+    }
     // verify and try to submit the valid transaction
     auto self = std::weak_ptr<TxPool>(shared_from_this());
-    m_worker->enqueue([self, _txData, _txSubmitCallback]() {
+    m_worker->enqueue([self]() {
         try
         {
             auto txpool = self.lock();
@@ -76,12 +80,7 @@ void TxPool::asyncSubmit(bytesPointer _txData, TxSubmitCallback _txSubmitCallbac
             {
                 return;
             }
-            auto txpoolStorage = txpool->m_txpoolStorage;
-            if (!txpool->checkExistsInGroup(_txSubmitCallback))
-            {
-                return;
-            }
-            txpoolStorage->submitTransaction(_txData, _txSubmitCallback);
+            txpool->submitPendingTxs();
         }
         catch (std::exception const& e)
         {
@@ -91,6 +90,35 @@ void TxPool::asyncSubmit(bytesPointer _txData, TxSubmitCallback _txSubmitCallbac
     });
 }
 
+void TxPool::submitPendingTxs()
+{
+    std::vector<std::pair<bytesPointer, TxSubmitCallback>> txs;
+    {
+        std::lock_guard<std::mutex> l(x_pendingTxs);
+        // the txs may have been submitted by the former tasks
+        auto size = std::min(m_pendingTxs.size(), m_config->verifyBatchSize());
+        txs.reserve(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            txs.emplace_back(std::move(m_pendingTxs.front()));
+            m_pendingTxs.pop_front();
+        }
+    }
+    if (txs.empty())
+    {
+        return;
+    }
+    auto it = std::remove_if(txs.begin(), txs.end(),
+        [this](auto const& _tx) { return !checkExistsInGroup(_tx.second); });
+    txs.erase(it, txs.end());
+    if (txs.size() == 1)
+    {
+        m_txpoolStorage->submitTransaction(txs[0].first, txs[0].second);
+        return;
+    }
+    m_txpoolStorage->batchSubmitTransactions(txs);
+}
+
 bool TxPool::checkExistsInGroup(TxSubmitCallback _txSubmitCallback)
 {
     auto syncConfig = m_transactionSync->config();
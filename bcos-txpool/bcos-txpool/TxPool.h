@@ -24,6 +24,8 @@
 #include "txpool/interfaces/TxPoolStorageInterface.h"
 #include <bcos-framework/txpool/TxPoolInterface.h>
 #include <bcos-utilities/ThreadPool.h>
+#include <deque>
+#include <mutex>
 #include <thread>
 namespace bcos
 {
@@ -153,6 +155,8 @@ protected:
     void initSendResponseHandler();
 
     virtual void storeVerifiedBlock(bcos::protocol::Block::Ptr _block);
+    // submit at most verifyBatchSize pending txs together
+    virtual void submitPendingTxs();
 
 private:
     TxPoolConfig::Ptr m_config;
@@ -169,6 +173,11 @@ private:
     ThreadPool::Ptr m_filler;
     ThreadPool::Ptr m_txsResultNotifier;
     std::atomic_bool m_running = {false};
+
+    // the submitted txs waiting to be verified, txs arrived while the submitters are busy are
+    // verified in one batch
+    std::deque<std::pair<bytesPointer, bcos::protocol::TxSubmitCallback>> m_pendingTxs;
+    std::mutex x_pendingTxs;
 };
 }  // namespace txpool
 }  // namespace bcos
@@ -51,6 +51,12 @@ public:
     virtual ~TxPoolConfig() {}
     virtual void setPoolLimit(size_t _poolLimit) { m_poolLimit = _poolLimit; }
     virtual size_t poolLimit() const { return m_poolLimit; }
+    // the max number of submitted txs verified together
+    void setVerifyBatchSize(size_t _verifyBatchSize)
+    {
+        m_verifyBatchSize = std::max(_verifyBatchSize, (size_t)1);
+    }
+    size_t verifyBatchSize() const { return m_verifyBatchSize; }
 
     NonceCheckerInterface::Ptr txPoolNonceChecker() { return m_txPoolNonceChecker; }
 
@@ -80,6 +86,7 @@ private:
     std::shared_ptr<bcos::ledger::LedgerInterface> m_ledger;
     NonceCheckerInterface::Ptr m_txPoolNonceChecker;
     size_t m_poolLimit = 15000;
+    size_t m_verifyBatchSize = 256;
     int64_t m_blockLimit = 1000;
 };
 }  // namespace txpool
@@ -39,6 +39,10 @@ public:
     virtual bcos::protocol::TransactionStatus submitTransaction(
         bytesPointer _txData, bcos::protocol::TxSubmitCallback _txSubmitCallback = nullptr) = 0;
 
+    // decode the transactions and verify their signatures in parallel, then submit them in order
+    virtual void batchSubmitTransactions(
+        std::vector<std::pair<bytesPointer, bcos::protocol::TxSubmitCallback>> const& _txs) = 0;
+
     virtual bcos::protocol::TransactionStatus insert(bcos::protocol::Transaction::ConstPtr _tx) = 0;
     virtual void batchInsert(bcos::protocol::Transactions const& _txs) = 0;
 
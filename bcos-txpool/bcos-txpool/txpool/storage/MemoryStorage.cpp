@@ -19,6 +19,7 @@
  * @date 2021-05-07
  */
 #include "bcos-txpool/txpool/storage/MemoryStorage.h"
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_invoke.h>
 #include <memory>
 #include <tuple>
@@ -92,6 +93,60 @@ TransactionStatus MemoryStorage::submitTransaction(
     }
 }
 
+void MemoryStorage::batchSubmitTransactions(
+    std::vector<std::pair<bytesPointer, TxSubmitCallback>> const& _txs)
+{
+    auto recordT = utcTime();
+    std::vector<Transaction::Ptr> txs(_txs.size());
+    // decode and verify the signatures in parallel, the txs already in the txpool are skipped
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, _txs.size()), [&](const tbb::blocked_range<size_t>& _r) {
+            for (size_t i = _r.begin(); i < _r.end(); i++)
+            {
+                try
+                {
+                    auto tx = m_config->txFactory()->createTransaction(ref(*_txs[i].first), false);
+                    tx->setImportTime(utcTime());
+                    txs[i] = tx;
+                    if (m_txsTable.count(tx->hash()))
+                    {
+                        continue;
+                    }
+                    tx->verify();
+                }
+                catch (std::exception const& e)
+                {
+                    if (txs[i])
+                    {
+                        txs[i]->setInvalid(true);
+                        continue;
+                    }
+                    TXPOOL_LOG(WARNING) << LOG_DESC("Invalid transaction for decode exception")
+                                        << LOG_KV("error", boost::diagnostic_information(e));
+                }
+            }
+        });
+    auto verifyT = utcTime() - recordT;
+    // submit in order, the nonces of the txs in the same batch are checked one by one
+    ReadGuard l(x_txpoolMutex);
+    for (size_t i = 0; i < txs.size(); i++)
+    {
+        auto const& callback = _txs[i].second;
+        if (!txs[i])
+        {
+            notifyInvalidReceipt(HashType(), TransactionStatus::Malform, callback);
+            continue;
+        }
+        auto result = verifyAndSubmitTransaction(txs[i], callback, true, false);
+        if (result != TransactionStatus::None)
+        {
+            notifyInvalidReceipt(txs[i]->hash(), result, callback);
+        }
+    }
+    TXPOOL_LOG(DEBUG) << LOG_DESC("batchSubmitTransactions") << LOG_KV("txs", _txs.size())
+                      << LOG_KV("verifyT", verifyT) << LOG_KV("timecost", (utcTime() - recordT));
+}
+
 TransactionStatus MemoryStorage::txpoolStorageCheck(Transaction::ConstPtr _tx)
 {
     auto txHash = _tx->hash();
@@ -130,6 +185,7 @@ TransactionStatus MemoryStorage::enforceSubmitTransaction(Transaction::Ptr _tx)
             {
                 m_sealedTxsSize++;
                 tx->setSealed(true);
+                m_unsealedTxs.erase(*tx);
             }
             tx->setBatchId(_tx->batchId());
             tx->setBatchHash(_tx->batchHash());
@@ -161,6 +217,7 @@ TransactionStatus MemoryStorage::enforceSubmitTransaction(Transaction::Ptr _tx)
         if (!tx->sealed())
         {
             tx->setSealed(true);
+            m_unsealedTxs.erase(*tx);
             m_sealedTxsSize++;
         }
     }
@@ -168,6 +225,7 @@ TransactionStatus MemoryStorage::enforceSubmitTransaction(Transaction::Ptr _tx)
     {
         // avoid the sealed txs be sealed again
         _tx->setSealed(true);
+        m_unsealedTxs.erase(*_tx);
         m_sealedTxsSize++;
     }
     return TransactionStatus::None;
@@ -248,6 +306,10 @@ TransactionStatus MemoryStorage::insertWithoutLock(Transaction::ConstPtr _tx)
     {
         return TransactionStatus::AlreadyInTxPool;
     }
+    if (!_tx->sealed())
+    {
+        m_unsealedTxs.insert(_tx);
+    }
     m_onReady();
     if (m_preStoreTxs)
     {
@@ -331,6 +393,10 @@ Transaction::ConstPtr MemoryStorage::removeWithoutLock(HashType const& _txHash)
     {
         m_sealedTxsSize--;
     }
+    if (tx)
+    {
+        m_unsealedTxs.erase(*tx);
+    }
     m_txsTable.unsafe_erase(_txHash);
 #if FISCO_DEBUG
     // TODO: remove this, now just for bug tracing
@@ -559,37 +625,35 @@ void MemoryStorage::batchFetchTxs(Block::Ptr _txsList, Block::Ptr _sysTxsList, s
     startT = utcTime();
     int64_t currentTime = (int64_t)utcTime();
     size_t traverseCount = 0;
-    for (auto const& it : m_txsTable)
-    {
+    auto fetchTx = [&](Transaction::ConstPtr const& tx) -> UnsealedTxsIndex::Visit {
         traverseCount++;
-        auto tx = it.second;
         // Note: When inserting data into tbb::concurrent_unordered_map while traversing,
-        // it.second will occasionally be a null pointer.
+        // the tx will occasionally be a null pointer.
         if (!tx)
         {
-            continue;
+            return UnsealedTxsIndex::Visit::Keep;
         }
         // only seal the txs have been stored to the backend
         if (m_preStoreTxs && !tx->storeToBackend())
         {
-            continue;
+            return UnsealedTxsIndex::Visit::Keep;
         }
         auto txHash = tx->hash();
         if (m_invalidTxs.count(txHash))
         {
-            continue;
+            return UnsealedTxsIndex::Visit::Erase;
         }
         // the transaction has already been sealed for newer proposal
         if (_avoidDuplicate && tx->sealed())
         {
-            continue;
+            return UnsealedTxsIndex::Visit::Erase;
         }
         if (currentTime > (tx->importTime() + m_txsExpirationTime))
         {
             // add to m_invalidTxs to be deleted
             m_invalidTxs.insert(txHash);
             m_invalidTxs.insert(tx->nonce());
-            continue;
+            return UnsealedTxsIndex::Visit::Erase;
         }
         /// check nonce again when obtain transactions
         // since the invalid nonce has already been checked before the txs import into the
@@ -604,18 +668,18 @@ void MemoryStorage::batchFetchTxs(Block::Ptr _txsList, Block::Ptr _sysTxsList, s
             // add to m_invalidTxs to be deleted
             m_invalidTxs.insert(txHash);
             m_invalidTxs.insert(tx->nonce());
-            continue;
+            return UnsealedTxsIndex::Visit::Erase;
         }
         // blockLimit expired
         if (result == TransactionStatus::BlockLimitCheckFail)
         {
             m_invalidTxs.insert(txHash);
             m_invalidNonces.insert(tx->nonce());
-            continue;
+            return UnsealedTxsIndex::Visit::Erase;
         }
         if (_avoidTxs && _avoidTxs->count(txHash))
         {
-            continue;
+            return UnsealedTxsIndex::Visit::Keep;
         }
         auto txMetaData = m_config->blockFactory()->createTransactionMetaData();
 
@@ -647,7 +711,29 @@ void MemoryStorage::batchFetchTxs(Block::Ptr _txsList, Block::Ptr _sysTxsList, s
         if ((_txsList->transactionsMetaDataSize() + _sysTxsList->transactionsMetaDataSize()) >=
             _txsLimit)
         {
-            break;
+            return UnsealedTxsIndex::Visit::EraseAndStop;
+        }
+        return UnsealedTxsIndex::Visit::Erase;
+    };
+    if (_avoidDuplicate)
+    {
+        // only the unsealed txs can be fetched, pop them from the head of the index
+        m_unsealedTxs.traverse(fetchTx);
+    }
+    else
+    {
+        for (auto const& it : m_txsTable)
+        {
+            auto visit = fetchTx(it.second);
+            if (visit == UnsealedTxsIndex::Visit::Keep)
+            {
+                continue;
+            }
+            m_unsealedTxs.erase(*it.second);
+            if (visit == UnsealedTxsIndex::Visit::EraseAndStop)
+            {
+                break;
+            }
         }
     }
     auto fetchTxsT = utcTime() - startT;
@@ -715,12 +801,27 @@ void MemoryStorage::clear()
 {
     WriteGuard l(x_txpoolMutex);
     m_txsTable.clear();
+    m_unsealedTxs.clear();
     m_invalidTxs.clear();
     m_invalidNonces.clear();
     m_missedTxs.clear();
     notifyUnsealedTxsSize();
 }
 
+void MemoryStorage::setSealPriority(UnsealedTxsIndex::Priority _priority)
+{
+    WriteGuard l(x_txpoolMutex);
+    m_unsealedTxs.setPriority(std::move(_priority));
+    for (auto const& it : m_txsTable)
+    {
+        auto tx = it.second;
+        if (tx && !tx->sealed())
+        {
+            m_unsealedTxs.insert(tx);
+        }
+    }
+}
+
 HashListPtr MemoryStorage::filterUnknownTxs(HashList const& _txsHashList, NodeIDPtr _peer)
 {
     ReadGuard l(x_txpoolMutex);
@@ -810,6 +911,14 @@ void MemoryStorage::batchMarkTxsWithoutLock(
             m_sealedTxsSize--;
         }
         tx->setSealed(_sealFlag);
+        if (_sealFlag)
+        {
+            m_unsealedTxs.erase(*tx);
+        }
+        else
+        {
+            m_unsealedTxs.insert(tx);
+        }
         successCount += 1;
         // set the block information for the transaction
         if (_sealFlag)
@@ -834,7 +943,9 @@ void MemoryStorage::batchMarkTxsWithoutLock(
 
 void MemoryStorage::batchMarkAllTxs(bool _sealFlag)
 {
-    ReadGuard l(x_txpoolMutex);
+    // Note: use writeLock here in case of the txs inserted concurrently missing in the index
+    WriteGuard l(x_txpoolMutex);
+    m_unsealedTxs.clear();
     for (auto item : m_txsTable)
     {
         auto tx = item.second;
@@ -847,6 +958,7 @@ void MemoryStorage::batchMarkAllTxs(bool _sealFlag)
         {
             tx->setBatchId(-1);
             tx->setBatchHash(HashType());
+            m_unsealedTxs.insert(tx);
         }
     }
     if (_sealFlag)
@@ -20,6 +20,7 @@
  */
 #pragma once
 #include "bcos-txpool/TxPoolConfig.h"
+#include "bcos-txpool/txpool/storage/UnsealedTxsIndex.h"
 #include <bcos-utilities/ThreadPool.h>
 #include <bcos-utilities/Timer.h>
 #include <tbb/concurrent_unordered_map.h>
@@ -40,6 +41,9 @@ public:
 
     bcos::protocol::TransactionStatus submitTransaction(bytesPointer _txData,
         bcos::protocol::TxSubmitCallback _txSubmitCallback = nullptr) override;
+    void batchSubmitTransactions(
+        std::vector<std::pair<bytesPointer, bcos::protocol::TxSubmitCallback>> const& _txs)
+        override;
 
     bcos::protocol::TransactionStatus insert(bcos::protocol::Transaction::ConstPtr _tx) override;
     void batchInsert(bcos::protocol::Transactions const& _txs) override;
@@ -96,6 +100,10 @@ public:
 
     bool preStoreTxs() const override { return m_preStoreTxs; }
 
+    // set the order in which the unsealed txs are sealed, the earliest imported txs are sealed
+    // first by default
+    void setSealPriority(UnsealedTxsIndex::Priority _priority);
+
 protected:
     bcos::protocol::TransactionStatus insertWithoutLock(bcos::protocol::Transaction::ConstPtr _tx);
     bcos::protocol::TransactionStatus enforceSubmitTransaction(
@@ -137,6 +145,8 @@ protected:
     tbb::concurrent_unordered_map<bcos::crypto::HashType, bcos::protocol::Transaction::ConstPtr,
         std::hash<bcos::crypto::HashType>>
         m_txsTable;
+    // the unsealed txs of m_txsTable in sealing order
+    UnsealedTxsIndex m_unsealedTxs;
 
     mutable SharedMutex x_txpoolMutex;
 
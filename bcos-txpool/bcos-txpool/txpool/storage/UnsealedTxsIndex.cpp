@@ -0,0 +1,120 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the priority-ordered index of the unsealed txs, sharded by tx hash
+ * @file UnsealedTxsIndex.cpp
+ */
+#include "bcos-txpool/txpool/storage/UnsealedTxsIndex.h"
+#include <algorithm>
+#include <queue>
+
+using namespace bcos;
+using namespace bcos::txpool;
+using namespace bcos::crypto;
+using namespace bcos::protocol;
+
+UnsealedTxsIndex::UnsealedTxsIndex(size_t _shardsNum, Priority _priority)
+  : m_shards(std::max(_shardsNum, (size_t)1)),
+    m_priority(_priority ? std::move(_priority) : Priority(importTimePriority))
+{}
+
+void UnsealedTxsIndex::insert(Transaction::ConstPtr const& _tx)
+{
+    auto const& txHash = _tx->hash();
+    auto& txsShard = shard(txHash);
+    std::lock_guard<std::mutex> l(txsShard.mutex);
+    txsShard.txs.emplace(Key(m_priority(*_tx), txHash), _tx);
+}
+
+void UnsealedTxsIndex::erase(Transaction const& _tx)
+{
+    auto const& txHash = _tx.hash();
+    auto& txsShard = shard(txHash);
+    std::lock_guard<std::mutex> l(txsShard.mutex);
+    txsShard.txs.erase(Key(m_priority(_tx), txHash));
+}
+
+void UnsealedTxsIndex::clear()
+{
+    for (auto& txsShard : m_shards)
+    {
+        std::lock_guard<std::mutex> l(txsShard.mutex);
+        txsShard.txs.clear();
+    }
+}
+
+size_t UnsealedTxsIndex::size() const
+{
+    size_t txsSize = 0;
+    for (auto const& txsShard : m_shards)
+    {
+        std::lock_guard<std::mutex> l(txsShard.mutex);
+        txsSize += txsShard.txs.size();
+    }
+    return txsSize;
+}
+
+void UnsealedTxsIndex::traverse(Visitor const& _visitor)
+{
+    // the shards are always locked in the same order, insert and erase only lock one shard
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(m_shards.size());
+    for (auto& txsShard : m_shards)
+    {
+        locks.emplace_back(txsShard.mutex);
+    }
+    // merge the ordered shards with a min-heap of the shard heads
+    using Cursor = std::pair<std::map<Key, Transaction::ConstPtr>::iterator, size_t>;
+    auto greater = [](Cursor const& _a, Cursor const& _b) {
+        return _a.first->first > _b.first->first;
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heads(greater);
+    for (size_t i = 0; i < m_shards.size(); i++)
+    {
+        if (!m_shards[i].txs.empty())
+        {
+            heads.emplace(m_shards[i].txs.begin(), i);
+        }
+    }
+    while (!heads.empty())
+    {
+        auto [it, shardIndex] = heads.top();
+        heads.pop();
+        auto& txs = m_shards[shardIndex].txs;
+        auto visit = _visitor(it->second);
+        auto next = (visit == Visit::Keep) ? std::next(it) : txs.erase(it);
+        if (visit == Visit::EraseAndStop)
+        {
+            break;
+        }
+        if (next != txs.end())
+        {
+            heads.emplace(next, shardIndex);
+        }
+    }
+}
+
+void UnsealedTxsIndex::setPriority(Priority _priority)
+{
+    // insert and erase read the priority under the lock of their shard
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(m_shards.size());
+    for (auto& txsShard : m_shards)
+    {
+        locks.emplace_back(txsShard.mutex);
+        txsShard.txs.clear();
+    }
+    m_priority = _priority ? std::move(_priority) : Priority(importTimePriority);
+}
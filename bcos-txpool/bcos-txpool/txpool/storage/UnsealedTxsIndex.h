@@ -0,0 +1,86 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief the priority-ordered index of the unsealed txs, sharded by tx hash
+ * @file UnsealedTxsIndex.h
+ */
+#pragma once
+#include <bcos-framework/protocol/Transaction.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace bcos
+{
+namespace txpool
+{
+// Keeps the unsealed txs ordered by priority (lower value is sealed first, ties broken by the tx
+// hash), so that sealing k txs only visits the head of the index instead of the whole pool.
+// The txs are sharded by hash, inserting and erasing only lock the shard of the tx.
+class UnsealedTxsIndex
+{
+public:
+    using Ptr = std::shared_ptr<UnsealedTxsIndex>;
+    // Note: the priority of a tx must not change while the tx is in the index
+    using Priority = std::function<int64_t(bcos::protocol::Transaction const&)>;
+
+    enum class Visit
+    {
+        Keep,
+        Erase,
+        EraseAndStop,
+    };
+    using Visitor = std::function<Visit(bcos::protocol::Transaction::ConstPtr const&)>;
+
+    explicit UnsealedTxsIndex(size_t _shardsNum = 16, Priority _priority = nullptr);
+
+    // seal the earliest imported txs first by default
+    static int64_t importTimePriority(bcos::protocol::Transaction const& _tx)
+    {
+        return _tx.importTime();
+    }
+
+    void insert(bcos::protocol::Transaction::ConstPtr const& _tx);
+    void erase(bcos::protocol::Transaction const& _tx);
+    void clear();
+    size_t size() const;
+
+    // visit the txs in priority order until the visitor stops or all txs have been visited;
+    // all shards are locked while visiting, the visitor must not access the index
+    void traverse(Visitor const& _visitor);
+
+    // reset the priority, the index is cleared and must be refilled by the caller
+    void setPriority(Priority _priority);
+
+private:
+    using Key = std::pair<int64_t, bcos::crypto::HashType>;
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::map<Key, bcos::protocol::Transaction::ConstPtr> txs;
+    };
+
+    Shard& shard(bcos::crypto::HashType const& _txHash)
+    {
+        return m_shards[std::hash<bcos::crypto::HashType>()(_txHash) % m_shards.size()];
+    }
+
+    std::vector<Shard> m_shards;
+    // guarded by the locks of all the shards
+    Priority m_priority;
+};
+}  // namespace txpool
+}  // namespace bcos
@@ -19,6 +19,8 @@
  * @date 2021-05-10
  */
 #include "LedgerNonceChecker.h"
+#include <algorithm>
+#include <limits>
 using namespace bcos;
 using namespace bcos::protocol;
 using namespace bcos::txpool;
@@ -28,18 +30,16 @@ void LedgerNonceChecker::initNonceCache(
 {
     for (auto const& it : _initialNonces)
     {
-        m_blockNonceCache[it.first] = it.second;
-        TxPoolNonceChecker::batchInsert(it.first, it.second);
+        batchInsert(it.first, it.second);
     }
 }
 
-TransactionStatus LedgerNonceChecker::checkNonce(Transaction::ConstPtr _tx, bool _shouldUpdate)
+TransactionStatus LedgerNonceChecker::checkNonce(Transaction::ConstPtr _tx, bool)
 {
     // check nonce
-    auto status = TxPoolNonceChecker::checkNonce(_tx, _shouldUpdate);
-    if (status != TransactionStatus::None)
+    if (exists(_tx->nonce()))
     {
-        return status;
+        return TransactionStatus::NonceCheckFail;
     }
     // check blockLimit
     return checkBlockLimit(_tx);
@@ -60,6 +60,96 @@ TransactionStatus LedgerNonceChecker::checkBlockLimit(bcos::protocol::Transactio
     return TransactionStatus::None;
 }
 
+bool LedgerNonceChecker::exists(NonceType const& _nonce)
+{
+    ReadGuard l(x_blockNonceCache);
+    return existsWithoutLock(_nonce);
+}
+
+bool LedgerNonceChecker::mayExist(NonceType const& _nonce) const
+{
+    bool hit = true;
+    forEachFilterIndex(_nonce, [&](size_t _index) {
+        if (m_nonceFilter[_index] == 0)
+        {
+            hit = false;
+        }
+    });
+    return hit;
+}
+
+bool LedgerNonceChecker::existsWithoutLock(NonceType const& _nonce) const
+{
+    if (!mayExist(_nonce))
+    {
+        return false;
+    }
+    for (auto const& blockNonces : m_blockNonces)
+    {
+        if (std::binary_search(blockNonces.nonces.begin(), blockNonces.nonces.end(), _nonce))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class F>
+void LedgerNonceChecker::forEachFilterIndex(NonceType const& _nonce, F&& _f) const
+{
+    // splitmix64 finalizer, the nonces may be sequential numbers
+    auto mix = [](uint64_t _x) {
+        _x = (_x ^ (_x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        _x = (_x ^ (_x >> 27)) * 0x94d049bb133111ebULL;
+        return _x ^ (_x >> 31);
+    };
+    uint64_t h1 = mix(std::hash<NonceType>()(_nonce));
+    uint64_t h2 = mix(h1) | 1;
+    auto mask = m_nonceFilter.size() - 1;
+    for (size_t i = 0; i < c_filterHashNum; i++)
+    {
+        _f((h1 + i * h2) & mask);
+    }
+}
+
+void LedgerNonceChecker::updateFilter(NonceType const& _nonce, bool _insert)
+{
+    forEachFilterIndex(_nonce, [&](size_t _index) {
+        auto& counter = m_nonceFilter[_index];
+        // the saturated counters are never decreased
+        if (counter == std::numeric_limits<uint8_t>::max())
+        {
+            return;
+        }
+        if (_insert)
+        {
+            counter++;
+        }
+        else if (counter > 0)
+        {
+            counter--;
+        }
+    });
+}
+
+void LedgerNonceChecker::resizeFilter()
+{
+    auto filterSize = m_nonceFilter.size();
+    while (filterSize < m_noncesSize * c_filterCountersPerNonce)
+    {
+        filterSize <<= 1;
+    }
+    m_nonceFilter.assign(filterSize, 0);
+    for (auto const& blockNonces : m_blockNonces)
+    {
+        for (auto const& nonce : blockNonces.nonces)
+        {
+            updateFilter(nonce, true);
+        }
+    }
+    NONCECHECKER_LOG(INFO) << LOG_DESC("resize nonce filter") << LOG_KV("filterSize", filterSize)
+                           << LOG_KV("nonceSize", m_noncesSize);
+}
 
 void LedgerNonceChecker::batchInsert(BlockNumber _batchId, NonceListPtr _nonceList)
 {
@@ -67,33 +157,104 @@ void LedgerNonceChecker::batchInsert(BlockNumber _batchId, NonceListPtr _nonceLi
     {
         m_blockNumber.store(_batchId);
     }
-    ssize_t batchToBeRemoved = (_batchId > m_blockLimit) ? (_batchId - m_blockLimit) : -1;
+    WriteGuard l(x_blockNonceCache);
+    auto& blockNonces = m_blockNonces[_batchId % m_blockNonces.size()];
+    // the block has already been cached, or has already expired
+    if (blockNonces.number >= _batchId)
+    {
+        return;
+    }
+    // remove the expired nonces
+    if (blockNonces.number >= 0)
+    {
+        for (auto const& nonce : blockNonces.nonces)
+        {
+            updateFilter(nonce, false);
+        }
+        m_noncesSize -= blockNonces.nonces.size();
+        NONCECHECKER_LOG(DEBUG) << LOG_DESC("batchInsert: remove expired nonce")
+                                << LOG_KV("batchToBeRemoved", blockNonces.number)
+                                << LOG_KV("nonceSize", blockNonces.nonces.size());
+    }
     // insert the latest nonces
-    TxPoolNonceChecker::batchInsert(_batchId, _nonceList);
+    blockNonces.number = _batchId;
+    blockNonces.nonces.assign(_nonceList->begin(), _nonceList->end());
+    std::sort(blockNonces.nonces.begin(), blockNonces.nonces.end());
+    m_noncesSize += blockNonces.nonces.size();
+    if (m_noncesSize * c_filterCountersPerNonce > m_nonceFilter.size())
+    {
+        resizeFilter();
+    }
+    else
+    {
+        for (auto const& nonce : blockNonces.nonces)
+        {
+            updateFilter(nonce, true);
+        }
+    }
+    NONCECHECKER_LOG(DEBUG) << LOG_DESC("batchInsert nonceList") << LOG_KV("batchId", _batchId)
+                            << LOG_KV("nonceSize", _nonceList->size());
+}
 
+void LedgerNonceChecker::insert(NonceType const& _nonce)
+{
     WriteGuard l(x_blockNonceCache);
-    if (!m_blockNonceCache.count(_batchId))
+    // insert into the slot of the latest block
+    auto blockNumber = m_blockNumber.load();
+    auto& blockNonces = m_blockNonces[blockNumber % m_blockNonces.size()];
+    if (blockNonces.number != blockNumber)
     {
-        m_blockNonceCache[_batchId] = _nonceList;
-        NONCECHECKER_LOG(DEBUG) << LOG_DESC("batchInsert nonceList") << LOG_KV("batchId", _batchId)
-                                << LOG_KV("nonceSize", _nonceList->size());
+        for (auto const& nonce : blockNonces.nonces)
+        {
+            updateFilter(nonce, false);
+        }
+        m_noncesSize -= blockNonces.nonces.size();
+        blockNonces.number = blockNumber;
+        blockNonces.nonces.clear();
     }
-    // the genesis has no nonceList
-    if (batchToBeRemoved == -1)
+    auto it = std::lower_bound(blockNonces.nonces.begin(), blockNonces.nonces.end(), _nonce);
+    if (it != blockNonces.nonces.end() && *it == _nonce)
     {
         return;
     }
-    // remove the expired nonces
-    if (!m_blockNonceCache.count(batchToBeRemoved))
+    blockNonces.nonces.insert(it, _nonce);
+    m_noncesSize++;
+    updateFilter(_nonce, true);
+}
+
+void LedgerNonceChecker::remove(NonceType const& _nonce)
+{
+    if (!mayExist(_nonce))
     {
-        NONCECHECKER_LOG(WARNING) << LOG_DESC("batchInsert: miss cache when remove expired cache")
-                                  << LOG_KV("batchToBeRemoved", batchToBeRemoved);
         return;
     }
-    auto nonceList = m_blockNonceCache[batchToBeRemoved];
-    m_blockNonceCache.erase(batchToBeRemoved);
-    batchRemove(*nonceList);
-    NONCECHECKER_LOG(DEBUG) << LOG_DESC("batchInsert: remove expired nonce")
-                            << LOG_KV("batchToBeRemoved", batchToBeRemoved)
-                            << LOG_KV("nonceSize", nonceList->size());
-}
\ No newline at end of file
+    for (auto& blockNonces : m_blockNonces)
+    {
+        auto it = std::lower_bound(blockNonces.nonces.begin(), blockNonces.nonces.end(), _nonce);
+        if (it != blockNonces.nonces.end() && *it == _nonce)
+        {
+            blockNonces.nonces.erase(it);
+            m_noncesSize--;
+            updateFilter(_nonce, false);
+            return;
+        }
+    }
+}
+
+void LedgerNonceChecker::batchRemove(NonceList const& _nonceList)
+{
+    WriteGuard l(x_blockNonceCache);
+    for (auto const& nonce : _nonceList)
+    {
+        remove(nonce);
+    }
+}
+
+void LedgerNonceChecker::batchRemove(tbb::concurrent_set<NonceType> const& _nonceList)
+{
+    WriteGuard l(x_blockNonceCache);
+    for (auto const& nonce : _nonceList)
+    {
+        remove(nonce);
+    }
+}
@@ -19,20 +19,24 @@
  * @date 2021-05-10
  */
 #pragma once
-#include "bcos-txpool/txpool/validator/TxPoolNonceChecker.h"
+#include "bcos-txpool/txpool/interfaces/NonceCheckerInterface.h"
 #include <bcos-framework/ledger/LedgerInterface.h>
+#include <bcos-utilities/Common.h>
 
 namespace bcos
 {
 namespace txpool
 {
-class LedgerNonceChecker : public TxPoolNonceChecker
+class LedgerNonceChecker : public NonceCheckerInterface
 {
 public:
     LedgerNonceChecker(
         std::shared_ptr<std::map<int64_t, bcos::protocol::NonceListPtr> > _initialNonces,
         bcos::protocol::BlockNumber _blockNumber, int64_t _blockLimit)
-      : TxPoolNonceChecker(), m_blockNumber(_blockNumber), m_blockLimit(_blockLimit)
+      : m_blockNumber(_blockNumber),
+        m_blockLimit(_blockLimit),
+        m_blockNonces(std::max(_blockLimit, (int64_t)1)),
+        m_nonceFilter(c_minFilterSize, 0)
     {
         if (_initialNonces)
         {
@@ -41,25 +45,51 @@ public:
     }
     bcos::protocol::TransactionStatus checkNonce(
         bcos::protocol::Transaction::ConstPtr _tx, bool _shouldUpdate = false) override;
+    bool exists(bcos::protocol::NonceType const& _nonce) override;
 
     void batchInsert(
         bcos::protocol::BlockNumber _batchId, bcos::protocol::NonceListPtr _nonceList) override;
+    void batchRemove(bcos::protocol::NonceList const& _nonceList) override;
+    void batchRemove(tbb::concurrent_set<bcos::protocol::NonceType> const& _nonceList) override;
+    void insert(bcos::protocol::NonceType const& _nonce) override;
 
 protected:
     virtual bcos::protocol::TransactionStatus checkBlockLimit(
         bcos::protocol::Transaction::ConstPtr _tx);
     virtual void initNonceCache(std::map<int64_t, bcos::protocol::NonceListPtr> _initialNonces);
 
+    void remove(bcos::protocol::NonceType const& _nonce) override;
+
 private:
+    // the sorted nonces of a block
+    struct BlockNonces
+    {
+        bcos::protocol::BlockNumber number = -1;
+        bcos::protocol::NonceList nonces;
+    };
+
+    bool mayExist(bcos::protocol::NonceType const& _nonce) const;
+    bool existsWithoutLock(bcos::protocol::NonceType const& _nonce) const;
+    void updateFilter(bcos::protocol::NonceType const& _nonce, bool _insert);
+    void resizeFilter();
+    template <class F>
+    void forEachFilterIndex(bcos::protocol::NonceType const& _nonce, F&& _f) const;
+
     std::atomic<bcos::protocol::BlockNumber> m_blockNumber = {0};
     int64_t m_blockLimit;
 
-    /// cache the block nonce to in case of accessing the DB to get nonces of given block frequently
-    /// key: block number
-    /// value: all the nonces of a given block
-    /// we cache at most m_blockLimit entries(occuppy about 32KB)
-    std::map<int64_t, bcos::protocol::NonceListPtr> m_blockNonceCache;
+    /// cache the nonces of the latest m_blockLimit blocks in case of accessing the DB frequently
+    /// the nonces of block n is cached in slot n % m_blockLimit, so the nonces of the expired
+    /// block are dropped in bulk when the slot is reused
+    std::vector<BlockNonces> m_blockNonces;
+    /// counting bloom filter of all the cached nonces, the slots are only searched on hit
+    std::vector<uint8_t> m_nonceFilter;
+    size_t m_noncesSize = 0;
     mutable SharedMutex x_blockNonceCache;
+
+    static constexpr size_t c_minFilterSize = 1 << 16;
+    static constexpr size_t c_filterCountersPerNonce = 16;
+    static constexpr size_t c_filterHashNum = 4;
 };
 }  // namespace txpool
-}  // namespace bcos
\ No newline at end of file
+}  // namespace bcos
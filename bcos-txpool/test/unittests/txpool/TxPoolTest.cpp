@@ -19,6 +19,7 @@
  * @date 2021-05-26
  */
 #include "bcos-crypto/interfaces/crypto/KeyPairInterface.h"
+#include "bcos-txpool/txpool/validator/LedgerNonceChecker.h"
 #include "test/unittests/txpool/TxPoolFixture.h"
 #include <bcos-crypto/hash/Keccak256.h>
 #include <bcos-crypto/hash/SM3.h>
@@ -497,6 +498,46 @@ void txPoolInitAndSubmitTransactionTest(bool _sm, CryptoSuite::Ptr _cryptoSuite)
     checkTxSubmit(txpool, txpoolStorage, tx, tx->hash(),
         (uint32_t)TransactionStatus::AlreadyInTxPool, importedTxNum);
 
+    // case9: submit txs in one batch, the txs are verified in parallel and inserted in order
+    {
+        auto batchTx = fakeTransaction(_cryptoSuite, utcTime() + 3000000,
+            ledger->blockNumber() + blockLimit - 4, faker->chainId(), faker->groupId());
+        batchTx->setStoreToBackend(true);
+        auto encode = [](Transaction::Ptr _tx) {
+            bcos::bytes encodedData;
+            _tx->encode(encodedData);
+            return std::make_shared<bytes>(encodedData.begin(), encodedData.end());
+        };
+        auto malformedData = encode(batchTx);
+        for (size_t i = 0; i < malformedData->size(); i++)
+        {
+            (*malformedData)[i] += 100;
+        }
+        std::vector<uint32_t> expectedStatus = {(uint32_t)TransactionStatus::None,
+            (uint32_t)TransactionStatus::AlreadyInTxPool, (uint32_t)TransactionStatus::Malform,
+            (uint32_t)TransactionStatus::AlreadyInTxPool};
+        // the callback of the submitted tx is called after it is committed
+        auto status =
+            std::make_shared<std::vector<std::atomic_uint32_t>>(expectedStatus.size());
+        std::vector<std::pair<bytesPointer, TxSubmitCallback>> batch;
+        for (auto txData : {encode(batchTx), encode(tx), malformedData, encode(batchTx)})
+        {
+            auto index = batch.size();
+            (*status)[index] = (uint32_t)TransactionStatus::None;
+            batch.emplace_back(
+                txData, [status, index](Error::Ptr, TransactionSubmitResult::Ptr _result) {
+                    (*status)[index] = _result->status();
+                });
+        }
+        txpoolStorage->batchSubmitTransactions(batch);
+        for (size_t i = 1; i < expectedStatus.size(); i++)
+        {
+            BOOST_CHECK_EQUAL((*status)[i].load(), expectedStatus[i]);
+        }
+        importedTxNum++;
+        BOOST_CHECK(txpoolStorage->size() == importedTxNum);
+    }
+
     // batch import transactions with multiple thread
     auto threadPool = std::make_shared<ThreadPool>("txpoolSubmitter", 8);
 
@@ -536,12 +577,12 @@ void txPoolInitAndSubmitTransactionTest(bool _sm, CryptoSuite::Ptr _cryptoSuite)
             std::this_thread::sleep_for(std::chrono::milliseconds(2));
         }
     }
-    // case9: the txpool is full
+    // case10: the txpool is full
     txpoolConfig->setPoolLimit(importedTxNum);
     checkTxSubmit(txpool, txpoolStorage, tx, tx->hash(), (uint32_t)TransactionStatus::TxPoolIsFull,
         importedTxNum);
 
-    // case10: malformed transaction
+    // case11: malformed transaction
     bcos::bytes encodedData;
     tx->encode(encodedData);
     auto txData = std::make_shared<bytes>(encodedData.begin(), encodedData.end());
@@ -631,6 +672,60 @@ BOOST_AUTO_TEST_CASE(fillWithSubmit)
     //     });
     // fillPromise.get_future().get();
 }
+
+BOOST_AUTO_TEST_CASE(testLedgerNonceChecker)
+{
+    int64_t blockLimit = 5;
+    auto initialNonces = std::make_shared<std::map<int64_t, NonceListPtr>>();
+    for (int64_t i = 1; i <= blockLimit; i++)
+    {
+        auto nonceList = std::make_shared<NonceList>();
+        for (int64_t j = 0; j < 100; j++)
+        {
+            nonceList->emplace_back(i * 1000 + j);
+        }
+        (*initialNonces)[i] = nonceList;
+    }
+    auto nonceChecker = std::make_shared<LedgerNonceChecker>(initialNonces, blockLimit, blockLimit);
+    for (auto const& it : *initialNonces)
+    {
+        for (auto const& nonce : *(it.second))
+        {
+            BOOST_CHECK(nonceChecker->exists(nonce));
+        }
+    }
+    BOOST_CHECK(!nonceChecker->exists(NonceType(100)));
+
+    // the nonces of the expired blocks are dropped, the filter grows with the nonces
+    for (int64_t i = blockLimit + 1; i <= 4 * blockLimit; i++)
+    {
+        auto nonceList = std::make_shared<NonceList>();
+        for (int64_t j = 0; j < 10000; j++)
+        {
+            nonceList->emplace_back(NonceType(i) * 1000000 + j);
+        }
+        nonceChecker->batchInsert(i, nonceList);
+    }
+    for (auto const& it : *initialNonces)
+    {
+        for (auto const& nonce : *(it.second))
+        {
+            BOOST_CHECK(!nonceChecker->exists(nonce));
+        }
+    }
+    for (int64_t i = blockLimit + 1; i <= 4 * blockLimit; i++)
+    {
+        auto expired = (i <= 3 * blockLimit);
+        BOOST_CHECK(nonceChecker->exists(NonceType(i) * 1000000 + 1) != expired);
+    }
+
+    // remove and insert the nonces
+    auto nonce = NonceType(4 * blockLimit) * 1000000 + 1;
+    nonceChecker->batchRemove(NonceList{nonce});
+    BOOST_CHECK(!nonceChecker->exists(nonce));
+    nonceChecker->insert(nonce);
+    BOOST_CHECK(nonceChecker->exists(nonce));
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace bcos
\ No newline at end of file
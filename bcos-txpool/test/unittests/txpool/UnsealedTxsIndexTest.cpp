@@ -0,0 +1,95 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ * @brief unit test for the index of the unsealed txs
+ * @file UnsealedTxsIndexTest.cpp
+ */
+#include "bcos-txpool/txpool/storage/UnsealedTxsIndex.h"
+#include <bcos-crypto/hash/Keccak256.h>
+#include <bcos-crypto/interfaces/crypto/CryptoSuite.h>
+#include <bcos-crypto/signature/secp256k1/Secp256k1Crypto.h>
+#include <bcos-protocol/testutils/protocol/FakeTransaction.h>
+#include <bcos-utilities/testutils/TestPromptFixture.h>
+#include <boost/test/unit_test.hpp>
+using namespace bcos;
+using namespace bcos::txpool;
+using namespace bcos::protocol;
+using namespace bcos::crypto;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(UnsealedTxsIndexTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testTraverseInPriorityOrder)
+{
+    auto cryptoSuite = std::make_shared<CryptoSuite>(
+        std::make_shared<Keccak256>(), std::make_shared<Secp256k1Crypto>(), nullptr);
+    UnsealedTxsIndex index(4);
+    std::vector<Transaction::Ptr> txs;
+    // import the txs in reverse order
+    for (int64_t i = 0; i < 20; i++)
+    {
+        auto tx = fakeTransaction(cryptoSuite, utcTime() + i);
+        tx->setImportTime(1000 - i);
+        index.insert(tx);
+        txs.emplace_back(tx);
+    }
+    BOOST_CHECK_EQUAL(index.size(), 20);
+
+    // the earliest imported txs are visited first, skipped txs are kept
+    std::vector<int64_t> visited;
+    index.traverse([&](Transaction::ConstPtr const& _tx) {
+        visited.emplace_back(_tx->importTime());
+        if (_tx->importTime() % 2 == 0)
+        {
+            return UnsealedTxsIndex::Visit::Keep;
+        }
+        return _tx->importTime() >= 989 ? UnsealedTxsIndex::Visit::EraseAndStop :
+                                          UnsealedTxsIndex::Visit::Erase;
+    });
+    BOOST_CHECK_EQUAL(visited.size(), 9);
+    BOOST_CHECK(std::is_sorted(visited.begin(), visited.end()));
+    BOOST_CHECK_EQUAL(visited.front(), 981);
+    BOOST_CHECK_EQUAL(index.size(), 15);
+
+    // erase and re-insert the txs
+    index.erase(*txs[0]);
+    index.erase(*txs[0]);
+    BOOST_CHECK_EQUAL(index.size(), 14);
+    index.insert(txs[0]);
+    index.insert(txs[0]);
+    BOOST_CHECK_EQUAL(index.size(), 15);
+
+    // order by a custom priority, the latest imported txs first
+    index.setPriority([](Transaction const& _tx) { return -_tx.importTime(); });
+    BOOST_CHECK_EQUAL(index.size(), 0);
+    for (auto const& tx : txs)
+    {
+        index.insert(tx);
+    }
+    visited.clear();
+    index.traverse([&](Transaction::ConstPtr const& _tx) {
+        visited.emplace_back(_tx->importTime());
+        return UnsealedTxsIndex::Visit::Erase;
+    });
+    BOOST_CHECK_EQUAL(visited.size(), 20);
+    BOOST_CHECK(std::is_sorted(visited.rbegin(), visited.rend()));
+    BOOST_CHECK_EQUAL(index.size(), 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
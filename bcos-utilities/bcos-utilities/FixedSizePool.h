@@ -0,0 +1,198 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @brief: a pool of fixed size memory blocks allocated in large chunks
+ *  @file FixedSizePool.h
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace bcos
+{
+/// Thread safe pool of fixed size memory blocks, for the objects allocated and freed in large
+/// numbers, e.g. the messages of every transaction in a block.
+/// The blocks are carved out of chunks of CHUNK_BLOCKS blocks and are recycled rather than returned
+/// to the system. Every thread keeps a small list of free blocks, only refilling it from or
+/// flushing it to the shared list takes the lock, BATCH_BLOCKS blocks at a time, so the blocks
+/// allocated by one thread and freed by another flow back through the shared list.
+template <size_t BlockSize>
+class FixedSizePool
+{
+public:
+    constexpr static size_t BATCH_BLOCKS = 64;
+    constexpr static size_t CHUNK_BLOCKS = 1024;
+
+    FixedSizePool(const FixedSizePool&) = delete;
+    FixedSizePool& operator=(const FixedSizePool&) = delete;
+    FixedSizePool(FixedSizePool&&) = delete;
+    FixedSizePool& operator=(FixedSizePool&&) = delete;
+
+    // never destroyed, the blocks may be freed by the destructors of other static objects
+    static FixedSizePool& instance()
+    {
+        static auto* pool = new FixedSizePool();
+        return *pool;
+    }
+
+    void* allocate()
+    {
+        auto& cache = localCache();
+        if (!cache.head)
+        {
+            refill(cache);
+        }
+        auto* block = cache.head;
+        cache.head = block->next;
+        --cache.size;
+        return block;
+    }
+
+    void deallocate(void* _p)
+    {
+        auto& cache = localCache();
+        auto* block = static_cast<Block*>(_p);
+        block->next = cache.head;
+        cache.head = block;
+        if (++cache.size >= BATCH_BLOCKS * 2)
+        {
+            flush(cache, BATCH_BLOCKS);
+        }
+    }
+
+    // the blocks allocated from the system
+    size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(x_mutex);
+        return m_chunks.size() * CHUNK_BLOCKS;
+    }
+
+private:
+    union Block
+    {
+        Block* next;
+        alignas(std::max_align_t) std::byte data[BlockSize];
+    };
+    struct Chunk
+    {
+        Block blocks[CHUNK_BLOCKS];
+    };
+    struct LocalCache
+    {
+        Block* head = nullptr;
+        size_t size = 0;
+
+        ~LocalCache()
+        {
+            if (head)
+            {
+                FixedSizePool::instance().flush(*this, size);
+            }
+        }
+    };
+
+    FixedSizePool() = default;
+    ~FixedSizePool() = default;
+
+    static LocalCache& localCache()
+    {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+
+    void refill(LocalCache& _cache)
+    {
+        std::lock_guard<std::mutex> lock(x_mutex);
+        if (!m_freeBlocks)
+        {
+            auto& chunk = m_chunks.emplace_back(std::make_unique<Chunk>());
+            for (auto& block : chunk->blocks)
+            {
+                block.next = m_freeBlocks;
+                m_freeBlocks = &block;
+            }
+            m_freeSize += CHUNK_BLOCKS;
+        }
+        auto count = std::min(m_freeSize, BATCH_BLOCKS);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto* block = m_freeBlocks;
+            m_freeBlocks = block->next;
+            block->next = _cache.head;
+            _cache.head = block;
+        }
+        m_freeSize -= count;
+        _cache.size += count;
+    }
+
+    void flush(LocalCache& _cache, size_t _count)
+    {
+        // unlink the blocks before taking the lock
+        auto* first = _cache.head;
+        auto* last = first;
+        for (size_t i = 1; i < _count; ++i)
+        {
+            last = last->next;
+        }
+        _cache.head = last->next;
+        _cache.size -= _count;
+
+        std::lock_guard<std::mutex> lock(x_mutex);
+        last->next = m_freeBlocks;
+        m_freeBlocks = first;
+        m_freeSize += _count;
+    }
+
+    mutable std::mutex x_mutex;
+    Block* m_freeBlocks = nullptr;
+    size_t m_freeSize = 0;
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+};
+
+/// Allocate the objects of T and its subclasses of the same size from the FixedSizePool, by
+/// inheriting PoolAllocated<T>; larger subclasses fall back to the global operator new.
+/// Also works when the objects are deleted through a base class with a virtual destructor.
+template <class T>
+struct PoolAllocated
+{
+    static void* operator new(size_t _size)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned type");
+        if (_size != sizeof(T))
+        {
+            return ::operator new(_size);
+        }
+        return FixedSizePool<sizeof(T)>::instance().allocate();
+    }
+
+    static void operator delete(void* _p, size_t _size)
+    {
+        if (!_p)
+        {
+            return;
+        }
+        if (_size != sizeof(T))
+        {
+            ::operator delete(_p);
+            return;
+        }
+        FixedSizePool<sizeof(T)>::instance().deallocate(_p);
+    }
+};
+}  // namespace bcos
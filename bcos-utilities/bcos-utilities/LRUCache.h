@@ -0,0 +1,198 @@
+/*
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @brief: a size bounded LRU cache, sharded by the hash of the keys
+ *  @file LRUCache.h
+ */
+#pragma once
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bcos
+{
+/// Thread safe LRU cache bounded by the total size of the items, every item is charged the size
+/// given by the caller, 1 by default to bound the number of the items.
+/// The items are spread over shardCount shards by the hash of the key, every shard has its own
+/// lock and an equal share of the capacity, the least recently used items of a shard are evicted
+/// when the shard is full. The values are returned by copy, they are usually shared pointers to
+/// immutable data.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache
+{
+public:
+    using Ptr = std::shared_ptr<LRUCache>;
+    // called with the evicted item under the lock of its shard, not called for the items erased
+    // or replaced
+    using EvictHandler = std::function<void(const Key&, const Value&)>;
+
+    explicit LRUCache(size_t capacity, size_t shardCount = 1, EvictHandler evictHandler = nullptr)
+      : m_shards(shardCount > 0 ? shardCount : 1), m_evictHandler(std::move(evictHandler))
+    {
+        for (auto& shard : m_shards)
+        {
+            shard.capacity = capacity / m_shards.size();
+        }
+    }
+
+    LRUCache(const LRUCache&) = delete;
+    LRUCache& operator=(const LRUCache&) = delete;
+
+    std::optional<Value> get(const Key& key)
+    {
+        auto& shard = getShard(key);
+        std::unique_lock lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+        {
+            ++m_misses;
+            return std::nullopt;
+        }
+        shard.items.splice(shard.items.begin(), shard.items, it->second);
+        ++m_hits;
+        return it->second->value;
+    }
+
+    // the version is increased before the cached values are invalidated, a value read from the
+    // backend before that must not be inserted
+    uint64_t version() const { return m_version; }
+    void increaseVersion() { ++m_version; }
+
+    // replaces the cached value of key; version is the version() before the value was read, the
+    // value is dropped if it changed since then; returns false if the value is not cached
+    bool insert(Key key, Value value, size_t size = 1, std::optional<uint64_t> version = {})
+    {
+        return put(std::move(key), std::move(value), size, version, true);
+    }
+    // keeps the cached value of key if any, returns false if the value is not cached
+    bool tryInsert(Key key, Value value, size_t size = 1)
+    {
+        return put(std::move(key), std::move(value), size, std::nullopt, false);
+    }
+
+    void erase(const Key& key)
+    {
+        auto& shard = getShard(key);
+        std::unique_lock lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+        {
+            shard.size -= it->second->size;
+            shard.items.erase(it->second);
+            shard.index.erase(it);
+        }
+    }
+
+    void clear()
+    {
+        for (auto& shard : m_shards)
+        {
+            std::unique_lock lock(shard.mutex);
+            shard.index.clear();
+            shard.items.clear();
+            shard.size = 0;
+        }
+    }
+
+    // the total size of the cached items
+    size_t size() const
+    {
+        size_t total = 0;
+        for (auto& shard : m_shards)
+        {
+            std::unique_lock lock(shard.mutex);
+            total += shard.size;
+        }
+        return total;
+    }
+
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+    uint64_t evictions() const { return m_evictions; }
+
+private:
+    struct Item
+    {
+        Key key;
+        Value value;
+        size_t size;
+    };
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        // the most recently used item is at the front
+        std::list<Item> items;
+        std::unordered_map<Key, typename std::list<Item>::iterator, Hash> index;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    Shard& getShard(const Key& key) { return m_shards[Hash{}(key) % m_shards.size()]; }
+
+    bool put(Key key, Value value, size_t size, std::optional<uint64_t> version, bool replace)
+    {
+        auto& shard = getShard(key);
+        if (size > shard.capacity)
+        {
+            return false;
+        }
+        std::unique_lock lock(shard.mutex);
+        if (version && *version != m_version)
+        {
+            return false;
+        }
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+        {
+            if (!replace)
+            {
+                return false;
+            }
+            shard.size -= it->second->size;
+            shard.items.erase(it->second);
+            shard.index.erase(it);
+        }
+        shard.items.push_front(Item{std::move(key), std::move(value), size});
+        shard.index.emplace(shard.items.front().key, shard.items.begin());
+        shard.size += size;
+        while (shard.size > shard.capacity)
+        {
+            auto& last = shard.items.back();
+            if (m_evictHandler)
+            {
+                m_evictHandler(last.key, last.value);
+            }
+            shard.size -= last.size;
+            shard.index.erase(last.key);
+            shard.items.pop_back();
+            ++m_evictions;
+        }
+        return true;
+    }
+
+    std::vector<Shard> m_shards;
+    EvictHandler m_evictHandler;
+    std::atomic_uint64_t m_hits{0};
+    std::atomic_uint64_t m_misses{0};
+    std::atomic_uint64_t m_evictions{0};
+    std::atomic_uint64_t m_version{0};
+};
+}  // namespace bcos
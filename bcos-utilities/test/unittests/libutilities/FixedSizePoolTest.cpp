@@ -0,0 +1,121 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file FixedSizePoolTest.cpp
+ */
+
+#include "bcos-utilities/FixedSizePool.h"
+#include "bcos-utilities/testutils/TestPromptFixture.h"
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bcos;
+
+namespace bcos
+{
+namespace test
+{
+namespace
+{
+struct Message
+{
+    virtual ~Message() = default;
+    std::string from;
+};
+struct PooledMessage : public Message, public PoolAllocated<PooledMessage>
+{
+    std::string to;
+};
+// larger than PooledMessage, allocated by the global operator new
+struct LargeMessage : public PooledMessage
+{
+    std::string data;
+};
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(FixedSizePoolTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testRecycle)
+{
+    auto& pool = FixedSizePool<48>::instance();
+    std::vector<void*> blocks;
+    std::set<void*> distinct;
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        blocks.push_back(pool.allocate());
+        distinct.insert(blocks.back());
+    }
+    BOOST_CHECK_EQUAL(distinct.size(), 3000);
+    auto capacity = pool.capacity();
+    BOOST_CHECK_GE(capacity, 3000);
+    BOOST_CHECK_EQUAL(capacity % FixedSizePool<48>::CHUNK_BLOCKS, 0);
+
+    // the blocks are reused, no more chunk is allocated
+    for (auto* block : blocks)
+    {
+        pool.deallocate(block);
+    }
+    blocks.clear();
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        blocks.push_back(pool.allocate());
+    }
+    BOOST_CHECK_EQUAL(pool.capacity(), capacity);
+    for (auto* block : blocks)
+    {
+        pool.deallocate(block);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testFreeByOtherThreads)
+{
+    auto& pool = FixedSizePool<sizeof(PooledMessage)>::instance();
+    std::vector<std::unique_ptr<Message>> messages;
+    for (size_t round = 0; round < 10; ++round)
+    {
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            auto message = std::make_unique<PooledMessage>();
+            message->from = std::to_string(i);
+            message->to = std::string(64, 'a');
+            messages.emplace_back(std::move(message));
+        }
+        messages.emplace_back(std::make_unique<LargeMessage>());
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; ++t)
+        {
+            std::vector<std::unique_ptr<Message>> part;
+            for (size_t i = t; i < messages.size(); i += 4)
+            {
+                part.emplace_back(std::move(messages[i]));
+            }
+            threads.emplace_back([part = std::move(part)]() mutable { part.clear(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        messages.clear();
+    }
+    // the blocks freed by the other threads are allocated again
+    BOOST_CHECK_LE(pool.capacity(), 2 * FixedSizePool<sizeof(PooledMessage)>::CHUNK_BLOCKS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
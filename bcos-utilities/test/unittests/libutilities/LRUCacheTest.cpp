@@ -0,0 +1,131 @@
+/**
+ *  Copyright (C) 2022 FISCO BCOS.
+ *  SPDX-License-Identifier: Apache-2.0
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  @file LRUCacheTest.cpp
+ */
+
+#include "bcos-utilities/LRUCache.h"
+#include "bcos-utilities/testutils/TestPromptFixture.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bcos;
+
+namespace bcos
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(LRUCacheTest, TestPromptFixture)
+
+BOOST_AUTO_TEST_CASE(testGetAndInsert)
+{
+    LRUCache<std::string, std::string> cache(10);
+    BOOST_CHECK(!cache.get("k1"));
+    BOOST_CHECK_EQUAL(cache.misses(), 1);
+
+    BOOST_CHECK(cache.insert("k1", "v1", 4));
+    BOOST_CHECK_EQUAL(cache.get("k1").value(), "v1");
+    BOOST_CHECK_EQUAL(cache.hits(), 1);
+    BOOST_CHECK_EQUAL(cache.size(), 4);
+
+    // insert replaces the cached value, tryInsert keeps it
+    BOOST_CHECK(cache.insert("k1", "v2", 5));
+    BOOST_CHECK_EQUAL(cache.get("k1").value(), "v2");
+    BOOST_CHECK_EQUAL(cache.size(), 5);
+    BOOST_CHECK(!cache.tryInsert("k1", "v3", 4));
+    BOOST_CHECK_EQUAL(cache.get("k1").value(), "v2");
+    BOOST_CHECK_EQUAL(cache.size(), 5);
+
+    // the item larger than the capacity is not cached
+    BOOST_CHECK(!cache.insert("k2", "v", 11));
+    BOOST_CHECK(!cache.get("k2"));
+
+    cache.erase("k1");
+    BOOST_CHECK(!cache.get("k1"));
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testEvict)
+{
+    std::vector<int> evicted;
+    LRUCache<int, std::string> cache(
+        10, 1, [&evicted](int const& key, std::string const&) { evicted.push_back(key); });
+    cache.insert(1, "a", 4);
+    cache.insert(2, "b", 4);
+    // 1 is used more recently than 2
+    BOOST_CHECK(cache.get(1));
+    cache.insert(3, "c", 4);
+    BOOST_CHECK(cache.get(1));
+    BOOST_CHECK(!cache.get(2));
+    BOOST_CHECK(cache.get(3));
+    BOOST_CHECK_EQUAL(cache.size(), 8);
+    BOOST_CHECK_EQUAL(cache.evictions(), 1);
+    BOOST_CHECK(evicted == std::vector<int>{2});
+
+    // the erased and replaced items are not reported
+    cache.insert(1, "d", 2);
+    cache.erase(3);
+    BOOST_CHECK_EQUAL(cache.evictions(), 1);
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK(!cache.get(1));
+}
+
+BOOST_AUTO_TEST_CASE(testVersion)
+{
+    LRUCache<std::string, std::string> cache(1024);
+    auto version = cache.version();
+    BOOST_CHECK(cache.insert("k1", "v1", 1, version));
+
+    // a value read before the invalidation must not be inserted
+    cache.increaseVersion();
+    cache.erase("k1");
+    BOOST_CHECK(!cache.insert("k1", "stale", 1, version));
+    BOOST_CHECK(!cache.get("k1"));
+    BOOST_CHECK(cache.insert("k1", "v2", 1, cache.version()));
+    BOOST_CHECK_EQUAL(cache.get("k1").value(), "v2");
+}
+
+BOOST_AUTO_TEST_CASE(testShards)
+{
+    // every shard has 256 of the capacity
+    LRUCache<int, int> cache(1024, 4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 1000; ++i)
+            {
+                cache.insert(t * 1000 + i, i, 32);
+                cache.get(t * 1000 + i / 2);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_CHECK_LE(cache.size(), 1024);
+    BOOST_CHECK_GT(cache.evictions(), 0);
+    BOOST_CHECK_EQUAL(cache.hits() + cache.misses(), 4000);
+    // an item larger than the share of a shard is not cached
+    BOOST_CHECK(!cache.insert(-1, 0, 257));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace bcos
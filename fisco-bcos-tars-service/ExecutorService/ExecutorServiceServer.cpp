@@ -145,6 +145,33 @@ bcostars::Error ExecutorServiceServer::dmcExecuteTransactions(std::string const&
     return bcostars::Error();
 }
 
+bcostars::Error ExecutorServiceServer::batchDmcExecuteTransactions(
+    std::vector<bcostars::ExecutionMessage> const& _inputs,
+    std::vector<bcostars::ExecutionMessage>&, tars::TarsCurrentPtr _current)
+{
+    _current->setResponse(false);
+    auto executionMessages =
+        std::make_shared<std::vector<bcos::protocol::ExecutionMessage::UniquePtr>>();
+    for (auto const& input : _inputs)
+    {
+        auto msg = std::make_unique<bcostars::protocol::ExecutionMessageImpl>(
+            [m_message = input]() mutable { return &m_message; });
+        executionMessages->emplace_back(std::move(msg));
+    }
+    m_executor->batchDmcExecuteTransactions(*executionMessages,
+        [_current](bcos::Error::UniquePtr _error,
+            std::vector<bcos::protocol::ExecutionMessage::UniquePtr> _outputs) {
+            std::vector<bcostars::ExecutionMessage> tarsOutputs;
+            for (auto const& it : _outputs)
+            {
+                tarsOutputs.emplace_back(toTarsMessage(it));
+            }
+            async_response_batchDmcExecuteTransactions(
+                _current, toTarsError(std::move(_error)), std::move(tarsOutputs));
+        });
+    return bcostars::Error();
+}
+
 bcostars::Error ExecutorServiceServer::dagExecuteTransactions(
     std::vector<bcostars::ExecutionMessage> const& _inputs,
     std::vector<bcostars::ExecutionMessage>&, tars::TarsCurrentPtr _current)
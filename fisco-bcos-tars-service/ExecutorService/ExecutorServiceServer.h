@@ -53,6 +53,9 @@ public:
     bcostars::Error dmcExecuteTransactions(std::string const& _contractAddress,
         std::vector<bcostars::ExecutionMessage> const& _inputs,
         std::vector<bcostars::ExecutionMessage>& _ouptputs, tars::TarsCurrentPtr _current) override;
+    bcostars::Error batchDmcExecuteTransactions(
+        std::vector<bcostars::ExecutionMessage> const& _inputs,
+        std::vector<bcostars::ExecutionMessage>& _ouptputs, tars::TarsCurrentPtr _current) override;
     bcostars::Error dagExecuteTransactions(std::vector<bcostars::ExecutionMessage> const& _inputs,
         std::vector<bcostars::ExecutionMessage>& _ouptputs, tars::TarsCurrentPtr _current) override;
     bcostars::Error dmcCall(bcostars::ExecutionMessage const& _input,
@@ -139,6 +139,7 @@ void ExecutorServiceApp::createAndInitExecutor()
         m_txpool, cache, storage, executionMessageFactory,
         m_protocolInitializer->cryptoSuite()->hashImpl(), m_nodeConfig->isWasm(),
         m_nodeConfig->isAuthCheck(), m_nodeConfig->keyPageSize(), "executor");
+    executorFactory->setOccExecute(m_nodeConfig->isOccExecute());
 
     m_executor = std::make_shared<bcos::executor::SwitchExecutorManager>(executorFactory);
 
@@ -33,6 +33,7 @@
 #include "bcos-crypto/hasher/OpenSSLHasher.h"
 #include "bcos-executor/src/executor/SwitchExecutorManager.h"
 #include "bcos-framework/storage/StorageInterface.h"
+#include "bcos-table/src/KeyPageStorage.h"
 #include <bcos-crypto/interfaces/crypto/CommonType.h>
 #include <bcos-crypto/signature/key/KeyFactoryImpl.h>
 #include <bcos-framework/executor/NativeExecutionMessage.h>
@@ -144,9 +145,14 @@ void Initializer::init(bcos::protocol::NodeArchitectureType _nodeArchType,
     bcos::storage::TransactionalStorageInterface::Ptr consensusStorage = nullptr;
     if (boost::iequals(m_nodeConfig->storageType(), "RocksDB"))
     {
+        bcos::storage::RocksDBProfile profile;
+        profile.enableColumnFamily = m_nodeConfig->enableColumnFamily();
+        profile.stateBlockCacheSize = m_nodeConfig->stateBlockCacheSize();
+        profile.historyBlockCacheSize = m_nodeConfig->historyBlockCacheSize();
+        profile.historyUniversalCompaction = m_nodeConfig->historyUniversalCompaction();
         // m_protocolInitializer->dataEncryption() will return nullptr when storage_security = false
-        storage = StorageInitializer::build(
-            storagePath, m_protocolInitializer->dataEncryption(), m_nodeConfig->keyPageSize());
+        storage = StorageInitializer::build(storagePath, m_protocolInitializer->dataEncryption(),
+            m_nodeConfig->keyPageSize(), profile);
         schedulerStorage = storage;
         consensusStorage = StorageInitializer::build(
             consensusStoragePath, m_protocolInitializer->dataEncryption());
@@ -198,6 +204,7 @@ void Initializer::init(bcos::protocol::NodeArchitectureType _nodeArchType,
         m_txpoolInitializer->txpool(), m_protocolInitializer->txResultFactory(),
         m_protocolInitializer->cryptoSuite()->hashImpl(), m_nodeConfig->isAuthCheck(),
         m_nodeConfig->isWasm(), m_nodeConfig->isSerialExecute());
+    factory->setOccExecute(m_nodeConfig->isOccExecute());
 
     int64_t schedulerSeq = 0;  // In Max node, this seq will be update after consensus module switch
                                // to a leader during startup
@@ -217,6 +224,7 @@ void Initializer::init(bcos::protocol::NodeArchitectureType _nodeArchType,
     {
         INITIALIZER_LOG(INFO) << LOG_DESC("initNode: disableLRUCacheStorage");
     }
+    std::shared_ptr<const std::set<std::string, std::less<>>> keyPageIgnoreTables;
 
     if (_nodeArchType == bcos::protocol::NodeArchitectureType::MAX)
     {
@@ -239,6 +247,8 @@ void Initializer::init(bcos::protocol::NodeArchitectureType _nodeArchType,
             m_ledger, m_txpoolInitializer->txpool(), cache, storage, executionMessageFactory,
             m_protocolInitializer->cryptoSuite()->hashImpl(), m_nodeConfig->isWasm(),
             m_nodeConfig->isAuthCheck(), m_nodeConfig->keyPageSize(), executorName);
+        executorFactory->setOccExecute(m_nodeConfig->isOccExecute());
+        keyPageIgnoreTables = executorFactory->keyPageIgnoreTables();
         auto parallelExecutor =
             std::make_shared<bcos::executor::SwitchExecutorManager>(executorFactory);
         executorManager->addExecutor(executorName, parallelExecutor);
@@ -270,6 +280,26 @@ void Initializer::init(bcos::protocol::NodeArchitectureType _nodeArchType,
                 INITIALIZER_LOG(INFO) << LOG_DESC("registerNode") << LOG_KV("group", groupID)
                                       << LOG_KV("node", nodeID->hex()) << LOG_KV("type", _type);
             });
+        // the nonces of the latest blockLimit blocks are exported to check the replayed txs, the
+        // key pages written in the boost format are exported in the flat format
+        if (m_nodeConfig->snapshotInterval() > 0)
+        {
+            sync::StateSnapshotExporter::ValueNormalizer normalizer;
+            if (m_nodeConfig->keyPageSize() > 0 && keyPageIgnoreTables)
+            {
+                normalizer = [keyPageIgnoreTables](std::string_view _table, std::string_view _key,
+                                 std::string_view _value) -> std::optional<std::string> {
+                    // the current state is written by the ledger, not in key pages
+                    if (_table == ledger::SYS_CURRENT_STATE || keyPageIgnoreTables->count(_table))
+                    {
+                        return std::nullopt;
+                    }
+                    return bcos::storage::KeyPageStorage::toFlatValue(_key, _value);
+                };
+            }
+            blockSync->enableStateSnapshot(storage, m_nodeConfig->snapshotInterval(),
+                (bcos::protocol::BlockNumber)m_nodeConfig->blockLimit(), std::move(normalizer));
+        }
     }
     else
     {
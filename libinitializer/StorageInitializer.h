@@ -28,6 +28,7 @@
 #include "rocksdb/write_batch.h"
 #include <bcos-framework/security/DataEncryptInterface.h>
 #include <bcos-framework/storage/StorageInterface.h>
+#include <bcos-storage/RocksDBColumnFamily.h>
 #include <bcos-storage/RocksDBStorage.h>
 #include <bcos-storage/TiKVStorage.h>
 
@@ -37,10 +38,10 @@ class StorageInitializer
 {
 public:
     static bcos::storage::TransactionalStorageInterface::Ptr build(const std::string& _storagePath,
-        const bcos::security::DataEncryptInterface::Ptr _dataEncrypt, size_t keyPageSize = 0)
+        const bcos::security::DataEncryptInterface::Ptr _dataEncrypt, size_t keyPageSize = 0,
+        const bcos::storage::RocksDBProfile& _profile = bcos::storage::RocksDBProfile())
     {
         boost::filesystem::create_directories(_storagePath);
-        rocksdb::DB* db;
         rocksdb::Options options;
         // Note: This option will increase much memory
         // options.IncreaseParallelism();
@@ -61,18 +62,9 @@ public:
         }
 
         // open DB
-        rocksdb::Status s = rocksdb::DB::Open(options, _storagePath, &db);
-        if (!s.ok())
-        {
-            BCOS_LOG(INFO) << LOG_DESC("open rocksDB failed") << LOG_KV("error", s.ToString());
-            throw std::runtime_error("open rocksDB failed, err:" + s.ToString());
-        }
-        auto unique_db = std::unique_ptr<rocksdb::DB, std::function<void(rocksdb::DB*)>>(
-            db, [](rocksdb::DB* db) {
-                CancelAllBackgroundWork(db, true);
-                delete db;
-            });
-        return std::make_shared<bcos::storage::RocksDBStorage>(std::move(unique_db), _dataEncrypt);
+        auto [db, columnFamilies] = bcos::storage::openRocksDB(_storagePath, options, _profile);
+        return std::make_shared<bcos::storage::RocksDBStorage>(
+            std::move(db), std::move(columnFamilies), _dataEncrypt);
     }
 
 #ifdef WITH_TIKV
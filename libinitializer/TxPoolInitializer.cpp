@@ -47,6 +47,7 @@ TxPoolInitializer::TxPoolInitializer(bcos::tool::NodeConfig::Ptr _nodeConfig,
         m_nodeConfig->verifierWorkerNum(), m_nodeConfig->txsExpirationTime(), _preStoreTxs);
     auto txpoolConfig = m_txpool->txpoolConfig();
     txpoolConfig->setPoolLimit(m_nodeConfig->txpoolLimit());
+    txpoolConfig->setVerifyBatchSize(m_nodeConfig->verifyBatchSize());
 }
 
 void TxPoolInitializer::init(bcos::sealer::SealerInterface::Ptr _sealer)
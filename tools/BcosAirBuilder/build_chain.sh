@@ -1206,6 +1206,11 @@ generate_common_ini() {
     enable_cache=true
     ; The granularity of the storage page, in bytes, must not be less than 4096 Bytes, the default is 10240 Bytes (10KB)
     key_page_size=${key_page_size}
+    ; store system, state and history tables in separate column families, only take effect for a new data_path
+    ;enable_column_family=false
+    ; block cache of the state and history column families, in MB
+    ;state_block_cache_size=128
+    ;history_block_cache_size=32
 
 [txpool]
     ; size of the txpool, default is 15000
@@ -1214,6 +1219,8 @@ generate_common_ini() {
     notify_worker_num=2
     ; txs verification threads num, default is the number of CPU cores
     ;verify_worker_num=2
+    ; max number of submitted txs verified together, default is 256
+    ;verify_batch_size=256
     ; txs expiration time, in seconds, default is 10 minutes
     txs_expiration_time = 600
 